@@ -5,6 +5,7 @@
 #endif
 
 #include <sched.h>
+#include <sys/types.h>
 
 #include "envoy/api/os_sys_calls_common.h"
 #include "envoy/common/pure.h"
@@ -20,6 +21,12 @@ public:
    * @see sched_getaffinity (man 2 sched_getaffinity)
    */
   virtual SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) PURE;
+
+  /**
+   * @see sendfile (man 2 sendfile)
+   */
+  virtual SysCallSizeResult sendfile(os_fd_t out_fd, os_fd_t in_fd, off_t* offset,
+                                     size_t count) PURE;
 };
 
 using LinuxOsSysCallsPtr = std::unique_ptr<LinuxOsSysCalls>;
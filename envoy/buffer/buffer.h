@@ -4,6 +4,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "envoy/api/os_sys_calls.h"
 #include "envoy/common/exception.h"
@@ -47,6 +48,15 @@ struct ConstRawSlice {
 
 using RawSliceVector = absl::InlinedVector<RawSlice, 16>;
 
+/**
+ * A range of bytes in an open file.
+ */
+struct FileRange {
+  os_fd_t fd_{};
+  uint64_t offset_ = 0;
+  uint64_t len_ = 0;
+};
+
 /**
  * A wrapper class to facilitate passing in externally owned data to a buffer via addBufferFragment.
  * When the buffer no longer needs the data passed in through a fragment, it calls done() on it.
@@ -68,6 +78,14 @@ public:
    * Called by a buffer when the referenced data is no longer needed.
    */
   virtual void done() PURE;
+
+  /**
+   * @return the range of a file whose content the referenced data is a read-only mapping of, if
+   * any. A socket may then send the data directly from the file (e.g. with sendfile) rather than
+   * from memory. The file must remain open, and its content in the range unchanged, until done()
+   * is called. The range's length is size().
+   */
+  virtual absl::optional<FileRange> fileRange() const { return absl::nullopt; }
 };
 
 /**
@@ -244,6 +262,16 @@ public:
    */
   virtual RawSlice frontSlice() const PURE;
 
+  /**
+   * Find the first slice whose data is part of a file, i.e. which was added by addBufferFragment()
+   * with a fragment that has a BufferFragment::fileRange().
+   * @param max_slices supplies the number of non-empty slices at the front of the buffer to search.
+   * @return the number of bytes in the buffer before that slice, and the range of the file holding
+   * the slice's data, or nullopt if none of the slices searched is part of a file.
+   */
+  virtual absl::optional<std::pair<uint64_t, FileRange>>
+  findFileSlice(uint64_t max_slices) const PURE;
+
   /**
    * Transfer ownership of the front slice to the caller. Must only be called if the
    * buffer is not empty otherwise the implementation will have undefined behavior.
@@ -6,6 +6,8 @@
 #include "envoy/network/address.h"
 #include "envoy/thread_local/thread_local.h"
 
+struct statx;
+
 namespace Envoy {
 namespace Io {
 
@@ -27,9 +29,15 @@ public:
     Close = 0x10,
     Cancel = 0x20,
     Shutdown = 0x40,
+    // An operation on a file rather than a socket, e.g. by an AsyncFileManager.
+    File = 0x80,
   };
 
-  Request(RequestType type, IoUringSocket& socket) : type_(type), socket_(socket) {}
+  Request(RequestType type, IoUringSocket& socket) : type_(type), socket_(&socket) {}
+  /**
+   * Constructs a request which does not belong to an io_uring socket.
+   */
+  explicit Request(RequestType type) : type_(type), socket_(nullptr) {}
   virtual ~Request() = default;
 
   /**
@@ -38,13 +46,27 @@ public:
   RequestType type() const { return type_; }
 
   /**
-   * Returns the io_uring socket the request belongs to.
+   * Returns the io_uring socket the request belongs to. Must not be called for requests which do
+   * not belong to a socket.
+   */
+  IoUringSocket& socket() const { return *socket_; }
+
+  /**
+   * Returns the flags of the completion being delivered for this request, e.g. whether a multishot
+   * request will complete again or which provided buffer holds the received data. Only valid
+   * within the completion callback, and always zero for injected completions.
    */
-  IoUringSocket& socket() const { return socket_; }
+  uint32_t completionFlags() const { return completion_flags_; }
+
+  /**
+   * Set the flags of the completion being delivered for this request.
+   */
+  void setCompletionFlags(uint32_t flags) { completion_flags_ = flags; }
 
 private:
   RequestType type_;
-  IoUringSocket& socket_;
+  IoUringSocket* socket_;
+  uint32_t completion_flags_{0};
 };
 
 /**
@@ -126,6 +148,58 @@ public:
   virtual IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                       off_t offset, Request* user_data) PURE;
 
+  /**
+   * Prepares a multishot recv system call reading into the provided buffer ring and puts it into
+   * the submission queue. The request completes once per received chunk of data for as long as the
+   * completion carries the IORING_CQE_F_MORE flag. Requires a successful setupBufferRing().
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareRecvMultishot(os_fd_t fd, Request* user_data) PURE;
+
+  /**
+   * Prepares a writev system call linked to a following close system call and puts both into the
+   * submission queue. The close only runs if the writev writes all the given data; otherwise it
+   * completes with -ECANCELED.
+   * Returns IoUringResult::Failed in case the submission queue has no room for both entries
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareWritevAndClose(os_fd_t fd, const struct iovec* iovecs,
+                                              unsigned nr_vecs, Request* write_user_data,
+                                              Request* close_user_data) PURE;
+
+  /**
+   * Prepares an openat system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareOpenat(os_fd_t dfd, const char* path, int flags, mode_t mode,
+                                      Request* user_data) PURE;
+
+  /**
+   * Prepares a statx system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareStatx(os_fd_t dfd, const char* path, int flags, unsigned mask,
+                                     struct statx* statxbuf, Request* user_data) PURE;
+
+  /**
+   * Prepares an unlinkat system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareUnlinkat(os_fd_t dfd, const char* path, int flags,
+                                        Request* user_data) PURE;
+
+  /**
+   * Prepares a linkat system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareLinkat(os_fd_t old_dfd, const char* old_path, os_fd_t new_dfd,
+                                      const char* new_path, int flags, Request* user_data) PURE;
+
   /**
    * Prepares a close system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -147,6 +221,24 @@ public:
    */
   virtual IoUringResult prepareShutdown(os_fd_t fd, int how, Request* user_data) PURE;
 
+  /**
+   * Registers a ring of provided buffers with the kernel for use by prepareRecvMultishot().
+   * @param entries the number of buffers in the ring. Must be a power of 2.
+   * @param buffer_size the size of each buffer.
+   * @return false if the kernel does not support provided buffer rings.
+   */
+  virtual bool setupBufferRing(uint32_t entries, uint32_t buffer_size) PURE;
+
+  /**
+   * Moves the data received into a provided buffer to the given buffer and returns a buffer to the
+   * ring in its place.
+   * @param buffer_id the buffer id carried in the completion flags.
+   * @param length the number of bytes received into the buffer.
+   * @param output the buffer to move the data to.
+   */
+  virtual void consumeProvidedBuffer(uint16_t buffer_id, uint32_t length,
+                                     Buffer::Instance& output) PURE;
+
   /**
    * Submits the entries in the submission queue to the kernel using the
    * `io_uring_enter()` system call.
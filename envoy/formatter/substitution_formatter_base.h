@@ -29,6 +29,18 @@ public:
    */
   virtual std::string formatWithContext(const Context& context,
                                         const StreamInfo::StreamInfo& stream_info) const PURE;
+
+  /**
+   * Append a formatted substitution line to a buffer, which callers formatting many lines can
+   * reuse to avoid allocating a string per line.
+   * @param context supplies the formatter context.
+   * @param stream_info supplies the stream info.
+   * @param output supplies the buffer the line is appended to.
+   */
+  virtual void appendWithContext(const Context& context, const StreamInfo::StreamInfo& stream_info,
+                                 std::string& output) const {
+    output.append(formatWithContext(context, stream_info));
+  }
 };
 
 using FormatterPtr = std::unique_ptr<Formatter>;
@@ -61,6 +73,45 @@ public:
   virtual ProtobufWkt::Value
   formatValueWithContext(const Context& context,
                          const StreamInfo::StreamInfo& stream_info) const PURE;
+
+  /**
+   * Append the value formatWithContext() would return to a buffer. Providers override this when
+   * they can write the value without building an intermediate string.
+   * @param context supplies the formatter context.
+   * @param stream_info supplies the stream info.
+   * @param output supplies the buffer the value is appended to.
+   * @return bool false if there is no value, in which case nothing is appended.
+   */
+  virtual bool appendWithContext(const Context& context, const StreamInfo::StreamInfo& stream_info,
+                                 std::string& output) const {
+    absl::optional<std::string> value = formatWithContext(context, stream_info);
+    if (!value.has_value()) {
+      return false;
+    }
+    output.append(value.value());
+    return true;
+  }
+
+  /**
+   * The kind of the values returned by formatValueWithContext().
+   */
+  enum class ValueKind {
+    // Any value.
+    Unknown,
+    // The null value when formatWithContext() returns no value, and otherwise a string value equal
+    // to it.
+    String,
+    // The null value when formatWithContext() returns no value, and otherwise a number value of
+    // which it is the decimal integer representation.
+    Integer,
+  };
+
+  /**
+   * @return ValueKind the kind of the values returned by formatValueWithContext(). Structured
+   *         formatters write values of a known kind from appendWithContext() instead of building
+   *         a ProtobufWkt::Value.
+   */
+  virtual ValueKind valueKind() const { return ValueKind::Unknown; }
 };
 
 using FormatterProviderPtr = std::unique_ptr<FormatterProvider>;
@@ -61,6 +61,21 @@ enum class DrainStrategy {
   Immediate,
 };
 
+/**
+ * What a write to a file access log does when the file's flush buffer is full.
+ */
+enum class FileFlushOverflowAction {
+  /**
+   * The writing thread waits until the buffer has been written to disk.
+   */
+  Block,
+
+  /**
+   * The data is discarded.
+   */
+  Drop,
+};
+
 using CommandLineOptionsPtr = std::unique_ptr<envoy::admin::v3::CommandLineOptions>;
 
 /**
@@ -222,6 +237,17 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() const PURE;
 
+  /**
+   * @return uint64_t the maximum number of bytes buffered for each file before they are flushed, or
+   *         0 for no limit.
+   */
+  virtual uint64_t fileFlushBufferLimitBytes() const PURE;
+
+  /**
+   * @return FileFlushOverflowAction what writes do when a file's buffer limit is reached.
+   */
+  virtual FileFlushOverflowAction fileFlushOverflowAction() const PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -101,6 +102,22 @@ public:
    */
   virtual bool autoSniSanMatch() const PURE;
 
+  struct VerificationCacheConfig {
+    uint32_t max_entries_;
+    std::chrono::milliseconds ttl_;
+  };
+
+  /**
+   * @return the configuration of the cache of trust chain verification results, if one is used.
+   */
+  virtual const absl::optional<VerificationCacheConfig>& verificationCache() const PURE;
+
+  /**
+   * @return the number of threads trust chain verification is offloaded to, or 0 if it is done on
+   * the thread doing the handshake.
+   */
+  virtual uint32_t asyncVerificationThreads() const PURE;
+
   // SECURITY NOTE
   //
   // When adding or changing this interface, it is likely that a change is needed to
@@ -113,6 +113,12 @@ public:
    */
   virtual const std::string& tlsKeyLogPath() const PURE;
 
+  /**
+   * @return true if the traffic keys should be installed in the kernel once the handshake is
+   * complete, so that the kernel encrypts and decrypts records where it supports it.
+   */
+  virtual bool enableKernelTls() const PURE;
+
   /**
    * @return the access log manager object reference
    */
@@ -173,6 +179,14 @@ public:
     MustStaple,
   };
 
+  struct SharedSessionCacheConfig {
+    uint32_t max_sessions_;
+    uint32_t max_session_size_;
+    // The file the cache is stored in, or empty for anonymous memory.
+    std::string path_;
+    std::chrono::seconds ticket_key_rotation_interval_;
+  };
+
   /**
    * @return True if client certificate is required, false otherwise.
    */
@@ -222,6 +236,12 @@ public:
    * @return a factory which can be used to create TLS context provider instances.
    */
   virtual TlsCertificateSelectorFactory tlsCertificateSelectorFactory() const PURE;
+
+  /**
+   * @return the configuration of the cache of sessions and session ticket keys shared with other
+   * server contexts, if one should be used rather than a cache in each context.
+   */
+  virtual absl::optional<SharedSessionCacheConfig> sharedSessionCache() const PURE;
 };
 
 using ServerContextConfigPtr = std::unique_ptr<ServerContextConfig>;
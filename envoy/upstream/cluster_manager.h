@@ -274,12 +274,16 @@ public:
    *                       update. It can be overridden by setting `remove_ignored` to true while
    *                       calling removeCluster(). This is useful for clusters whose lifecycle
    *                       is managed with custom implementation, e.g., DFP clusters.
+   * @param from_cds whether the cluster comes from a CDS update. Only such clusters are created
+   *                 lazily when lazy_cluster_creation is configured; others are always created and
+   *                 warmed right away.
    * @return true if the action results in an add/update of a cluster, an error
    * status if the config is invalid.
    */
   virtual absl::StatusOr<bool>
   addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
-                     const std::string& version_info, const bool avoid_cds_removal = false) PURE;
+                     const std::string& version_info, const bool avoid_cds_removal = false,
+                     const bool from_cds = false) PURE;
 
   /**
    * Set a callback that will be invoked when all primary clusters have been initialized.
@@ -303,7 +307,8 @@ public:
   struct ClusterInfoMaps {
     bool hasCluster(absl::string_view cluster) const {
       return active_clusters_.find(cluster) != active_clusters_.end() ||
-             warming_clusters_.find(cluster) != warming_clusters_.end();
+             warming_clusters_.find(cluster) != warming_clusters_.end() ||
+             lazy_clusters_.contains(cluster);
     }
 
     ClusterConstOptRef getCluster(absl::string_view cluster) const {
@@ -320,6 +325,9 @@ public:
 
     ClusterInfoMap active_clusters_;
     ClusterInfoMap warming_clusters_;
+    // Names of the clusters added via API which are not created yet, when lazy cluster creation is
+    // configured. These are in neither of the maps above.
+    absl::flat_hash_set<std::string> lazy_clusters_;
 
     // Number of clusters that were dynamically added via API (xDS). This will be
     // less than or equal to the number of `active_clusters_` and `warming_clusters_`.
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -107,6 +108,17 @@ public:
   virtual absl::Status onOrcaLoadReport(const OrcaLoadReport& /*report*/) {
     return absl::OkStatus();
   }
+
+  /**
+   * Invoked when a response from this upstream host completes, or when a request to it times out
+   * or is reset after it was sent, to update the host lb policy data.
+   * NOTE: this method may be called concurrently from multiple threads.
+   * Please ensure that the implementation is thread-safe.
+   *
+   * @param response_time supplies the time from the end of the request to the end of the
+   * response, or to the timeout or reset.
+   */
+  virtual void onResponseTime(std::chrono::microseconds /*response_time*/) {}
 };
 
 using HostLbPolicyDataPtr = std::unique_ptr<HostLbPolicyData>;
@@ -220,6 +232,12 @@ public:
    */
   virtual HostStats& stats() const PURE;
 
+  /**
+   * @return the host specific stats for reading. Unlike stats(), this does not allocate the stats
+   * of a host which has not used them yet, whose stats all read as zero.
+   */
+  virtual HostStats& statsForReading() const PURE;
+
   /**
    * @return custom stats for multi-dimensional load balancing.
    */
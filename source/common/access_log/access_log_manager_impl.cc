@@ -1,6 +1,9 @@
 #include "source/common/access_log/access_log_manager_impl.h"
 
+#include <algorithm>
+#include <functional>
 #include <string>
+#include <thread>
 
 #include "envoy/common/exception.h"
 
@@ -8,7 +11,7 @@
 #include "source/common/common/fmt.h"
 #include "source/common/common/lock_guard.h"
 
-#include "absl/container/fixed_array.h"
+#include "absl/container/inlined_vector.h"
 
 namespace Envoy {
 namespace AccessLog {
@@ -46,47 +49,119 @@ AccessLogManagerImpl::createAccessLog(const Filesystem::FilePathAndType& file_in
                                                   open_result.err_->getErrorDetails()));
   }
 
-  access_logs_[file_name] =
-      std::make_shared<AccessLogFileImpl>(std::move(file), dispatcher_, lock_, file_stats_,
-                                          file_flush_interval_msec_, api_.threadFactory());
+  if (flusher_ == nullptr) {
+    flusher_ = std::make_shared<AccessLogFlusher>(api_.threadFactory());
+  }
+  access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
+      std::move(file), dispatcher_, lock_, file_stats_, file_flush_interval_msec_, flusher_,
+      file_buffer_limit_bytes_, file_overflow_action_);
   return access_logs_[file_name];
 }
 
+AccessLogFlusher::AccessLogFlusher(Thread::ThreadFactory& thread_factory)
+    : thread_factory_(thread_factory) {}
+
+AccessLogFlusher::~AccessLogFlusher() {
+  {
+    Thread::LockGuard lock(lock_);
+    // Files unregister themselves when destroyed, so nothing is left to flush.
+    ASSERT(pending_.empty());
+    flush_thread_exit_ = true;
+    flush_event_.notifyOne();
+  }
+
+  if (flush_thread_ != nullptr) {
+    flush_thread_->join();
+  }
+}
+
+void AccessLogFlusher::requestFlush(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(lock_);
+  // There are few files, so a linear search is cheaper than maintaining a set.
+  if (std::find(pending_.begin(), pending_.end(), &file) != pending_.end()) {
+    return;
+  }
+  pending_.push_back(&file);
+
+  if (flush_thread_ == nullptr) {
+    flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
+                                                 Thread::Options{"AccessLogFlush"});
+  }
+  flush_event_.notifyOne();
+}
+
+void AccessLogFlusher::removeFile(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(lock_);
+  // A flush in progress may request another flush of the file when it ends, so the file is only
+  // taken out of the queue once it is no longer being flushed.
+  while (flushing_ == &file) {
+    flush_done_.wait(lock_);
+  }
+  pending_.erase(std::remove(pending_.begin(), pending_.end(), &file), pending_.end());
+}
+
+void AccessLogFlusher::flushThreadFunc() {
+  while (true) {
+    AccessLogFileImpl* file;
+    {
+      Thread::LockGuard lock(lock_);
+      while (pending_.empty() && !flush_thread_exit_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        flush_event_.wait(lock_);
+      }
+
+      if (flush_thread_exit_) {
+        return;
+      }
+
+      file = pending_.front();
+      pending_.pop_front();
+      flushing_ = file;
+    }
+
+    // The file cannot be destroyed while flushing_ points to it, see removeFile().
+    file->flushFromFlushThread();
+
+    {
+      Thread::LockGuard lock(lock_);
+      flushing_ = nullptr;
+      flush_done_.notifyAll();
+    }
+  }
+}
+
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
-                                     Thread::ThreadFactory& thread_factory)
+                                     AccessLogFlusherSharedPtr flusher,
+                                     uint64_t buffer_limit_bytes,
+                                     FileOverflowAction overflow_action)
     : file_(std::move(file)), file_lock_(lock),
+      shards_(std::clamp<uint32_t>(std::thread::hardware_concurrency(), 1, MAX_SHARDS)),
       flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notifyOne();
+        flusher_->requestFlush(*this);
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
+      flusher_(std::move(flusher)), flush_interval_msec_(flush_interval_msec),
+      buffer_limit_bytes_(buffer_limit_bytes), overflow_action_(overflow_action), stats_(stats) {
   flush_timer_->enableTimer(flush_interval_msec_);
 }
 
 void AccessLogFileImpl::reopen() {
-  Thread::LockGuard lock(write_lock_);
   reopen_file_ = true;
-  flush_event_.notifyOne();
+  flusher_->requestFlush(*this);
 }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
-  {
-    Thread::LockGuard lock(write_lock_);
-    flush_thread_exit_ = true;
-    flush_event_.notifyOne();
-  }
-
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
-  }
+  flusher_->removeFile(*this);
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    {
+      Thread::LockGuard flush_lock(flush_lock_);
+      collectShards();
+      doWrite(about_to_write_buffer_);
     }
     const Api::IoCallBoolResult result = file_->close();
     ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
@@ -94,6 +169,13 @@ AccessLogFileImpl::~AccessLogFileImpl() {
   }
 }
 
+void AccessLogFileImpl::collectShards() {
+  for (Shard& shard : shards_) {
+    Thread::LockGuard lock(shard.lock_);
+    about_to_write_buffer_.move(shard.buffer_);
+  }
+}
+
 void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   Buffer::RawSliceVector slices = buffer.getRawSlices();
 
@@ -107,10 +189,17 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   //            process lock or had multiple locks.
   {
     Thread::LockGuard lock(file_lock_);
-    for (const Buffer::RawSlice& slice : slices) {
-      absl::string_view data(static_cast<char*>(slice.mem_), slice.len_);
-      const Api::IoCallSizeResult result = file_->write(data);
-      if (result.ok() && result.return_value_ == static_cast<ssize_t>(slice.len_)) {
+    absl::InlinedVector<absl::string_view, MAX_SLICES_PER_WRITE> batch;
+    for (size_t first = 0; first < slices.size(); first += MAX_SLICES_PER_WRITE) {
+      const size_t last = std::min<size_t>(slices.size(), first + MAX_SLICES_PER_WRITE);
+      uint64_t batch_length = 0;
+      batch.clear();
+      for (size_t i = first; i < last; i++) {
+        batch.emplace_back(static_cast<const char*>(slices[i].mem_), slices[i].len_);
+        batch_length += slices[i].len_;
+      }
+      const Api::IoCallSizeResult result = file_->writev(batch);
+      if (result.ok() && result.return_value_ == static_cast<ssize_t>(batch_length)) {
         stats_.write_completed_.inc();
       } else {
         // Probably disk full.
@@ -119,49 +208,32 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
     }
   }
 
-  stats_.write_total_buffered_.sub(buffer.length());
-  buffer.drain(buffer.length());
-}
-
-void AccessLogFileImpl::flushThreadFunc() {
-
-  // Transfer the action from `reopen_file_` to this variable so that `reopen_file_` is only
-  // accessed while holding the mutex while the actual operation is performed while not holding the
-  // mutex.
-  bool do_reopen = false;
-
-  while (true) {
-    std::unique_lock<Thread::BasicLockable> flush_lock;
+  const uint64_t length = buffer.length();
+  buffer.drain(length);
+  buffered_bytes_ -= length;
+  stats_.write_total_buffered_.sub(length);
 
+  if (buffer_limit_bytes_ > 0 && length > 0) {
     {
-      Thread::LockGuard write_lock(write_lock_);
-
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      //
-      // Note: do not stop waiting when only `do_reopen` is true. In this case, we tried to
-      // reopen and failed. We don't want to retry this in a tight loop, so wait for the next
-      // event (timer or flush).
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
-        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
-        flush_event_.wait(write_lock_);
-      }
-
-      if (flush_thread_exit_) {
-        return;
-      }
+      // Taking the lock ensures that a writer in reserveBuffer() is either already waiting, or
+      // will see the new buffered_bytes_.
+      Thread::LockGuard lock(drain_lock_);
+    }
+    drain_event_.notifyAll();
+  }
+}
 
-      flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
+void AccessLogFileImpl::flushFromFlushThread() {
+  {
+    Thread::LockGuard flush_lock(flush_lock_);
+    collectShards();
 
-      if (reopen_file_) {
-        do_reopen = true;
-        reopen_file_ = false;
-      }
+    if (reopen_file_.exchange(false)) {
+      do_reopen_ = true;
     }
-
-    if (do_reopen) {
+    // When a reopen fails, do_reopen_ stays set and the reopen is retried by the next flush,
+    // which happens on the next timer or write event rather than in a tight loop.
+    if (do_reopen_) {
       if (file_->isOpen()) {
         const Api::IoCallBoolResult result = file_->close();
         ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
@@ -171,56 +243,73 @@ void AccessLogFileImpl::flushThreadFunc() {
       if (!open_result.return_value_) {
         stats_.reopen_failed_.inc();
       } else {
-        do_reopen = false;
+        do_reopen_ = false;
       }
     }
     // doWrite no matter file isOpen, if not, we can drain buffer
     doWrite(about_to_write_buffer_);
   }
+
+  // The shards may have been filled past MIN_FLUSH_SIZE during the write, after the request for
+  // this flush was taken off the queue.
+  if (buffered_bytes_ > MIN_FLUSH_SIZE) {
+    flusher_->requestFlush(*this);
+  }
 }
 
 void AccessLogFileImpl::flush() {
-  std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
-
-  {
-    Thread::LockGuard write_lock(write_lock_);
-
-    // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
-    // but has not yet completed doWrite(). This would allow flush() to
-    // return before the pending data has actually been written to disk.
-    flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-
-    if (flush_buffer_.length() == 0) {
-      return;
-    }
+  // flush_lock_ is held for the whole flush, so that if the flush thread has already moved the
+  // shards to about_to_write_buffer_ but not yet written it, this waits for that write rather than
+  // returning before the pending data has actually been written to disk.
+  Thread::LockGuard flush_lock(flush_lock_);
+  collectShards();
+  doWrite(about_to_write_buffer_);
+}
 
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
+bool AccessLogFileImpl::reserveBuffer(uint64_t length) {
+  if (buffer_limit_bytes_ == 0 || buffered_bytes_ + length <= buffer_limit_bytes_) {
+    return true;
+  }
+  if (overflow_action_ == FileOverflowAction::Drop) {
+    return false;
   }
 
-  doWrite(about_to_write_buffer_);
+  stats_.write_blocked_.inc();
+  flusher_->requestFlush(*this);
+  Thread::LockGuard lock(drain_lock_);
+  // Data bigger than the limit is let through once the buffer is empty.
+  while (buffered_bytes_ > 0 && buffered_bytes_ + length > buffer_limit_bytes_) {
+    drain_event_.wait(drain_lock_);
+  }
+  return true;
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
-
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+  // The limit is checked without holding a lock, so concurrent writers may take the buffer a
+  // little past it.
+  if (!reserveBuffer(data.length())) {
+    stats_.write_dropped_.inc();
+    return;
   }
 
   stats_.write_buffered_.inc();
   stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notifyOne();
+  // Counted before the data is added, so that a concurrent flush never subtracts more than was
+  // added.
+  const uint64_t previously_buffered = buffered_bytes_.fetch_add(data.length());
+
+  Shard& shard = shards_[std::hash<std::thread::id>()(std::this_thread::get_id()) % shards_.size()];
+  {
+    Thread::LockGuard lock(shard.lock_);
+    shard.buffer_.add(data.data(), data.size());
   }
-}
 
-void AccessLogFileImpl::createFlushStructures() {
-  flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
-                                               Thread::Options{"AccessLogFlush"});
+  // Only the write which takes the buffer past MIN_FLUSH_SIZE requests a flush, so that writers do
+  // not all contend on the flusher's lock while the flush is pending.
+  if (previously_buffered <= MIN_FLUSH_SIZE &&
+      previously_buffered + data.length() > MIN_FLUSH_SIZE) {
+    flusher_->requestFlush(*this);
+  }
 }
 
 } // namespace AccessLog
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <string>
 
 #include "envoy/access_log/access_log.h"
@@ -13,6 +16,7 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 
+#include "absl/container/fixed_array.h"
 #include "absl/container/node_hash_map.h"
 
 namespace Envoy {
@@ -20,8 +24,10 @@ namespace Envoy {
 #define ACCESS_LOG_FILE_STATS(COUNTER, GAUGE)                                                      \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
+  COUNTER(write_blocked)                                                                           \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
   COUNTER(write_failed)                                                                            \
   GAUGE(write_total_buffered, Accumulate)
 
@@ -31,12 +37,62 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+/**
+ * What a write to an access log file does when the file's buffer limit is reached.
+ */
+enum class FileOverflowAction {
+  // Wait until the flush thread has written enough of the buffer to disk.
+  Block,
+  // Discard the data.
+  Drop,
+};
+
+class AccessLogFileImpl;
+
+/**
+ * The thread which flushes all the access log files of a manager to disk. Files ask it to flush
+ * them when their buffers get big enough, when their flush timers fire or when they are reopened,
+ * and it flushes them one at a time in the order they asked.
+ */
+class AccessLogFlusher {
+public:
+  explicit AccessLogFlusher(Thread::ThreadFactory& thread_factory);
+  ~AccessLogFlusher();
+
+  /**
+   * Flushes a file on the flush thread, unless it is already waiting to be flushed.
+   */
+  void requestFlush(AccessLogFileImpl& file);
+
+  /**
+   * Forgets a file which is being destroyed, waiting for it if it is being flushed.
+   */
+  void removeFile(AccessLogFileImpl& file);
+
+private:
+  void flushThreadFunc();
+
+  Thread::ThreadFactory& thread_factory_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar flush_event_;
+  Thread::CondVar flush_done_;
+  std::deque<AccessLogFileImpl*> pending_ ABSL_GUARDED_BY(lock_);
+  AccessLogFileImpl* flushing_ ABSL_GUARDED_BY(lock_){};
+  bool flush_thread_exit_ ABSL_GUARDED_BY(lock_){false};
+  Thread::ThreadPtr flush_thread_; // Started by the first flush request.
+};
+
+using AccessLogFlusherSharedPtr = std::shared_ptr<AccessLogFlusher>;
+
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
   AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
                        Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
-                       Stats::Store& stats_store)
-      : file_flush_interval_msec_(file_flush_interval_msec), api_(api), dispatcher_(dispatcher),
+                       Stats::Store& stats_store, uint64_t file_buffer_limit_bytes = 0,
+                       FileOverflowAction file_overflow_action = FileOverflowAction::Block)
+      : file_flush_interval_msec_(file_flush_interval_msec),
+        file_buffer_limit_bytes_(file_buffer_limit_bytes),
+        file_overflow_action_(file_overflow_action), api_(api), dispatcher_(dispatcher),
         lock_(lock),
         file_stats_{ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
                                           POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
@@ -49,26 +105,34 @@ public:
 
 private:
   const std::chrono::milliseconds file_flush_interval_msec_;
+  const uint64_t file_buffer_limit_bytes_;
+  const FileOverflowAction file_overflow_action_;
   Api::Api& api_;
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
   AccessLogFileStats file_stats_;
+  // Created with the first file, and shared with the files, which may outlive the manager.
+  AccessLogFlusherSharedPtr flusher_;
   absl::node_hash_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * Writes are therefore buffered, and the buffers are written to disk by the AccessLogFlusher
+ * thread which is shared by all the files of a manager.
+ *
+ * To keep the threads writing to a file from contending on a single lock, the buffer is split
+ * into shards, and each thread appends to the shard picked by its thread ID, so the lines written
+ * by one thread stay in order. A flush writes the shards out with vectored writes.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                     Thread::BasicLockable& lock, AccessLogFileStats& stats,
                     std::chrono::milliseconds flush_interval_msec,
-                    Thread::ThreadFactory& thread_factory);
+                    AccessLogFlusherSharedPtr flusher, uint64_t buffer_limit_bytes = 0,
+                    FileOverflowAction overflow_action = FileOverflowAction::Block);
   ~AccessLogFileImpl() override;
 
   // AccessLog::AccessLogFile
@@ -83,18 +147,33 @@ public:
   void flush() override;
 
 private:
+  friend class AccessLogFlusher;
+
+  struct Shard {
+    Thread::MutexBasicLockable lock_;
+    Buffer::OwnedImpl buffer_ ABSL_GUARDED_BY(lock_);
+  };
+
+  // Waits until the buffer has room for the data, or returns false if the data is to be dropped.
+  bool reserveBuffer(uint64_t length);
+  // Called by the flush thread.
+  void flushFromFlushThread();
+  // Moves the shards into about_to_write_buffer_. flush_lock_ must be held.
+  void collectShards();
   void doWrite(Buffer::Instance& buffer);
-  void flushThreadFunc();
-  void createFlushStructures();
 
   // Minimum size before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  // The number of slices written by each vectored write.
+  static constexpr uint64_t MAX_SLICES_PER_WRITE = 64;
+  // The maximum number of buffer shards, which is otherwise the number of CPUs.
+  static constexpr uint32_t MAX_SHARDS = 16;
 
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
-  //    1) write_lock_
-  //    2) flush_lock_
+  //    1) flush_lock_
+  //    2) a shard's lock_
   //    3) file_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
@@ -105,31 +184,31 @@ private:
                                           // concurrent access to the about_to_write_buffer_, fd_,
                                           // and all other data used during flushing and file
                                           // re-opening.
-  Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
-  Thread::CondVar flush_event_;
-  bool flush_thread_exit_ ABSL_GUARDED_BY(write_lock_){false};
-  bool reopen_file_ ABSL_GUARDED_BY(write_lock_){false};
-  Buffer::OwnedImpl
-      flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
-                                                  // gets filled and then flushed either when max
-                                                  // size is reached or when a timer fires.
+  absl::FixedArray<Shard> shards_; // Filled by the writing threads, and moved to
+                                   // about_to_write_buffer_ by flushes.
   // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
   // through the std::make_unique assignment. I do not believe it's possible to annotate this
   // properly now due to limitations in the clang thread annotation analysis.
-  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
-                                            // continue to fill. This buffer is then used for the
-                                            // final write to disk.
+  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only while flushing. Data is
+                                            // moved from the shards under their locks, which are
+                                            // then released so that the shards can continue to
+                                            // fill. This buffer is then used for the final write
+                                            // to disk.
+  // The bytes in the shards and about_to_write_buffer_, which the buffer limit applies to.
+  std::atomic<uint64_t> buffered_bytes_{0};
+  std::atomic<bool> reopen_file_{false};
+  bool do_reopen_ ABSL_GUARDED_BY(flush_lock_){false}; // Set while a reopen has failed, so that it
+                                                       // is retried by the next flush.
+  // Writers blocked on the buffer limit wait on drain_event_ for flushes.
+  Thread::MutexBasicLockable drain_lock_;
+  Thread::CondVar drain_event_;
   Event::TimerPtr flush_timer_;
-  Thread::ThreadFactory& thread_factory_;
+  const AccessLogFlusherSharedPtr flusher_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
+  const uint64_t buffer_limit_bytes_; // 0 means no limit.
+  const FileOverflowAction overflow_action_;
   AccessLogFileStats& stats_;
 };
 
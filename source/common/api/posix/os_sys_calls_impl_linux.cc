@@ -3,6 +3,7 @@
 #endif
 
 #include <sched.h>
+#include <sys/sendfile.h>
 
 #include <cerrno>
 
@@ -17,5 +18,11 @@ SysCallIntResult LinuxOsSysCallsImpl::sched_getaffinity(pid_t pid, size_t cpuset
   return {rc, errno};
 }
 
+SysCallSizeResult LinuxOsSysCallsImpl::sendfile(os_fd_t out_fd, os_fd_t in_fd, off_t* offset,
+                                                size_t count) {
+  const ssize_t rc = ::sendfile(out_fd, in_fd, offset, count);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
 } // namespace Api
 } // namespace Envoy
@@ -197,6 +197,13 @@ SysCallIntResult OsSysCallsImpl::recvmmsg(os_fd_t sockfd, struct mmsghdr* msgvec
   PANIC("not implemented");
 }
 
+SysCallIntResult OsSysCallsImpl::sendmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags) {
+  // Batching writers fall back to sendmsg() as supportsMmsg() is false, so fail rather than crash
+  // if one is used anyway.
+  return {-1, SOCKET_ERROR_NOT_SUP};
+}
+
 bool OsSysCallsImpl::supportsMmsg() const {
   // Windows doesn't support it.
   return false;
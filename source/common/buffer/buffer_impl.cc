@@ -245,6 +245,26 @@ RawSlice OwnedImpl::frontSlice() const {
   return {nullptr, 0};
 }
 
+absl::optional<std::pair<uint64_t, FileRange>>
+OwnedImpl::findFileSlice(uint64_t max_slices) const {
+  uint64_t offset = 0;
+  for (const auto& slice : slices_) {
+    if (max_slices == 0) {
+      break;
+    }
+    if (slice.dataSize() == 0) {
+      continue;
+    }
+    absl::optional<FileRange> range = slice.fileRange();
+    if (range.has_value()) {
+      return std::make_pair(offset, range.value());
+    }
+    offset += slice.dataSize();
+    max_slices--;
+  }
+  return absl::nullopt;
+}
+
 SliceDataPtr OwnedImpl::extractMutableFrontSlice() {
   RELEASE_ASSERT(length_ > 0, "Extract called on empty buffer");
   // Remove zero byte fragments from the front of the queue to ensure
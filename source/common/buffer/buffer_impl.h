@@ -9,6 +9,7 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/http/stream_reset_handler.h"
 
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/non_copyable.h"
 #include "source/common/common/utility.h"
@@ -57,7 +58,7 @@ public:
    * @param account the account to charge.
    */
   Slice(uint64_t min_capacity, const BufferMemoryAccountSharedPtr& account)
-      : capacity_(sliceSize(min_capacity)), storage_(new uint8_t[capacity_]),
+      : capacity_(sliceSize(min_capacity)), storage_(allocateStorage(capacity_)),
         base_(storage_.get()) {
     if (account) {
       account->charge(capacity_);
@@ -91,7 +92,7 @@ public:
   Slice(BufferFragment& fragment)
       : capacity_(fragment.size()), storage_(nullptr),
         base_(static_cast<uint8_t*>(const_cast<void*>(fragment.data()))),
-        reservable_(fragment.size()) {
+        reservable_(fragment.size()), fragment_(&fragment) {
     releasor_ = [&fragment]() { fragment.done(); };
   }
 
@@ -104,16 +105,19 @@ public:
     drain_trackers_ = std::move(rhs.drain_trackers_);
     account_ = std::move(rhs.account_);
     releasor_.swap(rhs.releasor_);
+    fragment_ = rhs.fragment_;
 
     rhs.capacity_ = 0;
     rhs.base_ = nullptr;
     rhs.data_ = 0;
     rhs.reservable_ = 0;
+    rhs.fragment_ = nullptr;
   }
 
   Slice& operator=(Slice&& rhs) noexcept {
     if (this != &rhs) {
       callAndClearDrainTrackersAndCharges();
+      releaseStorage();
 
       capacity_ = rhs.capacity_;
       storage_ = std::move(rhs.storage_);
@@ -127,11 +131,13 @@ public:
       }
       releasor_ = rhs.releasor_;
       rhs.releasor_ = nullptr;
+      fragment_ = rhs.fragment_;
 
       rhs.capacity_ = 0;
       rhs.base_ = nullptr;
       rhs.data_ = 0;
       rhs.reservable_ = 0;
+      rhs.fragment_ = nullptr;
     }
 
     return *this;
@@ -139,6 +145,7 @@ public:
 
   ~Slice() {
     callAndClearDrainTrackersAndCharges();
+    releaseStorage();
     if (releasor_) {
       releasor_();
     }
@@ -169,6 +176,22 @@ public:
    */
   uint64_t dataSize() const { return reservable_ - data_; }
 
+  /**
+   * @return the range of a file holding the usable content, if the slice refers to a buffer
+   * fragment whose data is part of a file.
+   */
+  absl::optional<FileRange> fileRange() const {
+    if (fragment_ == nullptr) {
+      return absl::nullopt;
+    }
+    absl::optional<FileRange> range = fragment_->fileRange();
+    if (range.has_value()) {
+      range->offset_ += data_;
+      range->len_ = dataSize();
+    }
+    return range;
+  }
+
   /**
    * Remove the first `size` bytes of usable content. Runs in O(1) time.
    * @param size number of bytes to remove. If greater than data_size(), the result is undefined.
@@ -365,10 +388,37 @@ public:
    */
   static inline SizedStorage newStorage(uint64_t min_capacity) {
     const uint64_t slice_size = sliceSize(min_capacity);
-    return {StoragePtr{new uint8_t[slice_size]}, static_cast<size_t>(slice_size)};
+    return {allocateStorage(slice_size), static_cast<size_t>(slice_size)};
+  }
+
+  /**
+   * Allocate backend storage of exactly the given capacity, from the calling thread's slice pool if
+   * one is installed.
+   * @param capacity the capacity of the storage in bytes.
+   * @return the backend storage.
+   */
+  static inline StoragePtr allocateStorage(uint64_t capacity) {
+    SlicePool* pool = SlicePool::current();
+    return pool != nullptr ? pool->allocate(capacity) : StoragePtr{new uint8_t[capacity]};
   }
 
 protected:
+  /**
+   * Return owned storage, if any, to the calling thread's slice pool, or free it if no pool is
+   * installed.
+   */
+  void releaseStorage() {
+    if (storage_ == nullptr) {
+      return;
+    }
+    SlicePool* pool = SlicePool::current();
+    if (pool != nullptr) {
+      pool->release(std::move(storage_), capacity_);
+    } else {
+      storage_.reset();
+    }
+  }
+
   /** Length of the byte array that base_ points to. This is also the offset in bytes from the start
    * of the slice to the end of the Reservable section. */
   uint64_t capacity_ = 0;
@@ -396,6 +446,9 @@ protected:
 
   /** The releasor for the BufferFragment */
   std::function<void()> releasor_;
+
+  /** The external buffer fragment the slice refers to, if any. */
+  const BufferFragment* fragment_{nullptr};
 };
 
 class OwnedImpl;
@@ -663,6 +716,8 @@ public:
   void drain(uint64_t size) override;
   RawSliceVector getRawSlices(absl::optional<uint64_t> max_slices = absl::nullopt) const override;
   RawSlice frontSlice() const override;
+  absl::optional<std::pair<uint64_t, FileRange>>
+  findFileSlice(uint64_t max_slices) const override;
   SliceDataPtr extractMutableFrontSlice() override;
   uint64_t length() const override;
   void* linearize(uint32_t size) override;
@@ -765,12 +820,15 @@ private:
   public:
     static constexpr uint32_t free_list_max_ = Buffer::Reservation::MAX_SLICES_;
 
-    OwnedImplReservationSlicesOwnerMultiple() : free_list_ref_(free_list_) {}
+    OwnedImplReservationSlicesOwnerMultiple()
+        : free_list_ref_(free_list_), pool_(SlicePool::current()) {}
     ~OwnedImplReservationSlicesOwnerMultiple() override {
       for (auto r = owned_storages_.rbegin(); r != owned_storages_.rend(); r++) {
         if (r->mem_ != nullptr) {
           ASSERT(r->len_ == Slice::default_slice_size_);
-          if (free_list_ref_.size() < free_list_max_) {
+          if (pool_ != nullptr) {
+            pool_->release(std::move(r->mem_), r->len_);
+          } else if (free_list_ref_.size() < free_list_max_) {
             free_list_ref_.push_back(std::move(r->mem_));
           }
         }
@@ -781,7 +839,9 @@ private:
       ASSERT(Slice::sliceSize(Slice::default_slice_size_) == Slice::default_slice_size_);
 
       Slice::SizedStorage storage{nullptr, Slice::default_slice_size_};
-      if (!free_list_ref_.empty()) {
+      if (pool_ != nullptr) {
+        storage.mem_ = pool_->allocate(Slice::default_slice_size_);
+      } else if (!free_list_ref_.empty()) {
         storage.mem_ = std::move(free_list_ref_.back());
         free_list_ref_.pop_back();
       } else {
@@ -802,6 +862,10 @@ private:
     // constructing the owner to reduce thread local resolving to improve performance.
     absl::InlinedVector<Slice::StoragePtr, free_list_max_>& free_list_ref_;
 
+    // The calling thread's slice pool, if any. When present it is used instead of the free list so
+    // that reservation storage and slice storage share a single cache.
+    SlicePool* const pool_;
+
     // Simple thread local cache to reduce unnecessary memory allocation and release. This cache
     // is currently only used for multiple slices reservation because of the additional overhead
     // that thread local resolving would introduce.
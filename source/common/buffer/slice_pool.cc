@@ -0,0 +1,106 @@
+#include "source/common/buffer/slice_pool.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Buffer {
+
+thread_local SlicePool* SlicePool::current_ = nullptr;
+
+SlicePool::SlicePool(const SlicePoolConfig& config)
+    : high_watermark_(config.high_watermark_), low_watermark_(config.low_watermark_) {
+  ASSERT(low_watermark_ <= high_watermark_);
+  std::vector<uint64_t> capacities = config.size_classes_;
+  std::sort(capacities.begin(), capacities.end());
+  capacities.erase(std::unique(capacities.begin(), capacities.end()), capacities.end());
+
+  // Reserve up front so that the lookup table can point into classes_.
+  classes_.reserve(capacities.size());
+  for (const uint64_t capacity : capacities) {
+    ASSERT(capacity > 0 && capacity <= MaxPooledSize && capacity % PageSize == 0);
+    SizeClass& size_class = classes_.emplace_back();
+    size_class.capacity_ = capacity;
+    size_class.blocks_.reserve(high_watermark_);
+    classes_by_pages_[capacity / PageSize] = &size_class;
+  }
+}
+
+SlicePool::~SlicePool() {
+  if (stats_ != nullptr) {
+    for (const SizeClass& size_class : classes_) {
+      stats_->cached_bytes_.sub(size_class.blocks_.size() * size_class.capacity_);
+    }
+  }
+}
+
+SlicePool::StoragePtr SlicePool::allocate(uint64_t capacity) {
+  SizeClass* size_class = sizeClass(capacity);
+  if (size_class == nullptr) {
+    return StoragePtr{new uint8_t[capacity]};
+  }
+
+  if (size_class->blocks_.empty()) {
+    if (stats_ != nullptr) {
+      stats_->miss_.inc();
+    }
+    return StoragePtr{new uint8_t[capacity]};
+  }
+
+  StoragePtr storage = std::move(size_class->blocks_.back());
+  size_class->blocks_.pop_back();
+  if (stats_ != nullptr) {
+    stats_->hit_.inc();
+    stats_->cached_bytes_.sub(capacity);
+  }
+  return storage;
+}
+
+void SlicePool::release(StoragePtr&& storage, uint64_t capacity) {
+  SizeClass* size_class = sizeClass(capacity);
+  if (size_class == nullptr || storage == nullptr || high_watermark_ == 0) {
+    storage.reset();
+    return;
+  }
+
+  std::vector<StoragePtr>& blocks = size_class->blocks_;
+  if (blocks.size() >= high_watermark_) {
+    // Free everything above the low watermark in one go, rather than freeing one block on every
+    // release once the cache is full.
+    const uint64_t trimmed = blocks.size() - low_watermark_;
+    blocks.resize(low_watermark_);
+    if (stats_ != nullptr) {
+      stats_->trimmed_.add(trimmed);
+      stats_->cached_bytes_.sub(trimmed * capacity);
+    }
+  }
+
+  blocks.push_back(std::move(storage));
+  if (stats_ != nullptr) {
+    stats_->cached_bytes_.add(capacity);
+  }
+}
+
+void SlicePool::initializeStats(Stats::Scope& scope, const std::string& prefix) {
+  stats_ = std::make_unique<SlicePoolStats>(SlicePoolStats{
+      ALL_SLICE_POOL_STATS(POOL_COUNTER_PREFIX(scope, prefix), POOL_GAUGE_PREFIX(scope, prefix))});
+  for (const SizeClass& size_class : classes_) {
+    stats_->cached_bytes_.add(size_class.blocks_.size() * size_class.capacity_);
+  }
+}
+
+uint32_t SlicePool::cachedBlocks(uint64_t capacity) const {
+  const SizeClass* size_class = sizeClass(capacity);
+  return size_class == nullptr ? 0 : size_class->blocks_.size();
+}
+
+SlicePoolPtr SlicePool::create(const SlicePoolConfig& config) {
+  if (config.size_classes_.empty()) {
+    return nullptr;
+  }
+  return std::make_unique<SlicePool>(config);
+}
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * All buffer slice pool stats. @see stats_macros.h
+ */
+#define ALL_SLICE_POOL_STATS(COUNTER, GAUGE)                                                       \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  COUNTER(trimmed)                                                                                 \
+  GAUGE(cached_bytes, NeverImport)
+
+/**
+ * Struct definition for all buffer slice pool stats. @see stats_macros.h
+ */
+struct SlicePoolStats {
+  ALL_SLICE_POOL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+using SlicePoolStatsPtr = std::unique_ptr<SlicePoolStats>;
+
+/**
+ * Configuration of a slice pool. Each size class is a slice capacity in bytes and must be a
+ * multiple of SlicePool::PageSize no larger than SlicePool::MaxPooledSize.
+ */
+struct SlicePoolConfig {
+  std::vector<uint64_t> size_classes_;
+  // Number of blocks cached per size class before the cache is trimmed.
+  uint32_t high_watermark_{DefaultHighWatermark};
+  // Number of blocks left in a size class cache after it has been trimmed.
+  uint32_t low_watermark_{DefaultLowWatermark};
+
+  static constexpr uint32_t DefaultHighWatermark = 256;
+  static constexpr uint32_t DefaultLowWatermark = 128;
+};
+
+class SlicePool;
+using SlicePoolPtr = std::unique_ptr<SlicePool>;
+
+/**
+ * A cache of slice backing storage, keyed by exact slice capacity. A pool is owned by a single
+ * dispatcher and is only touched from the thread running that dispatcher, so no synchronization
+ * is performed. Storage that does not match a configured size class is allocated and freed
+ * normally. Storage allocated from one pool may be released into another; ownership of the memory
+ * simply moves with it.
+ */
+class SlicePool : NonCopyable {
+public:
+  using StoragePtr = std::unique_ptr<uint8_t[]>;
+
+  // Must match the slice size granularity used by Buffer::Slice.
+  static constexpr uint64_t PageSize = 4096;
+  static constexpr uint64_t MaxPooledSize = 64 * PageSize;
+
+  explicit SlicePool(const SlicePoolConfig& config);
+  ~SlicePool();
+
+  /**
+   * @param capacity the number of bytes of storage required.
+   * @return storage of exactly capacity bytes, served from the cache when possible.
+   */
+  StoragePtr allocate(uint64_t capacity);
+
+  /**
+   * Return storage to the pool. If the size class cache for the storage has reached the high
+   * watermark, it is trimmed down to the low watermark before the storage is freed.
+   * @param storage the storage to release.
+   * @param capacity the capacity that the storage was allocated with.
+   */
+  void release(StoragePtr&& storage, uint64_t capacity);
+
+  /**
+   * Initialize stats for this pool. Must be called from the thread that owns the pool.
+   * @param scope the scope to create the stats in.
+   * @param prefix the stat name prefix, including any trailing '.'.
+   */
+  void initializeStats(Stats::Scope& scope, const std::string& prefix);
+
+  /**
+   * @return the number of blocks cached for the given capacity, or 0 if it is not pooled.
+   */
+  uint32_t cachedBlocks(uint64_t capacity) const;
+
+  /**
+   * @return the pool installed on the calling thread, or nullptr if there is none.
+   */
+  static SlicePool* current() { return current_; }
+
+  /**
+   * @return a pool built from the configuration, or nullptr if no size classes are configured.
+   */
+  static SlicePoolPtr create(const SlicePoolConfig& config);
+
+  /**
+   * Installs a pool as the calling thread's current pool for the lifetime of this object.
+   */
+  class ScopedCurrent : NonCopyable {
+  public:
+    explicit ScopedCurrent(SlicePool* pool) : previous_(current_) { current_ = pool; }
+    ~ScopedCurrent() { current_ = previous_; }
+
+  private:
+    SlicePool* const previous_;
+  };
+
+private:
+  struct SizeClass {
+    uint64_t capacity_{};
+    std::vector<StoragePtr> blocks_;
+  };
+
+  SizeClass* sizeClass(uint64_t capacity) const {
+    if (capacity == 0 || capacity > MaxPooledSize || capacity % PageSize != 0) {
+      return nullptr;
+    }
+    return classes_by_pages_[capacity / PageSize];
+  }
+
+  const uint32_t high_watermark_;
+  const uint32_t low_watermark_;
+  std::vector<SizeClass> classes_;
+  // Indexed by capacity in pages; nullptr where the capacity is not pooled.
+  std::array<SizeClass*, MaxPooledSize / PageSize + 1> classes_by_pages_{};
+  SlicePoolStatsPtr stats_;
+
+  static thread_local SlicePool* current_;
+};
+
+} // namespace Buffer
+} // namespace Envoy
@@ -1,5 +1,7 @@
 #include "source/common/common/regex.h"
 
+#include <algorithm>
+
 #include "envoy/common/exception.h"
 #include "envoy/extensions/regex_engines/v3/google_re2.pb.h"
 #include "envoy/extensions/regex_engines/v3/google_re2.pb.validate.h"
@@ -92,6 +94,41 @@ CompiledGoogleReMatcher::CompiledGoogleReMatcher(
   }
 }
 
+CompiledGoogleReSet::CompiledGoogleReSet() : set_(re2::RE2::Quiet, re2::RE2::ANCHOR_BOTH) {}
+
+absl::StatusOr<std::unique_ptr<CompiledGoogleReSet>>
+CompiledGoogleReSet::create(const std::vector<std::string>& patterns) {
+  auto ret = std::unique_ptr<CompiledGoogleReSet>(new CompiledGoogleReSet());
+  for (const std::string& pattern : patterns) {
+    std::string error;
+    if (ret->set_.Add(pattern, &error) < 0) {
+      return absl::InvalidArgumentError(
+          fmt::format("unable to add regex '{}' to regex set: {}", pattern, error));
+    }
+  }
+  if (!ret->set_.Compile()) {
+    return absl::ResourceExhaustedError(
+        fmt::format("unable to compile regex set of {} patterns", patterns.size()));
+  }
+  ret->size_ = patterns.size();
+  return ret;
+}
+
+bool CompiledGoogleReSet::match(absl::string_view value, std::vector<int>& matches) const {
+  matches.clear();
+  if (size_ == 0) {
+    return true;
+  }
+  re2::RE2::Set::ErrorInfo error_info;
+  if (!set_.Match(value, &matches, &error_info) &&
+      error_info.kind != re2::RE2::Set::kNoError) {
+    return false;
+  }
+  // RE2 does not specify the order of the reported matches.
+  std::sort(matches.begin(), matches.end());
+  return true;
+}
+
 absl::StatusOr<CompiledMatcherPtr> GoogleReEngine::matcher(const std::string& regex) const {
   return CompiledGoogleReMatcher::createAndSizeCheck(regex);
 }
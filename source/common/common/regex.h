@@ -13,6 +13,7 @@
 #include "source/common/stats/symbol_table.h"
 
 #include "re2/re2.h"
+#include "re2/set.h"
 #include "xds/type/matcher/v3/regex.pb.h"
 
 namespace Envoy {
@@ -64,6 +65,46 @@ public:
       : CompiledGoogleReMatcher(regex) {}
 };
 
+/**
+ * A set of RE2 patterns compiled into a single automaton, so that one scan of an input reports all
+ * of the patterns that fully match it. This is intended for callers that evaluate many patterns
+ * against the same input (e.g. regex routes of a virtual host) and would otherwise run one RE2
+ * match per pattern.
+ */
+class CompiledGoogleReSet {
+public:
+  /**
+   * Compiles a set of patterns. Fails if any of the patterns is invalid or the automaton exceeds
+   * RE2's memory budget.
+   * @param patterns supplies the patterns. A pattern's index in this vector identifies it in match
+   *        results.
+   */
+  static absl::StatusOr<std::unique_ptr<CompiledGoogleReSet>>
+  create(const std::vector<std::string>& patterns);
+
+  /**
+   * Finds the patterns that fully match a value.
+   * @param value supplies the value to match.
+   * @param matches receives the indices of the matching patterns in ascending order.
+   * @return false if the match could not be completed (e.g. the automaton ran out of memory), in
+   *         which case the contents of matches must not be relied upon.
+   */
+  bool match(absl::string_view value, std::vector<int>& matches) const;
+
+  /**
+   * @return the number of patterns in the set.
+   */
+  size_t size() const { return size_; }
+
+private:
+  CompiledGoogleReSet();
+
+  re2::RE2::Set set_;
+  size_t size_{};
+};
+
+using CompiledGoogleReSetPtr = std::unique_ptr<const CompiledGoogleReSet>;
+
 class GoogleReEngine : public Engine {
 public:
   absl::StatusOr<CompiledMatcherPtr> matcher(const std::string& regex) const override;
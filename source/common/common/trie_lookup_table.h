@@ -4,6 +4,7 @@
 
 #include "source/common/common/assert.h"
 
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
@@ -167,6 +168,32 @@ public:
     return nodes_[result].value_;
   }
 
+  /**
+   * Finds the entries whose keys are a prefix of the specified key.
+   * Complexity is O(min(longest key prefix, key length)).
+   * @param key the key used to find.
+   * @return the non-empty values whose keys are a prefix of the specified key, ordered from the
+   *         shortest to the longest key.
+   */
+  absl::InlinedVector<Value, 4> findMatchingPrefixes(absl::string_view key) const {
+    absl::InlinedVector<Value, 4> result;
+    int32_t current = 0;
+    if (nodes_[current].value_) {
+      result.push_back(nodes_[current].value_);
+    }
+
+    for (uint8_t c : key) {
+      current = getChildIndex(current, c);
+
+      if (current == NoNode) {
+        break;
+      } else if (nodes_[current].value_) {
+        result.push_back(nodes_[current].value_);
+      }
+    }
+    return result;
+  }
+
 private:
   // Flat representation of the tree - each node has a vector of indices to its
   // child nodes.
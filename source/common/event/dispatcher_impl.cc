@@ -1,5 +1,6 @@
 #include "source/common/event/dispatcher_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
@@ -26,6 +27,7 @@
 #include "source/common/filesystem/watcher_impl.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/connection_impl.h"
+#include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
 
 #include "event2/event.h"
@@ -37,6 +39,25 @@
 namespace Envoy {
 namespace Event {
 
+namespace {
+
+Buffer::SlicePoolPtr
+createSlicePool(const envoy::config::bootstrap::v3::BufferSlicePool& slice_pool_proto) {
+  Buffer::SlicePoolConfig config;
+  config.size_classes_.assign(slice_pool_proto.size_classes().begin(),
+                              slice_pool_proto.size_classes().end());
+  config.high_watermark_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      slice_pool_proto, high_watermark, Buffer::SlicePoolConfig::DefaultHighWatermark);
+  config.low_watermark_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      slice_pool_proto, low_watermark, Buffer::SlicePoolConfig::DefaultLowWatermark);
+  // The server rejects a low watermark above the high watermark, but dispatchers may be created
+  // from a bootstrap which was never validated, such as in tests.
+  config.low_watermark_ = std::min(config.low_watermark_, config.high_watermark_);
+  return Buffer::SlicePool::create(config);
+}
+
+} // namespace
+
 DispatcherImpl::DispatcherImpl(const std::string& name, Api::Api& api,
                                Event::TimeSystem& time_system)
     : DispatcherImpl(name, api, time_system, {}) {}
@@ -60,15 +81,17 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Api::Api& api,
                      watermark_factory != nullptr
                          ? watermark_factory
                          : std::make_shared<Buffer::WatermarkBufferFactory>(
-                               api.bootstrap().overload_manager().buffer_factory_config())) {}
+                               api.bootstrap().overload_manager().buffer_factory_config()),
+                     &api.bootstrap()) {}
 
 DispatcherImpl::DispatcherImpl(const std::string& name, Thread::ThreadFactory& thread_factory,
                                TimeSource& time_source, Filesystem::Instance& file_system,
                                Event::TimeSystem& time_system,
                                const ScaledRangeTimerManagerFactory& scaled_timer_factory,
-                               const Buffer::WatermarkFactorySharedPtr& watermark_factory)
+                               const Buffer::WatermarkFactorySharedPtr& watermark_factory,
+                               const envoy::config::bootstrap::v3::Bootstrap* bootstrap)
     : name_(name), thread_factory_(thread_factory), time_source_(time_source),
-      file_system_(file_system), buffer_factory_(watermark_factory),
+      file_system_(file_system), buffer_factory_(watermark_factory), bootstrap_(bootstrap),
       scheduler_(time_system.createScheduler(base_scheduler_, base_scheduler_)),
       thread_local_delete_cb_(
           base_scheduler_.createSchedulableCallback([this]() -> void { runThreadLocalDelete(); })),
@@ -111,6 +134,9 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope,
     stats_ = std::make_unique<DispatcherStats>(
         DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
     base_scheduler_.initializeStats(stats_.get());
+    if (slice_pool_ != nullptr) {
+      slice_pool_->initializeStats(scope, effective_prefix + "buffer_slice_pool.");
+    }
     ENVOY_LOG(debug, "running {} on thread {}", stats_prefix_, run_tid_.debugString());
   });
 }
@@ -278,6 +304,13 @@ void DispatcherImpl::run(RunType type) {
   // callbacks that have to get run before the initial event loop starts running. libevent does
   // not guarantee that events are run in any particular order. So even if we post() and call
   // event_base_once() before some other event, the other event might get called first.
+  if (!slice_pool_created_) {
+    slice_pool_created_ = true;
+    if (bootstrap_ != nullptr) {
+      slice_pool_ = createSlicePool(bootstrap_->buffer_slice_pool());
+    }
+  }
+  Buffer::SlicePool::ScopedCurrent scoped_slice_pool(slice_pool_.get());
   runPostCallbacks();
   base_scheduler_.run(type);
 }
@@ -9,11 +9,13 @@
 #include "envoy/api/api.h"
 #include "envoy/common/scope_tracker.h"
 #include "envoy/common/time.h"
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
 #include "envoy/event/deferred_deletable.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/stats/scope.h"
 
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 #include "source/common/event/libevent.h"
@@ -47,7 +49,8 @@ public:
                  TimeSource& time_source, Filesystem::Instance& file_system,
                  Event::TimeSystem& time_system,
                  const ScaledRangeTimerManagerFactory& scaled_timer_factory,
-                 const Buffer::WatermarkFactorySharedPtr& watermark_factory);
+                 const Buffer::WatermarkFactorySharedPtr& watermark_factory,
+                 const envoy::config::bootstrap::v3::Bootstrap* bootstrap = nullptr);
   ~DispatcherImpl() override;
 
   /**
@@ -148,6 +151,13 @@ private:
   DispatcherStatsPtr stats_;
   Thread::ThreadId run_tid_;
   Buffer::WatermarkFactorySharedPtr buffer_factory_;
+  // The bootstrap of the server owning the dispatcher, if any. The slice pool is built from it when
+  // the dispatcher first runs rather than on construction, as the main thread dispatcher is created
+  // before the bootstrap is loaded.
+  const envoy::config::bootstrap::v3::Bootstrap* const bootstrap_;
+  // Installed as the thread's slice pool while the dispatcher runs. Null if no pool is configured.
+  Buffer::SlicePoolPtr slice_pool_;
+  bool slice_pool_created_{};
   LibeventScheduler base_scheduler_;
   SchedulerPtr scheduler_;
 
@@ -43,6 +43,7 @@ public:
 
   ~FileSharedImpl() override = default;
 
+  Api::IoCallSizeResult writev(absl::Span<const absl::string_view> buffers) override;
   bool isOpen() const override;
   std::string path() const override;
   DestinationType destinationType() const override;
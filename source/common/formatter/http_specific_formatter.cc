@@ -81,6 +81,17 @@ ProtobufWkt::Value HeaderFormatter::formatValue(const Http::HeaderMap& headers)
   return ValueUtil::stringValue(std::string(val));
 }
 
+bool HeaderFormatter::append(const Http::HeaderMap& headers, std::string& output) const {
+  const Http::HeaderEntry* header = findHeader(headers);
+  if (!header) {
+    return false;
+  }
+
+  absl::string_view val = header->value().getStringView();
+  output.append(SubstitutionFormatUtils::truncateStringView(val, max_length_));
+  return true;
+}
+
 ResponseHeaderFormatter::ResponseHeaderFormatter(absl::string_view main_header,
                                                  absl::string_view alternative_header,
                                                  absl::optional<size_t> max_length)
@@ -98,6 +109,12 @@ ResponseHeaderFormatter::formatValueWithContext(const HttpFormatterContext& cont
   return HeaderFormatter::formatValue(context.responseHeaders());
 }
 
+bool ResponseHeaderFormatter::appendWithContext(const HttpFormatterContext& context,
+                                                const StreamInfo::StreamInfo&,
+                                                std::string& output) const {
+  return HeaderFormatter::append(context.responseHeaders(), output);
+}
+
 RequestHeaderFormatter::RequestHeaderFormatter(absl::string_view main_header,
                                                absl::string_view alternative_header,
                                                absl::optional<size_t> max_length)
@@ -115,6 +132,12 @@ RequestHeaderFormatter::formatValueWithContext(const HttpFormatterContext& conte
   return HeaderFormatter::formatValue(context.requestHeaders());
 }
 
+bool RequestHeaderFormatter::appendWithContext(const HttpFormatterContext& context,
+                                               const StreamInfo::StreamInfo&,
+                                               std::string& output) const {
+  return HeaderFormatter::append(context.requestHeaders(), output);
+}
+
 ResponseTrailerFormatter::ResponseTrailerFormatter(absl::string_view main_header,
                                                    absl::string_view alternative_header,
                                                    absl::optional<size_t> max_length)
@@ -132,6 +155,12 @@ ResponseTrailerFormatter::formatValueWithContext(const HttpFormatterContext& con
   return HeaderFormatter::formatValue(context.responseTrailers());
 }
 
+bool ResponseTrailerFormatter::appendWithContext(const HttpFormatterContext& context,
+                                                 const StreamInfo::StreamInfo&,
+                                                 std::string& output) const {
+  return HeaderFormatter::append(context.responseTrailers(), output);
+}
+
 HeadersByteSizeFormatter::HeadersByteSizeFormatter(const HeaderType header_type)
     : header_type_(header_type) {}
 
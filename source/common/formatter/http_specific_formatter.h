@@ -59,6 +59,7 @@ public:
 protected:
   absl::optional<std::string> format(const Http::HeaderMap& headers) const;
   ProtobufWkt::Value formatValue(const Http::HeaderMap& headers) const;
+  bool append(const Http::HeaderMap& headers, std::string& output) const;
 
 private:
   const Http::HeaderEntry* findHeader(const Http::HeaderMap& headers) const;
@@ -107,6 +108,10 @@ public:
   ProtobufWkt::Value
   formatValueWithContext(const HttpFormatterContext& context,
                          const StreamInfo::StreamInfo& stream_info) const override;
+  bool appendWithContext(const HttpFormatterContext& context,
+                         const StreamInfo::StreamInfo& stream_info,
+                         std::string& output) const override;
+  ValueKind valueKind() const override { return ValueKind::String; }
 };
 
 /**
@@ -124,6 +129,10 @@ public:
   ProtobufWkt::Value
   formatValueWithContext(const HttpFormatterContext& context,
                          const StreamInfo::StreamInfo& stream_info) const override;
+  bool appendWithContext(const HttpFormatterContext& context,
+                         const StreamInfo::StreamInfo& stream_info,
+                         std::string& output) const override;
+  ValueKind valueKind() const override { return ValueKind::String; }
 };
 
 /**
@@ -141,6 +150,10 @@ public:
   ProtobufWkt::Value
   formatValueWithContext(const HttpFormatterContext& context,
                          const StreamInfo::StreamInfo& stream_info) const override;
+  bool appendWithContext(const HttpFormatterContext& context,
+                         const StreamInfo::StreamInfo& stream_info,
+                         std::string& output) const override;
+  ValueKind valueKind() const override { return ValueKind::String; }
 };
 
 /**
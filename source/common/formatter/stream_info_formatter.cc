@@ -476,6 +476,17 @@ CommonDurationFormatter::format(const StreamInfo::StreamInfo& info) const {
   }
   return fmt::format_int(duration.value()).str();
 }
+bool CommonDurationFormatter::appendWithContext(const Context&, const StreamInfo::StreamInfo& info,
+                                                std::string& output) const {
+  auto duration = getDurationCount(info);
+  if (!duration.has_value()) {
+    return false;
+  }
+  const fmt::format_int value(duration.value());
+  output.append(value.data(), value.size());
+  return true;
+}
+
 ProtobufWkt::Value CommonDurationFormatter::formatValue(const StreamInfo::StreamInfo& info) const {
   auto duration = getDurationCount(info);
   if (!duration.has_value()) {
@@ -595,6 +606,9 @@ public:
 
   StreamInfoStringFormatterProvider(FieldExtractor f) : field_extractor_(f) {}
 
+  // FormatterProvider
+  ValueKind valueKind() const override { return ValueKind::String; }
+
   // StreamInfoFormatterProvider
   absl::optional<std::string> format(const StreamInfo::StreamInfo& stream_info) const override {
     return field_extractor_(stream_info);
@@ -615,6 +629,20 @@ public:
 
   StreamInfoDurationFormatterProvider(FieldExtractor f) : field_extractor_(f) {}
 
+  // FormatterProvider
+  bool appendWithContext(const Context&, const StreamInfo::StreamInfo& stream_info,
+                         std::string& output) const override {
+    const auto millis = extractMillis(stream_info);
+    if (!millis) {
+      return false;
+    }
+
+    const fmt::format_int value(millis.value());
+    output.append(value.data(), value.size());
+    return true;
+  }
+  ValueKind valueKind() const override { return ValueKind::Integer; }
+
   // StreamInfoFormatterProvider
   absl::optional<std::string> format(const StreamInfo::StreamInfo& stream_info) const override {
     const auto millis = extractMillis(stream_info);
@@ -652,6 +680,15 @@ public:
 
   StreamInfoUInt64FormatterProvider(FieldExtractor f) : field_extractor_(f) {}
 
+  // FormatterProvider
+  bool appendWithContext(const Context&, const StreamInfo::StreamInfo& stream_info,
+                         std::string& output) const override {
+    const fmt::format_int value(field_extractor_(stream_info));
+    output.append(value.data(), value.size());
+    return true;
+  }
+  ValueKind valueKind() const override { return ValueKind::Integer; }
+
   // StreamInfoFormatterProvider
   absl::optional<std::string> format(const StreamInfo::StreamInfo& stream_info) const override {
     return fmt::format_int(field_extractor_(stream_info)).str();
@@ -689,6 +726,13 @@ public:
                                      StreamInfoAddressFieldExtractionType extraction_type)
       : field_extractor_(f), extraction_type_(extraction_type) {}
 
+  // FormatterProvider
+  ValueKind valueKind() const override {
+    // The port is a number value, unless it can't be extracted from the address.
+    return extraction_type_ == StreamInfoAddressFieldExtractionType::JustPort ? ValueKind::Unknown
+                                                                             : ValueKind::String;
+  }
+
   // StreamInfoFormatterProvider
   absl::optional<std::string> format(const StreamInfo::StreamInfo& stream_info) const override {
     Network::Address::InstanceConstSharedPtr address = field_extractor_(stream_info);
@@ -740,6 +784,9 @@ public:
 
   StreamInfoSslConnectionInfoFormatterProvider(FieldExtractor f) : field_extractor_(f) {}
 
+  // FormatterProvider
+  ValueKind valueKind() const override { return ValueKind::String; }
+
   absl::optional<std::string> format(const StreamInfo::StreamInfo& stream_info) const override {
     if (stream_info.downstreamAddressProvider().sslConnection() == nullptr) {
       return absl::nullopt;
@@ -777,6 +824,9 @@ public:
 
   StreamInfoUpstreamSslConnectionInfoFormatterProvider(FieldExtractor f) : field_extractor_(f) {}
 
+  // FormatterProvider
+  ValueKind valueKind() const override { return ValueKind::String; }
+
   absl::optional<std::string> format(const StreamInfo::StreamInfo& stream_info) const override {
     if (!stream_info.upstreamInfo() ||
         stream_info.upstreamInfo()->upstreamSslConnection() == nullptr) {
@@ -154,6 +154,11 @@ public:
       : time_point_beg_(std::move(beg)), time_point_end_(std::move(end)),
         duration_precision_(duration_precision) {}
 
+  // FormatterProvider
+  bool appendWithContext(const Context&, const StreamInfo::StreamInfo& info,
+                         std::string& output) const override;
+  ValueKind valueKind() const override { return ValueKind::Integer; }
+
   // StreamInfoFormatterProvider
   absl::optional<std::string> format(const StreamInfo::StreamInfo&) const override;
   ProtobufWkt::Value formatValue(const StreamInfo::StreamInfo&) const override;
@@ -208,6 +213,9 @@ public:
 
   SystemTimeFormatter(absl::string_view format, TimeFieldExtractorPtr f, bool local_time = false);
 
+  // FormatterProvider
+  ValueKind valueKind() const override { return ValueKind::String; }
+
   // StreamInfoFormatterProvider
   absl::optional<std::string> format(const StreamInfo::StreamInfo&) const override;
   ProtobufWkt::Value formatValue(const StreamInfo::StreamInfo&) const override;
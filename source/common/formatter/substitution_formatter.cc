@@ -1,5 +1,7 @@
 #include "source/common/formatter/substitution_formatter.h"
 
+#include "absl/strings/numbers.h"
+
 namespace Envoy {
 namespace Formatter {
 
@@ -367,38 +369,88 @@ std::string FormatterImpl::formatWithContext(const Context& context,
                                              const StreamInfo::StreamInfo& stream_info) const {
   std::string log_line;
   log_line.reserve(256);
+  appendWithContext(context, stream_info, log_line);
+  return log_line;
+}
 
+void FormatterImpl::appendWithContext(const Context& context,
+                                      const StreamInfo::StreamInfo& stream_info,
+                                      std::string& output) const {
   for (const auto& provider : providers_) {
-    const absl::optional<std::string> bit = provider->formatWithContext(context, stream_info);
     // Add the formatted value if there is one. Otherwise add a default value
     // of "-" if omit_empty_values_ is not set.
-    if (bit.has_value()) {
-      log_line += bit.value();
-    } else if (!omit_empty_values_) {
-      log_line += DefaultUnspecifiedValueStringView;
+    if (!provider->appendWithContext(context, stream_info, output) && !omit_empty_values_) {
+      output.append(DefaultUnspecifiedValueStringView);
     }
   }
+}
 
-  return log_line;
+// Sanitizes the value a provider appended to the output at the given offset.
+void sanitizeAppendedValue(std::string& output, size_t offset, std::string& sanitize_buffer) {
+  const absl::string_view value = absl::string_view(output).substr(offset);
+  const absl::string_view sanitized = Json::sanitize(sanitize_buffer, value);
+  // The value is returned unchanged unless it needs escaping.
+  if (sanitized.data() != value.data()) {
+    output.resize(offset);
+    output.append(sanitized);
+  }
 }
 
 void stringValueToLogLine(const JsonFormatterImpl::Formatters& formatters, const Context& context,
-                          const StreamInfo::StreamInfo& info, JsonStringSerializer& serializer,
-                          bool omit_empty_values) {
-
-  serializer.addRawString(Json::Constants::DoubleQuote); // Start the JSON string.
+                          const StreamInfo::StreamInfo& info, std::string& log_line,
+                          std::string& sanitize_buffer, bool omit_empty_values) {
+  log_line.append(Json::Constants::DoubleQuote); // Start the JSON string.
   for (const JsonFormatterImpl::Formatter& formatter : formatters) {
-    const absl::optional<std::string> value = formatter->formatWithContext(context, info);
-    if (!value.has_value()) {
+    const size_t offset = log_line.size();
+    if (!formatter->appendWithContext(context, info, log_line)) {
       // Add the empty value. This needn't be sanitized.
-      serializer.addRawString(omit_empty_values ? EMPTY_STRING : DefaultUnspecifiedValueStringView);
+      log_line.append(omit_empty_values ? EMPTY_STRING : DefaultUnspecifiedValueStringView);
       continue;
     }
-    // Sanitize the string value and add it to the buffer. The string value will not be quoted
-    // since we handle the quoting by ourselves at the outer level.
-    serializer.addSanitized({}, value.value(), {});
+    // Sanitize the string value in the buffer. The string value will not be quoted since we
+    // handle the quoting by ourselves at the outer level.
+    sanitizeAppendedValue(log_line, offset, sanitize_buffer);
+  }
+  log_line.append(Json::Constants::DoubleQuote); // End the JSON string.
+}
+
+void typedValueToLogLine(const FormatterProvider& formatter, const Context& context,
+                         const StreamInfo::StreamInfo& info, std::string& log_line,
+                         std::string& sanitize_buffer) {
+  const size_t offset = log_line.size();
+  switch (formatter.valueKind()) {
+  case FormatterProvider::ValueKind::String:
+    log_line.append(Json::Constants::DoubleQuote);
+    if (!formatter.appendWithContext(context, info, log_line)) {
+      log_line.resize(offset);
+      log_line.append(Json::Constants::Null);
+      return;
+    }
+    sanitizeAppendedValue(log_line, offset + 1, sanitize_buffer);
+    log_line.append(Json::Constants::DoubleQuote);
+    return;
+  case FormatterProvider::ValueKind::Integer: {
+    if (!formatter.appendWithContext(context, info, log_line)) {
+      log_line.append(Json::Constants::Null);
+      return;
+    }
+    // Serialize the integer as its number value would be, which is not always as its decimal
+    // representation.
+    double number;
+    const bool parsed = absl::SimpleAtod(absl::string_view(log_line).substr(offset), &number);
+    log_line.resize(offset);
+    JsonStringSerializer serializer(log_line);
+    if (parsed) {
+      serializer.addNumber(number);
+    } else {
+      serializer.addNull();
+    }
+    return;
+  }
+  case FormatterProvider::ValueKind::Unknown:
+    break;
   }
-  serializer.addRawString(Json::Constants::DoubleQuote); // End the JSON string.
+  Json::Utility::appendValueToString(formatter.formatValueWithContext(context, info), log_line);
 }
 
 JsonFormatterImpl::JsonFormatterImpl(const ProtobufWkt::Struct& struct_format,
@@ -419,14 +471,22 @@ std::string JsonFormatterImpl::formatWithContext(const Context& context,
                                                  const StreamInfo::StreamInfo& info) const {
   std::string log_line;
   log_line.reserve(2048);
-  JsonStringSerializer serializer(log_line); // Helper to serialize the value to log line.
+  appendWithContext(context, info, log_line);
+  return log_line;
+}
+
+void JsonFormatterImpl::appendWithContext(const Context& context,
+                                          const StreamInfo::StreamInfo& info,
+                                          std::string& log_line) const {
+  // Only used when a value needs escaping.
+  std::string sanitize_buffer;
 
   for (const ParsedFormatElement& element : parsed_elements_) {
     // 1. Handle the raw string element.
     if (absl::holds_alternative<std::string>(element)) {
       // The raw string element will be added to the buffer directly.
       // It is sanitized when loading the configuration.
-      serializer.addRawString(absl::get<std::string>(element));
+      log_line.append(absl::get<std::string>(element));
       continue;
     }
 
@@ -436,17 +496,16 @@ std::string JsonFormatterImpl::formatWithContext(const Context& context,
 
     if (formatters.size() != 1) {
       // 2. Handle the formatter element with multiple or zero providers.
-      stringValueToLogLine(formatters, context, info, serializer, omit_empty_values_);
+      stringValueToLogLine(formatters, context, info, log_line, sanitize_buffer,
+                           omit_empty_values_);
     } else {
       // 3. Handle the formatter element with a single provider and value
       //    type needs to be kept.
-      auto value = formatters[0]->formatValueWithContext(context, info);
-      Json::Utility::appendValueToString(value, log_line);
+      typedValueToLogLine(*formatters[0], context, info, log_line, sanitize_buffer);
     }
   }
 
   log_line.push_back('\n');
-  return log_line;
 }
 
 } // namespace Formatter
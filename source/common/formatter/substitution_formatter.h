@@ -41,6 +41,12 @@ public:
                                             const StreamInfo::StreamInfo&) const override {
     return str_;
   }
+  bool appendWithContext(const Context&, const StreamInfo::StreamInfo&,
+                         std::string& output) const override {
+    output.append(str_.string_value());
+    return true;
+  }
+  ValueKind valueKind() const override { return ValueKind::String; }
 
 private:
   ProtobufWkt::Value str_;
@@ -93,6 +99,8 @@ public:
   // Formatter
   std::string formatWithContext(const Context& context,
                                 const StreamInfo::StreamInfo& stream_info) const override;
+  void appendWithContext(const Context& context, const StreamInfo::StreamInfo& stream_info,
+                         std::string& output) const override;
 
 protected:
   FormatterImpl(absl::Status& creation_status, absl::string_view format,
@@ -120,6 +128,8 @@ public:
   // Formatter
   std::string formatWithContext(const Context& context,
                                 const StreamInfo::StreamInfo& info) const override;
+  void appendWithContext(const Context& context, const StreamInfo::StreamInfo& info,
+                         std::string& output) const override;
 
 private:
   const bool omit_empty_values_;
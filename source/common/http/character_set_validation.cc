@@ -0,0 +1,153 @@
+#include "source/common/http/character_set_validation.h"
+
+#include "source/common/common/assert.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ENVOY_CHARACTER_SET_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// Strings shorter than this are always scanned one character at a time.
+constexpr size_t MinVectorScanSize = 16;
+
+size_t findFirstNotInScalar(const std::array<uint32_t, 8>& table, const char* data, size_t begin,
+                            size_t size) {
+  for (size_t i = begin; i < size; ++i) {
+    if (!testCharInTable(table, data[i])) {
+      return i;
+    }
+  }
+  return absl::string_view::npos;
+}
+
+#ifdef ENVOY_CHARACTER_SET_X86_SIMD
+// The vectorized scans split every character into its high and low nibble, and use each nibble as
+// a shuffle index: the low nibble selects a row of the set, and the high nibble selects the bit
+// within the row. A character is in the set if the two share a bit. Rows only have 8 bits, so
+// characters with the high bit set are looked up in a second set of rows.
+
+__attribute__((target("ssse3"))) size_t
+findFirstNotInSsse3(const std::array<uint32_t, 8>& table, const uint8_t* ascii_rows,
+                    const uint8_t* extended_rows, const char* data, size_t size) {
+  const __m128i ascii = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ascii_rows));
+  const __m128i extended = _mm_loadu_si128(reinterpret_cast<const __m128i*>(extended_rows));
+  const __m128i ascii_bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i extended_bits = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128);
+  const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i low = _mm_and_si128(input, nibble_mask);
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(input, 4), nibble_mask);
+    const __m128i in_set = _mm_or_si128(
+        _mm_and_si128(_mm_shuffle_epi8(ascii, low), _mm_shuffle_epi8(ascii_bits, high)),
+        _mm_and_si128(_mm_shuffle_epi8(extended, low), _mm_shuffle_epi8(extended_bits, high)));
+    const uint32_t not_in_set =
+        _mm_movemask_epi8(_mm_cmpeq_epi8(in_set, _mm_setzero_si128()));
+    if (not_in_set != 0) {
+      return i + __builtin_ctz(not_in_set);
+    }
+  }
+  return findFirstNotInScalar(table, data, i, size);
+}
+
+__attribute__((target("avx2"))) size_t
+findFirstNotInAvx2(const std::array<uint32_t, 8>& table, const uint8_t* ascii_rows,
+                   const uint8_t* extended_rows, const char* data, size_t size) {
+  const __m256i ascii =
+      _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ascii_rows)));
+  const __m256i extended = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(extended_rows)));
+  const __m256i ascii_bits = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0));
+  const __m256i extended_bits = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128));
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const __m256i low = _mm256_and_si256(input, nibble_mask);
+    const __m256i high = _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble_mask);
+    const __m256i in_set = _mm256_or_si256(
+        _mm256_and_si256(_mm256_shuffle_epi8(ascii, low), _mm256_shuffle_epi8(ascii_bits, high)),
+        _mm256_and_si256(_mm256_shuffle_epi8(extended, low),
+                         _mm256_shuffle_epi8(extended_bits, high)));
+    const uint32_t not_in_set =
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(in_set, _mm256_setzero_si256()));
+    if (not_in_set != 0) {
+      return i + __builtin_ctz(not_in_set);
+    }
+  }
+  return findFirstNotInScalar(table, data, i, size);
+}
+#endif
+
+CharacterSet::ScanImpl bestScanImpl() {
+  static const CharacterSet::ScanImpl best = []() {
+    if (CharacterSet::scanImplSupported(CharacterSet::ScanImpl::Avx2)) {
+      return CharacterSet::ScanImpl::Avx2;
+    }
+    if (CharacterSet::scanImplSupported(CharacterSet::ScanImpl::Ssse3)) {
+      return CharacterSet::ScanImpl::Ssse3;
+    }
+    return CharacterSet::ScanImpl::Scalar;
+  }();
+  return best;
+}
+
+} // namespace
+
+bool CharacterSet::scanImplSupported(ScanImpl impl) {
+  switch (impl) {
+  case ScanImpl::Scalar:
+    return true;
+#ifdef ENVOY_CHARACTER_SET_X86_SIMD
+  case ScanImpl::Ssse3:
+    return __builtin_cpu_supports("ssse3");
+  case ScanImpl::Avx2:
+    return __builtin_cpu_supports("avx2");
+#else
+  case ScanImpl::Ssse3:
+  case ScanImpl::Avx2:
+    return false;
+#endif
+  }
+  return false;
+}
+
+size_t CharacterSet::findFirstNotIn(absl::string_view value) const {
+  if (value.size() < MinVectorScanSize) {
+    return findFirstNotInScalar(table_, value.data(), 0, value.size());
+  }
+  return findFirstNotIn(value, bestScanImpl());
+}
+
+size_t CharacterSet::findFirstNotIn(absl::string_view value, ScanImpl impl) const {
+  ASSERT(scanImplSupported(impl));
+  switch (impl) {
+  case ScanImpl::Scalar:
+    break;
+#ifdef ENVOY_CHARACTER_SET_X86_SIMD
+  case ScanImpl::Ssse3:
+    return findFirstNotInSsse3(table_, ascii_rows_.data(), extended_rows_.data(), value.data(),
+                               value.size());
+  case ScanImpl::Avx2:
+    return findFirstNotInAvx2(table_, ascii_rows_.data(), extended_rows_.data(), value.data(),
+                              value.size());
+#else
+  case ScanImpl::Ssse3:
+  case ScanImpl::Avx2:
+    break;
+#endif
+  }
+  return findFirstNotInScalar(table_, value.data(), 0, value.size());
+}
+
+} // namespace Http
+} // namespace Envoy
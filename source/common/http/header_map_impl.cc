@@ -1,5 +1,6 @@
 #include "source/common/http/header_map_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -96,6 +97,38 @@ size_t HeaderMapImpl::HeaderList::remove(absl::string_view key) {
   return removed_bytes;
 }
 
+HeaderMapImpl::HeaderNodePool::~HeaderNodePool() {
+  while (chunks_ != nullptr) {
+    ChunkHeader* next = chunks_->next_;
+    ::operator delete(chunks_);
+    chunks_ = next;
+  }
+}
+
+void HeaderMapImpl::HeaderNodePool::addChunk() {
+  ASSERT(free_list_ == nullptr);
+  ASSERT(block_size_ >= sizeof(FreeBlock));
+  // Double the chunk size on each growth so that the number of allocations is logarithmic in the
+  // number of headers, capped so that very large maps do not over-reserve.
+  const uint32_t num_blocks =
+      std::min<uint32_t>(MinChunkBlocks << std::min<uint32_t>(num_chunks_, 16), MaxChunkBlocks);
+  char* chunk =
+      static_cast<char*>(::operator new(sizeof(ChunkHeader) + num_blocks * block_size_));
+  ChunkHeader* header = reinterpret_cast<ChunkHeader*>(chunk);
+  header->next_ = chunks_;
+  chunks_ = header;
+  ++num_chunks_;
+
+  // Thread the new blocks onto the free list in address order so that consecutive inserts are
+  // laid out contiguously.
+  char* blocks = chunk + sizeof(ChunkHeader);
+  for (uint32_t i = num_blocks; i > 0; --i) {
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(blocks + (i - 1) * block_size_);
+    block->next_ = free_list_;
+    free_list_ = block;
+  }
+}
+
 HeaderMapImpl::HeaderEntryImpl::HeaderEntryImpl(const LowerCaseString& key) : key_(key) {}
 
 HeaderMapImpl::HeaderEntryImpl::HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -78,6 +79,8 @@ public:
 
   // Performs a manual byte size count for test verification.
   void verifyByteSizeInternalForTest() const;
+  // Returns the number of storage chunks allocated for header entries, for test verification.
+  uint32_t headerStorageChunksForTest() const { return headers_.pool().chunks(); }
 
   // Note: This class does not actually implement Http::HeaderMap to avoid virtual inheritance in
   // the derived classes. Instead, it is used as a mix-in class for TypedHeaderMapImpl below. This
@@ -114,6 +117,101 @@ public:
   StatefulHeaderKeyFormatterOptRef formatter() { return makeOptRefFromPtr(formatter_.get()); }
 
 protected:
+  /**
+   * Pool of fixed size blocks backing the nodes of HeaderList. Blocks are carved out of chunks that
+   * grow geometrically, so building and tearing down a typical header map costs a handful of
+   * allocations rather than one per header. Released blocks go on an intrusive free list and are
+   * reused by later inserts; chunks are only returned to the system when the pool is destroyed.
+   * List nodes never move, so list iterators and the O(1) inline header pointers remain stable.
+   */
+  class HeaderNodePool : NonCopyable {
+  public:
+    ~HeaderNodePool();
+
+    void* allocate(size_t size) {
+      if (block_size_ == 0) {
+        block_size_ = roundUpToBlockAlignment(size);
+      }
+      if (roundUpToBlockAlignment(size) != block_size_) {
+        // Anything other than a single list node (e.g. a sentinel node in some standard library
+        // implementations) is not pooled.
+        return ::operator new(size);
+      }
+      if (free_list_ == nullptr) {
+        addChunk();
+      }
+      FreeBlock* block = free_list_;
+      free_list_ = block->next_;
+      return block;
+    }
+
+    void deallocate(void* p, size_t size) {
+      if (roundUpToBlockAlignment(size) != block_size_) {
+        ::operator delete(p);
+        return;
+      }
+      FreeBlock* block = static_cast<FreeBlock*>(p);
+      block->next_ = free_list_;
+      free_list_ = block;
+    }
+
+    // The number of chunks allocated from the system so far.
+    uint32_t chunks() const { return num_chunks_; }
+
+    static constexpr uint32_t MinChunkBlocks = 4;
+    static constexpr uint32_t MaxChunkBlocks = 64;
+
+  private:
+    struct FreeBlock {
+      FreeBlock* next_;
+    };
+    // Chunks are chained through a header placed at the start of each chunk so that tracking them
+    // does not itself allocate.
+    struct alignas(std::max_align_t) ChunkHeader {
+      ChunkHeader* next_;
+    };
+
+    static constexpr size_t roundUpToBlockAlignment(size_t size) {
+      return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    }
+    void addChunk();
+
+    FreeBlock* free_list_{};
+    ChunkHeader* chunks_{};
+    size_t block_size_{};
+    uint32_t num_chunks_{};
+  };
+
+  /**
+   * Standard allocator that routes HeaderList node allocations through a HeaderNodePool.
+   */
+  template <class T> class HeaderNodeAllocator {
+  public:
+    using value_type = T;
+
+    explicit HeaderNodeAllocator(HeaderNodePool& pool) : pool_(&pool) {}
+    template <class U>
+    HeaderNodeAllocator(const HeaderNodeAllocator<U>& other) : pool_(other.pool_) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(pool_->allocate(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { pool_->deallocate(p, n * sizeof(T)); }
+
+    template <class U> bool operator==(const HeaderNodeAllocator<U>& rhs) const {
+      return pool_ == rhs.pool_;
+    }
+    template <class U> bool operator!=(const HeaderNodeAllocator<U>& rhs) const {
+      return pool_ != rhs.pool_;
+    }
+
+  private:
+    template <class U> friend class HeaderNodeAllocator;
+
+    HeaderNodePool* pool_;
+  };
+
+  struct HeaderEntryImpl;
+  using HeaderEntryList = std::list<HeaderEntryImpl, HeaderNodeAllocator<HeaderEntryImpl>>;
+
   struct HeaderEntryImpl : public HeaderEntry, NonCopyable {
     HeaderEntryImpl(const LowerCaseString& key);
     HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value);
@@ -129,9 +227,9 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    HeaderEntryList::iterator entry_;
   };
-  using HeaderNode = std::list<HeaderEntryImpl>::iterator;
+  using HeaderNode = HeaderEntryList::iterator;
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
@@ -193,7 +291,8 @@ protected:
 
   /**
    * List of HeaderEntryImpl that keeps the pseudo headers (key starting with ':') in the front
-   * of the list (as required by nghttp2) and otherwise maintains insertion order.
+   * of the list (as required by nghttp2) and otherwise maintains insertion order. List nodes are
+   * allocated from a HeaderNodePool owned by the list.
    * When the list size is greater or equal to 3, all headers are added to a map, to allow fast
    * access given a header key. Once the map is initialized, it will be used even
    * if the number of headers decreases below the threshold.
@@ -210,7 +309,9 @@ protected:
     using HeaderNodeVector = absl::InlinedVector<HeaderNode, 1>;
     using HeaderLazyMap = absl::flat_hash_map<absl::string_view, HeaderNodeVector>;
 
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    HeaderList()
+        : headers_(HeaderNodeAllocator<HeaderEntryImpl>(pool_)),
+          pseudo_headers_end_(headers_.end()) {}
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
@@ -300,12 +401,12 @@ protected:
      */
     size_t remove(absl::string_view key);
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
+    HeaderEntryList::iterator begin() { return headers_.begin(); }
+    HeaderEntryList::iterator end() { return headers_.end(); }
+    HeaderEntryList::const_iterator begin() const { return headers_.begin(); }
+    HeaderEntryList::const_iterator end() const { return headers_.end(); }
+    HeaderEntryList::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
+    HeaderEntryList::const_reverse_iterator rend() const { return headers_.rend(); }
     HeaderLazyMap::iterator mapFind(absl::string_view key) { return lazy_map_.find(key); }
     HeaderLazyMap::iterator mapEnd() { return lazy_map_.end(); }
     size_t size() const { return headers_.size(); }
@@ -316,8 +417,12 @@ protected:
       lazy_map_.clear();
     }
 
+    const HeaderNodePool& pool() const { return pool_; }
+
   private:
-    std::list<HeaderEntryImpl> headers_;
+    // The pool must outlive the list that allocates from it, so it is declared first.
+    HeaderNodePool pool_;
+    HeaderEntryList headers_;
     HeaderNode pseudo_headers_end_;
     HeaderLazyMap lazy_map_;
   };
@@ -1251,32 +1251,54 @@ std::string Utility::PercentEncoding::encode(absl::string_view value, const size
   return encoded;
 }
 
+namespace {
+// Returns the character encoded by the percent-encoded triplet starting at pos, or nullopt if the
+// '%' at pos does not start a valid triplet.
+absl::optional<char> decodePercentEncodedTriplet(absl::string_view encoded, size_t pos) {
+  ASSERT(encoded[pos] == '%');
+  if (pos + 2 >= encoded.size()) {
+    return absl::nullopt;
+  }
+  const char& hi = encoded[pos + 1];
+  const char& lo = encoded[pos + 2];
+  if (!absl::ascii_isxdigit(hi) || !absl::ascii_isxdigit(lo)) {
+    return absl::nullopt;
+  }
+  char ch;
+  if (absl::ascii_isdigit(hi)) {
+    ch = hi - '0';
+  } else {
+    ch = absl::ascii_toupper(hi) - 'A' + 10;
+  }
+
+  ch *= 16;
+  if (absl::ascii_isdigit(lo)) {
+    ch += lo - '0';
+  } else {
+    ch += absl::ascii_toupper(lo) - 'A' + 10;
+  }
+  return ch;
+}
+} // namespace
+
 std::string Utility::PercentEncoding::decode(absl::string_view encoded) {
   std::string decoded;
   decoded.reserve(encoded.size());
-  for (size_t i = 0; i < encoded.size(); ++i) {
-    char ch = encoded[i];
-    if (ch == '%' && i + 2 < encoded.size()) {
-      const char& hi = encoded[i + 1];
-      const char& lo = encoded[i + 2];
-      if (absl::ascii_isxdigit(hi) && absl::ascii_isxdigit(lo)) {
-        if (absl::ascii_isdigit(hi)) {
-          ch = hi - '0';
-        } else {
-          ch = absl::ascii_toupper(hi) - 'A' + 10;
-        }
-
-        ch *= 16;
-        if (absl::ascii_isdigit(lo)) {
-          ch += lo - '0';
-        } else {
-          ch += absl::ascii_toupper(lo) - 'A' + 10;
-        }
-        i += 2;
-      }
+  // Runs of characters between '%' are copied as a whole, rather than one character at a time.
+  size_t start = 0;
+  for (size_t pos = encoded.find('%'); pos != absl::string_view::npos;
+       pos = encoded.find('%', start)) {
+    decoded.append(encoded.data() + start, pos - start);
+    const absl::optional<char> ch = decodePercentEncodedTriplet(encoded, pos);
+    if (ch.has_value()) {
+      decoded.push_back(*ch);
+      start = pos + 3;
+    } else {
+      decoded.push_back('%');
+      start = pos + 1;
     }
-    decoded.push_back(ch);
   }
+  decoded.append(encoded.data() + start, encoded.size() - start);
   return decoded;
 }
 
@@ -1348,39 +1370,30 @@ bool Utility::PercentEncoding::queryParameterIsUrlEncoded(absl::string_view valu
 std::string Utility::PercentEncoding::urlDecodeQueryParameter(absl::string_view encoded) {
   std::string decoded;
   decoded.reserve(encoded.size());
-  for (size_t i = 0; i < encoded.size(); ++i) {
-    char ch = encoded[i];
-    if (ch == '%' && i + 2 < encoded.size()) {
-      const char& hi = encoded[i + 1];
-      const char& lo = encoded[i + 2];
-      if (absl::ascii_isxdigit(hi) && absl::ascii_isxdigit(lo)) {
-        if (absl::ascii_isdigit(hi)) {
-          ch = hi - '0';
-        } else {
-          ch = absl::ascii_toupper(hi) - 'A' + 10;
-        }
-
-        ch *= 16;
-        if (absl::ascii_isdigit(lo)) {
-          ch += lo - '0';
-        } else {
-          ch += absl::ascii_toupper(lo) - 'A' + 10;
-        }
-        if (shouldPercentDecodeChar(ch)) {
-          // Decode the character only if it is present in the characters_to_decode
-          decoded.push_back(ch);
-        } else {
-          // Otherwise keep it as is.
-          decoded.push_back('%');
-          decoded.push_back(hi);
-          decoded.push_back(lo);
-        }
-        i += 2;
+  size_t start = 0;
+  for (size_t pos = encoded.find('%'); pos != absl::string_view::npos;
+       pos = encoded.find('%', start)) {
+    decoded.append(encoded.data() + start, pos - start);
+    const absl::optional<char> ch = decodePercentEncodedTriplet(encoded, pos);
+    if (ch.has_value()) {
+      if (shouldPercentDecodeChar(*ch)) {
+        // Decode the character only if it is present in the characters_to_decode
+        decoded.push_back(*ch);
+      } else {
+        // Otherwise keep it as is.
+        decoded.append(encoded.data() + pos, 3);
       }
+      start = pos + 3;
     } else {
-      decoded.push_back(ch);
+      // A '%' that is not followed by two hex digits is dropped, unless it is one of the last two
+      // characters.
+      if (pos + 2 >= encoded.size()) {
+        decoded.push_back('%');
+      }
+      start = pos + 1;
     }
   }
+  decoded.append(encoded.data() + start, encoded.size() - start);
   return decoded;
 }
 
@@ -1616,28 +1629,16 @@ bool Utility::isValidRefererValue(absl::string_view value) {
     return !(url.containsFragment() || url.containsUserinfo());
   }
 
-  bool seen_slash = false;
-
-  for (char c : value) {
-    switch (c) {
-    case ':':
-      if (!seen_slash) {
-        // First path segment cannot contain ':'
-        // https://www.rfc-editor.org/rfc/rfc3986#section-3.3
-        return false;
-      }
-      continue;
-    case '/':
-      seen_slash = true;
-      continue;
-    default:
-      if (!testCharInTable(kUriQueryAndFragmentCharTable, c)) {
-        return false;
-      }
-    }
+  // First path segment cannot contain ':'
+  // https://www.rfc-editor.org/rfc/rfc3986#section-3.3
+  const size_t first_colon = value.find(':');
+  if (first_colon != absl::string_view::npos &&
+      value.substr(0, first_colon).find('/') == absl::string_view::npos) {
+    return false;
   }
 
-  return true;
+  // Both ':' and '/' are in the query and fragment character set.
+  return kUriQueryAndFragmentCharSet.containsAll(value);
 }
 
 } // namespace Http
@@ -2,6 +2,8 @@
 
 #include <sys/eventfd.h>
 
+#include "source/common/buffer/buffer_impl.h"
+
 namespace Envoy {
 namespace Io {
 
@@ -30,7 +32,12 @@ IoUringImpl::IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polli
   RELEASE_ASSERT(ret == 0, fmt::format("unable to initialize io_uring: {}", errorDetails(-ret)));
 }
 
-IoUringImpl::~IoUringImpl() { io_uring_queue_exit(&ring_); }
+IoUringImpl::~IoUringImpl() {
+  if (buf_ring_ != nullptr) {
+    io_uring_free_buf_ring(&ring_, buf_ring_, buf_ring_entries_, BufferGroupId);
+  }
+  io_uring_queue_exit(&ring_);
+}
 
 os_fd_t IoUringImpl::registerEventfd() {
   ASSERT(!isEventfdRegistered());
@@ -69,7 +76,11 @@ void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
 
   for (unsigned i = 0; i < count; ++i) {
     struct io_uring_cqe* cqe = cqes_[i];
-    completion_cb(reinterpret_cast<Request*>(cqe->user_data), cqe->res, false);
+    Request* req = reinterpret_cast<Request*>(cqe->user_data);
+    if (req != nullptr) {
+      req->setCompletionFlags(cqe->flags);
+    }
+    completion_cb(req, cqe->res, false);
   }
 
   io_uring_cq_advance(&ring_, count);
@@ -151,6 +162,107 @@ IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const struct iovec* iovecs,
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::prepareRecvMultishot(os_fd_t fd, Request* user_data) {
+  ENVOY_LOG(trace, "prepare multishot recv for fd = {}", fd);
+  ASSERT(buf_ring_ != nullptr);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_recv_multishot(sqe, fd, nullptr, 0, 0);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = BufferGroupId;
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareWritevAndClose(os_fd_t fd, const struct iovec* iovecs,
+                                                 unsigned nr_vecs, Request* write_user_data,
+                                                 Request* close_user_data) {
+  ENVOY_LOG(trace, "prepare linked writev and close for fd = {}", fd);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  // Both entries have to be queued together, otherwise the link would attach to whatever entry
+  // is prepared next.
+  if (io_uring_sq_space_left(&ring_) < 2) {
+    return IoUringResult::Failed;
+  }
+
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  io_uring_prep_writev(sqe, fd, iovecs, nr_vecs, 0);
+  io_uring_sqe_set_data(sqe, write_user_data);
+  // A short write fails the link, so the close is only executed once all the data is written.
+  sqe->flags |= IOSQE_IO_LINK;
+
+  sqe = io_uring_get_sqe(&ring_);
+  io_uring_prep_close(sqe, fd);
+  io_uring_sqe_set_data(sqe, close_user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareOpenat(os_fd_t dfd, const char* path, int flags, mode_t mode,
+                                         Request* user_data) {
+  ENVOY_LOG(trace, "prepare openat for path = {}", path);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_openat(sqe, dfd, path, flags, mode);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareStatx(os_fd_t dfd, const char* path, int flags, unsigned mask,
+                                        struct statx* statxbuf, Request* user_data) {
+  ENVOY_LOG(trace, "prepare statx for path = {}", path);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_statx(sqe, dfd, path, flags, mask, statxbuf);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareUnlinkat(os_fd_t dfd, const char* path, int flags,
+                                           Request* user_data) {
+  ENVOY_LOG(trace, "prepare unlinkat for path = {}", path);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_unlinkat(sqe, dfd, path, flags);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareLinkat(os_fd_t old_dfd, const char* old_path, os_fd_t new_dfd,
+                                         const char* new_path, int flags, Request* user_data) {
+  ENVOY_LOG(trace, "prepare linkat for path = {}", new_path);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_linkat(sqe, old_dfd, old_path, new_dfd, new_path, flags);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::prepareClose(os_fd_t fd, Request* user_data) {
   ENVOY_LOG(trace, "prepare close for fd = {}", fd);
   // TODO (soulxu): Handling the case of CQ ring is overflow.
@@ -195,6 +307,58 @@ IoUringResult IoUringImpl::prepareShutdown(os_fd_t fd, int how, Request* user_da
   return IoUringResult::Ok;
 }
 
+bool IoUringImpl::setupBufferRing(uint32_t entries, uint32_t buffer_size) {
+  ASSERT(buf_ring_ == nullptr);
+  ASSERT(entries > 0 && (entries & (entries - 1)) == 0);
+  int ret = 0;
+  buf_ring_ = io_uring_setup_buf_ring(&ring_, entries, BufferGroupId, 0, &ret);
+  if (buf_ring_ == nullptr) {
+    ENVOY_LOG(debug, "unable to set up provided buffer ring: {}", errorDetails(-ret));
+    return false;
+  }
+
+  buf_ring_entries_ = entries;
+  buffer_size_ = buffer_size;
+  provided_buffers_.resize(entries);
+  for (uint32_t i = 0; i < entries; ++i) {
+    provided_buffers_[i].reset(new uint8_t[buffer_size_]);
+    provideBuffer(i, i);
+  }
+  io_uring_buf_ring_advance(buf_ring_, entries);
+  return true;
+}
+
+void IoUringImpl::provideBuffer(uint16_t buffer_id, int offset) {
+  io_uring_buf_ring_add(buf_ring_, provided_buffers_[buffer_id].get(), buffer_size_, buffer_id,
+                        io_uring_buf_ring_mask(buf_ring_entries_), offset);
+}
+
+void IoUringImpl::consumeProvidedBuffer(uint16_t buffer_id, uint32_t length,
+                                        Buffer::Instance& output) {
+  ASSERT(buf_ring_ != nullptr);
+  ASSERT(buffer_id < provided_buffers_.size());
+  ASSERT(length <= buffer_size_);
+
+  // Small reads are copied out so that the buffer can go straight back to the ring, rather than
+  // pinning a whole buffer for a few bytes. Larger reads hand the buffer itself over to the output
+  // buffer and replace it in the ring with a fresh one.
+  if (length < buffer_size_ / 4) {
+    output.add(provided_buffers_[buffer_id].get(), length);
+  } else {
+    Buffer::BufferFragment* fragment = new Buffer::BufferFragmentImpl(
+        provided_buffers_[buffer_id].release(), length,
+        [](const void* data, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
+          delete[] reinterpret_cast<const uint8_t*>(data);
+          delete this_fragment;
+        });
+    output.addBufferFragment(*fragment);
+    provided_buffers_[buffer_id].reset(new uint8_t[buffer_size_]);
+  }
+
+  provideBuffer(buffer_id, 0);
+  io_uring_buf_ring_advance(buf_ring_, 1);
+}
+
 IoUringResult IoUringImpl::submit() {
   int res = io_uring_submit(&ring_);
   RELEASE_ASSERT(res >= 0 || res == -EBUSY, "unable to submit io_uring queue entries");
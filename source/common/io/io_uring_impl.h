@@ -40,18 +40,45 @@ public:
                              Request* user_data) override;
   IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                               off_t offset, Request* user_data) override;
+  IoUringResult prepareRecvMultishot(os_fd_t fd, Request* user_data) override;
+  IoUringResult prepareWritevAndClose(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
+                                      Request* write_user_data, Request* close_user_data) override;
+  IoUringResult prepareOpenat(os_fd_t dfd, const char* path, int flags, mode_t mode,
+                              Request* user_data) override;
+  IoUringResult prepareStatx(os_fd_t dfd, const char* path, int flags, unsigned mask,
+                             struct statx* statxbuf, Request* user_data) override;
+  IoUringResult prepareUnlinkat(os_fd_t dfd, const char* path, int flags,
+                                Request* user_data) override;
+  IoUringResult prepareLinkat(os_fd_t old_dfd, const char* old_path, os_fd_t new_dfd,
+                              const char* new_path, int flags, Request* user_data) override;
   IoUringResult prepareClose(os_fd_t fd, Request* user_data) override;
   IoUringResult prepareCancel(Request* cancelling_user_data, Request* user_data) override;
   IoUringResult prepareShutdown(os_fd_t fd, int how, Request* user_data) override;
+  bool setupBufferRing(uint32_t entries, uint32_t buffer_size) override;
+  void consumeProvidedBuffer(uint16_t buffer_id, uint32_t length,
+                             Buffer::Instance& output) override;
   IoUringResult submit() override;
   void injectCompletion(os_fd_t fd, Request* user_data, int32_t result) override;
   void removeInjectedCompletion(os_fd_t fd) override;
 
 private:
+  // The buffer group id of the provided buffer ring. There is at most one ring per io_uring.
+  static constexpr uint16_t BufferGroupId = 0;
+
+  void provideBuffer(uint16_t buffer_id, int offset);
+
   struct io_uring ring_ {};
   std::vector<struct io_uring_cqe*> cqes_;
   os_fd_t event_fd_{INVALID_SOCKET};
   std::list<InjectedCompletion> injected_completions_;
+
+  // The provided buffer ring, if set up. Each buffer in provided_buffers_ is owned here while it is
+  // available to the kernel, and handed over to the read buffer once data has been received into
+  // it.
+  struct io_uring_buf_ring* buf_ring_{nullptr};
+  uint32_t buf_ring_entries_{0};
+  uint32_t buffer_size_{0};
+  std::vector<std::unique_ptr<uint8_t[]>> provided_buffers_;
 };
 
 } // namespace Io
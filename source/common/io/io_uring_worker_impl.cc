@@ -3,6 +3,18 @@
 namespace Envoy {
 namespace Io {
 
+namespace {
+
+uint64_t rawSlicesLength(const Buffer::RawSliceVector& slices) {
+  uint64_t length = 0;
+  for (const Buffer::RawSlice& slice : slices) {
+    length += slice.len_;
+  }
+  return length;
+}
+
+} // namespace
+
 ReadRequest::ReadRequest(IoUringSocket& socket, uint32_t size)
     : Request(RequestType::Read, socket), buf_(std::make_unique<uint8_t[]>(size)),
       iov_(std::make_unique<struct iovec>()) {
@@ -60,14 +72,29 @@ void IoUringSocketEntry::onRemoteClose() {
 
 IoUringWorkerImpl::IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                                      uint32_t read_buffer_size, uint32_t write_timeout_ms,
-                                     Event::Dispatcher& dispatcher)
+                                     Event::Dispatcher& dispatcher, uint32_t buffer_ring_size,
+                                     bool enable_linked_write_and_close)
     : IoUringWorkerImpl(std::make_unique<IoUringImpl>(io_uring_size, use_submission_queue_polling),
-                        read_buffer_size, write_timeout_ms, dispatcher) {}
+                        read_buffer_size, write_timeout_ms, dispatcher, buffer_ring_size,
+                        enable_linked_write_and_close) {}
 
 IoUringWorkerImpl::IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size,
-                                     uint32_t write_timeout_ms, Event::Dispatcher& dispatcher)
+                                     uint32_t write_timeout_ms, Event::Dispatcher& dispatcher,
+                                     uint32_t buffer_ring_size, bool enable_linked_write_and_close)
     : io_uring_(std::move(io_uring)), read_buffer_size_(read_buffer_size),
-      write_timeout_ms_(write_timeout_ms), dispatcher_(dispatcher) {
+      write_timeout_ms_(write_timeout_ms),
+      enable_linked_write_and_close_(enable_linked_write_and_close), dispatcher_(dispatcher) {
+  if (buffer_ring_size > 0) {
+    // Fall back to a single-shot readv per read if the kernel does not support provided buffer
+    // rings.
+    uint32_t entries = 1;
+    while (entries < buffer_ring_size) {
+      entries <<= 1;
+    }
+    buffer_ring_enabled_ = io_uring_->setupBufferRing(entries, read_buffer_size_);
+    ENVOY_LOG(debug, "io_uring provided buffer ring of {} buffers {}", entries,
+              buffer_ring_enabled_ ? "enabled" : "unsupported, falling back to readv");
+  }
   const os_fd_t event_fd = io_uring_->registerEventfd();
   // We only care about the read event of Eventfd, since we only receive the
   // event here.
@@ -153,6 +180,25 @@ IoUringWorkerImpl::submitConnectRequest(IoUringSocket& socket,
 }
 
 Request* IoUringWorkerImpl::submitReadRequest(IoUringSocket& socket) {
+  if (buffer_ring_enabled_) {
+    // A single multishot receive stays armed until it completes without IORING_CQE_F_MORE, so
+    // there is no submission per read.
+    Request* req = new Request(Request::RequestType::Read, socket);
+
+    ENVOY_LOG(trace, "submit multishot recv request, fd = {}, read req = {}", socket.fd(),
+              fmt::ptr(req));
+
+    auto res = io_uring_->prepareRecvMultishot(socket.fd(), req);
+    if (res == IoUringResult::Failed) {
+      // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+      submit();
+      res = io_uring_->prepareRecvMultishot(socket.fd(), req);
+      RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare multishot recv");
+    }
+    submit();
+    return req;
+  }
+
   ReadRequest* req = new ReadRequest(socket, read_buffer_size_);
 
   ENVOY_LOG(trace, "submit read request, fd = {}, read req = {}", socket.fd(), fmt::ptr(req));
@@ -185,6 +231,28 @@ Request* IoUringWorkerImpl::submitWriteRequest(IoUringSocket& socket,
   return req;
 }
 
+std::pair<Request*, Request*>
+IoUringWorkerImpl::submitWriteAndCloseRequest(IoUringSocket& socket,
+                                              const Buffer::RawSliceVector& slices) {
+  WriteRequest* write_req = new WriteRequest(socket, slices);
+  Request* close_req = new Request(Request::RequestType::Close, socket);
+
+  ENVOY_LOG(trace, "submit linked write and close request, fd = {}, write req = {}, close req = {}",
+            socket.fd(), fmt::ptr(write_req), fmt::ptr(close_req));
+
+  auto res = io_uring_->prepareWritevAndClose(socket.fd(), write_req->iov_.get(), slices.size(),
+                                              write_req, close_req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareWritevAndClose(socket.fd(), write_req->iov_.get(), slices.size(),
+                                           write_req, close_req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare linked writev and close");
+  }
+  submit();
+  return {write_req, close_req};
+}
+
 Request* IoUringWorkerImpl::submitCloseRequest(IoUringSocket& socket) {
   Request* req = new Request(Request::RequestType::Close, socket);
 
@@ -235,6 +303,13 @@ Request* IoUringWorkerImpl::submitShutdownRequest(IoUringSocket& socket, int how
   return req;
 }
 
+void IoUringWorkerImpl::consumeProvidedBuffer(const Request& req, int32_t result,
+                                              Buffer::Instance& output) {
+  ASSERT(req.completionFlags() & IORING_CQE_F_BUFFER);
+  io_uring_->consumeProvidedBuffer(req.completionFlags() >> IORING_CQE_BUFFER_SHIFT, result,
+                                   output);
+}
+
 IoUringSocketEntryPtr IoUringWorkerImpl::removeSocket(IoUringSocketEntry& socket) {
   // Remove all the injection completion for this socket.
   io_uring_->removeInjectedCompletion(socket.fd());
@@ -294,7 +369,10 @@ void IoUringWorkerImpl::onFileEvent() {
       break;
     }
 
-    delete req;
+    // A multishot request stays alive until its final completion.
+    if (!(req->completionFlags() & IORING_CQE_F_MORE)) {
+      delete req;
+    }
   });
   delay_submit_ = false;
   submit();
@@ -410,6 +488,14 @@ void IoUringServerSocket::shutdown(int how) {
 void IoUringServerSocket::onClose(Request* req, int32_t result, bool injected) {
   IoUringSocketEntry::onClose(req, result, injected);
   ASSERT(!injected);
+  if (result == -ECANCELED) {
+    // The close was linked to a write that did not write all its data, or that was canceled.
+    // Retry once the remaining writes are done.
+    ENVOY_LOG(trace, "linked close canceled, fd = {}", fd_);
+    close_req_ = nullptr;
+    submitWriteOrShutdownRequest();
+    return;
+  }
   cleanup();
 }
 
@@ -429,6 +515,10 @@ void IoUringServerSocket::onCancel(Request* req, int32_t result, bool injected)
 }
 
 void IoUringServerSocket::moveReadDataToBuffer(Request* req, size_t data_length) {
+  if (req->completionFlags() & IORING_CQE_F_BUFFER) {
+    parent_.consumeProvidedBuffer(*req, data_length, read_buf_);
+    return;
+  }
   ReadRequest* read_req = static_cast<ReadRequest*>(req);
   Buffer::BufferFragment* fragment = new Buffer::BufferFragmentImpl(
       read_req->buf_.release(), data_length,
@@ -439,6 +529,15 @@ void IoUringServerSocket::moveReadDataToBuffer(Request* req, size_t data_length)
   read_buf_.addBufferFragment(*fragment);
 }
 
+void IoUringServerSocket::discardReadData(Request* req, int32_t result) {
+  // Data received into a provided buffer still has to be consumed so that the buffer is returned
+  // to the ring.
+  if (result > 0 && (req->completionFlags() & IORING_CQE_F_BUFFER)) {
+    Buffer::OwnedImpl discarded;
+    parent_.consumeProvidedBuffer(*req, result, discarded);
+  }
+}
+
 void IoUringServerSocket::onReadCompleted(int32_t result) {
   ENVOY_LOG(trace, "read from socket, fd = {}, result = {}", fd_, result);
   ReadParam param{read_buf_, result};
@@ -457,23 +556,32 @@ void IoUringServerSocket::onRead(Request* req, int32_t result, bool injected) {
             "onRead with result {}, fd = {}, injected = {}, status_ = {}, enable_close_event = {}",
             result, fd_, injected, static_cast<int>(status_), enable_close_event_);
   if (!injected) {
-    read_req_ = nullptr;
+    // A multishot receive remains the in flight read request until its final completion.
+    const bool more = req->completionFlags() & IORING_CQE_F_MORE;
+    if (!more) {
+      read_req_ = nullptr;
+    }
     // If the socket is going to close, discard all results.
-    if (status_ == Closed && write_or_shutdown_req_ == nullptr && read_cancel_req_ == nullptr &&
-        write_or_shutdown_cancel_req_ == nullptr) {
+    if (status_ == Closed) {
       if (result > 0 && keep_fd_open_) {
         moveReadDataToBuffer(req, result);
+      } else {
+        discardReadData(req, result);
+      }
+      if (!more && write_or_shutdown_req_ == nullptr && read_cancel_req_ == nullptr &&
+          write_or_shutdown_cancel_req_ == nullptr) {
+        closeInternal();
       }
-      closeInternal();
       return;
     }
   }
 
-  // Move read data from request to buffer or store the error.
+  // Move read data from request to buffer or store the error. Running out of provided buffers
+  // ends a multishot receive without an error, and it is simply armed again below.
   if (result > 0) {
     moveReadDataToBuffer(req, result);
   } else {
-    if (result != -ECANCELED) {
+    if (result != -ECANCELED && !(result == -ENOBUFS && parent_.bufferRingEnabled())) {
       read_error_ = result;
     }
   }
@@ -632,6 +740,15 @@ void IoUringServerSocket::submitWriteOrShutdownRequest() {
       Buffer::RawSliceVector slices = write_buf_.getRawSlices(IOV_MAX);
       ENVOY_LOG(trace, "submit write request, write_buf size = {}, num_iovecs = {}, fd = {}",
                 write_buf_.length(), slices.size(), fd_);
+      // If this is the last write before closing, link the close to it to save a round trip.
+      if (status_ == Closed && !keep_fd_open_ && parent_.linkedWriteAndCloseEnabled() &&
+          rawSlicesLength(slices) == write_buf_.length() && close_req_ == nullptr &&
+          read_req_ == nullptr && read_cancel_req_ == nullptr &&
+          write_or_shutdown_cancel_req_ == nullptr) {
+        std::tie(write_or_shutdown_req_, close_req_) =
+            parent_.submitWriteAndCloseRequest(*this, slices);
+        return;
+      }
       write_or_shutdown_req_ = parent_.submitWriteRequest(*this, slices);
     } else if (shutdown_.has_value() && !shutdown_.value()) {
       write_or_shutdown_req_ = parent_.submitShutdownRequest(*this, SHUT_WR);
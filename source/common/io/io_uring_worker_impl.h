@@ -32,9 +32,11 @@ class IoUringWorkerImpl : public IoUringWorker, private Logger::Loggable<Logger:
 public:
   IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                     uint32_t read_buffer_size, uint32_t write_timeout_ms,
-                    Event::Dispatcher& dispatcher);
+                    Event::Dispatcher& dispatcher, uint32_t buffer_ring_size = 0,
+                    bool enable_linked_write_and_close = false);
   IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size, uint32_t write_timeout_ms,
-                    Event::Dispatcher& dispatcher);
+                    Event::Dispatcher& dispatcher, uint32_t buffer_ring_size = 0,
+                    bool enable_linked_write_and_close = false);
   ~IoUringWorkerImpl() override;
 
   // IoUringWorker
@@ -55,6 +57,21 @@ public:
 
   Event::Dispatcher& dispatcher() override;
 
+  // Submit a write request linked to a close request for a socket. The close only runs once all
+  // the given data is written. Returns the write and close requests.
+  std::pair<Request*, Request*> submitWriteAndCloseRequest(IoUringSocket& socket,
+                                                           const Buffer::RawSliceVector& slices);
+
+  // Move the data of a read completion that was received into a provided buffer to the given
+  // buffer.
+  void consumeProvidedBuffer(const Request& req, int32_t result, Buffer::Instance& output);
+
+  // Whether reads are multishot receives from the provided buffer ring.
+  bool bufferRingEnabled() const { return buffer_ring_enabled_; }
+
+  // Whether closing a socket with pending data links the final write and the close.
+  bool linkedWriteAndCloseEnabled() const { return enable_linked_write_and_close_; }
+
   // Remove a socket from this worker.
   IoUringSocketEntryPtr removeSocket(IoUringSocketEntry& socket);
 
@@ -74,6 +91,8 @@ protected:
   IoUringPtr io_uring_;
   const uint32_t read_buffer_size_;
   const uint32_t write_timeout_ms_;
+  const bool enable_linked_write_and_close_;
+  bool buffer_ring_enabled_{false};
   // The dispatcher of this worker is running on.
   Event::Dispatcher& dispatcher_;
   // The file event of iouring's eventfd.
@@ -247,6 +266,7 @@ protected:
   void submitReadRequest();
   void submitWriteOrShutdownRequest();
   void moveReadDataToBuffer(Request* req, size_t data_length);
+  void discardReadData(Request* req, int32_t result);
   void onReadCompleted(int32_t result);
   void onWriteCompleted(int32_t result);
 };
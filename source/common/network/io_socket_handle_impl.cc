@@ -5,6 +5,9 @@
 #include "envoy/buffer/buffer.h"
 
 #include "source/common/api/os_sys_calls_impl.h"
+#if defined(__linux__)
+#include "source/common/api/os_sys_calls_impl_linux.h"
+#endif
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/safe_memcpy.h"
 #include "source/common/common/utility.h"
@@ -139,6 +142,31 @@ Api::IoCallUint64Result IoSocketHandleImpl::writev(const Buffer::RawSlice* slice
 Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
   constexpr uint64_t MaxSlices = 16;
   Buffer::RawSliceVector slices = buffer.getRawSlices(MaxSlices);
+#if defined(__linux__)
+  // Data which is part of a file is sent directly from the file, and data before it is written
+  // up to the start of the file's data.
+  const auto file_slice = buffer.findFileSlice(MaxSlices);
+  if (file_slice.has_value()) {
+    if (file_slice->first == 0) {
+      absl::optional<Api::IoCallUint64Result> sent = sendFileRange(file_slice->second);
+      if (sent.has_value()) {
+        if (sent->ok() && sent->return_value_ > 0) {
+          buffer.drain(sent->return_value_);
+        }
+        return std::move(sent.value());
+      }
+      // The file's data is also mapped into memory, so it can still be written from there.
+      slices.resize(1);
+    } else {
+      uint64_t remaining = file_slice->first;
+      size_t num_slices = 0;
+      while (remaining > 0) {
+        remaining -= slices[num_slices++].len_;
+      }
+      slices.resize(num_slices);
+    }
+  }
+#endif
   Api::IoCallUint64Result result = writev(slices.begin(), slices.size());
   if (result.ok() && result.return_value_ > 0) {
     buffer.drain(static_cast<uint64_t>(result.return_value_));
@@ -146,6 +174,21 @@ Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
   return result;
 }
 
+#if defined(__linux__)
+absl::optional<Api::IoCallUint64Result>
+IoSocketHandleImpl::sendFileRange(const Buffer::FileRange& range) {
+  off_t offset = range.offset_;
+  const Api::SysCallSizeResult result =
+      Api::LinuxOsSysCallsSingleton::get().sendfile(fd_, range.fd_, &offset, range.len_);
+  if (result.return_value_ < 0 &&
+      (result.errno_ == SOCKET_ERROR_INVAL || result.errno_ == ENOSYS)) {
+    // The socket or the file does not support sendfile.
+    return absl::nullopt;
+  }
+  return sysCallResultToIoCallResult(result);
+}
+#endif
+
 Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slices,
                                                     uint64_t num_slice, int flags,
                                                     const Address::Ip* self_ip,
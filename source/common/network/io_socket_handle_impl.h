@@ -108,6 +108,12 @@ protected:
   size_t addressCacheMaxSize() const { return address_cache_max_capacity_; }
 
 private:
+#if defined(__linux__)
+  // Sends a range of a file with sendfile. Returns nullopt if sendfile is not supported for the
+  // socket or the file, in which case nothing was sent.
+  absl::optional<Api::IoCallUint64Result> sendFileRange(const Buffer::FileRange& range);
+#endif
+
   // Returns the destination address if the control message carries it.
   // Otherwise returns nullptr.
   Address::InstanceConstSharedPtr maybeGetDstAddressFromHeader(const cmsghdr& cmsg,
@@ -0,0 +1,119 @@
+#include "source/common/network/udp_mmsg_batch_writer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "envoy/api/os_sys_calls.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_error_impl.h"
+#include "source/common/network/udp_packet_writer_handler_impl.h"
+#include "source/common/network/utility.h"
+
+namespace Envoy {
+namespace Network {
+
+UdpMmsgBatchWriter::UdpMmsgBatchWriter(IoHandle& io_handle, uint32_t max_batch_size)
+    : io_handle_(io_handle), max_batch_size_(std::min(max_batch_size, MaxBatchSize)) {
+  ASSERT(max_batch_size_ > 0);
+  packets_.reserve(max_batch_size_);
+}
+
+Api::IoCallUint64Result UdpMmsgBatchWriter::writePacket(const Buffer::Instance& buffer,
+                                                        const Address::Ip* local_ip,
+                                                        const Address::Instance& peer_address) {
+  ASSERT(!write_blocked_, "Cannot write while IO handle is blocked.");
+  const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&peer_address);
+  if (local_ip != nullptr || address_base == nullptr || address_base->sockAddr() == nullptr) {
+    // Setting the source address needs per-datagram control messages, so fall back to sendmsg().
+    Api::IoCallUint64Result result = flush();
+    if (!result.ok()) {
+      return result;
+    }
+    result = Utility::writeToSocket(io_handle_, buffer, local_ip, peer_address);
+    if (result.err_ && result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+      write_blocked_ = true;
+    }
+    return result;
+  }
+
+  if (packets_.size() == max_batch_size_) {
+    Api::IoCallUint64Result result = flush();
+    if (!result.ok()) {
+      return result;
+    }
+  }
+
+  const uint64_t length = buffer.length();
+  BufferedPacket& packet = packets_.emplace_back();
+  packet.offset_ = data_.size();
+  packet.length_ = length;
+  packet.peer_address_length_ = address_base->sockAddrLen();
+  memcpy(&packet.peer_address_, address_base->sockAddr(), packet.peer_address_length_);
+  data_.resize(data_.size() + length);
+  buffer.copyOut(0, length, data_.data() + packet.offset_);
+  return {length, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result UdpMmsgBatchWriter::flush() {
+  if (packets_.empty()) {
+    return {/*rc=*/0, /*err=*/Api::IoError::none()};
+  }
+
+  // The payloads are only addressable once data_ has stopped growing.
+  const uint32_t num_packets = packets_.size();
+  iovecs_.resize(num_packets);
+  messages_.resize(num_packets);
+  for (uint32_t i = 0; i < num_packets; ++i) {
+    BufferedPacket& packet = packets_[i];
+    iovecs_[i].iov_base = data_.data() + packet.offset_;
+    iovecs_[i].iov_len = packet.length_;
+    msghdr& header = messages_[i].msg_hdr;
+    memset(&header, 0, sizeof(header));
+    header.msg_name = &packet.peer_address_;
+    header.msg_namelen = packet.peer_address_length_;
+    header.msg_iov = &iovecs_[i];
+    header.msg_iovlen = 1;
+  }
+
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const os_fd_t fd = io_handle_.fdDoNotUse();
+  uint32_t num_sent = 0;
+  uint64_t bytes_sent = 0;
+  Api::IoErrorPtr error = Api::IoError::none();
+  while (num_sent < num_packets) {
+    const Api::SysCallIntResult result =
+        os_sys_calls.sendmmsg(fd, &messages_[num_sent], num_packets - num_sent, 0);
+    if (result.return_value_ <= 0) {
+      if (result.errno_ == SOCKET_ERROR_AGAIN) {
+        write_blocked_ = true;
+        error = IoSocketError::getIoSocketEagainError();
+      } else {
+        error = IoSocketError::create(result.errno_);
+      }
+      break;
+    }
+    for (int i = 0; i < result.return_value_; ++i) {
+      bytes_sent += messages_[num_sent + i].msg_len;
+    }
+    num_sent += result.return_value_;
+  }
+
+  // Datagrams which were not sent are dropped along with the rest of the batch.
+  packets_.clear();
+  data_.clear();
+  return {bytes_sent, std::move(error)};
+}
+
+UdpPacketWriterPtr UdpMmsgBatchWriterFactory::createUdpPacketWriter(IoHandle& io_handle,
+                                                                    Stats::Scope&) {
+  if (!Api::OsSysCallsSingleton::get().supportsMmsg()) {
+    return std::make_unique<UdpDefaultWriter>(io_handle);
+  }
+  return std::make_unique<UdpMmsgBatchWriter>(io_handle, max_batch_size_);
+}
+
+} // namespace Network
+} // namespace Envoy
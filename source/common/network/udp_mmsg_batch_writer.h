@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+#include "envoy/network/socket.h"
+#include "envoy/network/udp_packet_writer_handler.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * UdpPacketWriter which copies datagrams into an internal batch and sends the whole batch with a
+ * single sendmmsg() call when it is flushed or full. Unlike GSO, the datagrams in a batch may have
+ * different sizes and destinations. Datagrams with an explicit source address are written
+ * immediately with sendmsg(), after flushing the batch to preserve ordering.
+ *
+ * The writer drops datagrams that could not be sent when a flush fails, rather than retaining them
+ * until the socket becomes writable, as datagram delivery is best-effort in any case.
+ */
+class UdpMmsgBatchWriter : public UdpPacketWriter {
+public:
+  // Matches UIO_MAXIOV, the most datagrams the kernel accepts in one sendmmsg() call.
+  static constexpr uint32_t MaxBatchSize = 1024;
+  static constexpr uint32_t DefaultBatchSize = 64;
+
+  UdpMmsgBatchWriter(IoHandle& io_handle, uint32_t max_batch_size);
+
+  // UdpPacketWriter
+  Api::IoCallUint64Result writePacket(const Buffer::Instance& buffer, const Address::Ip* local_ip,
+                                      const Address::Instance& peer_address) override;
+  bool isWriteBlocked() const override { return write_blocked_; }
+  void setWritable() override { write_blocked_ = false; }
+  uint64_t getMaxPacketSize(const Address::Instance& /*peer_address*/) const override {
+    return UdpMaxOutgoingPacketSize;
+  }
+  bool isBatchMode() const override { return true; }
+  UdpPacketWriterBuffer getNextWriteLocation(const Address::Ip* /*local_ip*/,
+                                             const Address::Instance& /*peer_address*/) override {
+    return {nullptr, 0, nullptr};
+  }
+  Api::IoCallUint64Result flush() override;
+
+  /**
+   * @return the number of datagrams waiting for the next flush.
+   */
+  uint32_t bufferedPackets() const { return packets_.size(); }
+
+private:
+  struct BufferedPacket {
+    // Offset and length of the payload in data_.
+    uint64_t offset_;
+    uint64_t length_;
+    sockaddr_storage peer_address_;
+    socklen_t peer_address_length_;
+  };
+
+  IoHandle& io_handle_;
+  const uint32_t max_batch_size_;
+  bool write_blocked_{false};
+  std::vector<uint8_t> data_;
+  std::vector<BufferedPacket> packets_;
+  // Scratch space for flush(), kept to avoid reallocating on every batch.
+  std::vector<iovec> iovecs_;
+  std::vector<mmsghdr> messages_;
+};
+
+/**
+ * Creates UdpMmsgBatchWriters, or UdpDefaultWriters on platforms without sendmmsg().
+ */
+class UdpMmsgBatchWriterFactory : public UdpPacketWriterFactory {
+public:
+  explicit UdpMmsgBatchWriterFactory(uint32_t max_batch_size) : max_batch_size_(max_batch_size) {}
+
+  // UdpPacketWriterFactory
+  UdpPacketWriterPtr createUdpPacketWriter(IoHandle& io_handle, Stats::Scope& scope) override;
+
+private:
+  const uint32_t max_batch_size_;
+};
+
+} // namespace Network
+} // namespace Envoy
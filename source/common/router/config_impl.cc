@@ -2071,7 +2071,52 @@ VirtualHostImpl::VirtualHostImpl(
       SET_AND_RETURN_IF_NOT_OK(route_or_error.status(), creation_status);
       routes_.emplace_back(route_or_error.value());
     }
+    ignore_path_parameters_in_path_matching_ =
+        global_route_config->ignorePathParametersInPathMatching();
+    if (routes_.size() >= MinRoutesForIndex &&
+        Runtime::runtimeFeatureEnabled("envoy.reloadable_features.router_route_index")) {
+      buildRouteIndex(virtual_host, factory_context);
+    }
+  }
+}
+
+void VirtualHostImpl::buildRouteIndex(const envoy::config::route::v3::VirtualHost& virtual_host,
+                                      Server::Configuration::ServerFactoryContext& factory_context) {
+  ASSERT(static_cast<size_t>(virtual_host.routes_size()) == routes_.size());
+  const bool uses_google_re_engine =
+      dynamic_cast<const Regex::GoogleReEngine*>(&factory_context.regexEngine()) != nullptr;
+  route_index_ = std::make_unique<RouteIndex>();
+  for (uint32_t i = 0; i < routes_.size(); ++i) {
+    const auto& match = virtual_host.routes(i).match();
+    const bool case_sensitive = PROTOBUF_GET_WRAPPED_OR_DEFAULT(match, case_sensitive, true);
+    switch (match.path_specifier_case()) {
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPrefix:
+      route_index_->addPrefix(i, match.prefix(), case_sensitive);
+      break;
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPath:
+      route_index_->addExactPath(i, match.path(), case_sensitive);
+      break;
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPathSeparatedPrefix:
+      // Any path matching the path separated prefix also matches the plain prefix.
+      route_index_->addPrefix(i, match.path_separated_prefix(), case_sensitive);
+      break;
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kSafeRegex:
+      // Only RE2 regexes can be grouped into a regex set, routes compiled by another regex engine
+      // are evaluated individually.
+      if (match.safe_regex().has_google_re2() || uses_google_re_engine) {
+        route_index_->addRegex(i, match.safe_regex().regex());
+      } else {
+        route_index_->addUnindexed(i);
+      }
+      break;
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kConnectMatcher:
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPathMatchPolicy:
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::PATH_SPECIFIER_NOT_SET:
+      route_index_->addUnindexed(i);
+      break;
+    }
   }
+  route_index_->finalize();
 }
 
 const VirtualHost& SslRedirectRoute::virtualHost() const { return *virtual_host_; }
@@ -2161,10 +2206,39 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return nullptr;
   }
 
+  // The index does not track which routes remain after a candidate, which the route callback
+  // needs, so it is only used when there is no callback. Requests without a path can only match
+  // routes that support pathless headers, which are found by the linear scan.
+  if (route_index_ != nullptr && cb == nullptr && headers.Path() != nullptr) {
+    return getRouteFromIndex(headers, stream_info, random_value);
+  }
+
   // Check for a route that matches the request.
   return getRouteFromRoutes(cb, headers, stream_info, random_value, routes_);
 }
 
+RouteConstSharedPtr VirtualHostImpl::getRouteFromIndex(const Http::RequestHeaderMap& headers,
+                                                       const StreamInfo::StreamInfo& stream_info,
+                                                       uint64_t random_value) const {
+  // Normalize the path the same way the route path matchers do before matching.
+  absl::string_view path = Http::PathUtil::removeQueryAndFragment(headers.getPathValue());
+  if (ignore_path_parameters_in_path_matching_) {
+    path = path.substr(0, path.find(';'));
+  }
+
+  RouteIndex::Candidates candidates;
+  route_index_->candidates(path, candidates);
+  for (const uint32_t index : candidates) {
+    RouteConstSharedPtr route_entry = routes_[index]->matches(headers, stream_info, random_value);
+    if (route_entry != nullptr) {
+      return route_entry;
+    }
+  }
+
+  ENVOY_LOG(debug, "route was resolved but final route list did not match incoming request");
+  return nullptr;
+}
+
 const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
     absl::string_view host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
     RouteMatcher::SubstringFunction substring_function) const {
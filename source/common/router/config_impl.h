@@ -31,6 +31,7 @@
 #include "source/common/router/config_utility.h"
 #include "source/common/router/header_parser.h"
 #include "source/common/router/metadatamatchcriteria_impl.h"
+#include "source/common/router/route_index.h"
 #include "source/common/router/router_ratelimit.h"
 #include "source/common/router/tls_context_match_criteria_impl.h"
 #include "source/common/stats/symbol_table.h"
@@ -406,16 +407,28 @@ public:
                      const StreamInfo::StreamInfo& stream_info, uint64_t random_value,
                      absl::Span<const RouteEntryImplBaseConstSharedPtr> routes) const;
 
+  // Virtual hosts with at least this many routes get a RouteIndex.
+  static constexpr uint32_t MinRoutesForIndex = 8;
+
 private:
   enum class SslRequirements : uint8_t { None, ExternalOnly, All };
 
+  void buildRouteIndex(const envoy::config::route::v3::VirtualHost& virtual_host,
+                       Server::Configuration::ServerFactoryContext& factory_context);
+  RouteConstSharedPtr getRouteFromIndex(const Http::RequestHeaderMap& headers,
+                                        const StreamInfo::StreamInfo& stream_info,
+                                        uint64_t random_value) const;
+
   CommonVirtualHostSharedPtr shared_virtual_host_;
 
   std::shared_ptr<const SslRedirectRoute> ssl_redirect_route_;
   SslRequirements ssl_requirements_;
 
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Narrows down the routes to evaluate for a request path. Only built for large route tables.
+  RouteIndexPtr route_index_;
   Matcher::MatchTreeSharedPtr<Http::HttpMatchingData> matcher_;
+  bool ignore_path_parameters_in_path_matching_{};
 };
 
 using VirtualHostSharedPtr = std::shared_ptr<VirtualHostImpl>;
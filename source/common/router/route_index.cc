@@ -0,0 +1,106 @@
+#include "source/common/router/route_index.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/logger.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+
+void RouteIndex::addExactPath(uint32_t route, absl::string_view path, bool case_sensitive) {
+  ASSERT(!finalized_);
+  if (case_sensitive) {
+    case_sensitive_.exact_paths_[path].push_back(route);
+  } else {
+    case_insensitive_.exact_paths_[absl::AsciiStrToLower(path)].push_back(route);
+  }
+  ++size_;
+}
+
+void RouteIndex::addPrefix(uint32_t route, absl::string_view prefix, bool case_sensitive) {
+  ASSERT(!finalized_);
+  if (case_sensitive) {
+    case_sensitive_.prefixes_[prefix].push_back(route);
+  } else {
+    case_insensitive_.prefixes_[absl::AsciiStrToLower(prefix)].push_back(route);
+  }
+  ++size_;
+}
+
+void RouteIndex::addRegex(uint32_t route, absl::string_view pattern) {
+  ASSERT(!finalized_);
+  regex_patterns_.emplace_back(pattern);
+  regex_routes_.push_back(route);
+  ++size_;
+}
+
+void RouteIndex::addUnindexed(uint32_t route) {
+  ASSERT(!finalized_);
+  unindexed_.push_back(route);
+  ++size_;
+}
+
+void RouteIndex::finalize() {
+  ASSERT(!finalized_);
+  for (Table* table : {&case_sensitive_, &case_insensitive_}) {
+    for (const auto& [prefix, routes] : table->prefixes_) {
+      table->prefix_trie_.add(prefix, &routes);
+    }
+  }
+  if (!regex_patterns_.empty()) {
+    auto set_or_error = Regex::CompiledGoogleReSet::create(regex_patterns_);
+    if (set_or_error.ok()) {
+      regex_set_ = std::move(set_or_error.value());
+    } else {
+      // The routes compiled their regexes individually, so this can only fail on resource limits.
+      // Fall back to evaluating the regex routes for every path.
+      ENVOY_LOG_MISC(debug, "not indexing regex routes: {}", set_or_error.status().message());
+      unindexed_.insert(unindexed_.end(), regex_routes_.begin(), regex_routes_.end());
+      regex_routes_.clear();
+    }
+    regex_patterns_.clear();
+    regex_patterns_.shrink_to_fit();
+  }
+  finalized_ = true;
+}
+
+void RouteIndex::Table::lookup(absl::string_view path, Candidates& candidates) const {
+  if (!exact_paths_.empty()) {
+    const auto it = exact_paths_.find(path);
+    if (it != exact_paths_.end()) {
+      candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    }
+  }
+  if (!prefixes_.empty()) {
+    for (const RouteList* routes : prefix_trie_.findMatchingPrefixes(path)) {
+      candidates.insert(candidates.end(), routes->begin(), routes->end());
+    }
+  }
+}
+
+void RouteIndex::candidates(absl::string_view path, Candidates& candidates) const {
+  ASSERT(finalized_);
+  candidates.insert(candidates.end(), unindexed_.begin(), unindexed_.end());
+  if (regex_set_ != nullptr) {
+    std::vector<int> matches;
+    if (regex_set_->match(path, matches)) {
+      for (const int match : matches) {
+        candidates.push_back(regex_routes_[match]);
+      }
+    } else {
+      candidates.insert(candidates.end(), regex_routes_.begin(), regex_routes_.end());
+    }
+  }
+  case_sensitive_.lookup(path, candidates);
+  if (!case_insensitive_.exact_paths_.empty() || !case_insensitive_.prefixes_.empty()) {
+    case_insensitive_.lookup(absl::AsciiStrToLower(path), candidates);
+  }
+  // Every route is registered exactly once, so there are no duplicates to remove.
+  std::sort(candidates.begin(), candidates.end());
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "source/common/common/non_copyable.h"
+#include "source/common/common/regex.h"
+#include "source/common/common/trie_lookup_table.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Index over the routes of a virtual host that narrows down, for a given request path, the routes
+ * whose path matcher can possibly match. Exact path routes are looked up in a hash map, prefix
+ * routes in a trie, regex routes are matched with a single scan of a regex set, and all other
+ * routes (URI templates, CONNECT, ...) are always candidates. Routes are identified by their
+ * position in the virtual host and candidates are reported in that order, so evaluating them in
+ * turn preserves first-match semantics.
+ *
+ * The index may report routes that do not end up matching (e.g. because of header matchers), but
+ * never omits a route whose path matcher would match.
+ */
+class RouteIndex : NonCopyable {
+public:
+  using Candidates = absl::InlinedVector<uint32_t, 16>;
+
+  /**
+   * Registers a route that matches on an exact path.
+   * @param route supplies the position of the route in the virtual host.
+   * @param path supplies the path to match.
+   * @param case_sensitive supplies whether the path match is case sensitive.
+   */
+  void addExactPath(uint32_t route, absl::string_view path, bool case_sensitive);
+
+  /**
+   * Registers a route that matches on a path prefix. Routes with stricter prefix semantics (e.g.
+   * path separated prefixes) may be registered here too as the index only narrows candidates.
+   * @param route supplies the position of the route in the virtual host.
+   * @param prefix supplies the prefix to match.
+   * @param case_sensitive supplies whether the prefix match is case sensitive.
+   */
+  void addPrefix(uint32_t route, absl::string_view prefix, bool case_sensitive);
+
+  /**
+   * Registers a route that fully matches the path against an RE2 regular expression. Regex routes
+   * are grouped into one regex set so that a single scan finds all of the matching ones.
+   * @param route supplies the position of the route in the virtual host.
+   * @param pattern supplies the regular expression, which must use RE2 syntax.
+   */
+  void addRegex(uint32_t route, absl::string_view pattern);
+
+  /**
+   * Registers a route that is a candidate for every path.
+   * @param route supplies the position of the route in the virtual host.
+   */
+  void addUnindexed(uint32_t route);
+
+  /**
+   * Builds the lookup structures. Must be called once after all routes have been added and before
+   * the first call to candidates().
+   */
+  void finalize();
+
+  /**
+   * Finds the routes whose path matchers may match a path.
+   * @param path supplies the request path with query string, fragment and any ignored path
+   *        parameters removed.
+   * @param candidates receives the positions of the candidate routes in ascending order.
+   */
+  void candidates(absl::string_view path, Candidates& candidates) const;
+
+  /**
+   * @return the number of routes registered in the index.
+   */
+  uint32_t size() const { return size_; }
+
+private:
+  using RouteList = std::vector<uint32_t>;
+
+  struct Table {
+    void lookup(absl::string_view path, Candidates& candidates) const;
+
+    absl::flat_hash_map<std::string, RouteList> exact_paths_;
+    absl::flat_hash_map<std::string, RouteList> prefixes_;
+    // Points into prefixes_, which is not modified once the trie is built.
+    TrieLookupTable<const RouteList*> prefix_trie_;
+  };
+
+  Table case_sensitive_;
+  Table case_insensitive_;
+  // Regex patterns and their routes, in the order they were added. The pattern index in the regex
+  // set is the position in these vectors.
+  std::vector<std::string> regex_patterns_;
+  RouteList regex_routes_;
+  Regex::CompiledGoogleReSetPtr regex_set_;
+  RouteList unindexed_;
+  uint32_t size_{};
+  bool finalized_{};
+};
+
+using RouteIndexPtr = std::unique_ptr<RouteIndex>;
+
+} // namespace Router
+} // namespace Envoy
@@ -1224,6 +1224,7 @@ void Filter::onResponseTimeout() {
     if (upstream_request->upstreamHost()) {
       upstream_request->upstreamHost()->stats().rq_timeout_.inc();
     }
+    observeAbortedResponseTime(*upstream_request);
 
     if (upstream_request->awaitingHeaders()) {
       if (cluster_->timeoutBudgetStats().has_value()) {
@@ -1308,6 +1309,7 @@ void Filter::onPerTryTimeoutCommon(UpstreamRequest& upstream_request, Stats::Cou
   if (upstream_request.upstreamHost()) {
     upstream_request.upstreamHost()->stats().rq_timeout_.inc();
   }
+  observeAbortedResponseTime(upstream_request);
 
   upstream_request.resetStream();
 
@@ -1359,6 +1361,30 @@ void Filter::updateOutlierDetection(Upstream::Outlier::Result result,
   }
 }
 
+void Filter::observeResponseTime(UpstreamRequest& upstream_request,
+                                 std::chrono::microseconds response_time) {
+  if (callbacks_->streamInfo().healthCheck() || !upstream_request.upstreamHost()) {
+    return;
+  }
+  OptRef<Upstream::HostLbPolicyData> host_lb_policy_data =
+      upstream_request.upstreamHost()->lbPolicyData();
+  if (host_lb_policy_data.has_value()) {
+    host_lb_policy_data->onResponseTime(response_time);
+  }
+}
+
+void Filter::observeAbortedResponseTime(UpstreamRequest& upstream_request) {
+  // A request which is reset before the downstream request completed has not waited for a
+  // response, so there is no response time to report.
+  if (!DateUtil::timePointValid(downstream_request_complete_time_)) {
+    return;
+  }
+  observeResponseTime(upstream_request,
+                      std::chrono::duration_cast<std::chrono::microseconds>(
+                          callbacks_->dispatcher().timeSource().monotonicTime() -
+                          downstream_request_complete_time_));
+}
+
 void Filter::chargeUpstreamAbort(Http::Code code, bool dropped, UpstreamRequest& upstream_request) {
   if (downstream_response_started_) {
     if (upstream_request.grpcRqSuccessDeferred()) {
@@ -1493,6 +1519,7 @@ void Filter::onUpstreamReset(Http::StreamResetReason reset_reason,
     // config param set to true.
     updateOutlierDetection(Upstream::Outlier::Result::LocalOriginConnectFailed, upstream_request,
                            absl::nullopt);
+    observeAbortedResponseTime(upstream_request);
   }
 
   if (maybeRetryReset(reset_reason, upstream_request, TimeoutRetry::No)) {
@@ -1859,8 +1886,11 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
     upstream_request.resetStream();
   }
   Event::Dispatcher& dispatcher = callbacks_->dispatcher();
-  std::chrono::milliseconds response_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-      dispatcher.timeSource().monotonicTime() - downstream_request_complete_time_);
+  const std::chrono::microseconds precise_response_time =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          dispatcher.timeSource().monotonicTime() - downstream_request_complete_time_);
+  std::chrono::milliseconds response_time =
+      std::chrono::duration_cast<std::chrono::milliseconds>(precise_response_time);
 
   Upstream::ClusterTimeoutBudgetStatsOptRef tb_stats = cluster()->timeoutBudgetStats();
   if (tb_stats.has_value()) {
@@ -1868,6 +1898,12 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
         FilterUtility::percentageOfTimeout(response_time, timeout_.global_timeout_));
   }
 
+  // Latency aware LB policies observe the response times of their hosts. This is independent of
+  // whether dynamic stats are emitted.
+  if (DateUtil::timePointValid(downstream_request_complete_time_)) {
+    observeResponseTime(upstream_request, precise_response_time);
+  }
+
   if (config_->emit_dynamic_stats_ && !callbacks_->streamInfo().healthCheck() &&
       DateUtil::timePointValid(downstream_request_complete_time_)) {
     upstream_request.upstreamHost()->outlierDetector().putResponseTime(response_time);
@@ -584,6 +584,13 @@ private:
                                                 uint64_t status_code);
   void updateOutlierDetection(Upstream::Outlier::Result result, UpstreamRequest& upstream_request,
                               absl::optional<uint64_t> code);
+  // Reports the time since the downstream request completed to the LB policy data of the upstream
+  // host, for latency aware LB policies.
+  void observeResponseTime(UpstreamRequest& upstream_request,
+                           std::chrono::microseconds response_time);
+  // Reports the time a request which timed out or was reset waited for its upstream host, so that
+  // a host which stops responding does not look idle to latency aware LB policies.
+  void observeAbortedResponseTime(UpstreamRequest& upstream_request);
   void doRetry(bool can_send_early_data, bool can_use_http3, TimeoutRetry is_timeout_retry);
   void continueDoRetry(bool can_send_early_data, bool can_use_http3, TimeoutRetry is_timeout_retry,
                        Upstream::HostConstSharedPtr&& host, Upstream::ThreadLocalCluster& cluster,
@@ -9,6 +9,7 @@
 #include "source/common/common/fmt.h"
 #include "source/common/common/logger.h"
 #include "source/common/config/datasource.h"
+#include "source/common/protobuf/utility.h"
 
 #include "spdlog/spdlog.h"
 
@@ -17,6 +18,9 @@ namespace Ssl {
 
 static const std::string INLINE_STRING = "<inline>";
 
+const uint32_t CertificateValidationContextConfigImpl::DEFAULT_VERIFICATION_CACHE_MAX_ENTRIES = 4096;
+const uint64_t CertificateValidationContextConfigImpl::DEFAULT_VERIFICATION_CACHE_TTL_MS = 300000;
+
 CertificateValidationContextConfigImpl::CertificateValidationContextConfigImpl(
     std::string ca_cert, std::string certificate_revocation_list,
     const envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext& config,
@@ -44,7 +48,16 @@ CertificateValidationContextConfigImpl::CertificateValidationContextConfigImpl(
       max_verify_depth_(config.has_max_verify_depth()
                             ? absl::optional<uint32_t>(config.max_verify_depth().value())
                             : absl::nullopt),
-      auto_sni_san_match_(auto_sni_san_match) {}
+      auto_sni_san_match_(auto_sni_san_match),
+      verification_cache_(
+          config.has_verification_cache()
+              ? absl::make_optional(VerificationCacheConfig{
+                    PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.verification_cache(), max_entries,
+                                                    DEFAULT_VERIFICATION_CACHE_MAX_ENTRIES),
+                    std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
+                        config.verification_cache(), ttl, DEFAULT_VERIFICATION_CACHE_TTL_MS))})
+              : absl::nullopt),
+      async_verification_threads_(config.async_verification_threads()) {}
 
 absl::StatusOr<std::unique_ptr<CertificateValidationContextConfigImpl>>
 CertificateValidationContextConfigImpl::create(
@@ -60,6 +60,15 @@ public:
 
   bool autoSniSanMatch() const override { return auto_sni_san_match_; }
 
+  const absl::optional<VerificationCacheConfig>& verificationCache() const override {
+    return verification_cache_;
+  }
+
+  uint32_t asyncVerificationThreads() const override { return async_verification_threads_; }
+
+  static const uint32_t DEFAULT_VERIFICATION_CACHE_MAX_ENTRIES;
+  static const uint64_t DEFAULT_VERIFICATION_CACHE_TTL_MS;
+
 protected:
   CertificateValidationContextConfigImpl(
       std::string ca_cert, std::string certificate_revocation_list,
@@ -86,6 +95,8 @@ private:
   const bool only_verify_leaf_cert_crl_;
   absl::optional<uint32_t> max_verify_depth_;
   const bool auto_sni_san_match_;
+  const absl::optional<VerificationCacheConfig> verification_cache_;
+  const uint32_t async_verification_threads_;
 };
 
 } // namespace Ssl
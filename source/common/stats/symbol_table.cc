@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <iostream>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 #include "source/common/common/assert.h"
@@ -261,11 +262,8 @@ bool StatName::startsWith(StatName prefix) const {
 
 std::vector<absl::string_view> SymbolTable::decodeStrings(StatName stat_name) const {
   std::vector<absl::string_view> strings;
-  Thread::LockGuard lock(lock_);
   Encoding::decodeTokens(
-      stat_name,
-      [this, &strings](Symbol symbol)
-          ABSL_NO_THREAD_SAFETY_ANALYSIS { strings.push_back(fromSymbol(symbol)); },
+      stat_name, [this, &strings](Symbol symbol) { strings.push_back(fromSymbol(symbol)); },
       [&strings](absl::string_view str) { strings.push_back(str); });
   return strings;
 }
@@ -298,6 +296,33 @@ SymbolTable::~SymbolTable() {
   ASSERT(numSymbols() == 0);
 }
 
+SymbolTable::SymbolEntries::~SymbolEntries() {
+  for (std::atomic<std::atomic<SymbolEntry*>*>& bucket_slot : buckets_) {
+    std::atomic<SymbolEntry*>* bucket = bucket_slot.load(std::memory_order_relaxed);
+    if (bucket == nullptr) {
+      continue;
+    }
+    // Entries can only remain here if StatNames were leaked, which is
+    // asserted in ~SymbolTable.
+    const size_t bucket_size = size_t(1) << (&bucket_slot - buckets_.data() + FirstBucketBits);
+    for (size_t i = 0; i < bucket_size; ++i) {
+      delete bucket[i].load(std::memory_order_relaxed);
+    }
+    delete[] bucket;
+  }
+}
+
+void SymbolTable::SymbolEntries::set(Symbol symbol, SymbolEntry* entry) {
+  const Slot slot = slotOf(symbol);
+  std::atomic<SymbolEntry*>* bucket = buckets_[slot.bucket_].load(std::memory_order_relaxed);
+  if (bucket == nullptr) {
+    // Value-initialization clears the slots.
+    bucket = new std::atomic<SymbolEntry*>[size_t(1) << (slot.bucket_ + FirstBucketBits)]();
+    buckets_[slot.bucket_].store(bucket, std::memory_order_release);
+  }
+  bucket[slot.index_].store(entry, std::memory_order_release);
+}
+
 // TODO(ambuc): There is a possible performance optimization here for avoiding
 // the encoding of IPs / numbers if they appear in stat names. We don't want to
 // waste time symbolizing an integer as an integer, if we can help it.
@@ -306,23 +331,31 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
     return;
   }
 
+  if (track_recent_lookups_.load(std::memory_order_relaxed)) {
+    Thread::LockGuard lock(recent_lookups_lock_);
+    recent_lookups_.lookup(name);
+  } else {
+    untracked_lookups_.fetch_add(1, std::memory_order_relaxed);
+  }
+
   // We want to hold the lock for the minimum amount of time, so we do the
-  // string-splitting and prepare a temp vector of Symbol first.
+  // string-splitting first.
   const std::vector<absl::string_view> tokens = absl::StrSplit(name, '.');
   std::vector<Symbol> symbols;
-  symbols.reserve(tokens.size());
 
-  // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
-  {
-    Thread::LockGuard lock(lock_);
-    recent_lookups_.lookup(name);
-    for (auto& token : tokens) {
+  // Now populate the Symbol objects, which involves bumping ref-counts in this.
+  // Tokens which are already in the table, as is usual once a name has been
+  // encoded before, only need the lock shared.
+  if (!findSymbols(tokens, symbols)) {
+    absl::MutexLock lock(&lock_);
+    for (size_t i = 0; i < tokens.size(); ++i) {
       // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
       // length below some threshold, say 4 bytes. It might be preferable not to
       // reserve Symbols for every 3 digit number found (for example) in ipv4
       // addresses.
-      symbols.push_back(toSymbol(token));
+      if (symbols[i] == 0) {
+        symbols[i] = toSymbol(tokens[i]);
+      }
     }
   }
 
@@ -330,9 +363,28 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
   encoding.addSymbols(symbols);
 }
 
+bool SymbolTable::findSymbols(const std::vector<absl::string_view>& tokens,
+                              std::vector<Symbol>& symbols) {
+  symbols.reserve(tokens.size());
+  bool found_all = true;
+  absl::ReaderMutexLock lock(&lock_);
+  for (absl::string_view token : tokens) {
+    auto encode_find = encode_map_.find(token);
+    if (encode_find == encode_map_.end()) {
+      symbols.push_back(0);
+      found_all = false;
+      continue;
+    }
+    // The entry cannot be removed while the lock is held, even shared.
+    SymbolEntry* entry = encode_find->second;
+    entry->ref_count_.fetch_add(1, std::memory_order_relaxed);
+    symbols.push_back(entry->symbol_);
+  }
+  return found_all;
+}
+
 uint64_t SymbolTable::numSymbols() const {
-  Thread::LockGuard lock(lock_);
-  ASSERT(encode_map_.size() == decode_map_.size());
+  absl::ReaderMutexLock lock(&lock_);
   return encode_map_.size();
 }
 
@@ -344,21 +396,15 @@ void SymbolTable::incRefCount(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
+    // The caller holds a reference to stat_name, so the entry can be found
+    // and its count bumped without a lock, as it cannot be removed meanwhile.
+    SymbolEntry* entry = entries_.find(symbol);
+    ASSERT(entry != nullptr, "Please see "
+                             "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
+                             "debugging-symbol-table-assertions");
 
-    ASSERT(decode_search != decode_map_.end(),
-           "Please see "
-           "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
-           "debugging-symbol-table-assertions");
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end(),
-           "Please see "
-           "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
-           "debugging-symbol-table-assertions");
-
-    ++encode_search->second.ref_count_;
+    entry->ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
@@ -366,24 +412,28 @@ void SymbolTable::free(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
+  absl::InlinedVector<SymbolEntry*, 8> last_references;
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
-
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end());
+    SymbolEntry* entry = entries_.find(symbol);
+    ASSERT(entry != nullptr);
+    if (!entry->releaseUnlessLast()) {
+      last_references.push_back(entry);
+    }
+  }
+  if (last_references.empty()) {
+    return;
+  }
 
+  absl::MutexLock lock(&lock_);
+  for (SymbolEntry* entry : last_references) {
     // If that was the last remaining client usage of the symbol, erase the
-    // current mappings and add the now-unused symbol to the reuse pool.
-    //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
-      decode_map_.erase(decode_search);
-      encode_map_.erase(encode_search);
-      pool_.push(symbol);
+    // current mappings and add the now-unused symbol to the reuse pool. Another
+    // thread may have encoded the token again before we took the lock.
+    if (entry->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      encode_map_.erase(entry->str_->toStringView());
+      entries_.set(entry->symbol_, nullptr);
+      pool_.push(entry->symbol_);
+      delete entry;
     }
   }
 }
@@ -392,15 +442,16 @@ uint64_t SymbolTable::getRecentLookups(const RecentLookupsFn& iter) const {
   uint64_t total = 0;
   absl::flat_hash_map<std::string, uint64_t> name_count_map;
 
-  // We don't want to hold lock_ while calling the iterator, but we need it to
-  // access recent_lookups_, so we buffer in name_count_map.
+  // We don't want to hold recent_lookups_lock_ while calling the iterator, but
+  // we need it to access recent_lookups_, so we buffer in name_count_map.
   {
-    Thread::LockGuard lock(lock_);
+    Thread::LockGuard lock(recent_lookups_lock_);
     recent_lookups_.forEach(
         [&name_count_map](absl::string_view str, uint64_t count)
             ABSL_NO_THREAD_SAFETY_ANALYSIS { name_count_map[std::string(str)] += count; });
     total += recent_lookups_.total();
   }
+  total += untracked_lookups_.load(std::memory_order_relaxed);
 
   // Now we have the collated name-count map data: we need to vectorize and
   // sort. We define the pair with the count first as std::pair::operator<
@@ -444,17 +495,19 @@ DynamicSpans SymbolTable::getDynamicSpans(StatName stat_name) const {
 }
 
 void SymbolTable::setRecentLookupCapacity(uint64_t capacity) {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   recent_lookups_.setCapacity(capacity);
+  track_recent_lookups_.store(capacity > 0, std::memory_order_relaxed);
 }
 
 void SymbolTable::clearRecentLookups() {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   recent_lookups_.clear();
+  untracked_lookups_.store(0, std::memory_order_relaxed);
 }
 
 uint64_t SymbolTable::recentLookupCapacity() const {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   return recent_lookups_.capacity();
 }
 
@@ -465,39 +518,38 @@ StatNameSetPtr SymbolTable::makeSet(absl::string_view name) {
 }
 
 Symbol SymbolTable::toSymbol(absl::string_view sv) {
-  Symbol result;
   auto encode_find = encode_map_.find(sv);
-  // If the string segment doesn't already exist,
-  if (encode_find == encode_map_.end()) {
-    // We create the actual string, place it in the decode_map_, and then insert
-    // a string_view pointing to it in the encode_map_. This allows us to only
-    // store the string once. We use unique_ptr so copies are not made as
-    // flat_hash_map moves values around.
-    InlineStringPtr str = InlineString::create(sv);
-    auto encode_insert = encode_map_.insert({str->toStringView(), SharedSymbol(next_symbol_)});
-    ASSERT(encode_insert.second);
-    auto decode_insert = decode_map_.insert({next_symbol_, std::move(str)});
-    ASSERT(decode_insert.second);
-
-    result = next_symbol_;
-    newSymbol();
-  } else {
-    // If the insertion didn't take place, return the actual value at that location and up the
-    // refcount at that location
-    result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
-  }
+  if (encode_find != encode_map_.end()) {
+    // The token already exists, so up its refcount. It may have been added
+    // since findSymbols() looked for it, or appear twice in the name.
+    SymbolEntry* entry = encode_find->second;
+    entry->ref_count_.fetch_add(1, std::memory_order_relaxed);
+    return entry->symbol_;
+  }
+
+  // We create the entry holding the actual string, and then insert a
+  // string_view pointing to it in the encode map. This allows us to only store
+  // the string once. The entry is published for decoding before the symbol is
+  // handed out to the caller.
+  auto entry = std::make_unique<SymbolEntry>(sv, next_symbol_);
+  auto encode_insert = encode_map_.insert({entry->str_->toStringView(), entry.get()});
+  ASSERT(encode_insert.second);
+  ASSERT(entries_.find(next_symbol_) == nullptr);
+  entries_.set(next_symbol_, entry.get());
+  entry.release();
+
+  const Symbol result = next_symbol_;
+  newSymbol();
   return result;
 }
 
-absl::string_view SymbolTable::fromSymbol(const Symbol symbol) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
-  auto search = decode_map_.find(symbol);
-  RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
-  return search->second->toStringView();
+absl::string_view SymbolTable::fromSymbol(const Symbol symbol) const {
+  const SymbolEntry* entry = entries_.find(symbol);
+  RELEASE_ASSERT(entry != nullptr, "no such symbol");
+  return entry->str_->toStringView();
 }
 
-void SymbolTable::newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+void SymbolTable::newSymbol() {
   if (pool_.empty()) {
     next_symbol_ = ++monotonic_counter_;
   } else {
@@ -509,15 +561,6 @@ void SymbolTable::newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
 }
 
 bool SymbolTable::lessThan(const StatName& a, const StatName& b) const {
-  // Proactively take the table lock in anticipation that we'll need to
-  // convert at least one symbol to a string_view, and it's easier not to
-  // bother to lazily take the lock.
-  Thread::LockGuard lock(lock_);
-  return lessThanLockHeld(a, b);
-}
-
-bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
   Encoding::TokenIter a_iter(a), b_iter(b);
   while (true) {
     Encoding::TokenIter::TokenType a_type = a_iter.next();
@@ -547,16 +590,14 @@ bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTable::debugPrint() const {
-  Thread::LockGuard lock(lock_);
-  std::vector<Symbol> symbols;
-  for (const auto& p : decode_map_) {
-    symbols.push_back(p.first);
+  absl::ReaderMutexLock lock(&lock_);
+  std::vector<std::tuple<Symbol, absl::string_view, uint32_t>> symbols;
+  for (const auto& p : encode_map_) {
+    symbols.emplace_back(p.second->symbol_, p.first, p.second->ref_count_.load());
   }
   std::sort(symbols.begin(), symbols.end());
-  for (Symbol symbol : symbols) {
-    const InlineString& token = *decode_map_.find(symbol)->second;
-    const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+  for (const auto& [symbol, token, ref_count] : symbols) {
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token, ref_count);
   }
 }
 #endif
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <stack>
 #include <string>
@@ -17,8 +19,10 @@
 #include "absl/container/fixed_array.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Stats {
@@ -324,8 +328,6 @@ public:
    */
   DynamicSpans getDynamicSpans(StatName stat_name) const;
 
-  bool lessThanLockHeld(const StatName& a, const StatName& b) const;
-
   template <class GetStatName, class Obj> struct StatNameCompare {
     StatNameCompare(const SymbolTable& symbol_table, GetStatName getter)
         : symbol_table_(symbol_table), getter_(getter) {}
@@ -337,9 +339,8 @@ public:
   };
 
   /**
-   * Sorts a range by StatName. This API is more efficient than
-   * calling std::sort directly as it takes a single lock for the
-   * entire sort, rather than locking on each comparison.
+   * Sorts a range by StatName. Decoding symbols does not take any locks, so
+   * this is equivalent to calling std::sort with lessThan().
    *
    * @param begin the beginning of the range to sort
    * @param end the end of the range to sort
@@ -347,9 +348,6 @@ public:
    */
   template <class Obj, class Iter, class GetStatName>
   void sortByStatNames(Iter begin, Iter end, GetStatName get_stat_name) const {
-    // Grab the lock once before sorting begins, so we don't have to re-take
-    // it on every comparison.
-    Thread::LockGuard lock(lock_);
     StatNameCompare<GetStatName, Obj> compare(*this, get_stat_name);
     std::sort(begin, end, compare);
   }
@@ -395,15 +393,94 @@ private:
    */
   void incRefCount(const StatName& stat_name);
 
-  struct SharedSymbol {
-    SharedSymbol(Symbol symbol) : symbol_(symbol) {}
+  // A symbol together with the string it represents. Entries are owned by the
+  // SymbolTable, and are deleted when their reference count drops to zero.
+  struct SymbolEntry {
+    SymbolEntry(absl::string_view str, Symbol symbol)
+        : str_(InlineString::create(str)), symbol_(symbol) {}
+
+    /**
+     * Drops a reference without locking, unless it is the last one.
+     * @return false if this is the last reference, which must be dropped
+     *         while holding the table's lock exclusively.
+     */
+    bool releaseUnlessLast() {
+      uint32_t count = ref_count_.load(std::memory_order_relaxed);
+      while (count > 1) {
+        if (ref_count_.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    const InlineStringPtr str_;
+    const Symbol symbol_;
+    // May be incremented by a holder of a reference without a lock, or after
+    // an encode map lookup while holding the table's lock shared. It only drops
+    // to zero while the lock is held exclusively, so an entry cannot be revived
+    // once it is removed.
+    std::atomic<uint32_t> ref_count_{1};
+  };
+
+  /**
+   * Maps symbols to their entries. Lookups are lock-free, so that decoding
+   * symbols back to strings never contends with encoding. This is safe because
+   * a caller decoding a symbol always holds a reference to it, so the entry
+   * cannot be removed while it is being read.
+   *
+   * Symbols are allocated densely from FirstValidSymbol, so the map is an array
+   * split into buckets of doubling size, which lets it grow without moving any
+   * slot. Buckets are allocated on demand and are only freed when the table is
+   * destroyed, so the map costs at most two pointers per symbol allocated at
+   * once, and nothing for an empty table.
+   */
+  class SymbolEntries {
+  public:
+    ~SymbolEntries();
+
+    SymbolEntry* find(Symbol symbol) const {
+      const Slot slot = slotOf(symbol);
+      const std::atomic<SymbolEntry*>* bucket =
+          buckets_[slot.bucket_].load(std::memory_order_acquire);
+      if (bucket == nullptr) {
+        return nullptr;
+      }
+      return bucket[slot.index_].load(std::memory_order_acquire);
+    }
+
+    /**
+     * Sets or clears the entry for a symbol. Must be called with the table's
+     * lock held exclusively.
+     */
+    void set(Symbol symbol, SymbolEntry* entry);
 
-    Symbol symbol_;
-    uint32_t ref_count_{1};
+  private:
+    // The first bucket holds 2^FirstBucketBits symbols.
+    static constexpr uint32_t FirstBucketBits = 5;
+    static constexpr uint32_t NumBuckets = 8 * sizeof(Symbol) + 1 - FirstBucketBits;
+
+    struct Slot {
+      uint32_t bucket_;
+      uint64_t index_;
+    };
+
+    static Slot slotOf(Symbol symbol) {
+      // Bucket b holds the 2^(b + FirstBucketBits) positions from 2^(b + FirstBucketBits).
+      const uint64_t position = static_cast<uint64_t>(symbol) + (uint64_t(1) << FirstBucketBits);
+      const uint32_t bucket_bits = absl::bit_width(position) - 1;
+      return {bucket_bits - FirstBucketBits, position - (uint64_t(1) << bucket_bits)};
+    }
+
+    std::array<std::atomic<std::atomic<SymbolEntry*>*>, NumBuckets> buckets_{};
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // Encoding a name looks up the existing tokens while holding lock_ shared, so
+  // threads encoding existing names do not serialize. It is only held
+  // exclusively to add or remove tokens. Taking it shared still writes the
+  // mutex word, so encoding threads share its cache line; the lookup itself is
+  // not lock-free.
+  mutable absl::Mutex lock_;
 
   /**
    * Decodes a uint8_t array into an array of period-delimited strings. Note
@@ -429,17 +506,18 @@ private:
   Symbol toSymbol(absl::string_view sv) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   /**
-   * Convenience function for decode(), decoding one symbol at a time.
+   * Convenience function for decode(), decoding one symbol at a time. The
+   * caller must hold a reference to the symbol.
    *
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const;
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
    */
-  void newSymbol();
+  void newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   /**
    * Tokenizes name, finds or allocates symbols for each token, and adds them
@@ -451,30 +529,43 @@ private:
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     return monotonic_counter_;
   }
 
+  /**
+   * Finds the symbols of the tokens already in the table, taking a reference to
+   * each, while holding lock_ shared.
+   *
+   * @param tokens the tokens to look up.
+   * @param symbols receives the symbol of each token, or 0 if it is not in the table.
+   * @return whether all the tokens were found.
+   */
+  bool findSymbols(const std::vector<absl::string_view>& tokens, std::vector<Symbol>& symbols);
+
+  // Using absl::string_view lets us only store the complete string once, in the entry.
+  absl::flat_hash_map<absl::string_view, SymbolEntry*> encode_map_ ABSL_GUARDED_BY(lock_);
+  SymbolEntries entries_;
+
   // Stores the symbol to be used at next insertion. This should exist ahead of insertion time so
   // that if insertion succeeds, the value written is the correct one.
   Symbol next_symbol_ ABSL_GUARDED_BY(lock_);
 
   // If the free pool is exhausted, we monotonically increase this counter.
-  Symbol monotonic_counter_;
-
-  // Bitmap implementation.
-  // The encode map stores both the symbol and the ref count of that symbol.
-  // Using absl::string_view lets us only store the complete string once, in the decode map.
-  using EncodeMap = absl::flat_hash_map<absl::string_view, SharedSymbol>;
-  using DecodeMap = absl::flat_hash_map<Symbol, InlineStringPtr>;
-  EncodeMap encode_map_ ABSL_GUARDED_BY(lock_);
-  DecodeMap decode_map_ ABSL_GUARDED_BY(lock_);
+  Symbol monotonic_counter_ ABSL_GUARDED_BY(lock_);
 
   // Free pool of symbols for re-use.
   // TODO(ambuc): There might be an optimization here relating to storing ranges of freed symbols
   // using an Envoy::IntervalSet.
   std::stack<Symbol> pool_ ABSL_GUARDED_BY(lock_);
-  RecentLookups recent_lookups_ ABSL_GUARDED_BY(lock_);
+
+  // Recent lookups are only recorded under recent_lookups_lock_ when a capacity
+  // has been set. Otherwise only the count is kept, in untracked_lookups_, so
+  // that encoding does not serialize on a single lock.
+  mutable Thread::MutexBasicLockable recent_lookups_lock_;
+  RecentLookups recent_lookups_ ABSL_GUARDED_BY(recent_lookups_lock_);
+  std::atomic<bool> track_recent_lookups_{false};
+  std::atomic<uint64_t> untracked_lookups_{0};
 };
 
 // Base class for holding the backing-storing for a StatName. The two derived
@@ -1065,7 +1156,7 @@ template <class GetStatName, class Obj>
 bool SymbolTable::StatNameCompare<GetStatName, Obj>::operator()(const Obj& a, const Obj& b) const {
   StatName a_stat_name = getter_(a);
   StatName b_stat_name = getter_(b);
-  return symbol_table_.lessThanLockHeld(a_stat_name, b_stat_name);
+  return symbol_table_.lessThan(a_stat_name, b_stat_name);
 }
 
 using SymbolTablePtr = std::unique_ptr<SymbolTable>;
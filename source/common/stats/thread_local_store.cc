@@ -234,10 +234,17 @@ void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
     ASSERT(!merge_in_progress_);
     merge_in_progress_ = true;
     tls_cache_->runOnAllThreads(
-        [](OptRef<TlsCache> tls_cache) {
+        [this](OptRef<TlsCache> tls_cache) {
+          std::vector<uint64_t> recorded_ids;
           for (const auto& id_hist : tls_cache->tls_histogram_cache_) {
             const TlsHistogramSharedPtr& tls_hist = id_hist.second;
-            tls_hist->beginMerge();
+            if (tls_hist->beginMerge()) {
+              recorded_ids.push_back(id_hist.first);
+            }
+          }
+          if (!recorded_ids.empty()) {
+            Thread::LockGuard lock(recorded_histograms_mutex_);
+            recorded_histogram_ids_.insert(recorded_ids.begin(), recorded_ids.end());
           }
         },
         [this, merge_complete_cb]() -> void { mergeInternal(merge_complete_cb); });
@@ -249,7 +256,17 @@ void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
 
 void ThreadLocalStoreImpl::mergeInternal(PostMergeCb merge_complete_cb) {
   if (!shutting_down_) {
-    forEachHistogram(nullptr, [](ParentHistogram& histogram) { histogram.merge(); });
+    absl::flat_hash_set<uint64_t> recorded_ids;
+    {
+      Thread::LockGuard lock(recorded_histograms_mutex_);
+      recorded_ids.swap(recorded_histogram_ids_);
+    }
+    {
+      Thread::LockGuard lock(hist_mutex_);
+      for (ParentHistogramImpl* histogram : histogram_set_) {
+        histogram->mergeInterval(recorded_ids.contains(histogram->id()));
+      }
+    }
     merge_complete_cb();
     merge_in_progress_ = false;
   }
@@ -821,13 +838,19 @@ ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
   hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  recorded_[current_active_] = true;
   used_ = true;
 }
 
 void ThreadLocalHistogramImpl::merge(histogram_t* target) {
-  histogram_t** other_histogram = &histograms_[otherHistogramIndex()];
+  const uint64_t other_index = otherHistogramIndex();
+  if (!recorded_[other_index]) {
+    return;
+  }
+  histogram_t** other_histogram = &histograms_[other_index];
   hist_accumulate(target, other_histogram, 1);
   hist_clear(*other_histogram);
+  recorded_[other_index] = false;
 }
 
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
@@ -929,6 +952,21 @@ void ParentHistogramImpl::merge() {
     cumulative_statistics_.refresh(cumulative_histogram_);
     interval_statistics_.refresh(interval_histogram_);
     merged_ = true;
+    interval_empty_ = false;
+  }
+}
+
+void ParentHistogramImpl::mergeInterval(bool values_recorded) {
+  // A histogram that has never been merged takes the full path so that used() is decided exactly
+  // as in merge(). This is cheap, as such a histogram has few or no TLS histograms.
+  if (values_recorded || !merged_) {
+    merge();
+    return;
+  }
+  if (!interval_empty_) {
+    hist_clear(interval_histogram_);
+    interval_statistics_.refresh(interval_histogram_);
+    interval_empty_ = true;
   }
 }
 
@@ -21,6 +21,7 @@
 #include "source/common/stats/utility.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "circllhist.h"
 
 namespace Envoy {
@@ -42,11 +43,14 @@ public:
   /**
    * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
    * not have to lock the histogram in high throughput TLS writes.
+   * @return true if any values were recorded into the histogram swapped out for merging.
    */
-  void beginMerge() {
+  bool beginMerge() {
     // This switches the current_active_ between 1 and 0.
     ASSERT(std::this_thread::get_id() == created_thread_id_);
+    const bool recorded = recorded_[current_active_];
     current_active_ = otherHistogramIndex();
+    return recorded;
   }
 
   // Stats::Histogram
@@ -67,6 +71,10 @@ private:
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_{0};
   histogram_t* histograms_[2];
+  // Whether each of histograms_ has had values recorded since it was last merged. The active
+  // histogram's flag is only written by the owning thread; the other is only touched during merge,
+  // which is sequenced after beginMerge() by the cross-thread post.
+  bool recorded_[2]{false, false};
   std::atomic<bool> used_;
   std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -100,6 +108,16 @@ public:
    */
   void merge() override;
 
+  /**
+   * Merges the histogram at the end of an interval. When no thread recorded a value during the
+   * interval the cumulative histogram is unchanged, so only the interval histogram is reset, and
+   * only if it is not already empty.
+   * @param values_recorded whether any thread recorded a value during the interval.
+   */
+  void mergeInterval(bool values_recorded);
+
+  uint64_t id() const { return id_; }
+
   const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
   const HistogramStatistics& cumulativeStatistics() const override {
     return cumulative_statistics_;
@@ -141,6 +159,7 @@ private:
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ ABSL_GUARDED_BY(merge_lock_);
   bool merged_{false};
+  bool interval_empty_{true};
   std::atomic<bool> shutting_down_{false};
   std::atomic<uint32_t> ref_count_{0};
   const uint64_t id_; // Index into TlsCache::histogram_cache_.
@@ -551,6 +570,12 @@ private:
   std::atomic<uint64_t> next_scope_id_{};
   uint64_t next_histogram_id_ ABSL_GUARDED_BY(hist_mutex_) = 0;
 
+  // IDs of histograms that had values recorded on any thread since the last merge, collected by
+  // the workers as they swap their TLS histograms so that idle histograms can skip the merge.
+  Thread::MutexBasicLockable recorded_histograms_mutex_;
+  absl::flat_hash_set<uint64_t>
+      recorded_histogram_ids_ ABSL_GUARDED_BY(recorded_histograms_mutex_);
+
   StatNameSetPtr well_known_tags_;
 
   mutable Thread::MutexBasicLockable hist_mutex_;
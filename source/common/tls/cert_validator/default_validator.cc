@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 
+#include "envoy/event/dispatcher.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
@@ -52,9 +53,26 @@ DefaultCertValidator::DefaultCertValidator(
     allow_untrusted_certificate_ = config_->trustChainVerification() ==
                                    envoy::extensions::transport_sockets::tls::v3::
                                        CertificateValidationContext::ACCEPT_UNTRUSTED;
+    if (config_->verificationCache().has_value()) {
+      verification_cache_ = std::make_unique<VerificationCache>(
+          config_->verificationCache()->max_entries_, config_->verificationCache()->ttl_,
+          context_.timeSource());
+    }
+    if (config_->asyncVerificationThreads() > 0) {
+      verification_thread_pool_ =
+          VerificationThreadPoolRegistry::get(context_.singletonManager())
+              ->getOrCreate(config_->asyncVerificationThreads(), context_.api().threadFactory());
+      verification_jobs_ = std::make_shared<VerificationThreadPool::JobGroup>();
+    }
   }
 };
 
+DefaultCertValidator::~DefaultCertValidator() {
+  if (verification_jobs_ != nullptr) {
+    verification_jobs_->cancelAndWait();
+  }
+}
+
 absl::StatusOr<int> DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
                                                                 bool provides_certificates) {
 
@@ -297,7 +315,7 @@ DefaultCertValidator::verifyCertificate(X509* cert, const std::vector<std::strin
 }
 
 ValidationResults DefaultCertValidator::doVerifyCertChain(
-    STACK_OF(X509)& cert_chain, Ssl::ValidateResultCallbackPtr /*callback*/,
+    STACK_OF(X509)& cert_chain, Ssl::ValidateResultCallbackPtr callback,
     const Network::TransportSocketOptionsConstSharedPtr& transport_socket_options, SSL_CTX& ssl_ctx,
     const CertValidator::ExtraValidationContext& /*validation_context*/, bool is_server,
     absl::string_view host_name) {
@@ -308,6 +326,59 @@ ValidationResults DefaultCertValidator::doVerifyCertChain(
     return {ValidationResults::ValidationStatus::Failed,
             Envoy::Ssl::ClientValidationStatus::NoClientCertificate, absl::nullopt, error};
   }
+  absl::optional<VerificationCache::Key> cache_key;
+  if (verify_trusted_ca_ && verification_cache_ != nullptr) {
+    cache_key = VerificationCache::key(cert_chain, is_server);
+    if (verification_cache_->lookup(*cache_key)) {
+      stats_.verification_cache_hit_.inc();
+      return verifyLeafCert(sk_X509_value(&cert_chain, 0), host_name,
+                            transport_socket_options.get(),
+                            Envoy::Ssl::ClientValidationStatus::Validated);
+    }
+    stats_.verification_cache_miss_.inc();
+  }
+  // Only trust chain verification is worth offloading. The callback is not provided by callers
+  // which cannot handle asynchronous validation.
+  if (verification_thread_pool_ != nullptr && verify_trusted_ca_ && callback != nullptr) {
+    return verifyCertChainAsync(cert_chain, std::move(callback), transport_socket_options, ssl_ctx,
+                                is_server, host_name, cache_key);
+  }
+  return verifyCertChain(cert_chain, transport_socket_options.get(), ssl_ctx, is_server, host_name,
+                         cache_key);
+}
+
+ValidationResults DefaultCertValidator::verifyCertChainAsync(
+    STACK_OF(X509)& cert_chain, Ssl::ValidateResultCallbackPtr callback,
+    const Network::TransportSocketOptionsConstSharedPtr& transport_socket_options, SSL_CTX& ssl_ctx,
+    bool is_server, absl::string_view host_name,
+    const absl::optional<VerificationCache::Key>& cache_key) {
+  // The chain belongs to the connection, which may be closed before the verification runs, so the
+  // job holds its own references to the certificates. The SSL_CTX belongs to the context, which
+  // outlives this validator, which in turn outlives its jobs.
+  bssl::UniquePtr<STACK_OF(X509)> chain(X509_chain_up_ref(&cert_chain));
+  RELEASE_ASSERT(chain != nullptr, "");
+  verification_thread_pool_->post(
+      verification_jobs_,
+      [this, chain = std::move(chain), callback = std::move(callback), transport_socket_options,
+       &ssl_ctx, is_server, host = std::string(host_name), cache_key]() mutable {
+        ValidationResults result = verifyCertChain(*chain, transport_socket_options.get(), ssl_ctx,
+                                                   is_server, host, cache_key);
+        Event::Dispatcher& dispatcher = callback->dispatcher();
+        dispatcher.post([callback = std::move(callback), result = std::move(result)]() {
+          callback->onCertValidationResult(
+              result.status == ValidationResults::ValidationStatus::Successful,
+              result.detailed_status, result.error_details.value_or(""),
+              result.tls_alert.value_or(SSL_AD_CERTIFICATE_UNKNOWN));
+        });
+      });
+  return {ValidationResults::ValidationStatus::Pending,
+          Envoy::Ssl::ClientValidationStatus::NotValidated, absl::nullopt, absl::nullopt};
+}
+
+ValidationResults DefaultCertValidator::verifyCertChain(
+    STACK_OF(X509)& cert_chain, const Network::TransportSocketOptions* transport_socket_options,
+    SSL_CTX& ssl_ctx, bool is_server, absl::string_view host_name,
+    const absl::optional<VerificationCache::Key>& cache_key) {
   Envoy::Ssl::ClientValidationStatus detailed_status =
       Envoy::Ssl::ClientValidationStatus::NotValidated;
   X509* leaf_cert = sk_X509_value(&cert_chain, 0);
@@ -348,12 +419,30 @@ ValidationResults DefaultCertValidator::doVerifyCertChain(
               SSL_alert_from_verify_result(X509_STORE_CTX_get_error(ctx.get())), error};
     }
     detailed_status = Envoy::Ssl::ClientValidationStatus::Validated;
+
+    if (cache_key.has_value()) {
+      // The result is only valid while all the certificates of the verified chain are, unless
+      // their expiration is ignored.
+      SystemTime not_after = SystemTime::max();
+      if (!config_->allowExpiredCertificate()) {
+        for (const X509* cert : X509_STORE_CTX_get0_chain(ctx.get())) {
+          not_after = std::min(not_after, Utility::getExpirationTime(*cert));
+        }
+      }
+      verification_cache_->insert(*cache_key, not_after);
+    }
   }
+  return verifyLeafCert(leaf_cert, host_name, transport_socket_options, detailed_status);
+}
+
+ValidationResults DefaultCertValidator::verifyLeafCert(
+    X509* leaf_cert, absl::string_view sni,
+    const Network::TransportSocketOptions* transport_socket_options,
+    Envoy::Ssl::ClientValidationStatus detailed_status) {
   std::string error_details;
   uint8_t tls_alert = SSL_AD_CERTIFICATE_UNKNOWN;
-  const bool succeeded =
-      verifyCertAndUpdateStatus(leaf_cert, host_name, transport_socket_options.get(),
-                                detailed_status, &error_details, &tls_alert);
+  const bool succeeded = verifyCertAndUpdateStatus(leaf_cert, sni, transport_socket_options,
+                                                   detailed_status, &error_details, &tls_alert);
   return succeeded ? ValidationResults{ValidationResults::ValidationStatus::Successful,
                                        detailed_status, absl::nullopt, absl::nullopt}
                    : ValidationResults{ValidationResults::ValidationStatus::Failed, detailed_status,
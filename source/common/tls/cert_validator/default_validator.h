@@ -21,6 +21,8 @@
 #include "source/common/stats/symbol_table.h"
 #include "source/common/tls/cert_validator/cert_validator.h"
 #include "source/common/tls/cert_validator/san_matcher.h"
+#include "source/common/tls/cert_validator/verification_cache.h"
+#include "source/common/tls/cert_validator/verification_thread_pool.h"
 #include "source/common/tls/stats.h"
 
 #include "absl/synchronization/mutex.h"
@@ -37,7 +39,7 @@ public:
   DefaultCertValidator(const Envoy::Ssl::CertificateValidationContextConfig* config,
                        SslStats& stats, Server::Configuration::CommonFactoryContext& context);
 
-  ~DefaultCertValidator() override = default;
+  ~DefaultCertValidator() override;
 
   // Tls::CertValidator
   absl::Status addClientValidationContext(SSL_CTX* context, bool require_client_cert) override;
@@ -104,6 +106,23 @@ public:
                                   const std::vector<SanMatcherPtr>& subject_alt_name_matchers);
 
 private:
+  // Verifies a chain on the calling thread, adding it to the verification cache under cache_key if
+  // its trust chain verification succeeds.
+  ValidationResults verifyCertChain(STACK_OF(X509)& cert_chain,
+                                    const Network::TransportSocketOptions* transport_socket_options,
+                                    SSL_CTX& ssl_ctx, bool is_server, absl::string_view host_name,
+                                    const absl::optional<VerificationCache::Key>& cache_key);
+  // Verifies a chain on the verification thread pool, passing the result to the callback on its
+  // dispatcher.
+  ValidationResults verifyCertChainAsync(
+      STACK_OF(X509)& cert_chain, Ssl::ValidateResultCallbackPtr callback,
+      const Network::TransportSocketOptionsConstSharedPtr& transport_socket_options,
+      SSL_CTX& ssl_ctx, bool is_server, absl::string_view host_name,
+      const absl::optional<VerificationCache::Key>& cache_key);
+  // Verifies the leaf certificate's SANs and hashes, given the result of trust chain verification.
+  ValidationResults verifyLeafCert(X509* leaf_cert, absl::string_view sni,
+                                   const Network::TransportSocketOptions* transport_socket_options,
+                                   Envoy::Ssl::ClientValidationStatus detailed_status);
   bool verifyCertAndUpdateStatus(X509* leaf_cert, absl::string_view sni,
                                  const Network::TransportSocketOptions* transport_socket_options,
                                  Envoy::Ssl::ClientValidationStatus& detailed_status,
@@ -121,6 +140,9 @@ private:
   bool allow_untrusted_certificate_{false};
   bool verify_trusted_ca_{false};
   const bool auto_sni_san_match_{false};
+  VerificationCachePtr verification_cache_;
+  VerificationThreadPoolSharedPtr verification_thread_pool_;
+  VerificationThreadPool::JobGroupSharedPtr verification_jobs_;
 };
 
 DECLARE_FACTORY(DefaultCertValidatorFactory);
@@ -0,0 +1,77 @@
+#include "source/common/tls/cert_validator/verification_cache.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+
+#include "openssl/digest.h"
+#include "openssl/x509.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+VerificationCache::VerificationCache(uint32_t max_entries, std::chrono::milliseconds ttl,
+                                     TimeSource& time_source)
+    : max_entries_(max_entries), ttl_(ttl), time_source_(time_source) {}
+
+VerificationCache::Key VerificationCache::key(STACK_OF(X509)& cert_chain, bool is_server) {
+  bssl::ScopedEVP_MD_CTX md;
+  int rc = EVP_DigestInit(md.get(), EVP_sha256());
+  RELEASE_ASSERT(rc == 1, "");
+  const uint8_t side = is_server ? 1 : 0;
+  rc = EVP_DigestUpdate(md.get(), &side, sizeof(side));
+  RELEASE_ASSERT(rc == 1, "");
+  for (const X509* cert : &cert_chain) {
+    uint8_t cert_digest[SHA256_DIGEST_LENGTH];
+    unsigned int cert_digest_length;
+    rc = X509_digest(cert, EVP_sha256(), cert_digest, &cert_digest_length);
+    RELEASE_ASSERT(rc == 1 && cert_digest_length == SHA256_DIGEST_LENGTH, "");
+    rc = EVP_DigestUpdate(md.get(), cert_digest, cert_digest_length);
+    RELEASE_ASSERT(rc == 1, "");
+  }
+  Key key;
+  rc = EVP_DigestFinal(md.get(), key.data(), nullptr);
+  RELEASE_ASSERT(rc == 1, "");
+  return key;
+}
+
+bool VerificationCache::lookup(const Key& key) {
+  const SystemTime now = time_source_.systemTime();
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return false;
+  }
+  if (it->second->expiry_ <= now) {
+    entries_.erase(it->second);
+    index_.erase(it);
+    return false;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return true;
+}
+
+void VerificationCache::insert(const Key& key, SystemTime not_after) {
+  const SystemTime expiry =
+      std::min<SystemTime>(time_source_.systemTime() + ttl_, not_after);
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    it->second->expiry_ = expiry;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+  if (entries_.size() >= max_entries_) {
+    index_.erase(entries_.back().key_);
+    entries_.pop_back();
+  }
+  entries_.push_front({key, expiry});
+  index_.emplace(key, entries_.begin());
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
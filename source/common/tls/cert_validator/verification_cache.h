@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <list>
+
+#include "envoy/common/time.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/sha.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A cache of the certificate chains whose trust chain verification succeeded, shared by the
+ * threads using a validator. Entries expire after a fixed time, or when a certificate of the
+ * verified chain expires if that is sooner, and the least recently used entry is replaced when the
+ * cache is full.
+ */
+class VerificationCache {
+public:
+  using Key = std::array<uint8_t, SHA256_DIGEST_LENGTH>;
+
+  VerificationCache(uint32_t max_entries, std::chrono::milliseconds ttl, TimeSource& time_source);
+
+  /**
+   * @return the key of a certificate chain: a digest of its certificates and of whether it is
+   * verified as a client chain (by a server) or a server chain (by a client).
+   */
+  static Key key(STACK_OF(X509)& cert_chain, bool is_server);
+
+  /**
+   * @return whether the verification of a chain succeeded and has not expired.
+   */
+  bool lookup(const Key& key);
+
+  /**
+   * Records that the verification of a chain succeeded.
+   * @param key the chain's key.
+   * @param not_after the earliest expiration time of the certificates in the verified chain.
+   */
+  void insert(const Key& key, SystemTime not_after);
+
+private:
+  struct Entry {
+    Key key_;
+    SystemTime expiry_;
+  };
+  using EntryList = std::list<Entry>;
+
+  const uint32_t max_entries_;
+  const std::chrono::milliseconds ttl_;
+  TimeSource& time_source_;
+  absl::Mutex mutex_;
+  // Most recently used first.
+  EntryList entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<Key, EntryList::iterator> index_ ABSL_GUARDED_BY(mutex_);
+};
+
+using VerificationCachePtr = std::unique_ptr<VerificationCache>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
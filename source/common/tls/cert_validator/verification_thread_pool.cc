@@ -0,0 +1,108 @@
+#include "source/common/tls/cert_validator/verification_thread_pool.h"
+
+#include <utility>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+void VerificationThreadPool::JobGroup::cancelAndWait() {
+  const auto idle = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) { return running_ == 0; };
+  absl::MutexLock lock(&mutex_);
+  cancelled_ = true;
+  mutex_.Await(absl::Condition(&idle));
+}
+
+bool VerificationThreadPool::JobGroup::start() {
+  absl::MutexLock lock(&mutex_);
+  if (cancelled_) {
+    return false;
+  }
+  running_++;
+  return true;
+}
+
+void VerificationThreadPool::JobGroup::finish() {
+  absl::MutexLock lock(&mutex_);
+  ASSERT(running_ > 0);
+  running_--;
+}
+
+VerificationThreadPool::VerificationThreadPool(Thread::ThreadFactory& thread_factory,
+                                               uint32_t thread_count) {
+  ASSERT(thread_count > 0);
+  threads_.reserve(thread_count);
+  const Thread::Options options{"tls_verify"};
+  while (threads_.size() < thread_count) {
+    threads_.push_back(thread_factory.createThread([this]() { worker(); }, options));
+  }
+}
+
+VerificationThreadPool::~VerificationThreadPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    terminate_ = true;
+  }
+  // Jobs still queued belong to cancelled groups, since each validator cancels its jobs before the
+  // last reference to the pool is released, so they are dropped.
+  for (auto& thread : threads_) {
+    thread->join();
+  }
+}
+
+void VerificationThreadPool::post(JobGroupSharedPtr group, absl::AnyInvocable<void()> job) {
+  absl::MutexLock lock(&mutex_);
+  queue_.push({std::move(group), std::move(job)});
+}
+
+void VerificationThreadPool::worker() {
+  const auto ready = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !queue_.empty() || terminate_;
+  };
+  while (true) {
+    QueuedJob queued;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(&ready));
+      if (terminate_) {
+        return;
+      }
+      queued = std::move(queue_.front());
+      queue_.pop();
+    }
+    if (queued.group_->start()) {
+      queued.job_();
+      queued.group_->finish();
+    }
+  }
+}
+
+SINGLETON_MANAGER_REGISTRATION(tls_verification_thread_pool_registry);
+
+std::shared_ptr<VerificationThreadPoolRegistry>
+VerificationThreadPoolRegistry::get(Singleton::Manager& manager) {
+  return manager.getTyped<VerificationThreadPoolRegistry>(
+      SINGLETON_MANAGER_REGISTERED_NAME(tls_verification_thread_pool_registry),
+      [] { return std::make_shared<VerificationThreadPoolRegistry>(); }, true);
+}
+
+VerificationThreadPoolSharedPtr
+VerificationThreadPoolRegistry::getOrCreate(uint32_t thread_count,
+                                            Thread::ThreadFactory& thread_factory) {
+  absl::MutexLock lock(&mutex_);
+  std::weak_ptr<VerificationThreadPool>& entry = pools_[thread_count];
+  VerificationThreadPoolSharedPtr pool = entry.lock();
+  if (pool == nullptr) {
+    pool = std::make_shared<VerificationThreadPool>(thread_factory, thread_count);
+    entry = pool;
+  }
+  return pool;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/thread/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A pool of threads which certificate validators offload trust chain verification to, so that
+ * workers can continue processing other connections while a chain is verified.
+ */
+class VerificationThreadPool {
+public:
+  /**
+   * The jobs posted by one validator. Cancelling the group when the validator is destroyed ensures
+   * that none of them run, or are still running, after the validator is gone.
+   */
+  class JobGroup {
+  public:
+    /**
+     * Prevents the group's jobs from starting, and waits for those which have started to finish.
+     */
+    void cancelAndWait();
+
+  private:
+    friend class VerificationThreadPool;
+
+    bool start();
+    void finish();
+
+    absl::Mutex mutex_;
+    bool cancelled_ ABSL_GUARDED_BY(mutex_){false};
+    uint32_t running_ ABSL_GUARDED_BY(mutex_){0};
+  };
+  using JobGroupSharedPtr = std::shared_ptr<JobGroup>;
+
+  VerificationThreadPool(Thread::ThreadFactory& thread_factory, uint32_t thread_count);
+  ~VerificationThreadPool();
+
+  /**
+   * Runs a job on one of the pool's threads, unless its group is cancelled first.
+   */
+  void post(JobGroupSharedPtr group, absl::AnyInvocable<void()> job);
+
+private:
+  struct QueuedJob {
+    JobGroupSharedPtr group_;
+    absl::AnyInvocable<void()> job_;
+  };
+
+  void worker();
+
+  absl::Mutex mutex_;
+  std::queue<QueuedJob> queue_ ABSL_GUARDED_BY(mutex_);
+  bool terminate_ ABSL_GUARDED_BY(mutex_){false};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+using VerificationThreadPoolSharedPtr = std::shared_ptr<VerificationThreadPool>;
+
+/**
+ * The verification thread pools of a process, so that validators configured with the same number
+ * of threads share a pool. A pool is destroyed when no validator uses it.
+ */
+class VerificationThreadPoolRegistry : public Singleton::Instance {
+public:
+  static std::shared_ptr<VerificationThreadPoolRegistry> get(Singleton::Manager& manager);
+
+  VerificationThreadPoolSharedPtr getOrCreate(uint32_t thread_count,
+                                              Thread::ThreadFactory& thread_factory);
+
+private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<uint32_t, std::weak_ptr<VerificationThreadPool>>
+      pools_ ABSL_GUARDED_BY(mutex_);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
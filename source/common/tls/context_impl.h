@@ -93,6 +93,12 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return whether connections should install their traffic keys in the kernel once the handshake
+   * is complete.
+   */
+  bool kernelTlsEnabled() const { return enable_kernel_tls_; }
+
   /**
    * The global SSL-library index used for storing a pointer to the SslExtendedSocketInfo
    * class in the SSL instance, for retrieval in callbacks.
@@ -173,6 +179,7 @@ protected:
   const Network::Address::IpList tls_keylog_local_;
   const Network::Address::IpList tls_keylog_remote_;
   AccessLog::AccessLogFileSharedPtr tls_keylog_file_;
+  const bool enable_kernel_tls_;
 };
 
 using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
@@ -0,0 +1,329 @@
+#include "source/common/tls/ktls.h"
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/network/io_socket_error_impl.h"
+
+#include "absl/container/fixed_array.h"
+#include "absl/strings/str_cat.h"
+#include "openssl/digest.h"
+#include "openssl/err.h"
+#include "openssl/hkdf.h"
+#include "openssl/mem.h"
+#include "openssl/nid.h"
+#include "openssl/ssl.h"
+
+#if defined(__linux__)
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <linux/tls.h>
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace Ktls {
+
+namespace {
+
+#if defined(__linux__)
+
+constexpr size_t NonceSize = 12;
+
+// The keys for one direction of a connection, in the form the kernel takes them.
+struct DirectionKeys {
+  std::vector<uint8_t> key_;
+  // The per-connection part of the AEAD nonce. For AES-GCM, the first four bytes are the salt and
+  // the rest is the initial explicit nonce for TLS 1.2; for ChaCha20-Poly1305 it is all IV.
+  std::array<uint8_t, NonceSize> iv_{};
+  // The sequence number of the next record, big-endian.
+  std::array<uint8_t, 8> rec_seq_{};
+
+  ~DirectionKeys() {
+    OPENSSL_cleanse(key_.data(), key_.size());
+    OPENSSL_cleanse(iv_.data(), iv_.size());
+  }
+};
+
+union CryptoInfo {
+  tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+  tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+  tls12_crypto_info_chacha20_poly1305 chacha20_poly1305;
+#endif
+};
+
+void encodeSequence(uint64_t sequence, std::array<uint8_t, 8>& out) {
+  for (int i = 7; i >= 0; i--) {
+    out[i] = sequence & 0xff;
+    sequence >>= 8;
+  }
+}
+
+// Fills in one of the kernel's tls12_crypto_info_* structures, which have the same fields with
+// different sizes. Returns the size of the structure.
+template <class T>
+size_t fillCryptoInfo(T& info, uint16_t version, uint16_t cipher_type, const DirectionKeys& keys) {
+  static_assert(sizeof(info.salt) + sizeof(info.iv) == NonceSize);
+  std::memset(&info, 0, sizeof(info));
+  info.info.version = version;
+  info.info.cipher_type = cipher_type;
+  RELEASE_ASSERT(keys.key_.size() == sizeof(info.key), "");
+  std::memcpy(info.key, keys.key_.data(), sizeof(info.key));
+  std::memcpy(info.salt, keys.iv_.data(), sizeof(info.salt));
+  std::memcpy(info.iv, keys.iv_.data() + sizeof(info.salt), sizeof(info.iv));
+  std::memcpy(info.rec_seq, keys.rec_seq_.data(), sizeof(info.rec_seq));
+  return sizeof(info);
+}
+
+// Returns the size of the filled-in structure, or 0 if the kernel does not support the cipher.
+size_t fillCryptoInfo(CryptoInfo& info, uint16_t version, int cipher_nid,
+                      const DirectionKeys& keys) {
+  switch (cipher_nid) {
+  case NID_aes_128_gcm:
+    return fillCryptoInfo(info.aes_gcm_128, version, TLS_CIPHER_AES_GCM_128, keys);
+  case NID_aes_256_gcm:
+    return fillCryptoInfo(info.aes_gcm_256, version, TLS_CIPHER_AES_GCM_256, keys);
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+  case NID_chacha20_poly1305:
+    return fillCryptoInfo(info.chacha20_poly1305, version, TLS_CIPHER_CHACHA20_POLY1305, keys);
+#endif
+  default:
+    return 0;
+  }
+}
+
+size_t keyLength(int cipher_nid) {
+  switch (cipher_nid) {
+  case NID_aes_128_gcm:
+    return 16;
+  case NID_aes_256_gcm:
+  case NID_chacha20_poly1305:
+    return 32;
+  default:
+    return 0;
+  }
+}
+
+// Derives the key and IV of a direction of a TLS 1.3 connection from its traffic secret.
+bool deriveTls13Keys(const SSL_CIPHER* cipher, bssl::Span<const uint8_t> secret,
+                     size_t key_length, DirectionKeys& keys) {
+  if (secret.empty()) {
+    return false;
+  }
+  const EVP_MD* digest =
+      SSL_CIPHER_get_prf_nid(cipher) == NID_sha384 ? EVP_sha384() : EVP_sha256();
+  const absl::Span<const uint8_t> secret_span(secret.data(), secret.size());
+  keys.key_.resize(key_length);
+  return hkdfExpandLabel(digest, secret_span, "key", keys.key_.data(), key_length) &&
+         hkdfExpandLabel(digest, secret_span, "iv", keys.iv_.data(), keys.iv_.size());
+}
+
+// Takes the keys of a TLS 1.2 connection from its key block, which for AEAD ciphers consists of the
+// client write key, server write key, client write IV and server write IV (RFC 5246 section 6.3).
+bool deriveTls12Keys(const SSL* ssl, size_t key_length, bool is_server, DirectionKeys& tx,
+                     DirectionKeys& rx) {
+  const size_t key_block_length = SSL_get_key_block_len(ssl);
+  if (key_block_length % 2 != 0 || key_block_length / 2 <= key_length ||
+      key_block_length / 2 - key_length > NonceSize) {
+    return false;
+  }
+  const size_t fixed_iv_length = key_block_length / 2 - key_length;
+  std::vector<uint8_t> key_block(key_block_length);
+  if (!SSL_generate_key_block(ssl, key_block.data(), key_block.size())) {
+    OPENSSL_cleanse(key_block.data(), key_block.size());
+    return false;
+  }
+  const uint8_t* client_key = key_block.data();
+  const uint8_t* server_key = client_key + key_length;
+  const uint8_t* client_iv = server_key + key_length;
+  const uint8_t* server_iv = client_iv + fixed_iv_length;
+  const uint8_t* tx_key = is_server ? server_key : client_key;
+  const uint8_t* rx_key = is_server ? client_key : server_key;
+  tx.key_.assign(tx_key, tx_key + key_length);
+  rx.key_.assign(rx_key, rx_key + key_length);
+  std::memcpy(tx.iv_.data(), is_server ? server_iv : client_iv, fixed_iv_length);
+  std::memcpy(rx.iv_.data(), is_server ? client_iv : server_iv, fixed_iv_length);
+  OPENSSL_cleanse(key_block.data(), key_block.size());
+  if (fixed_iv_length < NonceSize) {
+    // AES-GCM records carry an explicit nonce, which BoringSSL sets to the sequence number. The
+    // kernel sends the explicit nonce it is given, incremented for each record, so this keeps it
+    // unique in the same way.
+    std::memcpy(tx.iv_.data() + fixed_iv_length, tx.rec_seq_.data(), NonceSize - fixed_iv_length);
+    std::memcpy(rx.iv_.data() + fixed_iv_length, rx.rec_seq_.data(), NonceSize - fixed_iv_length);
+  }
+  return true;
+}
+
+bool installKeys(Network::IoHandle& io_handle, int direction, uint16_t version, int cipher_nid,
+                 const DirectionKeys& keys) {
+  CryptoInfo info;
+  const size_t info_size = fillCryptoInfo(info, version, cipher_nid, keys);
+  const bool installed =
+      info_size != 0 &&
+      io_handle.setOption(SOL_TLS, direction, &info, info_size).return_value_ == 0;
+  OPENSSL_cleanse(&info, sizeof(info));
+  return installed;
+}
+
+#endif
+
+} // namespace
+
+bool hkdfExpandLabel(const EVP_MD* digest, absl::Span<const uint8_t> secret,
+                     absl::string_view label, uint8_t* out, size_t out_len) {
+  // struct { uint16 length; opaque label<7..255> = "tls13 " + Label; opaque context<0..255>; }
+  const std::string full_label = absl::StrCat("tls13 ", label);
+  std::vector<uint8_t> info;
+  info.reserve(4 + full_label.size());
+  info.push_back(out_len >> 8);
+  info.push_back(out_len & 0xff);
+  info.push_back(full_label.size());
+  info.insert(info.end(), full_label.begin(), full_label.end());
+  info.push_back(0);
+  return HKDF_expand(out, out_len, digest, secret.data(), secret.size(), info.data(),
+                     info.size()) == 1;
+}
+
+#if defined(__linux__)
+
+Offload enable(SSL* ssl, Network::IoHandle& io_handle) {
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  const uint16_t version = SSL_version(ssl);
+  const bool is_server = SSL_is_server(ssl);
+  if (cipher == nullptr || (version != TLS1_2_VERSION && version != TLS1_3_VERSION) ||
+      (version == TLS1_3_VERSION && !is_server) || SSL_has_pending(ssl)) {
+    return Offload::None;
+  }
+  const int cipher_nid = SSL_CIPHER_get_cipher_nid(cipher);
+  const size_t key_length = keyLength(cipher_nid);
+  if (key_length == 0) {
+    return Offload::None;
+  }
+  // A TLS 1.3 server seals its NewSessionTicket messages when the handshake completes, but only
+  // sends them with the next write, while the write sequence already counts them. Once the kernel
+  // sends the records BoringSSL never writes them, so they must be sent first, or the peer fails
+  // to decrypt the kernel's records. An empty write sends whatever is pending, and only succeeds
+  // once all of it was written.
+  if (SSL_write(ssl, nullptr, 0) < 0) {
+    ERR_clear_error();
+    return Offload::None;
+  }
+
+  DirectionKeys tx;
+  DirectionKeys rx;
+  encodeSequence(SSL_get_write_sequence(ssl), tx.rec_seq_);
+  encodeSequence(SSL_get_read_sequence(ssl), rx.rec_seq_);
+  if (version == TLS1_3_VERSION) {
+    bssl::Span<const uint8_t> read_secret;
+    bssl::Span<const uint8_t> write_secret;
+    if (!bssl::SSL_get_traffic_secrets(ssl, &read_secret, &write_secret) ||
+        !deriveTls13Keys(cipher, write_secret, key_length, tx) ||
+        !deriveTls13Keys(cipher, read_secret, key_length, rx)) {
+      return Offload::None;
+    }
+  } else if (!deriveTls12Keys(ssl, key_length, is_server, tx, rx)) {
+    return Offload::None;
+  }
+
+  // Attaching the TLS upper layer protocol fails if the kernel does not support kTLS; until keys
+  // are installed, the socket continues to behave as a plain TCP socket.
+  static constexpr char TlsUlp[] = "tls";
+  if (io_handle.setOption(IPPROTO_TCP, TCP_ULP, TlsUlp, sizeof(TlsUlp)).return_value_ != 0) {
+    return Offload::None;
+  }
+  // Whether the kernel supports the cipher is only known once the first keys are installed. The
+  // receive keys go first, since the kernel only processes received records once they are read.
+  const uint16_t kernel_version = version == TLS1_3_VERSION ? TLS_1_3_VERSION : TLS_1_2_VERSION;
+  if (!installKeys(io_handle, TLS_RX, kernel_version, cipher_nid, rx)) {
+    return Offload::None;
+  }
+  return installKeys(io_handle, TLS_TX, kernel_version, cipher_nid, tx) ? Offload::Enabled
+                                                                       : Offload::Failed;
+}
+
+Api::IoCallUint64Result receive(Network::IoHandle& io_handle, Buffer::RawSlice* slices,
+                                uint64_t num_slices, uint8_t& record_type) {
+  absl::FixedArray<iovec> iov(num_slices);
+  for (uint64_t i = 0; i < num_slices; i++) {
+    iov[i].iov_base = slices[i].mem_;
+    iov[i].iov_len = slices[i].len_;
+  }
+  // Without room for the record type, the kernel fails reads of records other than application
+  // data with EIO.
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))] = {};
+  msghdr message{};
+  message.msg_iov = iov.data();
+  message.msg_iovlen = num_slices;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  const Api::SysCallSizeResult result =
+      Api::OsSysCallsSingleton::get().recvmsg(io_handle.fdDoNotUse(), &message, 0);
+  if (result.return_value_ < 0) {
+    return {0, result.errno_ == SOCKET_ERROR_AGAIN
+                   ? Network::IoSocketError::getIoSocketEagainError()
+                   : Network::IoSocketError::create(result.errno_)};
+  }
+
+  record_type = ApplicationDataContentType;
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&message, cmsg)) {
+    if (cmsg->cmsg_level == SOL_TLS && cmsg->cmsg_type == TLS_GET_RECORD_TYPE) {
+      record_type = *CMSG_DATA(cmsg);
+    }
+  }
+  return {static_cast<uint64_t>(result.return_value_), Api::IoError::none()};
+}
+
+Api::SysCallSizeResult sendCloseNotify(Network::IoHandle& io_handle) {
+  // A warning-level close_notify alert (RFC 8446 section 6), sent as an alert record by setting
+  // the record type in a control message.
+  uint8_t alert[2] = {1, 0};
+  iovec iov{alert, sizeof(alert)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))] = {};
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *CMSG_DATA(cmsg) = AlertContentType;
+  return Api::OsSysCallsSingleton::get().sendmsg(io_handle.fdDoNotUse(), &message, MSG_NOSIGNAL);
+}
+
+#else
+
+Offload enable(SSL*, Network::IoHandle&) { return Offload::None; }
+
+Api::IoCallUint64Result receive(Network::IoHandle&, Buffer::RawSlice*, uint64_t, uint8_t&) {
+  return {0, Network::IoSocketError::create(SOCKET_ERROR_NOT_SUP)};
+}
+
+Api::SysCallSizeResult sendCloseNotify(Network::IoHandle&) { return {-1, SOCKET_ERROR_NOT_SUP}; }
+
+#endif
+
+} // namespace Ktls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/api/io_error.h"
+#include "envoy/api/os_sys_calls_common.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/network/io_handle.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "openssl/base.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace Ktls {
+
+// The content types of TLS records, from RFC 8446 section 5.1.
+constexpr uint8_t AlertContentType = 21;
+constexpr uint8_t ApplicationDataContentType = 23;
+
+// The description of a close_notify alert, from RFC 8446 section 6.
+constexpr uint8_t CloseNotifyAlert = 0;
+
+/**
+ * Whether the records of a connection are encrypted and decrypted by the kernel.
+ */
+enum class Offload {
+  // The records are encrypted and decrypted by BoringSSL.
+  None,
+  // The records are encrypted and decrypted by the kernel.
+  Enabled,
+  // Only some of the traffic keys could be installed in the kernel. Neither BoringSSL nor the
+  // kernel can carry on with the connection, which must be closed.
+  Failed,
+};
+
+/**
+ * Installs the traffic keys of a connection whose handshake is complete in the kernel, so that the
+ * kernel encrypts and decrypts the connection's records and data can be written to and read from
+ * the socket directly.
+ *
+ * Both directions are offloaded or neither is. Once the kernel has the keys of one direction,
+ * BoringSSL cannot correctly send or receive records in it, such as a key update or an alert
+ * in reply to a record from the peer. Connections are not offloaded if the kernel does not support
+ * the negotiated protocol version and cipher, if BoringSSL has already read data beyond the
+ * handshake, or if post-handshake messages are expected, which excludes TLS 1.3 clients, since
+ * servers send session tickets after the handshake. Handshake messages BoringSSL has not written
+ * yet, such as the session tickets of a TLS 1.3 server, are written first; if the socket cannot
+ * take them all, the connection is not offloaded.
+ *
+ * @param ssl the connection, whose handshake must be complete.
+ * @param io_handle the connection's socket.
+ * @return whether the connection was offloaded. If it is Offload::None, nothing was changed and
+ *         the connection can continue in BoringSSL.
+ */
+Offload enable(SSL* ssl, Network::IoHandle& io_handle);
+
+/**
+ * Reads from a connection whose records are decrypted by the kernel. A read returns either
+ * application data, or the contents of a single record of another type, such as an alert.
+ * @param io_handle the connection's socket.
+ * @param slices the buffers to read into.
+ * @param num_slices the number of buffers.
+ * @param record_type supplies the content type of the records which were read.
+ * @return the number of bytes read, or the error.
+ */
+Api::IoCallUint64Result receive(Network::IoHandle& io_handle, Buffer::RawSlice* slices,
+                                uint64_t num_slices, uint8_t& record_type);
+
+/**
+ * Sends a close_notify alert on a connection whose records are encrypted by the kernel.
+ */
+Api::SysCallSizeResult sendCloseNotify(Network::IoHandle& io_handle);
+
+/**
+ * HKDF-Expand-Label from RFC 8446 section 7.1, with an empty context.
+ * @return whether out was filled.
+ */
+bool hkdfExpandLabel(const EVP_MD* digest, absl::Span<const uint8_t> secret,
+                     absl::string_view label, uint8_t* out, size_t out_len);
+
+} // namespace Ktls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -86,6 +86,9 @@ bool getStatelessSessionResumptionDisabled(
 } // namespace
 
 const unsigned ServerContextConfigImpl::DEFAULT_MIN_VERSION = TLS1_2_VERSION;
+const uint32_t ServerContextConfigImpl::DEFAULT_SHARED_CACHE_MAX_SESSIONS = 20480;
+const uint32_t ServerContextConfigImpl::DEFAULT_SHARED_CACHE_MAX_SESSION_SIZE = 2048;
+const uint64_t ServerContextConfigImpl::DEFAULT_TICKET_KEY_ROTATION_INTERVAL_SECONDS = 3600;
 const unsigned ServerContextConfigImpl::DEFAULT_MAX_VERSION = TLS1_3_VERSION;
 
 const std::string ServerContextConfigImpl::DEFAULT_CIPHER_SUITES =
@@ -164,6 +167,17 @@ ServerContextConfigImpl::ServerContextConfigImpl(
         std::chrono::seconds(DurationUtil::durationToSeconds(config.session_timeout()));
   }
 
+  if (config.has_shared_session_cache()) {
+    const auto& cache = config.shared_session_cache();
+    shared_session_cache_ = SharedSessionCacheConfig{
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(cache, max_sessions, DEFAULT_SHARED_CACHE_MAX_SESSIONS),
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(cache, max_session_size,
+                                        DEFAULT_SHARED_CACHE_MAX_SESSION_SIZE),
+        cache.path(),
+        std::chrono::seconds(PROTOBUF_GET_SECONDS_OR_DEFAULT(
+            cache, ticket_key_rotation_interval, DEFAULT_TICKET_KEY_ROTATION_INTERVAL_SECONDS))};
+  }
+
   if (config.common_tls_context().has_custom_tls_certificate_selector()) {
     // If a custom tls context provider is configured, derive the factory from the config.
     const auto& provider_config = config.common_tls_context().custom_tls_certificate_selector();
@@ -42,6 +42,9 @@ public:
 
   bool fullScanCertsOnSNIMismatch() const override { return full_scan_certs_on_sni_mismatch_; }
   bool preferClientCiphers() const override { return prefer_client_ciphers_; }
+  absl::optional<SharedSessionCacheConfig> sharedSessionCache() const override {
+    return shared_session_cache_;
+  }
 
   Ssl::TlsCertificateSelectorFactory tlsCertificateSelectorFactory() const override;
 
@@ -55,6 +58,9 @@ private:
   static const unsigned DEFAULT_MAX_VERSION;
   static const std::string DEFAULT_CIPHER_SUITES;
   static const std::string DEFAULT_CURVES;
+  static const uint32_t DEFAULT_SHARED_CACHE_MAX_SESSIONS;
+  static const uint32_t DEFAULT_SHARED_CACHE_MAX_SESSION_SIZE;
+  static const uint64_t DEFAULT_TICKET_KEY_ROTATION_INTERVAL_SECONDS;
 
   const bool require_client_certificate_;
   const OcspStaplePolicy ocsp_staple_policy_;
@@ -73,6 +79,7 @@ private:
 
   Ssl::TlsCertificateSelectorFactory tls_certificate_selector_factory_;
   absl::optional<std::chrono::seconds> session_timeout_;
+  absl::optional<SharedSessionCacheConfig> shared_session_cache_;
   const bool disable_stateless_session_resumption_;
   const bool disable_stateful_session_resumption_;
   bool full_scan_certs_on_sni_mismatch_;
@@ -122,6 +122,15 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   SET_AND_RETURN_IF_NOT_OK(id_or_error.status(), creation_status);
   const SessionContextID& session_id = *id_or_error;
 
+  if (config.sharedSessionCache().has_value() &&
+      !config.capabilities().handles_session_resumption) {
+    auto cache_or_error =
+        SharedSessionCacheRegistry::get(factory_context_.singletonManager())
+            ->getOrCreate(config.sharedSessionCache().value(), factory_context_.timeSource());
+    SET_AND_RETURN_IF_NOT_OK(cache_or_error.status(), creation_status);
+    shared_session_cache_ = std::move(cache_or_error.value());
+  }
+
   // First, configure the base context for ClientHello interception.
   // TODO(htuch): replace with SSL_IDENTITY when we have this as a means to do multi-cert in
   // BoringSSL.
@@ -164,7 +173,8 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
     // `SSL_CTX_set_tlsext_ticket_key_cb`.
     if (config.disableStatelessSessionResumption()) {
       SSL_CTX_set_options(ctx.ssl_ctx_.get(), SSL_OP_NO_TICKET);
-    } else if (!session_ticket_keys_.empty() && !config.capabilities().handles_session_resumption) {
+    } else if ((!session_ticket_keys_.empty() || shared_session_cache_ != nullptr) &&
+               !config.capabilities().handles_session_resumption) {
       SSL_CTX_set_tlsext_ticket_key_cb(
           ctx.ssl_ctx_.get(),
           [](SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx, HMAC_CTX* hmac_ctx,
@@ -180,6 +190,8 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
 
     if (config.disableStatefulSessionResumption()) {
       SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(), SSL_SESS_CACHE_OFF);
+    } else if (shared_session_cache_ != nullptr) {
+      useSharedSessionCache(ctx.ssl_ctx_.get());
     }
 
     if (config.sessionTimeout() && !config.capabilities().handles_session_resumption) {
@@ -327,14 +339,24 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
   const EVP_MD* hmac = EVP_sha256();
   const EVP_CIPHER* cipher = EVP_aes_256_cbc();
 
+  // Configured keys take precedence over the keys of the shared cache, which are checked for each
+  // ticket since they change as they are rotated.
+  SharedSessionCache::TicketKeys shared_keys;
+  absl::Span<const Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys =
+      session_ticket_keys_;
+  if (session_ticket_keys_.empty() && shared_session_cache_ != nullptr) {
+    shared_keys = shared_session_cache_->ticketKeys(shared_ticket_keys_);
+    session_ticket_keys = shared_keys.keys();
+  }
+
   if (encrypt == 1) {
     // Encrypt
-    RELEASE_ASSERT(!session_ticket_keys_.empty(), "");
+    RELEASE_ASSERT(!session_ticket_keys.empty(), "");
     // TODO(ggreenway): validate in SDS that session_ticket_keys_ cannot be empty,
     // or if we allow it to be emptied, reconfigure the context so this callback
     // isn't set.
 
-    const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key = session_ticket_keys_.front();
+    const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key = session_ticket_keys.front();
 
     static_assert(std::tuple_size<decltype(key.name_)>::value == SSL_TICKET_KEY_NAME_LEN,
                   "Expected key.name length");
@@ -358,7 +380,7 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
   } else {
     // Decrypt
     bool is_enc_key = true; // first element is the encryption key
-    for (const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key : session_ticket_keys_) {
+    for (const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key : session_ticket_keys) {
       static_assert(std::tuple_size<decltype(key.name_)>::value == SSL_TICKET_KEY_NAME_LEN,
                     "Expected key.name length");
       if (std::equal(key.name_.begin(), key.name_.end(), key_name)) {
@@ -382,6 +404,56 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
   }
 }
 
+void ServerContextImpl::useSharedSessionCache(SSL_CTX* ctx) {
+  SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+  SSL_CTX_sess_set_new_cb(ctx, [](SSL* ssl, SSL_SESSION* session) -> int {
+    static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+        ->storeSharedSession(session);
+    // The cache keeps an encoded copy of the session rather than a reference to it.
+    return 0;
+  });
+  SSL_CTX_sess_set_get_cb(
+      ctx, [](SSL* ssl, const uint8_t* id, int id_length, int* out_copy) -> SSL_SESSION* {
+        *out_copy = 0;
+        return static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+            ->findSharedSession(ssl, id, id_length)
+            .release();
+      });
+  SSL_CTX_sess_set_remove_cb(ctx, [](SSL_CTX* ctx, SSL_SESSION* session) {
+    static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(ctx))->removeSharedSession(session);
+  });
+}
+
+void ServerContextImpl::storeSharedSession(SSL_SESSION* session) {
+  unsigned int id_length;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_length);
+  uint8_t* encoded;
+  size_t encoded_length;
+  if (!SSL_SESSION_to_bytes(session, &encoded, &encoded_length)) {
+    return;
+  }
+  bssl::UniquePtr<uint8_t> encoded_deleter(encoded);
+  const SystemTime expiry{
+      std::chrono::seconds(SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session))};
+  shared_session_cache_->insert({id, id_length}, {encoded, encoded_length}, expiry);
+}
+
+bssl::UniquePtr<SSL_SESSION> ServerContextImpl::findSharedSession(SSL* ssl, const uint8_t* id,
+                                                                  int id_length) {
+  std::vector<uint8_t> encoded;
+  if (!shared_session_cache_->lookup({id, static_cast<size_t>(id_length)}, encoded)) {
+    return nullptr;
+  }
+  return bssl::UniquePtr<SSL_SESSION>(
+      SSL_SESSION_from_bytes(encoded.data(), encoded.size(), SSL_get_SSL_CTX(ssl)));
+}
+
+void ServerContextImpl::removeSharedSession(SSL_SESSION* session) {
+  unsigned int id_length;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_length);
+  shared_session_cache_->remove({id, id_length});
+}
+
 // Returns a list of client capabilities for ECDSA curves as NIDs. An empty vector indicates
 // a client that is unable to handle ECDSA.
 Ssl::CurveNIDVector
@@ -25,6 +25,7 @@
 #include "source/common/tls/context_manager_impl.h"
 #include "source/common/tls/default_tls_certificate_selector.h"
 #include "source/common/tls/ocsp/ocsp.h"
+#include "source/common/tls/shared_session_cache.h"
 #include "source/common/tls/stats.h"
 
 #include "absl/synchronization/mutex.h"
@@ -83,11 +84,19 @@ private:
   int sessionTicketProcess(SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx,
                            HMAC_CTX* hmac_ctx, int encrypt);
 
+  // Stores the sessions of ctx in shared_session_cache_ instead of in ctx.
+  void useSharedSessionCache(SSL_CTX* ctx);
+  void storeSharedSession(SSL_SESSION* session);
+  bssl::UniquePtr<SSL_SESSION> findSharedSession(SSL* ssl, const uint8_t* id, int id_length);
+  void removeSharedSession(SSL_SESSION* session);
+
   absl::StatusOr<SessionContextID>
   generateHashForSessionContextId(const std::vector<std::string>& server_names);
 
   Ssl::TlsCertificateSelectorPtr tls_certificate_selector_;
   const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
+  std::shared_ptr<SharedSessionCache> shared_session_cache_;
+  SharedSessionCache::CachedTicketKeys shared_ticket_keys_;
   const Ssl::ServerContextConfig::OcspStaplePolicy ocsp_staple_policy_;
 };
 
@@ -0,0 +1,469 @@
+#include "source/common/tls/shared_session_cache.h"
+
+#if defined(__linux__)
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/cleanup.h"
+#include "source/common/common/fmt.h"
+#include "source/common/common/hash.h"
+#include "source/common/common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "openssl/mem.h"
+#include "openssl/rand.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#if defined(__linux__)
+
+namespace {
+
+constexpr uint64_t Magic = 0x454e564f59544c53; // "ENVOYTLS"
+// Must be changed whenever the layout of the cache changes, so that a process does not use a cache
+// file written by an incompatible version.
+constexpr uint32_t Version = 2;
+constexpr uint32_t ShardCount = 16;
+// The number of slots a session can be stored in.
+constexpr uint32_t Ways = 8;
+// SSL_MAX_SSL_SESSION_ID_LENGTH.
+constexpr uint32_t MaxIdLength = 32;
+constexpr size_t CacheLineSize = 64;
+
+constexpr size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+void initializeMutex(pthread_mutex_t& mutex) {
+  pthread_mutexattr_t attribute;
+  pthread_mutexattr_init(&attribute);
+  pthread_mutexattr_setpshared(&attribute, PTHREAD_PROCESS_SHARED);
+  pthread_mutexattr_setrobust(&attribute, PTHREAD_MUTEX_ROBUST);
+  pthread_mutex_init(&mutex, &attribute);
+  pthread_mutexattr_destroy(&attribute);
+}
+
+// Holds a process-shared robust mutex. If the process which last held the mutex died while holding
+// it, the data it protects may be inconsistent, which the new holder is told about so that it can
+// reset the data.
+class SharedMutexLock {
+public:
+  explicit SharedMutexLock(pthread_mutex_t& mutex) : mutex_(mutex) {
+    const int rc = pthread_mutex_lock(&mutex_);
+    ASSERT(rc == 0 || rc == EOWNERDEAD);
+    if (rc == EOWNERDEAD) {
+      owner_died_ = true;
+      pthread_mutex_consistent(&mutex_);
+    }
+  }
+  ~SharedMutexLock() { pthread_mutex_unlock(&mutex_); }
+
+  bool ownerDied() const { return owner_died_; }
+
+private:
+  pthread_mutex_t& mutex_;
+  bool owner_died_{};
+};
+
+absl::string_view asStringView(absl::Span<const uint8_t> bytes) {
+  return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+} // namespace
+
+struct SharedSessionCache::Header {
+  struct TicketKeyEntry {
+    // The rotation interval in which the key was generated, counted from the Unix epoch.
+    int64_t epoch_;
+    TicketKey key_;
+  };
+
+  // Set last when the cache is initialized.
+  uint64_t magic_;
+  uint32_t version_;
+  uint32_t slots_per_shard_;
+  uint32_t slot_size_;
+  int64_t ticket_key_rotation_interval_;
+
+  pthread_mutex_t keys_mutex_;
+  // Incremented under keys_mutex_ whenever the keys change, so that copies of them can be checked
+  // without taking the lock.
+  std::atomic<uint64_t> keys_generation_;
+  uint32_t key_count_;
+  TicketKeyEntry keys_[MaxTicketKeys];
+};
+
+// The generation is read by other processes without a lock.
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+struct SharedSessionCache::Shard {
+  alignas(CacheLineSize) pthread_mutex_t mutex_;
+  // Incremented whenever a slot is used, giving the order in which slots were last used.
+  uint64_t clock_;
+};
+
+// Followed by max_session_size bytes for the encoded session.
+struct SharedSessionCache::Slot {
+  // In seconds since the Unix epoch.
+  int64_t expiry_;
+  uint64_t last_used_;
+  // The length of the encoded session, or 0 if the slot is empty.
+  uint32_t length_;
+  uint8_t id_length_;
+  uint8_t id_[MaxIdLength];
+
+  uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+  bool matches(absl::Span<const uint8_t> id) const {
+    return length_ != 0 && id_length_ == id.size() && memcmp(id_, id.data(), id.size()) == 0;
+  }
+  // Returns the order in which slots are replaced: empty slots first, then expired ones, then the
+  // least recently used.
+  uint64_t replacementOrder(int64_t now) const {
+    if (length_ == 0) {
+      return 0;
+    }
+    return expiry_ <= now ? 1 : last_used_ + 2;
+  }
+};
+
+size_t SharedSessionCache::shardsOffset() { return alignUp(sizeof(Header), CacheLineSize); }
+
+size_t SharedSessionCache::slotsOffset() { return shardsOffset() + ShardCount * sizeof(Shard); }
+
+absl::StatusOr<std::shared_ptr<SharedSessionCache>>
+SharedSessionCache::create(const Ssl::ServerContextConfig::SharedSessionCacheConfig& config,
+                           TimeSource& time_source) {
+  const uint32_t slots_per_shard =
+      std::max(Ways, (config.max_sessions_ + ShardCount - 1) / ShardCount);
+  const uint32_t slot_size = alignUp(sizeof(Slot) + config.max_session_size_, alignof(Slot));
+  const size_t size =
+      slotsOffset() + static_cast<size_t>(ShardCount) * slots_per_shard * slot_size;
+  const int64_t interval = config.ticket_key_rotation_interval_.count();
+
+  auto& posix = Api::OsSysCallsSingleton::get();
+  int fd = -1;
+  Cleanup close_fd([&posix, &fd]() {
+    if (fd != -1) {
+      posix.close(fd);
+    }
+  });
+  const auto file_error = [&config](absl::string_view operation, int error) {
+    return absl::InvalidArgumentError(fmt::format(
+        "unable to {} shared TLS session cache file {}: {}", operation, config.path_,
+        errorDetails(error)));
+  };
+  const auto mismatch_error = [&config]() {
+    return absl::InvalidArgumentError(
+        fmt::format("shared TLS session cache file {} was created with a different configuration; "
+                    "remove it or change the path",
+                    config.path_));
+  };
+  if (!config.path_.empty()) {
+    const auto open_result = posix.open(config.path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (open_result.return_value_ == -1) {
+      return file_error("open", open_result.errno_);
+    }
+    fd = open_result.return_value_;
+    // Serializes the initialization of the file with other processes opening it. The lock is
+    // released when the file is closed; the mapping stays valid.
+    if (::flock(fd, LOCK_EX) != 0) {
+      return file_error("lock", errno);
+    }
+    struct stat stat_result;
+    const auto stat_status = posix.fstat(fd, &stat_result);
+    if (stat_status.return_value_ != 0) {
+      return file_error("stat", stat_status.errno_);
+    }
+    // The file holds session secrets and ticket keys, so a file which another user could have
+    // written, or could read, is not used.
+    if (!S_ISREG(stat_result.st_mode) || stat_result.st_uid != ::geteuid() ||
+        (stat_result.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO)) != (S_IRUSR | S_IWUSR)) {
+      return absl::InvalidArgumentError(
+          fmt::format("shared TLS session cache file {} must be a regular file owned by the user "
+                      "Envoy runs as, with mode 0600",
+                      config.path_));
+    }
+    if (stat_result.st_size == 0) {
+      const auto truncate_result = posix.ftruncate(fd, size);
+      if (truncate_result.return_value_ != 0) {
+        return file_error("resize", truncate_result.errno_);
+      }
+    } else if (static_cast<size_t>(stat_result.st_size) != size) {
+      return mismatch_error();
+    }
+  }
+
+  const auto mapping = posix.mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | (fd == -1 ? MAP_ANONYMOUS : 0), fd, 0);
+  if (mapping.return_value_ == MAP_FAILED) {
+    return absl::InternalError(
+        absl::StrCat("unable to map shared TLS session cache: ", errorDetails(mapping.errno_)));
+  }
+  std::shared_ptr<SharedSessionCache> cache(
+      new SharedSessionCache(time_source, mapping.return_value_, size));
+  Header& header = cache->header_;
+
+  // A file whose magic number is not set is new or was not fully initialized, e.g. because the
+  // process creating it died, and is initialized again.
+  if (header.magic_ != 0) {
+    if (header.magic_ != Magic || header.version_ != Version ||
+        header.slots_per_shard_ != slots_per_shard || header.slot_size_ != slot_size ||
+        header.ticket_key_rotation_interval_ != interval) {
+      return mismatch_error();
+    }
+    return cache;
+  }
+  // New mappings and files are zero-filled, so only the header and locks need initializing, and
+  // the slots' memory is not allocated until sessions are stored in them.
+  header.key_count_ = 0;
+  header.keys_generation_.store(0);
+  header.version_ = Version;
+  header.slots_per_shard_ = slots_per_shard;
+  header.slot_size_ = slot_size;
+  header.ticket_key_rotation_interval_ = interval;
+  initializeMutex(header.keys_mutex_);
+  for (uint32_t i = 0; i < ShardCount; i++) {
+    initializeMutex(cache->shard(i).mutex_);
+    cache->shard(i).clock_ = 0;
+  }
+  header.magic_ = Magic;
+  return cache;
+}
+
+SharedSessionCache::SharedSessionCache(TimeSource& time_source, void* mapping,
+                                       size_t mapping_size)
+    : time_source_(time_source), mapping_(mapping), mapping_size_(mapping_size),
+      header_(*static_cast<Header*>(mapping)) {}
+
+SharedSessionCache::~SharedSessionCache() { ::munmap(mapping_, mapping_size_); }
+
+SharedSessionCache::Shard& SharedSessionCache::shard(uint32_t index) {
+  return reinterpret_cast<Shard*>(static_cast<uint8_t*>(mapping_) + shardsOffset())[index];
+}
+
+SharedSessionCache::Slot& SharedSessionCache::slot(uint32_t shard, uint32_t index) {
+  const size_t slot_index = static_cast<size_t>(shard) * header_.slots_per_shard_ + index;
+  return *reinterpret_cast<Slot*>(static_cast<uint8_t*>(mapping_) + slotsOffset() +
+                                  slot_index * header_.slot_size_);
+}
+
+SharedSessionCache::Slot* SharedSessionCache::findSlot(const Location& location,
+                                                       absl::Span<const uint8_t> id) {
+  for (uint32_t i = 0; i < Ways; i++) {
+    Slot& candidate = slot(location.shard_, (location.first_slot_ + i) % header_.slots_per_shard_);
+    if (candidate.matches(id)) {
+      return &candidate;
+    }
+  }
+  return nullptr;
+}
+
+void SharedSessionCache::clearShard(uint32_t shard_index) {
+  for (uint32_t i = 0; i < header_.slots_per_shard_; i++) {
+    slot(shard_index, i).length_ = 0;
+  }
+  shard(shard_index).clock_ = 0;
+}
+
+int64_t SharedSessionCache::nowSeconds() const {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             time_source_.systemTime().time_since_epoch())
+      .count();
+}
+
+SharedSessionCache::Location SharedSessionCache::locate(absl::Span<const uint8_t> id) const {
+  const uint64_t hash = HashUtil::xxHash64(asStringView(id));
+  return {static_cast<uint32_t>(hash % ShardCount),
+          static_cast<uint32_t>((hash / ShardCount) % header_.slots_per_shard_)};
+}
+
+bool SharedSessionCache::insert(absl::Span<const uint8_t> id, absl::Span<const uint8_t> session,
+                                SystemTime expiry) {
+  if (id.empty() || id.size() > MaxIdLength || session.empty() ||
+      sizeof(Slot) + session.size() > header_.slot_size_) {
+    return false;
+  }
+  const int64_t now = nowSeconds();
+  const Location location = locate(id);
+  Shard& locked_shard = shard(location.shard_);
+  SharedMutexLock lock(locked_shard.mutex_);
+  if (lock.ownerDied()) {
+    clearShard(location.shard_);
+  }
+  Slot* target = findSlot(location, id);
+  if (target == nullptr) {
+    target = &slot(location.shard_, location.first_slot_);
+    for (uint32_t i = 1; i < Ways; i++) {
+      Slot& candidate =
+          slot(location.shard_, (location.first_slot_ + i) % header_.slots_per_shard_);
+      if (candidate.replacementOrder(now) < target->replacementOrder(now)) {
+        target = &candidate;
+      }
+    }
+  }
+  target->expiry_ =
+      std::chrono::duration_cast<std::chrono::seconds>(expiry.time_since_epoch()).count();
+  target->last_used_ = ++locked_shard.clock_;
+  target->id_length_ = id.size();
+  memcpy(target->id_, id.data(), id.size());
+  memcpy(target->data(), session.data(), session.size());
+  target->length_ = session.size();
+  return true;
+}
+
+bool SharedSessionCache::lookup(absl::Span<const uint8_t> id, std::vector<uint8_t>& session) {
+  if (id.empty() || id.size() > MaxIdLength) {
+    return false;
+  }
+  const int64_t now = nowSeconds();
+  const Location location = locate(id);
+  Shard& locked_shard = shard(location.shard_);
+  SharedMutexLock lock(locked_shard.mutex_);
+  if (lock.ownerDied()) {
+    clearShard(location.shard_);
+  }
+  Slot* found = findSlot(location, id);
+  if (found == nullptr) {
+    return false;
+  }
+  if (found->expiry_ <= now) {
+    found->length_ = 0;
+    return false;
+  }
+  found->last_used_ = ++locked_shard.clock_;
+  session.assign(found->data(), found->data() + found->length_);
+  return true;
+}
+
+void SharedSessionCache::remove(absl::Span<const uint8_t> id) {
+  if (id.empty() || id.size() > MaxIdLength) {
+    return;
+  }
+  const Location location = locate(id);
+  SharedMutexLock lock(shard(location.shard_).mutex_);
+  if (lock.ownerDied()) {
+    clearShard(location.shard_);
+  }
+  Slot* found = findSlot(location, id);
+  if (found != nullptr) {
+    found->length_ = 0;
+  }
+}
+
+SharedSessionCache::TicketKeys SharedSessionCache::ticketKeys(CachedTicketKeys& cached) {
+  const int64_t epoch = nowSeconds() / header_.ticket_key_rotation_interval_;
+  const uint64_t generation = header_.keys_generation_.load(std::memory_order_acquire);
+  {
+    absl::ReaderMutexLock lock(&cached.mutex_);
+    if (cached.keys_.count_ != 0 && cached.generation_ == generation && cached.epoch_ >= epoch) {
+      return cached.keys_;
+    }
+  }
+
+  absl::MutexLock cached_lock(&cached.mutex_);
+  SharedMutexLock lock(header_.keys_mutex_);
+  if (lock.ownerDied()) {
+    header_.key_count_ = 0;
+    header_.keys_generation_.fetch_add(1, std::memory_order_release);
+  }
+  if (header_.key_count_ == 0 || header_.keys_[0].epoch_ < epoch) {
+    // The new key goes first, followed by the keys which are still accepted, i.e. those replaced
+    // less than two rotation intervals ago.
+    Header::TicketKeyEntry keys[MaxTicketKeys];
+    keys[0].epoch_ = epoch;
+    TicketKey& key = keys[0].key_;
+    RELEASE_ASSERT(RAND_bytes(key.name_.data(), key.name_.size()) == 1 &&
+                       RAND_bytes(key.hmac_key_.data(), key.hmac_key_.size()) == 1 &&
+                       RAND_bytes(key.aes_key_.data(), key.aes_key_.size()) == 1,
+                   "");
+    uint32_t count = 1;
+    for (uint32_t i = 0; i < header_.key_count_ && count < MaxTicketKeys; i++) {
+      if (header_.keys_[i].epoch_ >= epoch - static_cast<int64_t>(MaxTicketKeys - 1)) {
+        keys[count++] = header_.keys_[i];
+      }
+    }
+    std::copy(keys, keys + count, header_.keys_);
+    header_.key_count_ = count;
+    header_.keys_generation_.fetch_add(1, std::memory_order_release);
+    OPENSSL_cleanse(keys, sizeof(keys));
+  }
+
+  for (uint32_t i = 0; i < header_.key_count_; i++) {
+    cached.keys_.keys_[i] = header_.keys_[i].key_;
+  }
+  cached.keys_.count_ = header_.key_count_;
+  cached.epoch_ = header_.keys_[0].epoch_;
+  cached.generation_ = header_.keys_generation_.load(std::memory_order_relaxed);
+  return cached.keys_;
+}
+
+#else
+
+absl::StatusOr<std::shared_ptr<SharedSessionCache>>
+SharedSessionCache::create(const Ssl::ServerContextConfig::SharedSessionCacheConfig&,
+                           TimeSource&) {
+  return absl::UnimplementedError("shared TLS session caches are only supported on Linux");
+}
+
+// No cache can be created on other platforms.
+SharedSessionCache::~SharedSessionCache() = default;
+
+bool SharedSessionCache::insert(absl::Span<const uint8_t>, absl::Span<const uint8_t>, SystemTime) {
+  return false;
+}
+
+bool SharedSessionCache::lookup(absl::Span<const uint8_t>, std::vector<uint8_t>&) { return false; }
+
+void SharedSessionCache::remove(absl::Span<const uint8_t>) {}
+
+SharedSessionCache::TicketKeys SharedSessionCache::ticketKeys(CachedTicketKeys&) { return {}; }
+
+#endif
+
+SharedSessionCache::TicketKeys::~TicketKeys() { OPENSSL_cleanse(keys_.data(), sizeof(keys_)); }
+
+SINGLETON_MANAGER_REGISTRATION(shared_tls_session_cache_registry);
+
+std::shared_ptr<SharedSessionCacheRegistry>
+SharedSessionCacheRegistry::get(Singleton::Manager& manager) {
+  // Pinned so that contexts created after the last one using a cache is destroyed, e.g. when a
+  // listener is updated, can still find caches held by other contexts.
+  return manager.getTyped<SharedSessionCacheRegistry>(
+      SINGLETON_MANAGER_REGISTERED_NAME(shared_tls_session_cache_registry),
+      [] { return std::make_shared<SharedSessionCacheRegistry>(); }, true);
+}
+
+absl::StatusOr<std::shared_ptr<SharedSessionCache>> SharedSessionCacheRegistry::getOrCreate(
+    const Ssl::ServerContextConfig::SharedSessionCacheConfig& config, TimeSource& time_source) {
+  const std::string key =
+      absl::StrCat(config.max_sessions_, ":", config.max_session_size_, ":",
+                   config.ticket_key_rotation_interval_.count(), ":", config.path_);
+  absl::MutexLock lock(&mutex_);
+  std::weak_ptr<SharedSessionCache>& entry = caches_[key];
+  if (std::shared_ptr<SharedSessionCache> cache = entry.lock(); cache != nullptr) {
+    return cache;
+  }
+  auto cache_or_error = SharedSessionCache::create(config, time_source);
+  RETURN_IF_NOT_OK_REF(cache_or_error.status());
+  entry = *cache_or_error;
+  return cache_or_error;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/ssl/context_config.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A cache of encoded TLS sessions and of session ticket keys, shared by the server contexts of a
+ * process and optionally, by storing it in a file, by the Envoy processes of a hot restart.
+ *
+ * The cache is a table of fixed-size slots in a shared memory mapping, so it never allocates and
+ * can be used by several processes. The table is divided into shards, each with its own
+ * process-shared lock. A session can only be stored in a few consecutive slots of the shard its ID
+ * hashes to, and replaces the least recently used of them, so each operation takes one lock and
+ * examines a bounded number of slots.
+ *
+ * The session ticket keys are generated by the cache and replaced every rotation interval, at
+ * times derived from the clock, so that every process sharing the cache uses the same keys. Each
+ * user of the keys keeps a copy of them, which is only refreshed under the process-shared lock
+ * when the rotation interval ends or another process changes the keys.
+ *
+ * A cache stored in a file holds the secrets of its sessions and the session ticket keys, which
+ * allow the traffic of the connections using them to be decrypted. The file must therefore be a
+ * regular file owned by the user Envoy runs as, with mode 0600; other files are refused.
+ *
+ * This is only supported on Linux.
+ */
+class SharedSessionCache {
+public:
+  using TicketKey = Ssl::ServerContextConfig::SessionTicketKey;
+  // The current key and the keys of the two previous rotation intervals.
+  static constexpr uint32_t MaxTicketKeys = 3;
+
+  /**
+   * A copy of the session ticket keys, which is cleansed when it is destroyed.
+   */
+  class TicketKeys {
+  public:
+    TicketKeys() = default;
+    TicketKeys(const TicketKeys&) = default;
+    TicketKeys& operator=(const TicketKeys&) = default;
+    ~TicketKeys();
+
+    /**
+     * @return the keys. The first key is used for encrypting new tickets, and all of them are
+     * candidates for decrypting received tickets.
+     */
+    absl::Span<const TicketKey> keys() const { return {keys_.data(), count_}; }
+
+  private:
+    friend class SharedSessionCache;
+
+    std::array<TicketKey, MaxTicketKeys> keys_{};
+    uint32_t count_{};
+  };
+
+  /**
+   * The session ticket keys last read by a user of the cache, e.g. a server context, so that the
+   * process-shared lock is only taken when the keys have changed.
+   */
+  class CachedTicketKeys {
+  private:
+    friend class SharedSessionCache;
+
+    absl::Mutex mutex_;
+    // The number of times the keys had been changed when they were read.
+    uint64_t generation_ ABSL_GUARDED_BY(mutex_){};
+    // The rotation interval of the current key.
+    int64_t epoch_ ABSL_GUARDED_BY(mutex_){};
+    TicketKeys keys_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  static absl::StatusOr<std::shared_ptr<SharedSessionCache>>
+  create(const Ssl::ServerContextConfig::SharedSessionCacheConfig& config,
+         TimeSource& time_source);
+  ~SharedSessionCache();
+
+  /**
+   * Stores a session, replacing any session with the same ID.
+   * @param id the session ID.
+   * @param session the encoded session.
+   * @param expiry the time after which the session cannot be resumed.
+   * @return false if the session was not stored because it or its ID is too large.
+   */
+  bool insert(absl::Span<const uint8_t> id, absl::Span<const uint8_t> session, SystemTime expiry);
+
+  /**
+   * Finds a session which has not expired.
+   * @param id the session ID.
+   * @param session receives the encoded session if it is found.
+   * @return whether the session was found.
+   */
+  bool lookup(absl::Span<const uint8_t> id, std::vector<uint8_t>& session);
+
+  /**
+   * Removes a session if it is in the cache.
+   */
+  void remove(absl::Span<const uint8_t> id);
+
+  /**
+   * @param cached the keys last read by the caller, which are refreshed if the current key is due
+   * to be replaced, in which case a new key is generated, or if the keys have been changed since
+   * they were read.
+   * @return the session ticket keys.
+   */
+  TicketKeys ticketKeys(CachedTicketKeys& cached);
+
+private:
+  struct Header;
+  struct Shard;
+  struct Slot;
+
+  // The slots a session can be stored in: the Ways slots of a shard starting at first_slot_.
+  struct Location {
+    uint32_t shard_;
+    uint32_t first_slot_;
+  };
+
+  SharedSessionCache(TimeSource& time_source, void* mapping, size_t mapping_size);
+
+  static size_t shardsOffset();
+  static size_t slotsOffset();
+  Shard& shard(uint32_t index);
+  Slot& slot(uint32_t shard, uint32_t index);
+  Location locate(absl::Span<const uint8_t> id) const;
+  // Finds the slot holding a session, or nullptr. The shard's lock must be held.
+  Slot* findSlot(const Location& location, absl::Span<const uint8_t> id);
+  void clearShard(uint32_t shard);
+  int64_t nowSeconds() const;
+
+  TimeSource& time_source_;
+  void* const mapping_;
+  const size_t mapping_size_;
+  Header& header_;
+};
+
+/**
+ * The shared session caches of a process, so that server contexts with the same cache
+ * configuration use the same cache. A cache is destroyed when no context uses it.
+ */
+class SharedSessionCacheRegistry : public Singleton::Instance {
+public:
+  static std::shared_ptr<SharedSessionCacheRegistry> get(Singleton::Manager& manager);
+
+  absl::StatusOr<std::shared_ptr<SharedSessionCache>>
+  getOrCreate(const Ssl::ServerContextConfig::SharedSessionCacheConfig& config,
+              TimeSource& time_source);
+
+private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::weak_ptr<SharedSessionCache>>
+      caches_ ABSL_GUARDED_BY(mutex_);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
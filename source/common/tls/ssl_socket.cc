@@ -10,6 +10,7 @@
 #include "source/common/tls/ssl_handshaker.h"
 #include "source/common/tls/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_replace.h"
 #include "openssl/err.h"
 #include "openssl/x509v3.h"
@@ -117,6 +118,13 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     }
   }
 
+  if (ktls_ == Ktls::Offload::Enabled) {
+    return doKernelTlsRead(read_buffer);
+  }
+  if (ktls_ == Ktls::Offload::Failed) {
+    return {PostIoAction::Close, 0, false};
+  }
+
   bool keep_reading = true;
   bool end_stream = false;
   PostIoAction action = PostIoAction::KeepOpen;
@@ -191,6 +199,9 @@ Network::Connection& SslSocket::connection() const { return callbacks_->connecti
 
 void SslSocket::onSuccess(SSL* ssl) {
   ctx_->logHandshake(ssl);
+  if (ctx_->kernelTlsEnabled()) {
+    enableKernelTls(ssl);
+  }
   if (callbacks_->connection().streamInfo().upstreamInfo()) {
     callbacks_->connection()
         .streamInfo()
@@ -206,6 +217,104 @@ void SslSocket::onSuccess(SSL* ssl) {
 
 void SslSocket::onFailure() { drainErrorQueue(); }
 
+void SslSocket::enableKernelTls(SSL* ssl) {
+  ktls_ = Ktls::enable(ssl, callbacks_->ioHandle());
+  ENVOY_CONN_LOG(debug, "kernel TLS: {}", callbacks_->connection(), static_cast<int>(ktls_));
+  switch (ktls_) {
+  case Ktls::Offload::None:
+    ctx_->stats().ktls_unsupported_.inc();
+    break;
+  case Ktls::Offload::Enabled:
+    ctx_->stats().ktls_enabled_.inc();
+    break;
+  case Ktls::Offload::Failed:
+    // The connection is closed by the next read or write.
+    ctx_->stats().ktls_failed_.inc();
+    failure_reason_ = "kernel TLS: failed to install the traffic keys";
+    break;
+  }
+}
+
+Network::IoResult SslSocket::doKernelTlsRead(Buffer::Instance& read_buffer) {
+  PostIoAction action = PostIoAction::KeepOpen;
+  uint64_t bytes_read = 0;
+  bool end_stream = false;
+  absl::optional<Api::IoError::IoErrorCode> err = absl::nullopt;
+  do {
+    Buffer::Reservation reservation = read_buffer.reserveForRead();
+    uint8_t record_type = 0;
+    Api::IoCallUint64Result result = Ktls::receive(
+        callbacks_->ioHandle(), reservation.slices(), reservation.numSlices(), record_type);
+
+    if (!result.ok()) {
+      ENVOY_CONN_LOG(trace, "ktls read error: {}, code: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails(), static_cast<int>(result.err_->getErrorCode()));
+      if (result.err_->getErrorCode() != Api::IoError::IoErrorCode::Again) {
+        action = PostIoAction::Close;
+        err = result.err_->getErrorCode();
+      }
+      break;
+    }
+    ENVOY_CONN_LOG(trace, "ktls read returns: {} (record type {})", callbacks_->connection(),
+                   result.return_value_, record_type);
+    if (result.return_value_ == 0) {
+      // Non-graceful shutdown by closing the underlying socket.
+      end_stream = true;
+      break;
+    }
+    if (record_type != Ktls::ApplicationDataContentType) {
+      // The contents of an alert are its level and description. Only a close_notify alert ends the
+      // stream gracefully. Other alerts are fatal, and post-handshake messages such as key updates
+      // cannot be processed once the kernel has the keys.
+      const uint8_t* contents = static_cast<const uint8_t*>(reservation.slices()[0].mem_);
+      if (record_type == Ktls::AlertContentType && result.return_value_ == 2 &&
+          contents[1] == Ktls::CloseNotifyAlert) {
+        end_stream = true;
+      } else {
+        ENVOY_CONN_LOG(debug, "ktls: unexpected record of type {}", callbacks_->connection(),
+                       record_type);
+        failure_reason_ = absl::StrCat("kernel TLS: unexpected record of type ",
+                                       static_cast<int>(record_type));
+        action = PostIoAction::Close;
+      }
+      break;
+    }
+    reservation.commit(result.return_value_);
+    bytes_read += result.return_value_;
+    if (callbacks_->shouldDrainReadBuffer()) {
+      callbacks_->setTransportSocketIsReadable();
+      break;
+    }
+  } while (true);
+
+  ENVOY_CONN_LOG(trace, "ktls read {} bytes", callbacks_->connection(), bytes_read);
+  return {action, bytes_read, end_stream, err};
+}
+
+Network::IoResult SslSocket::doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  uint64_t bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    // Writing the buffer directly lets slices which refer to files be sent with sendfile.
+    Api::IoCallUint64Result result = callbacks_->ioHandle().write(write_buffer);
+    if (!result.ok()) {
+      ENVOY_CONN_LOG(trace, "ktls write error: {}, code: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails(), static_cast<int>(result.err_->getErrorCode()));
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        return {PostIoAction::KeepOpen, bytes_written, false};
+      }
+      return {PostIoAction::Close, bytes_written, false, result.err_->getErrorCode()};
+    }
+    ENVOY_CONN_LOG(trace, "ktls write returns: {}", callbacks_->connection(), result.return_value_);
+    bytes_written += result.return_value_;
+  }
+
+  if (end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, bytes_written, false};
+}
+
 PostIoAction SslSocket::doHandshake() { return info_->doHandshake(); }
 
 void SslSocket::drainErrorQueue() {
@@ -263,6 +372,14 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (ktls_ == Ktls::Offload::Enabled) {
+    ASSERT(bytes_to_retry_ == 0);
+    return doKernelTlsWrite(write_buffer, end_stream);
+  }
+  if (ktls_ == Ktls::Offload::Failed) {
+    return {PostIoAction::Close, 0, false};
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
@@ -321,6 +438,17 @@ void SslSocket::shutdownSsl() {
   ASSERT(info_->state() != Ssl::SocketState::PreHandshake);
   if (info_->state() != Ssl::SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
+    if (ktls_ != Ktls::Offload::None) {
+      // BoringSSL no longer has the keys for the records it would send, so the kernel sends the
+      // alert. Nothing is sent if the kernel only has some of the keys.
+      if (ktls_ == Ktls::Offload::Enabled) {
+        const Api::SysCallSizeResult result = Ktls::sendCloseNotify(callbacks_->ioHandle());
+        ENVOY_CONN_LOG(debug, "kernel TLS shutdown: rc={}", callbacks_->connection(),
+                       result.return_value_);
+      }
+      info_->setState(Ssl::SocketState::ShutdownSent);
+      return;
+    }
     int rc = SSL_shutdown(rawSsl());
     if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
       // Windows operate under `EmulatedEdge`. These are level events that are artificially
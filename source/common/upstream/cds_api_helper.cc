@@ -52,7 +52,9 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
             fmt::format("{}: duplicate cluster {} found", cluster_name, cluster_name));
         continue;
       }
-      auto update_or_error = cm_.addOrUpdateCluster(cluster, resource.get().version());
+      auto update_or_error = cm_.addOrUpdateCluster(cluster, resource.get().version(),
+                                                    /*avoid_cds_removal=*/false,
+                                                    /*from_cds=*/true);
       if (!update_or_error.status().ok()) {
         exception_msgs.push_back(
             fmt::format("{}: {}", cluster_name, update_or_error.status().message()));
@@ -51,6 +51,7 @@ absl::Status CdsApiImpl::onConfigUpdate(const std::vector<Config::DecodedResourc
   for (const auto& resource : resources) {
     all_existing_clusters.active_clusters_.erase(resource.get().name());
     all_existing_clusters.warming_clusters_.erase(resource.get().name());
+    all_existing_clusters.lazy_clusters_.erase(resource.get().name());
   }
   Protobuf::RepeatedPtrField<std::string> to_remove_repeated;
   for (const auto& [cluster_name, _] : all_existing_clusters.active_clusters_) {
@@ -64,6 +65,9 @@ absl::Status CdsApiImpl::onConfigUpdate(const std::vector<Config::DecodedResourc
       *to_remove_repeated.Add() = cluster_name;
     }
   }
+  for (const std::string& cluster_name : all_existing_clusters.lazy_clusters_) {
+    *to_remove_repeated.Add() = cluster_name;
+  }
   return onConfigUpdate(resources, to_remove_repeated, version_info);
 }
 
@@ -122,6 +122,15 @@ absl::Status createClients(Grpc::AsyncClientFactoryPtr& primary_factory,
   return absl::OkStatus();
 }
 
+// The number of requests and connections of a cluster so far, which changes while it is in use.
+uint64_t clusterActivity(const ClusterInfo& info) {
+  if (!info.trafficStats().isPresent()) {
+    return 0;
+  }
+  return info.trafficStats()->upstream_rq_total_.value() +
+         info.trafficStats()->upstream_cx_total_.value();
+}
+
 } // namespace
 
 void ClusterManagerInitHelper::addCluster(ClusterManagerCluster& cm_cluster) {
@@ -329,6 +338,9 @@ ClusterManagerImpl::ClusterManagerImpl(
     : server_(server), factory_(factory), runtime_(runtime), stats_(stats), tls_(tls),
       xds_manager_(xds_manager), random_(api.randomGenerator()),
       deferred_cluster_creation_(bootstrap.cluster_manager().enable_deferred_cluster_creation()),
+      lazy_cluster_creation_(bootstrap.cluster_manager().has_lazy_cluster_creation()),
+      lazy_cluster_idle_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(
+          bootstrap.cluster_manager().lazy_cluster_creation(), idle_timeout, 0)),
       bind_config_(bootstrap.cluster_manager().has_upstream_bind_config()
                        ? absl::make_optional(bootstrap.cluster_manager().upstream_bind_config())
                        : absl::nullopt),
@@ -885,7 +897,7 @@ void ClusterManagerImpl::applyUpdates(ClusterManagerCluster& cluster, uint32_t p
 absl::StatusOr<bool>
 ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                                        const std::string& version_info,
-                                       const bool avoid_cds_removal) {
+                                       const bool avoid_cds_removal, const bool from_cds) {
   // First we need to see if this new config is new or an update to an existing dynamic cluster.
   // We don't allow updates to statically configured clusters in the main configuration. We check
   // both the warming clusters and the active clusters to see if we need an update or the update
@@ -894,6 +906,17 @@ ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster
   const auto existing_active_cluster = active_clusters_.find(cluster_name);
   const auto existing_warming_cluster = warming_clusters_.find(cluster_name);
   const uint64_t new_hash = MessageUtil::hash(cluster);
+  // Only clusters from CDS are created lazily. Clusters added by extensions, such as the sub
+  // clusters of the dynamic forward proxy, are waited for by their callers, and clusters which
+  // already exist, such as static clusters, and clusters requested by an on-demand discovery are
+  // about to be used.
+  if (lazy_cluster_creation_ && from_cds && !avoid_cds_removal &&
+      (lazy_clusters_.contains(cluster_name) ||
+       (existing_active_cluster == active_clusters_.end() &&
+        existing_warming_cluster == warming_clusters_.end() &&
+        !pending_cluster_creations_.contains(cluster_name)))) {
+    return addOrUpdateLazyCluster(cluster, new_hash, version_info);
+  }
   if (existing_warming_cluster != warming_clusters_.end()) {
     // If the cluster is the same as the warming cluster of the same name, block the update.
     if (existing_warming_cluster->second->blockUpdate(new_hash)) {
@@ -910,15 +933,25 @@ ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster
 
   if (existing_active_cluster != active_clusters_.end() ||
       existing_warming_cluster != warming_clusters_.end()) {
-    if (existing_active_cluster != active_clusters_.end()) {
-      // The following init manager remove call is a NOP in the case we are already initialized.
-      // It's just kept here to avoid additional logic.
-      init_helper_.removeCluster(*existing_active_cluster->second);
-    }
     cm_stats_.cluster_modified_.inc();
   } else {
     cm_stats_.cluster_added_.inc();
   }
+  RETURN_IF_NOT_OK(loadOrUpdateCluster(cluster, new_hash, version_info, avoid_cds_removal));
+  return true;
+}
+
+absl::Status
+ClusterManagerImpl::loadOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                                        uint64_t new_hash, const std::string& version_info,
+                                        bool avoid_cds_removal) {
+  const std::string& cluster_name = cluster.name();
+  const auto existing_active_cluster = active_clusters_.find(cluster_name);
+  if (existing_active_cluster != active_clusters_.end()) {
+    // The following init manager remove call is a NOP in the case we are already initialized.
+    // It's just kept here to avoid additional logic.
+    init_helper_.removeCluster(*existing_active_cluster->second);
+  }
 
   // There are two discrete paths here depending on when we are adding/updating a cluster.
   // 1) During initial server load we use the init manager which handles complex logic related to
@@ -955,9 +988,89 @@ ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster
     });
   }
 
+  return absl::OkStatus();
+}
+
+absl::StatusOr<bool>
+ClusterManagerImpl::addOrUpdateLazyCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                                           uint64_t new_hash,
+                                           const std::string& version_info) {
+  const std::string& cluster_name = cluster.name();
+  auto existing_lazy_cluster = lazy_clusters_.find(cluster_name);
+  if (existing_lazy_cluster != lazy_clusters_.end()) {
+    if (existing_lazy_cluster->second.config_hash_ == new_hash) {
+      return false;
+    }
+    // A cluster which is created is updated right away, so that its stored config is only
+    // replaced by one which is accepted.
+    if (active_clusters_.contains(cluster_name) || warming_clusters_.contains(cluster_name)) {
+      RETURN_IF_NOT_OK(loadOrUpdateCluster(cluster, new_hash, version_info,
+                                           /*avoid_cds_removal=*/false));
+    }
+    cm_stats_.cluster_modified_.inc();
+  } else {
+    existing_lazy_cluster = lazy_clusters_.try_emplace(cluster_name).first;
+    cm_stats_.cluster_added_.inc();
+  }
+
+  ENVOY_LOG(debug, "add/update lazy cluster {}", cluster_name);
+  LazyCluster& lazy_cluster = existing_lazy_cluster->second;
+  lazy_cluster.config_ = cluster.SerializeAsString();
+  lazy_cluster.config_hash_ = new_hash;
+  lazy_cluster.version_info_ = version_info;
+  cm_stats_.lazy_clusters_.set(lazy_clusters_.size());
   return true;
 }
 
+absl::Status ClusterManagerImpl::createLazyCluster(const std::string& cluster_name) {
+  LazyCluster& lazy_cluster = lazy_clusters_.at(cluster_name);
+  envoy::config::cluster::v3::Cluster cluster;
+  const bool parsed = cluster.ParseFromString(lazy_cluster.config_);
+  RELEASE_ASSERT(parsed, fmt::format("failed to parse stored config of cluster {}", cluster_name));
+
+  ENVOY_LOG(debug, "creating lazy cluster {}", cluster_name);
+  RETURN_IF_NOT_OK(loadOrUpdateCluster(cluster, lazy_cluster.config_hash_,
+                                       lazy_cluster.version_info_,
+                                       /*avoid_cds_removal=*/false));
+  cm_stats_.lazy_cluster_created_.inc();
+  if (lazy_cluster_idle_timeout_.count() > 0) {
+    // The timer is kept when the cluster is destroyed, to be enabled again if it is recreated.
+    if (lazy_cluster.idle_timer_ == nullptr) {
+      lazy_cluster.idle_timer_ = dispatcher_.createTimer(
+          [this, cluster_name] { onLazyClusterIdleTimeout(cluster_name); });
+    }
+    lazy_cluster.last_activity_ = 0;
+    lazy_cluster.idle_timer_->enableTimer(lazy_cluster_idle_timeout_);
+  }
+  return absl::OkStatus();
+}
+
+void ClusterManagerImpl::onLazyClusterIdleTimeout(const std::string& cluster_name) {
+  LazyCluster& lazy_cluster = lazy_clusters_.at(cluster_name);
+  const auto active_cluster = active_clusters_.find(cluster_name);
+  if (active_cluster == active_clusters_.end()) {
+    // The cluster is still warming, which is not a reason to destroy it.
+    lazy_cluster.idle_timer_->enableTimer(lazy_cluster_idle_timeout_);
+    return;
+  }
+
+  const ClusterInfo& info = *active_cluster->second->cluster_->info();
+  const uint64_t activity = clusterActivity(info);
+  const bool in_use = info.trafficStats().isPresent() &&
+                      (info.trafficStats()->upstream_cx_active_.value() > 0 ||
+                       info.trafficStats()->upstream_rq_active_.value() > 0);
+  if (in_use || activity != lazy_cluster.last_activity_) {
+    lazy_cluster.last_activity_ = activity;
+    lazy_cluster.idle_timer_->enableTimer(lazy_cluster_idle_timeout_);
+    return;
+  }
+
+  ENVOY_LOG(debug, "destroying idle lazy cluster {}", cluster_name);
+  unloadCluster(cluster_name, /*remove_ignored=*/true);
+  cm_stats_.lazy_cluster_evicted_.inc();
+  updateClusterCounts();
+}
+
 void ClusterManagerImpl::clusterWarmingToActive(const std::string& cluster_name) {
   auto warming_it = warming_clusters_.find(cluster_name);
   ASSERT(warming_it != warming_clusters_.end());
@@ -971,6 +1084,28 @@ void ClusterManagerImpl::clusterWarmingToActive(const std::string& cluster_name)
 }
 
 bool ClusterManagerImpl::removeCluster(const std::string& cluster_name, const bool remove_ignored) {
+  bool removed = false;
+  auto existing_lazy_cluster = lazy_clusters_.find(cluster_name);
+  if (existing_lazy_cluster != lazy_clusters_.end()) {
+    removed = true;
+    lazy_clusters_.erase(existing_lazy_cluster);
+    cm_stats_.lazy_clusters_.set(lazy_clusters_.size());
+    ENVOY_LOG(debug, "removing lazy cluster {}", cluster_name);
+  }
+
+  if (unloadCluster(cluster_name, remove_ignored)) {
+    removed = true;
+  }
+
+  if (removed) {
+    cm_stats_.cluster_removed_.inc();
+    updateClusterCounts();
+  }
+
+  return removed;
+}
+
+bool ClusterManagerImpl::unloadCluster(const std::string& cluster_name, const bool remove_ignored) {
   bool removed = false;
   auto existing_active_cluster = active_clusters_.find(cluster_name);
   if (existing_active_cluster != active_clusters_.end() &&
@@ -1012,8 +1147,6 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name, const bo
   }
 
   if (removed) {
-    cm_stats_.cluster_removed_.inc();
-    updateClusterCounts();
     // Cancel any pending merged updates.
     updates_map_.erase(cluster_name);
   }
@@ -1772,12 +1905,27 @@ ClusterManagerImpl::requestOnDemandClusterDiscovery(OdCdsApiSharedPtr odcds, std
       // it means that it was other worker thread that requested the discovery.
       return;
     }
-    // Start the discovery. If the cluster gets discovered, cluster manager will warm it up and
-    // invoke the cluster lifecycle callbacks, that will in turn invoke our callback.
-    odcds->updateOnDemand(name);
     // Setup the discovery timeout timer to avoid keeping callbacks indefinitely.
     auto timer = dispatcher_.createTimer([this, name] { notifyExpiredDiscovery(name); });
     timer->enableTimer(timeout);
+    if (lazy_clusters_.contains(name)) {
+      // The cluster's config is already known, so it only needs to be created, unless that is
+      // already under way. Once it is warmed up the cluster lifecycle callbacks invoke our
+      // callback.
+      pending_cluster_creations_.insert(
+          {name, ClusterCreation{std::move(odcds), std::move(timer)}});
+      if (!warming_clusters_.contains(name) && !active_clusters_.contains(name)) {
+        const absl::Status status = createLazyCluster(name);
+        if (!status.ok()) {
+          ENVOY_LOG(warn, "cm odcds: failed to create lazy cluster {}: {}", name, status.message());
+          notifyMissingCluster(name);
+        }
+      }
+      return;
+    }
+    // Start the discovery. If the cluster gets discovered, cluster manager will warm it up and
+    // invoke the cluster lifecycle callbacks, that will in turn invoke our callback.
+    odcds->updateOnDemand(name);
     // Keep odcds handle alive for the duration of the discovery process.
     pending_cluster_creations_.insert(
         {std::move(name), ClusterCreation{std::move(odcds), std::move(timer)}});
@@ -211,9 +211,12 @@ private:
   COUNTER(cluster_removed)                                                                         \
   COUNTER(cluster_updated)                                                                         \
   COUNTER(cluster_updated_via_merge)                                                               \
+  COUNTER(lazy_cluster_created)                                                                    \
+  COUNTER(lazy_cluster_evicted)                                                                    \
   COUNTER(update_merge_cancelled)                                                                  \
   COUNTER(update_out_of_merge_window)                                                              \
   GAUGE(active_clusters, NeverImport)                                                              \
+  GAUGE(lazy_clusters, NeverImport)                                                                \
   GAUGE(warming_clusters, NeverImport)
 
 /**
@@ -252,7 +255,8 @@ public:
   // Upstream::ClusterManager
   absl::StatusOr<bool> addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                                           const std::string& version_info,
-                                          const bool avoid_cds_removal = false) override;
+                                          const bool avoid_cds_removal = false,
+                                          const bool from_cds = false) override;
 
   void setPrimaryClustersInitializedCb(PrimaryClustersReadyCallback callback) override {
     init_helper_.setPrimaryClustersInitializedCb(callback);
@@ -280,6 +284,11 @@ public:
     // of active clusters + number of warming clusters.
     ASSERT(clusters_maps.added_via_api_clusters_num_ <=
            clusters_maps.active_clusters_.size() + clusters_maps.warming_clusters_.size());
+    for (const auto& cluster : lazy_clusters_) {
+      if (!active_clusters_.contains(cluster.first) && !warming_clusters_.contains(cluster.first)) {
+        clusters_maps.lazy_clusters_.insert(cluster.first);
+      }
+    }
     return clusters_maps;
   }
 
@@ -298,6 +307,7 @@ public:
     xds_manager_.shutdown();
     active_clusters_.clear();
     warming_clusters_.clear();
+    lazy_clusters_.clear();
     updateClusterCounts();
   }
 
@@ -864,6 +874,22 @@ private:
 
   using ClusterCreationsMap = absl::flat_hash_map<std::string, ClusterCreation>;
 
+  /**
+   * The configuration of a cluster added via CDS while lazy cluster creation is configured. The
+   * cluster is only created, in warming_clusters_ and then active_clusters_, once it is used.
+   */
+  struct LazyCluster {
+    // The serialized cluster, which is smaller than the parsed message.
+    std::string config_;
+    uint64_t config_hash_{};
+    std::string version_info_;
+    // While the cluster is created, its activity when the idle timer was last enabled.
+    uint64_t last_activity_{};
+    Event::TimerPtr idle_timer_;
+  };
+
+  using LazyClusterMap = absl::flat_hash_map<std::string, LazyCluster>;
+
   void applyUpdates(ClusterManagerCluster& cluster, uint32_t priority, PendingUpdates& updates);
   bool scheduleUpdate(ClusterManagerCluster& cluster, uint32_t priority, bool mergeable,
                       const uint64_t timeout);
@@ -880,6 +906,15 @@ private:
                                              const std::string& version_info, bool added_via_api,
                                              bool required_for_ads, ClusterMap& cluster_map,
                                              bool avoid_cds_removal = false);
+  absl::Status loadOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                                   uint64_t new_hash, const std::string& version_info,
+                                   bool avoid_cds_removal);
+  absl::StatusOr<bool> addOrUpdateLazyCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                                              uint64_t new_hash, const std::string& version_info);
+  absl::Status createLazyCluster(const std::string& cluster_name);
+  void onLazyClusterIdleTimeout(const std::string& cluster_name);
+  // Removes the created cluster of the given name, without updating the cluster stats.
+  bool unloadCluster(const std::string& cluster_name, bool remove_ignored);
   absl::Status onClusterInit(ClusterManagerCluster& cluster);
   void postThreadLocalHealthFailure(const HostSharedPtr& host);
   void updateClusterCounts();
@@ -922,6 +957,8 @@ private:
   Config::XdsManager& xds_manager_;
   Random::RandomGenerator& random_;
   const bool deferred_cluster_creation_;
+  const bool lazy_cluster_creation_;
+  const std::chrono::milliseconds lazy_cluster_idle_timeout_;
   absl::optional<envoy::config::core::v3::BindConfig> bind_config_;
   Outlier::EventLoggerSharedPtr outlier_event_logger_;
   const LocalInfo::LocalInfo& local_info_;
@@ -955,6 +992,7 @@ private:
       common_lb_config_pool_;
 
   ClusterSet primary_clusters_;
+  LazyClusterMap lazy_clusters_;
 
   bool initialized_{};
   bool ads_mux_initialized_{};
@@ -1,11 +1,13 @@
 #include "source/common/upstream/upstream_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <limits>
 #include <list>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "envoy/config/cluster/v3/circuit_breaker.pb.h"
@@ -58,6 +60,7 @@
 #include "source/extensions/filters/network/http_connection_manager/config.h"
 #include "source/server/transport_socket_config_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/strings/str_cat.h"
 
@@ -440,6 +443,34 @@ HostDescriptionImpl::HostDescriptionImpl(
       address_list_or_null_(makeAddressListOrNull(dest_address, address_list)),
       health_check_address_(resolveHealthCheckAddress(health_check_config, dest_address)) {}
 
+SharedLocalityConstSharedPtr
+SharedLocality::get(const envoy::config::core::v3::Locality& locality,
+                    Stats::SymbolTable& symbol_table) {
+  using Key = std::tuple<std::string, std::string, std::string, const Stats::SymbolTable*>;
+  struct Pool {
+    absl::Mutex mutex_;
+    absl::flat_hash_map<Key, std::weak_ptr<const SharedLocality>> entries_ ABSL_GUARDED_BY(mutex_);
+    // The size at which the entries of localities no longer used are removed.
+    size_t sweep_size_ ABSL_GUARDED_BY(mutex_){64};
+  };
+  static Pool* pool = new Pool();
+
+  Key key{locality.region(), locality.zone(), locality.sub_zone(), &symbol_table};
+  absl::MutexLock lock(&pool->mutex_);
+  std::weak_ptr<const SharedLocality>& entry = pool->entries_[key];
+  SharedLocalityConstSharedPtr shared = entry.lock();
+  if (shared != nullptr) {
+    return shared;
+  }
+  shared = std::make_shared<const SharedLocality>(locality, symbol_table);
+  entry = shared;
+  if (pool->entries_.size() >= pool->sweep_size_) {
+    absl::erase_if(pool->entries_, [](const auto& item) { return item.second.expired(); });
+    pool->sweep_size_ = std::max<size_t>(64, 2 * pool->entries_.size());
+  }
+  return shared;
+}
+
 HostDescriptionImplBase::HostDescriptionImplBase(
     ClusterInfoConstSharedPtr cluster, const std::string& hostname,
     Network::Address::InstanceConstSharedPtr dest_address, MetadataConstSharedPtr endpoint_metadata,
@@ -453,8 +484,7 @@ HostDescriptionImplBase::HostDescriptionImplBase(
                                               Config::MetadataEnvoyLbKeys::get().CANARY)
                   .bool_value()),
       endpoint_metadata_(endpoint_metadata), locality_metadata_(locality_metadata),
-      locality_(locality),
-      locality_zone_stat_name_(locality.zone(), cluster->statsScope().symbolTable()),
+      locality_(SharedLocality::get(locality, cluster->statsScope().symbolTable())),
       priority_(priority),
       socket_factory_(resolveTransportSocketFactory(dest_address, endpoint_metadata_.get())),
       creation_time_(time_source.monotonicTime()) {
@@ -466,6 +496,30 @@ HostDescriptionImplBase::HostDescriptionImplBase(
   }
 }
 
+HostDescriptionImplBase::~HostDescriptionImplBase() { delete stats_.load(); }
+
+HostStats& HostDescriptionImplBase::stats() const {
+  HostStats* stats = stats_.load(std::memory_order_acquire);
+  if (stats != nullptr) {
+    return *stats;
+  }
+  auto new_stats = std::make_unique<HostStats>();
+  if (stats_.compare_exchange_strong(stats, new_stats.get(), std::memory_order_acq_rel)) {
+    stats = new_stats.release();
+  }
+  return *stats;
+}
+
+HostStats& HostDescriptionImplBase::statsForReading() const {
+  HostStats* stats = stats_.load(std::memory_order_acquire);
+  if (stats != nullptr) {
+    return *stats;
+  }
+  // Nothing changes these, but reading counters latches them, which requires mutable references.
+  static HostStats* zero_stats = new HostStats();
+  return *zero_stats;
+}
+
 HostDescription::SharedConstAddressVector HostDescriptionImplBase::makeAddressListOrNull(
     const Network::Address::InstanceConstSharedPtr& address, const AddressVector& address_list) {
   if (!address || address_list.empty()) {
@@ -1693,6 +1747,58 @@ bool excludeBasedOnHealthFlag(const Host& host) {
          host.healthFlagGet(Host::HealthFlag::EDS_STATUS_DRAINING);
 }
 
+bool isHealthy(const Host& host) { return host.coarseHealth() == Host::Health::Healthy; }
+
+bool isDegraded(const Host& host) { return host.coarseHealth() == Host::Health::Degraded; }
+
+// Whether the hosts matching the predicate are, in order, exactly those of the partition. This
+// does not allocate, unlike building the partition again to compare it.
+bool partitionUnchanged(const HostVector& hosts, const HostVector& partition,
+                        const std::function<bool(const Host&)>& predicate) {
+  size_t matched = 0;
+  for (const auto& host : hosts) {
+    if (predicate(*host)) {
+      if (matched == partition.size() || partition[matched] != host) {
+        return false;
+      }
+      matched++;
+    }
+  }
+  return matched == partition.size();
+}
+
+template <class Partition>
+std::shared_ptr<const Partition>
+reuseOrPartition(const HostVector& hosts, std::shared_ptr<const Partition> previous,
+                 const std::function<bool(const Host&)>& predicate) {
+  if (partitionUnchanged(hosts, previous->get(), predicate)) {
+    return previous;
+  }
+  auto partition = std::make_shared<Partition>();
+  for (const auto& host : hosts) {
+    if (predicate(*host)) {
+      partition->get().emplace_back(host);
+    }
+  }
+  return partition;
+}
+
+HostsPerLocalityConstSharedPtr
+reuseOrPartition(const HostsPerLocality& hosts, HostsPerLocalityConstSharedPtr previous,
+                 const std::function<bool(const Host&)>& predicate) {
+  const auto& localities = hosts.get();
+  const auto& previous_localities = previous->get();
+  bool unchanged = hosts.hasLocalLocality() == previous->hasLocalLocality() &&
+                   localities.size() == previous_localities.size();
+  for (size_t i = 0; unchanged && i < localities.size(); ++i) {
+    unchanged = partitionUnchanged(localities[i], previous_localities[i], predicate);
+  }
+  if (unchanged) {
+    return previous;
+  }
+  return std::move(hosts.filter({predicate})[0]);
+}
+
 } // namespace
 
 std::tuple<HealthyHostVectorConstSharedPtr, DegradedHostVectorConstSharedPtr,
@@ -1729,6 +1835,37 @@ ClusterImplBase::partitionHostsPerLocality(const HostsPerLocality& hosts) {
                          std::move(filtered_clones[2]));
 }
 
+PrioritySet::UpdateHostsParams
+HostSetImpl::partitionHosts(HostVectorConstSharedPtr hosts,
+                            HostsPerLocalityConstSharedPtr hosts_per_locality,
+                            const HostSet& previous) {
+  if (hosts != previous.hostsPtr() && *hosts == previous.hosts()) {
+    hosts = previous.hostsPtr();
+  }
+  const HostsPerLocality& previous_per_locality = previous.hostsPerLocality();
+  if (hosts_per_locality != previous.hostsPerLocalityPtr() &&
+      hosts_per_locality->hasLocalLocality() == previous_per_locality.hasLocalLocality() &&
+      hosts_per_locality->get() == previous_per_locality.get()) {
+    hosts_per_locality = previous.hostsPerLocalityPtr();
+  }
+
+  auto healthy_hosts = reuseOrPartition(*hosts, previous.healthyHostsPtr(), isHealthy);
+  auto degraded_hosts = reuseOrPartition(*hosts, previous.degradedHostsPtr(), isDegraded);
+  auto excluded_hosts =
+      reuseOrPartition(*hosts, previous.excludedHostsPtr(), excludeBasedOnHealthFlag);
+  auto healthy_hosts_per_locality =
+      reuseOrPartition(*hosts_per_locality, previous.healthyHostsPerLocalityPtr(), isHealthy);
+  auto degraded_hosts_per_locality =
+      reuseOrPartition(*hosts_per_locality, previous.degradedHostsPerLocalityPtr(), isDegraded);
+  auto excluded_hosts_per_locality = reuseOrPartition(
+      *hosts_per_locality, previous.excludedHostsPerLocalityPtr(), excludeBasedOnHealthFlag);
+
+  return updateHostsParams(std::move(hosts), std::move(hosts_per_locality),
+                           std::move(healthy_hosts), std::move(healthy_hosts_per_locality),
+                           std::move(degraded_hosts), std::move(degraded_hosts_per_locality),
+                           std::move(excluded_hosts), std::move(excluded_hosts_per_locality));
+}
+
 bool ClusterInfoImpl::maintenanceMode() const {
   return runtime_.snapshot().featureEnabled(maintenance_mode_runtime_key_, 0);
 }
@@ -1906,13 +2043,14 @@ void ClusterImplBase::reloadHealthyHostsHelper(const HostSharedPtr&) {
   const auto& host_sets = prioritySet().hostSetsPerPriority();
   for (size_t priority = 0; priority < host_sets.size(); ++priority) {
     const auto& host_set = host_sets[priority];
-    // TODO(htuch): Can we skip these copies by exporting out const shared_ptr from HostSet?
-    HostVectorConstSharedPtr hosts_copy = std::make_shared<HostVector>(host_set->hosts());
-
-    HostsPerLocalityConstSharedPtr hosts_per_locality_copy = host_set->hostsPerLocality().clone();
-    prioritySet().updateHosts(
-        priority, HostSetImpl::partitionHosts(hosts_copy, hosts_per_locality_copy),
-        host_set->localityWeights(), {}, {}, random_.random(), absl::nullopt, absl::nullopt);
+    // Only the health of hosts changed, so the membership lists are shared as they are and only
+    // the partitions containing hosts whose health changed are rebuilt.
+    prioritySet().updateHosts(priority,
+                              HostSetImpl::partitionHosts(host_set->hostsPtr(),
+                                                          host_set->hostsPerLocalityPtr(),
+                                                          *host_set),
+                              host_set->localityWeights(), {}, {}, random_.random(),
+                              absl::nullopt, absl::nullopt);
   }
 }
 
@@ -2261,16 +2399,21 @@ void PriorityStateManager::updateClusterPrioritySet(
   auto per_locality_shared =
       std::make_shared<HostsPerLocalityImpl>(std::move(per_locality), non_empty_local_locality);
 
+  // Partitions which the update leaves unchanged are carried over from the current host set.
+  const auto& host_sets = parent_.prioritySet().hostSetsPerPriority();
+  PrioritySet::UpdateHostsParams update_hosts_params =
+      host_sets.size() > priority
+          ? HostSetImpl::partitionHosts(hosts, per_locality_shared, *host_sets[priority])
+          : HostSetImpl::partitionHosts(hosts, per_locality_shared);
+
   // If a batch update callback was provided, use that. Otherwise directly update
   // the PrioritySet.
   if (update_cb_ != nullptr) {
-    update_cb_->updateHosts(priority, HostSetImpl::partitionHosts(hosts, per_locality_shared),
-                            std::move(locality_weights), hosts_added.value_or(*hosts),
-                            hosts_removed.value_or<HostVector>({}), random_.random(),
-                            weighted_priority_health, overprovisioning_factor);
+    update_cb_->updateHosts(priority, std::move(update_hosts_params), std::move(locality_weights),
+                            hosts_added.value_or(*hosts), hosts_removed.value_or<HostVector>({}),
+                            random_.random(), weighted_priority_health, overprovisioning_factor);
   } else {
-    parent_.prioritySet().updateHosts(priority,
-                                      HostSetImpl::partitionHosts(hosts, per_locality_shared),
+    parent_.prioritySet().updateHosts(priority, std::move(update_hosts_params),
                                       std::move(locality_weights), hosts_added.value_or(*hosts),
                                       hosts_removed.value_or<HostVector>({}), random_.random(),
                                       weighted_priority_health, overprovisioning_factor);
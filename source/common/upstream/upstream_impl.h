@@ -137,6 +137,33 @@ private:
   const absl::optional<MonotonicTime> time_{};
 };
 
+/**
+ * A locality and the stat name of its zone. Hosts share one per distinct locality instead of each
+ * holding copies, which matters for clusters with very many hosts in few localities.
+ */
+class SharedLocality {
+public:
+  SharedLocality(const envoy::config::core::v3::Locality& locality,
+                 Stats::SymbolTable& symbol_table)
+      : locality_(locality), zone_stat_name_(locality.zone(), symbol_table) {}
+
+  /**
+   * @return the SharedLocality equal to a locality, shared with the hosts which currently use it.
+   * Thread safe.
+   */
+  static std::shared_ptr<const SharedLocality>
+  get(const envoy::config::core::v3::Locality& locality, Stats::SymbolTable& symbol_table);
+
+  const envoy::config::core::v3::Locality& locality() const { return locality_; }
+  Stats::StatName zoneStatName() const { return zone_stat_name_.statName(); }
+
+private:
+  const envoy::config::core::v3::Locality locality_;
+  const Stats::StatNameDynamicStorage zone_stat_name_;
+};
+
+using SharedLocalityConstSharedPtr = std::shared_ptr<const SharedLocality>;
+
 /**
  * Base implementation of most of Upstream::HostDescription, shared between
  * HostDescriptionImpl and LogicalHost, which is in
@@ -210,15 +237,16 @@ public:
     static DetectorHostMonitorNullImpl* null_outlier_detector = new DetectorHostMonitorNullImpl();
     return *null_outlier_detector;
   }
-  HostStats& stats() const override { return stats_; }
+  HostStats& stats() const override;
+  HostStats& statsForReading() const override;
   LoadMetricStats& loadMetricStats() const override { return load_metric_stats_; }
   const std::string& hostnameForHealthChecks() const override { return health_checks_hostname_; }
   const std::string& hostname() const override { return hostname_; }
-  const envoy::config::core::v3::Locality& locality() const override { return locality_; }
-  const MetadataConstSharedPtr localityMetadata() const override { return locality_metadata_; }
-  Stats::StatName localityZoneStatName() const override {
-    return locality_zone_stat_name_.statName();
+  const envoy::config::core::v3::Locality& locality() const override {
+    return locality_->locality();
   }
+  const MetadataConstSharedPtr localityMetadata() const override { return locality_metadata_; }
+  Stats::StatName localityZoneStatName() const override { return locality_->zoneStatName(); }
   uint32_t priority() const override { return priority_; }
   void priority(uint32_t priority) override { priority_ = priority; }
   Network::UpstreamTransportSocketFactory&
@@ -253,6 +281,7 @@ protected:
       const envoy::config::core::v3::Locality& locality,
       const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
       uint32_t priority, TimeSource& time_source, absl::Status& creation_status);
+  ~HostDescriptionImplBase() override;
 
   /**
    * @return nullptr if address_list is empty, otherwise a shared_ptr copy of address_list.
@@ -269,9 +298,10 @@ private:
   mutable absl::Mutex metadata_mutex_;
   MetadataConstSharedPtr endpoint_metadata_ ABSL_GUARDED_BY(metadata_mutex_);
   const MetadataConstSharedPtr locality_metadata_;
-  const envoy::config::core::v3::Locality locality_;
-  Stats::StatNameDynamicStorage locality_zone_stat_name_;
-  mutable HostStats stats_;
+  const SharedLocalityConstSharedPtr locality_;
+  // Allocated by the first call to stats(), since most hosts of a very large cluster may never be
+  // used by a given proxy.
+  mutable std::atomic<HostStats*> stats_{};
   mutable LoadMetricStatsImpl load_metric_stats_;
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
@@ -352,7 +382,7 @@ public:
   // Upstream::Host
   std::vector<std::pair<absl::string_view, Stats::PrimitiveCounterReference>>
   counters() const override {
-    return stats().counters();
+    return statsForReading().counters();
   }
   CreateConnectionData createConnection(
       Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
@@ -364,7 +394,7 @@ public:
 
   std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>>
   gauges() const override {
-    return stats().gauges();
+    return statsForReading().gauges();
   }
   void healthFlagClear(HealthFlag flag) override { health_flags_ &= ~enumToInt(flag); }
   bool healthFlagGet(HealthFlag flag) const override { return health_flags_ & enumToInt(flag); }
@@ -618,6 +648,12 @@ public:
   static PrioritySet::UpdateHostsParams updateHostsParams(const HostSet& host_set);
   static PrioritySet::UpdateHostsParams
   partitionHosts(HostVectorConstSharedPtr hosts, HostsPerLocalityConstSharedPtr hosts_per_locality);
+  // Like partitionHosts(), but reuses the lists of the host set being updated which the update
+  // leaves unchanged instead of building new ones. Workers receive the same lists they already
+  // have for those, so their load balancers only rebuild the schedules of the lists which changed.
+  static PrioritySet::UpdateHostsParams
+  partitionHosts(HostVectorConstSharedPtr hosts, HostsPerLocalityConstSharedPtr hosts_per_locality,
+                 const HostSet& previous);
 
   void updateHosts(PrioritySet::UpdateHostsParams&& update_hosts_params,
                    LocalityWeightsConstSharedPtr locality_weights, const HostVector& hosts_added,
@@ -0,0 +1,113 @@
+#include "source/extensions/access_loggers/binary_file/binary_file_access_log_impl.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+
+#include "absl/strings/numbers.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+namespace {
+
+// The size of the chunks the compressor writes its output in.
+constexpr uint32_t CompressorChunkSize = 4096;
+
+std::vector<ColumnSchema> schemaOf(const std::vector<Column>& columns) {
+  std::vector<ColumnSchema> schema;
+  schema.reserve(columns.size());
+  for (const Column& column : columns) {
+    schema.push_back(column.schema_);
+  }
+  return schema;
+}
+
+} // namespace
+
+BinaryFileAccessLog::SharedState::SharedState(BinaryFileAccessLogConfig&& config,
+                                              AccessLog::AccessLogFileSharedPtr log_file)
+    : config_(std::move(config)), schema_(schemaOf(config_.columns_)),
+      log_file_(std::move(log_file)) {}
+
+BinaryFileAccessLog::ThreadLocalWriter::ThreadLocalWriter(SharedStateConstSharedPtr state,
+                                                          Event::Dispatcher& dispatcher)
+    : state_(std::move(state)), encoder_(state_->schema_),
+      compressor_(state_->config_.compression_level_, false, 0, cdict_manager_,
+                  CompressorChunkSize),
+      flush_timer_(dispatcher.createTimer([this]() { flush(); })) {}
+
+BinaryFileAccessLog::ThreadLocalWriter::~ThreadLocalWriter() { flush(); }
+
+void BinaryFileAccessLog::ThreadLocalWriter::log(const Formatter::HttpFormatterContext& context,
+                                                 const StreamInfo::StreamInfo& stream_info) {
+  if (encoder_.entries() == 0) {
+    flush_timer_->enableTimer(state_->config_.flush_interval_);
+  }
+
+  const std::vector<Column>& columns = state_->config_.columns_;
+  for (size_t i = 0; i < columns.size(); i++) {
+    value_buffer_.clear();
+    if (!columns[i].provider_->appendWithContext(context, stream_info, value_buffer_)) {
+      encoder_.setNull(i);
+      continue;
+    }
+    if (columns[i].schema_.type_ == ColumnType::String) {
+      encoder_.setString(i, value_buffer_);
+      continue;
+    }
+    int64_t value;
+    if (absl::SimpleAtoi(value_buffer_, &value)) {
+      encoder_.setInteger(i, value);
+    } else {
+      encoder_.setNull(i);
+    }
+  }
+  encoder_.finishEntry();
+
+  if (encoder_.entries() >= state_->config_.entries_per_block_) {
+    flush_timer_->disableTimer();
+    flush();
+  }
+}
+
+void BinaryFileAccessLog::ThreadLocalWriter::flush() {
+  if (encoder_.entries() == 0) {
+    return;
+  }
+  Buffer::OwnedImpl payload;
+  encoder_.finish(payload);
+  const uint64_t uncompressed_size = payload.length();
+  compressor_.compress(payload, Envoy::Compression::Compressor::State::Finish);
+
+  Buffer::OwnedImpl block;
+  encodeBlockHeader(payload.length(), uncompressed_size, block);
+  block.move(payload);
+  state_->log_file_->write(absl::string_view(
+      static_cast<const char*>(block.linearize(block.length())), block.length()));
+}
+
+BinaryFileAccessLog::BinaryFileAccessLog(const Filesystem::FilePathAndType& access_log_file_info,
+                                         AccessLog::FilterPtr&& filter,
+                                         BinaryFileAccessLogConfig&& config,
+                                         AccessLog::AccessLogManager& log_manager,
+                                         ThreadLocal::SlotAllocator& slot_allocator)
+    : ImplBase(std::move(filter)),
+      tls_slot_(ThreadLocal::TypedSlot<ThreadLocalWriter>::makeUnique(slot_allocator)) {
+  auto file_or_error = log_manager.createAccessLog(access_log_file_info);
+  THROW_IF_NOT_OK_REF(file_or_error.status());
+  auto state = std::make_shared<const SharedState>(std::move(config), file_or_error.value());
+  tls_slot_->set([state](Event::Dispatcher& dispatcher) {
+    return std::make_shared<ThreadLocalWriter>(state, dispatcher);
+  });
+}
+
+void BinaryFileAccessLog::emitLog(const Formatter::HttpFormatterContext& context,
+                                  const StreamInfo::StreamInfo& stream_info) {
+  tls_slot_->get()->log(context, stream_info);
+}
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/formatter/substitution_formatter.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/extensions/access_loggers/binary_file/block_format.h"
+#include "source/extensions/access_loggers/common/access_log_base.h"
+#include "source/extensions/compression/zstd/compressor/zstd_compressor_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+/**
+ * A column of the binary file access log, and the formatter which supplies its values.
+ */
+struct Column {
+  ColumnSchema schema_;
+  Formatter::FormatterProviderPtr provider_;
+};
+
+struct BinaryFileAccessLogConfig {
+  std::vector<Column> columns_;
+  uint32_t entries_per_block_;
+  uint32_t compression_level_;
+  std::chrono::milliseconds flush_interval_;
+};
+
+/**
+ * Access log Instance that writes entries to a file as zstd compressed blocks of columns.
+ * @see block_format.h.
+ */
+class BinaryFileAccessLog : public Common::ImplBase {
+public:
+  BinaryFileAccessLog(const Filesystem::FilePathAndType& access_log_file_info,
+                      AccessLog::FilterPtr&& filter, BinaryFileAccessLogConfig&& config,
+                      AccessLog::AccessLogManager& log_manager,
+                      ThreadLocal::SlotAllocator& slot_allocator);
+
+private:
+  struct SharedState {
+    SharedState(BinaryFileAccessLogConfig&& config, AccessLog::AccessLogFileSharedPtr log_file);
+
+    const BinaryFileAccessLogConfig config_;
+    const std::vector<ColumnSchema> schema_;
+    const AccessLog::AccessLogFileSharedPtr log_file_;
+  };
+  using SharedStateConstSharedPtr = std::shared_ptr<const SharedState>;
+
+  /**
+   * The block a thread is collecting. Blocks are written out when they are full, when the flush
+   * interval elapses, and when the logger is destroyed.
+   */
+  class ThreadLocalWriter : public ThreadLocal::ThreadLocalObject {
+  public:
+    ThreadLocalWriter(SharedStateConstSharedPtr state, Event::Dispatcher& dispatcher);
+    ~ThreadLocalWriter() override;
+
+    void log(const Formatter::HttpFormatterContext& context,
+             const StreamInfo::StreamInfo& stream_info);
+
+  private:
+    void flush();
+
+    const SharedStateConstSharedPtr state_;
+    BlockEncoder encoder_;
+    // The compressor keeps a reference to the (absent) dictionary manager.
+    const Compression::Zstd::Compressor::ZstdCDictManagerPtr cdict_manager_;
+    Compression::Zstd::Compressor::ZstdCompressorImpl compressor_;
+    const Event::TimerPtr flush_timer_;
+    // Holds the values of string columns while they are formatted.
+    std::string value_buffer_;
+  };
+
+  // Common::ImplBase
+  void emitLog(const Formatter::HttpFormatterContext& context,
+               const StreamInfo::StreamInfo& stream_info) override;
+
+  ThreadLocal::TypedSlotPtr<ThreadLocalWriter> tls_slot_;
+};
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,270 @@
+#include "source/extensions/access_loggers/binary_file/block_format.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/fmt.h"
+
+#include "absl/base/internal/endian.h"
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+namespace {
+
+void appendVarint(uint64_t value, std::string& output) {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<char>(value));
+}
+
+void appendVarint(uint64_t value, Buffer::Instance& output) {
+  std::string encoded;
+  appendVarint(value, encoded);
+  output.add(encoded);
+}
+
+void appendString(absl::string_view value, Buffer::Instance& output) {
+  appendVarint(value.size(), output);
+  output.add(value);
+}
+
+uint64_t zigzagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzagDecode(uint64_t value) {
+  return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+/**
+ * Reads the fields of a payload, recording the first error.
+ */
+class Reader {
+public:
+  explicit Reader(absl::string_view data) : data_(data) {}
+
+  uint64_t varint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (data_.empty()) {
+        fail("truncated varint");
+        return 0;
+      }
+      const uint8_t byte = data_[0];
+      data_.remove_prefix(1);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    fail("varint too long");
+    return 0;
+  }
+
+  absl::string_view bytes(uint64_t length) {
+    if (length > data_.size()) {
+      fail("truncated field");
+      return {};
+    }
+    absl::string_view value = data_.substr(0, length);
+    data_.remove_prefix(length);
+    return value;
+  }
+
+  absl::string_view string() { return bytes(varint()); }
+
+  void fail(absl::string_view error) {
+    if (error_.empty()) {
+      error_ = std::string(error);
+      data_ = {};
+    }
+  }
+
+  bool done() const { return data_.empty(); }
+  const std::string& error() const { return error_; }
+
+private:
+  absl::string_view data_;
+  std::string error_;
+};
+
+} // namespace
+
+BlockEncoder::BlockEncoder(std::vector<ColumnSchema> schema)
+    : schema_(std::move(schema)), columns_(schema_.size()) {}
+
+void BlockEncoder::setString(size_t column, absl::string_view value) {
+  ASSERT(schema_[column].type_ == ColumnType::String);
+  ColumnData& data = columns_[column];
+  auto [it, inserted] = data.dictionary_index_.try_emplace(value, data.dictionary_.size());
+  if (inserted) {
+    data.dictionary_.push_back(it->first);
+  }
+  appendVarint(it->second + 1, data.data_);
+}
+
+void BlockEncoder::setInteger(size_t column, int64_t value) {
+  ASSERT(schema_[column].type_ == ColumnType::Integer);
+  ColumnData& data = columns_[column];
+  setPresent(data, true);
+  appendVarint(zigzagEncode(value), data.data_);
+}
+
+void BlockEncoder::setNull(size_t column) {
+  if (schema_[column].type_ == ColumnType::Integer) {
+    setPresent(columns_[column], false);
+  } else {
+    appendVarint(0, columns_[column].data_);
+  }
+}
+
+void BlockEncoder::setPresent(ColumnData& data, bool present) {
+  if (entries_ % 8 == 0) {
+    data.present_.push_back(0);
+  }
+  if (present) {
+    data.present_.back() |= static_cast<char>(1 << (entries_ % 8));
+  }
+}
+
+void BlockEncoder::finish(Buffer::Instance& output) {
+  appendVarint(entries_, output);
+  appendVarint(schema_.size(), output);
+  for (const ColumnSchema& column : schema_) {
+    appendString(column.name_, output);
+    const uint8_t type = static_cast<uint8_t>(column.type_);
+    output.add(&type, sizeof(type));
+  }
+  for (size_t i = 0; i < schema_.size(); i++) {
+    ColumnData& data = columns_[i];
+    if (schema_[i].type_ == ColumnType::String) {
+      appendVarint(data.dictionary_.size(), output);
+      for (absl::string_view value : data.dictionary_) {
+        appendString(value, output);
+      }
+      appendString(data.data_, output);
+    } else {
+      appendVarint(data.present_.size() + data.data_.size(), output);
+      output.add(data.present_);
+      output.add(data.data_);
+    }
+
+    data.dictionary_.clear();
+    data.dictionary_index_.clear();
+    data.present_.clear();
+    data.data_.clear();
+  }
+  entries_ = 0;
+}
+
+void encodeBlockHeader(uint32_t compressed_size, uint32_t uncompressed_size,
+                       Buffer::Instance& output) {
+  output.add(BlockMagic);
+  output.add(&FormatVersion, sizeof(FormatVersion));
+  output.writeLEInt<uint32_t>(compressed_size);
+  output.writeLEInt<uint32_t>(uncompressed_size);
+}
+
+absl::StatusOr<BlockHeader> decodeBlockHeader(absl::string_view data) {
+  ASSERT(data.size() >= BlockHeaderSize);
+  if (!absl::StartsWith(data, BlockMagic)) {
+    return absl::InvalidArgumentError("not a binary access log block");
+  }
+  const uint8_t version = data[BlockMagic.size()];
+  if (version != FormatVersion) {
+    return absl::InvalidArgumentError(fmt::format("unsupported format version {}", version));
+  }
+  return BlockHeader{absl::little_endian::Load32(data.data() + 5),
+                     absl::little_endian::Load32(data.data() + 9)};
+}
+
+absl::StatusOr<DecodedBlock> decodeBlockPayload(absl::string_view payload) {
+  Reader reader(payload);
+  DecodedBlock block;
+  const uint64_t entries = reader.varint();
+  const uint64_t column_count = reader.varint();
+  // Each entry takes at least one bit per column, and each column at least 3 bytes, which bounds
+  // the allocations for corrupt counts.
+  if (entries > payload.size() * 8) {
+    return absl::InvalidArgumentError("invalid entry count");
+  }
+  if (column_count > payload.size() / 3) {
+    return absl::InvalidArgumentError("invalid column count");
+  }
+  block.entries_ = entries;
+  block.columns_.resize(column_count);
+  for (DecodedColumn& column : block.columns_) {
+    column.schema_.name_ = std::string(reader.string());
+    const absl::string_view type = reader.bytes(1);
+    if (!type.empty()) {
+      const uint8_t value = type[0];
+      if (value > static_cast<uint8_t>(ColumnType::Integer)) {
+        reader.fail("invalid column type");
+      }
+      column.schema_.type_ = static_cast<ColumnType>(value);
+    }
+  }
+  if (!reader.error().empty()) {
+    return absl::InvalidArgumentError(reader.error());
+  }
+
+  for (DecodedColumn& column : block.columns_) {
+    std::vector<absl::string_view> dictionary;
+    if (column.schema_.type_ == ColumnType::String) {
+      const uint64_t dictionary_size = reader.varint();
+      for (uint64_t i = 0; i < dictionary_size && reader.error().empty(); i++) {
+        dictionary.push_back(reader.string());
+      }
+    }
+
+    Reader data(reader.string());
+    if (!reader.error().empty()) {
+      return absl::InvalidArgumentError(reader.error());
+    }
+    if (column.schema_.type_ == ColumnType::String) {
+      column.strings_.reserve(block.entries_);
+      for (uint32_t i = 0; i < block.entries_ && data.error().empty(); i++) {
+        const uint64_t value = data.varint();
+        if (value > dictionary.size()) {
+          data.fail("invalid dictionary index");
+        } else if (value == 0) {
+          column.strings_.emplace_back();
+        } else {
+          column.strings_.emplace_back(std::string(dictionary[value - 1]));
+        }
+      }
+    } else {
+      const absl::string_view present = data.bytes((block.entries_ + 7) / 8);
+      if (data.error().empty()) {
+        column.integers_.reserve(block.entries_);
+      }
+      for (uint32_t i = 0; i < block.entries_ && data.error().empty(); i++) {
+        if ((static_cast<uint8_t>(present[i / 8]) >> (i % 8)) & 1) {
+          column.integers_.emplace_back(zigzagDecode(data.varint()));
+        } else {
+          column.integers_.emplace_back();
+        }
+      }
+    }
+    if (data.error().empty() && !data.done()) {
+      data.fail("unexpected column data");
+    }
+    if (!data.error().empty()) {
+      return absl::InvalidArgumentError(
+          fmt::format("column '{}': {}", column.schema_.name_, data.error()));
+    }
+  }
+
+  if (!reader.done()) {
+    return absl::InvalidArgumentError("unexpected data after the last column");
+  }
+  return block;
+}
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+
+#include "absl/container/node_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+/**
+ * A binary access log file is a sequence of blocks, each of which holds a number of entries. A
+ * block is a header followed by a zstd frame:
+ *
+ *   magic                 4 bytes, "EBAL"
+ *   version               1 byte, FormatVersion
+ *   compressed size       4 bytes, little endian, the size of the zstd frame
+ *   uncompressed size     4 bytes, little endian, the size of the payload
+ *
+ * The payload, which is the content of the frame, describes its columns and stores the values of
+ * each column together. Integers in the payload are unsigned LEB128 varints:
+ *
+ *   entry count
+ *   column count
+ *   for each column:      name length, name, type (1 byte, ColumnType)
+ *   for each column:
+ *     string columns:     dictionary size, then the length and bytes of each dictionary entry,
+ *                         then the data length and one varint per entry
+ *     integer columns:    data length, then a bitmap of the entries which have a value, and one
+ *                         varint per entry with a value
+ *
+ * The varint of a string entry is 0 for no value, or the index of the value in the dictionary plus
+ * one. Bit i % 8 of byte i / 8 of the bitmap of an integer column is set if entry i has a value,
+ * whose varint is its zigzag encoding; every int64_t value fits, so none of them can be mistaken
+ * for a missing one. The data length lets a reader skip the columns it does not need.
+ */
+constexpr absl::string_view BlockMagic = "EBAL";
+constexpr uint8_t FormatVersion = 1;
+constexpr uint64_t BlockHeaderSize = 13;
+
+enum class ColumnType : uint8_t {
+  String = 0,
+  Integer = 1,
+};
+
+struct ColumnSchema {
+  std::string name_;
+  ColumnType type_;
+};
+
+/**
+ * Collects entries and serializes them as the payload of a block.
+ */
+class BlockEncoder {
+public:
+  explicit BlockEncoder(std::vector<ColumnSchema> schema);
+
+  /**
+   * Set the value of a column of the current entry. Each column is set once per entry, with the
+   * method matching its type or with setNull().
+   */
+  void setString(size_t column, absl::string_view value);
+  void setInteger(size_t column, int64_t value);
+  void setNull(size_t column);
+
+  /**
+   * Ends the current entry.
+   */
+  void finishEntry() { entries_++; }
+
+  /**
+   * @return uint32_t the number of entries since the last finish().
+   */
+  uint32_t entries() const { return entries_; }
+
+  /**
+   * Appends the payload of a block holding the entries to a buffer, and starts a new block.
+   */
+  void finish(Buffer::Instance& output);
+
+private:
+  struct ColumnData {
+    // The distinct values of a string column, with their indexes in dictionary_, which refers to
+    // the keys of the map since they do not move.
+    absl::node_hash_map<std::string, uint32_t> dictionary_index_;
+    std::vector<absl::string_view> dictionary_;
+    // The bitmap of the entries of an integer column which have a value.
+    std::string present_;
+    std::string data_;
+  };
+
+  // Records whether the current entry has a value in an integer column.
+  void setPresent(ColumnData& data, bool present);
+
+  const std::vector<ColumnSchema> schema_;
+  std::vector<ColumnData> columns_;
+  uint32_t entries_{0};
+};
+
+/**
+ * Appends the header of a block to a buffer.
+ */
+void encodeBlockHeader(uint32_t compressed_size, uint32_t uncompressed_size,
+                       Buffer::Instance& output);
+
+struct BlockHeader {
+  uint32_t compressed_size_;
+  uint32_t uncompressed_size_;
+};
+
+/**
+ * Decodes the header at the start of data, which must hold at least BlockHeaderSize bytes.
+ */
+absl::StatusOr<BlockHeader> decodeBlockHeader(absl::string_view data);
+
+/**
+ * The entries of a block, by column.
+ */
+struct DecodedColumn {
+  ColumnSchema schema_;
+  // Set for string columns.
+  std::vector<absl::optional<std::string>> strings_;
+  // Set for integer columns.
+  std::vector<absl::optional<int64_t>> integers_;
+};
+
+struct DecodedBlock {
+  uint32_t entries_;
+  std::vector<DecodedColumn> columns_;
+};
+
+/**
+ * Decodes the uncompressed payload of a block.
+ */
+absl::StatusOr<DecodedBlock> decodeBlockPayload(absl::string_view payload);
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
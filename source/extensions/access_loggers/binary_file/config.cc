@@ -0,0 +1,81 @@
+#include "source/extensions/access_loggers/binary_file/config.h"
+
+#include <memory>
+
+#include "envoy/extensions/access_loggers/binary_file/v3/binary_file.pb.h"
+#include "envoy/extensions/access_loggers/binary_file/v3/binary_file.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/filter_config.h"
+
+#include "source/common/formatter/substitution_formatter.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/access_loggers/binary_file/binary_file_access_log_impl.h"
+
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+AccessLog::InstanceSharedPtr BinaryFileAccessLogFactory::createAccessLogInstance(
+    const Protobuf::Message& config, AccessLog::FilterPtr&& filter,
+    Server::Configuration::FactoryContext& context,
+    std::vector<Formatter::CommandParserPtr>&& command_parsers) {
+  const auto& proto_config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog&>(
+      config, context.messageValidationVisitor());
+
+  BinaryFileAccessLogConfig log_config;
+  log_config.entries_per_block_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, entries_per_block, 1024);
+  log_config.compression_level_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, compression_level, 3);
+  log_config.flush_interval_ =
+      std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(proto_config, flush_interval, 1000));
+
+  absl::flat_hash_set<std::string> names;
+  for (const auto& column : proto_config.columns()) {
+    if (!names.insert(column.name()).second) {
+      throw EnvoyException(
+          fmt::format("binary file access log: duplicate column name '{}'", column.name()));
+    }
+    auto providers_or_error = Formatter::SubstitutionFormatParser::parse(column.format(),
+                                                                         command_parsers);
+    THROW_IF_NOT_OK_REF(providers_or_error.status());
+    if (providers_or_error->size() != 1) {
+      throw EnvoyException(fmt::format(
+          "binary file access log: the format of column '{}' must be a single command operator",
+          column.name()));
+    }
+    Formatter::FormatterProviderPtr provider = std::move(providers_or_error->front());
+    const ColumnType type =
+        provider->valueKind() == Formatter::FormatterProvider::ValueKind::Integer
+            ? ColumnType::Integer
+            : ColumnType::String;
+    log_config.columns_.push_back({{column.name(), type}, std::move(provider)});
+  }
+
+  Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, proto_config.path()};
+  return std::make_shared<BinaryFileAccessLog>(
+      file_info, std::move(filter), std::move(log_config),
+      context.serverFactoryContext().accessLogManager(),
+      context.serverFactoryContext().threadLocal());
+}
+
+ProtobufTypes::MessagePtr BinaryFileAccessLogFactory::createEmptyConfigProto() {
+  return std::make_unique<
+      envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog>();
+}
+
+std::string BinaryFileAccessLogFactory::name() const { return "envoy.access_loggers.binary_file"; }
+
+/**
+ * Static registration for the binary file access log. @see RegisterFactory.
+ */
+REGISTER_FACTORY(BinaryFileAccessLogFactory, AccessLog::AccessLogInstanceFactory);
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -397,7 +397,8 @@ void EdsClusterImpl::reloadHealthyHostsHelper(const HostSharedPtr& host) {
         {[&host_to_exclude](const Host& host) { return &host != host_to_exclude.get(); }})[0];
 
     prioritySet().updateHosts(priority,
-                              HostSetImpl::partitionHosts(hosts_copy, hosts_per_locality_copy),
+                              HostSetImpl::partitionHosts(hosts_copy, hosts_per_locality_copy,
+                                                          *host_set),
                               host_set->localityWeights(), {}, hosts_to_remove, random_.random(),
                               absl::nullopt, absl::nullopt);
   }
@@ -0,0 +1,360 @@
+#include "source/extensions/common/async_files/async_file_context_io_uring.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/common/async_files/async_file_action.h"
+#include "source/extensions/common/async_files/async_file_context_base.h"
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+#include "source/extensions/common/async_files/mapped_file_range.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+
+template <typename T> class AsyncFileActionIoUring : public AsyncFileActionWithResult<T> {
+public:
+  explicit AsyncFileActionIoUring(AsyncFileHandle handle, absl::AnyInvocable<void(T)> on_complete)
+      : AsyncFileActionWithResult<T>(std::move(on_complete)), handle_(std::move(handle)) {}
+
+protected:
+  int& fileDescriptor() { return context()->fileDescriptor(); }
+  AsyncFileContextIoUring* context() const {
+    return static_cast<AsyncFileContextIoUring*>(handle_.get());
+  }
+
+  Api::OsSysCalls& posix() const { return context()->ioUringManager().posix(); }
+
+  AsyncFileHandle handle_;
+};
+
+absl::Status statusFromCompletion(int32_t result) {
+  if (result < 0) {
+    return statusAfterFileError(-result);
+  }
+  return absl::OkStatus();
+}
+
+class ActionStat : public AsyncFileActionIoUring<absl::StatusOr<struct stat>>,
+                   public IoUringOperation {
+public:
+  ActionStat(AsyncFileHandle handle,
+             absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete)
+      : AsyncFileActionIoUring<absl::StatusOr<struct stat>>(handle, std::move(on_complete)) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, Io::Request* user_data) override {
+    ASSERT(fileDescriptor() != -1);
+    return ring.prepareStatx(fileDescriptor(), "", AT_EMPTY_PATH, STATX_BASIC_STATS,
+                             &statx_result_, user_data);
+  }
+
+  absl::StatusOr<struct stat> executeImpl() override {
+    RETURN_IF_NOT_OK(statusFromCompletion(completion_result_));
+    return AsyncFileManagerIoUring::toStat(statx_result_);
+  }
+
+private:
+  struct statx statx_result_ {};
+};
+
+class ActionCreateHardLink : public AsyncFileActionIoUring<absl::Status>, public IoUringOperation {
+public:
+  ActionCreateHardLink(AsyncFileHandle handle, absl::string_view filename,
+                       absl::AnyInvocable<void(absl::Status)> on_complete)
+      : AsyncFileActionIoUring<absl::Status>(handle, std::move(on_complete)),
+        filename_(filename), procfile_(absl::StrCat("/proc/self/fd/", fileDescriptor())) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, Io::Request* user_data) override {
+    ASSERT(fileDescriptor() != -1);
+    return ring.prepareLinkat(AT_FDCWD, procfile_.c_str(), AT_FDCWD, filename_.c_str(),
+                              AT_SYMLINK_FOLLOW, user_data);
+  }
+
+  absl::Status executeImpl() override { return statusFromCompletion(completion_result_); }
+
+  void onCancelledBeforeCallback() override {
+    if (result_.value().ok()) {
+      posix().unlink(filename_.c_str());
+    }
+  }
+  bool hasActionIfCancelledBeforeCallback() const override { return true; }
+
+private:
+  const std::string filename_;
+  const std::string procfile_;
+};
+
+class ActionCloseFile : public AsyncFileActionIoUring<absl::Status>, public IoUringOperation {
+public:
+  // As in AsyncFileContextThreadPool, take a copy of the file descriptor, because close sets the
+  // context's file descriptor to -1.
+  explicit ActionCloseFile(AsyncFileHandle handle,
+                           absl::AnyInvocable<void(absl::Status)> on_complete)
+      : AsyncFileActionIoUring<absl::Status>(handle, std::move(on_complete)),
+        file_descriptor_(fileDescriptor()) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, Io::Request* user_data) override {
+    return ring.prepareClose(file_descriptor_, user_data);
+  }
+
+  absl::Status executeImpl() override { return statusFromCompletion(completion_result_); }
+
+  bool executesEvenIfCancelled() const override { return true; }
+
+private:
+  const int file_descriptor_;
+};
+
+class ActionReadFile : public AsyncFileActionIoUring<absl::StatusOr<Buffer::InstancePtr>>,
+                       public IoUringOperation {
+public:
+  ActionReadFile(AsyncFileHandle handle, off_t offset, size_t length,
+                 absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete)
+      : AsyncFileActionIoUring<absl::StatusOr<Buffer::InstancePtr>>(handle,
+                                                                    std::move(on_complete)),
+        offset_(offset), length_(length), buffer_(std::make_unique<Buffer::OwnedImpl>()),
+        reservation_(buffer_->reserveSingleSlice(length)) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, Io::Request* user_data) override {
+    ASSERT(fileDescriptor() != -1);
+    iov_.iov_base = reservation_.slice().mem_;
+    iov_.iov_len = length_;
+    return ring.prepareReadv(fileDescriptor(), &iov_, 1, offset_, user_data);
+  }
+
+  absl::StatusOr<Buffer::InstancePtr> executeImpl() override {
+    RETURN_IF_NOT_OK(statusFromCompletion(completion_result_));
+    // The kernel read straight into the reserved slice, so a short read only needs a smaller
+    // commit.
+    reservation_.commit(completion_result_);
+    return std::move(buffer_);
+  }
+
+private:
+  const off_t offset_;
+  const size_t length_;
+  Buffer::InstancePtr buffer_;
+  Buffer::ReservationSingleSlice reservation_;
+  struct iovec iov_ {};
+};
+
+class ActionWriteFile : public AsyncFileActionIoUring<absl::StatusOr<size_t>>,
+                        public IoUringOperation {
+public:
+  ActionWriteFile(AsyncFileHandle handle, Buffer::Instance& contents, off_t offset,
+                  absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete)
+      : AsyncFileActionIoUring<absl::StatusOr<size_t>>(handle, std::move(on_complete)),
+        offset_(offset) {
+    contents_.move(contents);
+  }
+
+  Io::IoUringResult prepare(Io::IoUring& ring, Io::Request* user_data) override {
+    ASSERT(fileDescriptor() != -1);
+    Buffer::RawSliceVector slices = contents_.getRawSlices(IOV_MAX);
+    iovecs_.resize(slices.size());
+    for (size_t i = 0; i < slices.size(); i++) {
+      iovecs_[i].iov_base = slices[i].mem_;
+      iovecs_[i].iov_len = slices[i].len_;
+    }
+    return ring.prepareWritev(fileDescriptor(), iovecs_.data(), iovecs_.size(),
+                              offset_ + bytes_written_, user_data);
+  }
+
+  bool onCompletion(int32_t result) override {
+    completion_result_ = result;
+    if (result <= 0) {
+      return true;
+    }
+    // A write may be short, or there may be more slices than fit in one writev; write the rest.
+    bytes_written_ += result;
+    contents_.drain(result);
+    return contents_.length() == 0;
+  }
+
+  absl::StatusOr<size_t> executeImpl() override {
+    RETURN_IF_NOT_OK(statusFromCompletion(completion_result_));
+    return bytes_written_;
+  }
+
+private:
+  Buffer::OwnedImpl contents_;
+  const off_t offset_;
+  size_t bytes_written_ = 0;
+  std::vector<struct iovec> iovecs_;
+};
+
+// Mapping a file and faulting in its pages are not io_uring operations, so this action is performed
+// with blocking system calls on the ring thread.
+class ActionReadMapped : public AsyncFileActionIoUring<absl::StatusOr<Buffer::InstancePtr>> {
+public:
+  ActionReadMapped(AsyncFileHandle handle, off_t offset, size_t length,
+                   absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete)
+      : AsyncFileActionIoUring<absl::StatusOr<Buffer::InstancePtr>>(handle, std::move(on_complete)),
+        offset_(offset), length_(length) {}
+
+  absl::StatusOr<Buffer::InstancePtr> executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    return readMappedFileRange(posix(), fileDescriptor(), offset_, length_);
+  }
+
+private:
+  const off_t offset_;
+  const size_t length_;
+};
+
+// There is no io_uring operation for ftruncate on the kernels Envoy supports, so this action is
+// performed with a blocking system call on the ring thread.
+class ActionTruncateFile : public AsyncFileActionIoUring<absl::Status> {
+public:
+  ActionTruncateFile(AsyncFileHandle handle, size_t length,
+                     absl::AnyInvocable<void(absl::Status)> on_complete)
+      : AsyncFileActionIoUring<absl::Status>(handle, std::move(on_complete)), length_(length) {}
+
+  absl::Status executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    Api::SysCallIntResult result = posix().ftruncate(fileDescriptor(), length_);
+    if (result.return_value_ == -1) {
+      return statusAfterFileError(result);
+    }
+    return absl::OkStatus();
+  }
+
+private:
+  const size_t length_;
+};
+
+// There is no io_uring operation for dup, so this action is performed with a blocking system call
+// on the ring thread.
+class ActionDuplicateFile : public AsyncFileActionIoUring<absl::StatusOr<AsyncFileHandle>> {
+public:
+  ActionDuplicateFile(AsyncFileHandle handle,
+                      absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : AsyncFileActionIoUring<absl::StatusOr<AsyncFileHandle>>(handle, std::move(on_complete)) {}
+
+  absl::StatusOr<AsyncFileHandle> executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    auto newfd = posix().duplicate(fileDescriptor());
+    if (newfd.return_value_ == -1) {
+      return statusAfterFileError(newfd);
+    }
+    return std::make_shared<AsyncFileContextIoUring>(context()->ioUringManager(),
+                                                     newfd.return_value_);
+  }
+
+  void onCancelledBeforeCallback() override {
+    if (result_.value().ok()) {
+      result_.value().value()->close(nullptr, [](absl::Status) {}).IgnoreError();
+    }
+  }
+  bool hasActionIfCancelledBeforeCallback() const override { return true; }
+};
+
+} // namespace
+
+template <class T>
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::checkFileAndEnqueueIoUring(Event::Dispatcher* dispatcher,
+                                                    std::unique_ptr<T> action) {
+  if (fileDescriptor() == -1) {
+    return absl::FailedPreconditionError("file was already closed");
+  }
+  return ioUringManager().enqueueIoUring(dispatcher, std::move(action));
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::stat(
+    Event::Dispatcher* dispatcher,
+    absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete) {
+  return checkFileAndEnqueueIoUring(dispatcher,
+                                    std::make_unique<ActionStat>(handle(), std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::createHardLink(Event::Dispatcher* dispatcher, absl::string_view filename,
+                                        absl::AnyInvocable<void(absl::Status)> on_complete) {
+  return checkFileAndEnqueueIoUring(dispatcher, std::make_unique<ActionCreateHardLink>(
+                                                    handle(), filename, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::close(Event::Dispatcher* dispatcher,
+                               absl::AnyInvocable<void(absl::Status)> on_complete) {
+  auto ret = checkFileAndEnqueueIoUring(
+      dispatcher, std::make_unique<ActionCloseFile>(handle(), std::move(on_complete)));
+  fileDescriptor() = -1;
+  return ret;
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::read(
+    Event::Dispatcher* dispatcher, off_t offset, size_t length,
+    absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+  return checkFileAndEnqueueIoUring(
+      dispatcher,
+      std::make_unique<ActionReadFile>(handle(), offset, length, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::readMapped(
+    Event::Dispatcher* dispatcher, off_t offset, size_t length,
+    absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+  return checkFileAndEnqueue(dispatcher, std::make_unique<ActionReadMapped>(
+                                             handle(), offset, length, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::write(Event::Dispatcher* dispatcher, Buffer::Instance& contents,
+                               off_t offset,
+                               absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete) {
+  return checkFileAndEnqueueIoUring(dispatcher,
+                                    std::make_unique<ActionWriteFile>(handle(), contents, offset,
+                                                                      std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::duplicate(
+    Event::Dispatcher* dispatcher,
+    absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return checkFileAndEnqueue(
+      dispatcher, std::make_unique<ActionDuplicateFile>(handle(), std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::truncate(Event::Dispatcher* dispatcher, size_t length,
+                                  absl::AnyInvocable<void(absl::Status)> on_complete) {
+  return checkFileAndEnqueue(
+      dispatcher, std::make_unique<ActionTruncateFile>(handle(), length, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::checkFileAndEnqueue(Event::Dispatcher* dispatcher,
+                                             std::unique_ptr<AsyncFileAction> action) {
+  if (fileDescriptor() == -1) {
+    return absl::FailedPreconditionError("file was already closed");
+  }
+  return enqueue(dispatcher, std::move(action));
+}
+
+AsyncFileManagerIoUring& AsyncFileContextIoUring::ioUringManager() const {
+  return static_cast<AsyncFileManagerIoUring&>(manager());
+}
+
+AsyncFileContextIoUring::AsyncFileContextIoUring(AsyncFileManagerIoUring& manager, int fd)
+    : AsyncFileContextBase(manager), file_descriptor_(fd) {}
+
+AsyncFileContextIoUring::~AsyncFileContextIoUring() { ASSERT(file_descriptor_ == -1); }
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
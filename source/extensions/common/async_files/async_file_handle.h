@@ -52,6 +52,15 @@ public:
   read(Event::Dispatcher* dispatcher, off_t offset, size_t length,
        absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) PURE;
 
+  // As read, but the buffer passed to on_complete does not hold a copy of the file's content;
+  // it is a read-only memory mapping of the range of the file, which a socket can send directly
+  // from the file (see Buffer::BufferFragment::fileRange()). The pages of the range are read in
+  // before on_complete is called. The buffer remains valid after the file is closed, but the file
+  // must not be truncated while the buffer exists.
+  virtual absl::StatusOr<CancelFunction>
+  readMapped(Event::Dispatcher* dispatcher, off_t offset, size_t length,
+             absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) PURE;
+
   // Enqueues an action to write to the currently open file, at position offset, the bytes contained
   // by contents. It is an error to call write on an AsyncFileContext that does not have a file
   // open.
@@ -0,0 +1,481 @@
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "source/common/io/io_uring_impl.h"
+#include "source/extensions/common/async_files/async_file_action.h"
+#include "source/extensions/common/async_files/async_file_context_io_uring.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+constexpr uint32_t DefaultQueueSize = 256;
+} // namespace
+
+// The user data of an operation in the submission queue; owns the action until it completes.
+class AsyncFileManagerIoUring::RingRequest : public Io::Request {
+public:
+  RingRequest(QueuedAction queued_action, IoUringOperation* operation)
+      : Io::Request(RequestType::File), queued_action_(std::move(queued_action)),
+        operation_(operation) {}
+
+  QueuedAction queued_action_;
+  // Null for actions performed with blocking system calls.
+  IoUringOperation* const operation_;
+  // Whether the action has left the Queued state, so that preparing it again after a full
+  // submission queue or a partial completion does not check for cancellation twice.
+  bool started_ = false;
+  // Set for actions which execute even if cancelled, when they were cancelled while queued.
+  bool cancelled_while_queued_ = false;
+};
+
+AsyncFileManagerIoUring::AsyncFileManagerIoUring(
+    const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+    Api::OsSysCalls& posix)
+    : queue_size_(config.io_uring().queue_size() == 0 ? DefaultQueueSize
+                                                      : config.io_uring().queue_size()),
+      posix_(posix) {
+  if (!Io::isIoUringSupported()) {
+    throw EnvoyException("AsyncFileManagerIoUring not supported");
+  }
+  ring_ = std::make_unique<Io::IoUringImpl>(queue_size_, false);
+  event_fd_ = ring_->registerEventfd();
+  ENVOY_LOG(info, fmt::format("AsyncFileManagerIoUring created with id '{}', with queue size {}",
+                              config.id(), queue_size_));
+  ring_thread_ = std::thread([this]() { ringThread(); });
+}
+
+AsyncFileManagerIoUring::~AsyncFileManagerIoUring() ABSL_LOCKS_EXCLUDED(queue_mutex_) {
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    terminate_ = true;
+  }
+  wake();
+  // This destructor will be blocked until all queued file actions are complete.
+  ring_thread_.join();
+  ring_->unregisterEventfd();
+  ::close(event_fd_);
+}
+
+std::string AsyncFileManagerIoUring::describe() const {
+  return absl::StrCat("io_uring_queue_size = ", queue_size_);
+}
+
+void AsyncFileManagerIoUring::waitForIdle() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(queue_mutex_) {
+    return !ring_busy_ && queue_.empty() && cleanup_queue_.empty();
+  };
+  absl::MutexLock lock(&queue_mutex_);
+  queue_mutex_.Await(absl::Condition(&condition));
+}
+
+struct stat AsyncFileManagerIoUring::toStat(const struct statx& statx_result) {
+  struct stat ret {};
+  ret.st_dev = makedev(statx_result.stx_dev_major, statx_result.stx_dev_minor);
+  ret.st_ino = statx_result.stx_ino;
+  ret.st_mode = statx_result.stx_mode;
+  ret.st_nlink = statx_result.stx_nlink;
+  ret.st_uid = statx_result.stx_uid;
+  ret.st_gid = statx_result.stx_gid;
+  ret.st_rdev = makedev(statx_result.stx_rdev_major, statx_result.stx_rdev_minor);
+  ret.st_size = statx_result.stx_size;
+  ret.st_blksize = statx_result.stx_blksize;
+  ret.st_blocks = statx_result.stx_blocks;
+  ret.st_atim.tv_sec = statx_result.stx_atime.tv_sec;
+  ret.st_atim.tv_nsec = statx_result.stx_atime.tv_nsec;
+  ret.st_mtim.tv_sec = statx_result.stx_mtime.tv_sec;
+  ret.st_mtim.tv_nsec = statx_result.stx_mtime.tv_nsec;
+  ret.st_ctim.tv_sec = statx_result.stx_ctime.tv_sec;
+  ret.st_ctim.tv_nsec = statx_result.stx_ctime.tv_nsec;
+  return ret;
+}
+
+CancelFunction AsyncFileManagerIoUring::enqueueIoUring(Event::Dispatcher* dispatcher,
+                                                       std::unique_ptr<AsyncFileAction> action,
+                                                       IoUringOperation* operation) {
+  auto request =
+      std::make_unique<RingRequest>(QueuedAction{std::move(action), dispatcher}, operation);
+  auto cancel_func = [dispatcher, state = request->queued_action_.state_]() {
+    ASSERT(dispatcher == nullptr || dispatcher->isThreadSafe());
+    state->store(QueuedAction::State::Cancelled);
+  };
+  bool was_empty;
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    was_empty = queue_.empty() && cleanup_queue_.empty();
+    queue_.push_back(std::move(request));
+  }
+  // If the queue was not empty, the ring thread has been woken already and not yet taken the
+  // queue, so this action will be submitted in the same batch.
+  if (was_empty) {
+    wake();
+  }
+  return cancel_func;
+}
+
+void AsyncFileManagerIoUring::postCancelledActionForCleanup(
+    std::unique_ptr<AsyncFileAction> action) {
+  bool was_empty;
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    was_empty = queue_.empty() && cleanup_queue_.empty();
+    cleanup_queue_.push(std::move(action));
+  }
+  if (was_empty) {
+    wake();
+  }
+}
+
+void AsyncFileManagerIoUring::wake() {
+  // The eventfd registered with the ring also wakes the ring thread for completions.
+  eventfd_write(event_fd_, 1);
+}
+
+void AsyncFileManagerIoUring::ringThread() {
+  const Io::CompletionCb on_completion = [this](Io::Request* user_data, int32_t result, bool) {
+    ASSERT(user_data != nullptr);
+    --in_flight_;
+    onRingCompletion(RingRequestPtr(static_cast<RingRequest*>(user_data)), result);
+  };
+  while (true) {
+    std::deque<RingRequestPtr> queued;
+    std::queue<std::unique_ptr<AsyncFileAction>> cleanup;
+    {
+      absl::MutexLock lock(&queue_mutex_);
+      queued.swap(queue_);
+      cleanup.swap(cleanup_queue_);
+      ring_busy_ = !queued.empty() || !cleanup.empty() || !waiting_for_ring_.empty() ||
+                   in_flight_ > 0;
+      if (terminate_ && !ring_busy_) {
+        return;
+      }
+    }
+    const bool can_submit =
+        submit_pending_ || (!waiting_for_ring_.empty() && in_flight_ < queue_size_);
+    if (queued.empty() && cleanup.empty() && !can_submit) {
+      // Nothing to do until an operation completes or another action is enqueued. The queue was
+      // checked after the last time the eventfd was drained, so no wakeup can have been missed.
+      struct pollfd poll_fd {};
+      poll_fd.fd = event_fd_;
+      poll_fd.events = POLLIN;
+      ::poll(&poll_fd, 1, -1);
+      ring_->forEveryCompletion(on_completion);
+      continue;
+    }
+    for (RingRequestPtr& request : queued) {
+      if (request->operation_ == nullptr) {
+        executeBlocking(std::move(request->queued_action_));
+      } else {
+        waiting_for_ring_.push_back(std::move(request));
+      }
+    }
+    while (!cleanup.empty()) {
+      std::move(cleanup.front())->onCancelledBeforeCallback();
+      cleanup.pop();
+    }
+    submitWaitingActions();
+    ring_->forEveryCompletion(on_completion);
+  }
+}
+
+void AsyncFileManagerIoUring::submitWaitingActions() {
+  using State = QueuedAction::State;
+  bool prepared = false;
+  while (!waiting_for_ring_.empty() && in_flight_ < queue_size_) {
+    RingRequestPtr& request = waiting_for_ring_.front();
+    if (!request->started_) {
+      State expected = State::Queued;
+      if (!request->queued_action_.state_->compare_exchange_strong(expected, State::Executing)) {
+        ASSERT(expected == State::Cancelled);
+        if (!request->queued_action_.action_->executesEvenIfCancelled()) {
+          waiting_for_ring_.pop_front();
+          continue;
+        }
+        request->cancelled_while_queued_ = true;
+      }
+      request->started_ = true;
+    }
+    if (request->operation_->prepare(*ring_, request.get()) == Io::IoUringResult::Failed) {
+      break;
+    }
+    // The ring owns the request until it completes.
+    request.release();
+    waiting_for_ring_.pop_front();
+    ++in_flight_;
+    prepared = true;
+  }
+  if (prepared || submit_pending_) {
+    // If the kernel is busy, the prepared entries stay in the submission queue and are submitted
+    // again once completions have been handled.
+    submit_pending_ = ring_->submit() == Io::IoUringResult::Busy;
+  }
+}
+
+void AsyncFileManagerIoUring::onRingCompletion(RingRequestPtr request, int32_t result) {
+  if (!request->operation_->onCompletion(result)) {
+    waiting_for_ring_.push_front(std::move(request));
+    return;
+  }
+  request->queued_action_.action_->execute();
+  if (request->cancelled_while_queued_) {
+    return;
+  }
+  complete(std::move(request->queued_action_));
+}
+
+void AsyncFileManagerIoUring::executeBlocking(QueuedAction&& queued_action) {
+  using State = QueuedAction::State;
+  State expected = State::Queued;
+  if (!queued_action.state_->compare_exchange_strong(expected, State::Executing)) {
+    ASSERT(expected == State::Cancelled);
+    if (queued_action.action_->executesEvenIfCancelled()) {
+      queued_action.action_->execute();
+    }
+    return;
+  }
+  queued_action.action_->execute();
+  complete(std::move(queued_action));
+}
+
+void AsyncFileManagerIoUring::complete(QueuedAction&& queued_action) {
+  using State = QueuedAction::State;
+  std::shared_ptr<std::atomic<State>> state = std::move(queued_action.state_);
+  std::unique_ptr<AsyncFileAction> action = std::move(queued_action.action_);
+  State expected = State::Executing;
+  if (!state->compare_exchange_strong(expected, State::InCallback)) {
+    ASSERT(expected == State::Cancelled);
+    action->onCancelledBeforeCallback();
+    return;
+  }
+  if (queued_action.dispatcher_ == nullptr) {
+    // No need to bother arranging the callback, because a dispatcher was not provided.
+    return;
+  }
+  // As in AsyncFileManagerThreadPool, only keep the manager alive from the posted callback if the
+  // action has side-effects that need undoing on cancellation.
+  std::shared_ptr<AsyncFileManagerIoUring> manager;
+  if (action->hasActionIfCancelledBeforeCallback()) {
+    manager = shared_from_this();
+  }
+  queued_action.dispatcher_->post([manager = std::move(manager), action = std::move(action),
+                                   state = std::move(state)]() mutable {
+    State expected = State::InCallback;
+    if (state->compare_exchange_strong(expected, State::Done)) {
+      action->onComplete();
+      return;
+    }
+    ASSERT(expected == State::Cancelled);
+    if (manager == nullptr) {
+      return;
+    }
+    manager->postCancelledActionForCleanup(std::move(action));
+  });
+}
+
+namespace {
+
+class ActionWithFileResult : public AsyncFileActionWithResult<absl::StatusOr<AsyncFileHandle>>,
+                             public IoUringOperation {
+public:
+  ActionWithFileResult(AsyncFileManagerIoUring& manager,
+                       absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : AsyncFileActionWithResult(std::move(on_complete)), manager_(manager) {}
+
+protected:
+  void onCancelledBeforeCallback() override {
+    if (result_.value().ok()) {
+      result_.value().value()->close(nullptr, [](absl::Status) {}).IgnoreError();
+    }
+  }
+  bool hasActionIfCancelledBeforeCallback() const override { return true; }
+
+  absl::StatusOr<AsyncFileHandle> fileFromCompletion() {
+    if (completion_result_ < 0) {
+      return statusAfterFileError(-completion_result_);
+    }
+    return std::make_shared<AsyncFileContextIoUring>(manager_, completion_result_);
+  }
+
+  AsyncFileManagerIoUring& manager_;
+};
+
+class ActionCreateAnonymousFile : public ActionWithFileResult {
+public:
+  ActionCreateAnonymousFile(AsyncFileManagerIoUring& manager, absl::string_view path,
+                            absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : ActionWithFileResult(manager, std::move(on_complete)), path_(path) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, Io::Request* user_data) override {
+    return ring.prepareOpenat(AT_FDCWD, path_.c_str(), O_TMPFILE | O_RDWR, S_IRUSR | S_IWUSR,
+                              user_data);
+  }
+  bool onCompletion(int32_t result) override {
+    prepared_ = true;
+    return IoUringOperation::onCompletion(result);
+  }
+
+  absl::StatusOr<AsyncFileHandle> executeImpl() override {
+    if (prepared_) {
+      const int error = -completion_result_;
+      if (error != EOPNOTSUPP && error != EISDIR && error != EINVAL) {
+        return fileFromCompletion();
+      }
+      // The filesystem does not support O_TMPFILE; neither this nor later anonymous files can be
+      // opened with it.
+      manager_.supports_o_tmpfile_ = false;
+    }
+    return createWithMkstemp();
+  }
+
+private:
+  absl::StatusOr<AsyncFileHandle> createWithMkstemp() {
+    Api::OsSysCalls& posix = manager_.posix();
+    // See AsyncFileManagerThreadPool for why this uses a fixed-size C buffer.
+    char filename[4096];
+    static const char file_suffix[] = "/buffer.XXXXXX";
+    if (path_.size() + sizeof(file_suffix) > sizeof(filename)) {
+      return absl::InvalidArgumentError(
+          "AsyncFileManagerIoUring::createAnonymousFile: pathname too long for tmpfile");
+    }
+    snprintf(filename, sizeof(filename), "%s%s", path_.c_str(), file_suffix);
+    Api::SysCallIntResult open_result = posix.mkstemp(filename);
+    if (open_result.return_value_ == -1) {
+      return statusAfterFileError(open_result);
+    }
+    if (posix.unlink(filename).return_value_ != 0) {
+      posix.close(open_result.return_value_);
+      posix.unlink(filename);
+      return absl::UnimplementedError(
+          "AsyncFileManagerIoUring::createAnonymousFile: not supported for "
+          "target filesystem (failed to unlink an open file)");
+    }
+    return std::make_shared<AsyncFileContextIoUring>(manager_, open_result.return_value_);
+  }
+
+  const std::string path_;
+  bool prepared_ = false;
+};
+
+class ActionOpenExistingFile : public ActionWithFileResult {
+public:
+  ActionOpenExistingFile(AsyncFileManagerIoUring& manager, absl::string_view filename,
+                         AsyncFileManager::Mode mode,
+                         absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : ActionWithFileResult(manager, std::move(on_complete)), filename_(filename), mode_(mode) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, Io::Request* user_data) override {
+    return ring.prepareOpenat(AT_FDCWD, filename_.c_str(), openFlags(), 0, user_data);
+  }
+
+  absl::StatusOr<AsyncFileHandle> executeImpl() override { return fileFromCompletion(); }
+
+private:
+  int openFlags() const {
+    switch (mode_) {
+    case AsyncFileManager::Mode::ReadOnly:
+      return O_RDONLY;
+    case AsyncFileManager::Mode::WriteOnly:
+      return O_WRONLY;
+    case AsyncFileManager::Mode::ReadWrite:
+      return O_RDWR;
+    }
+    PANIC_DUE_TO_CORRUPT_ENUM;
+  }
+  const std::string filename_;
+  const AsyncFileManager::Mode mode_;
+};
+
+class ActionStat : public AsyncFileActionWithResult<absl::StatusOr<struct stat>>,
+                   public IoUringOperation {
+public:
+  ActionStat(absl::string_view filename,
+             absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete)
+      : AsyncFileActionWithResult(std::move(on_complete)), filename_(filename) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, Io::Request* user_data) override {
+    return ring.prepareStatx(AT_FDCWD, filename_.c_str(), 0, STATX_BASIC_STATS, &statx_result_,
+                             user_data);
+  }
+
+  absl::StatusOr<struct stat> executeImpl() override {
+    if (completion_result_ < 0) {
+      return statusAfterFileError(-completion_result_);
+    }
+    return AsyncFileManagerIoUring::toStat(statx_result_);
+  }
+
+private:
+  const std::string filename_;
+  struct statx statx_result_ {};
+};
+
+class ActionUnlink : public AsyncFileActionWithResult<absl::Status>, public IoUringOperation {
+public:
+  ActionUnlink(absl::string_view filename, absl::AnyInvocable<void(absl::Status)> on_complete)
+      : AsyncFileActionWithResult(std::move(on_complete)), filename_(filename) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, Io::Request* user_data) override {
+    return ring.prepareUnlinkat(AT_FDCWD, filename_.c_str(), 0, user_data);
+  }
+
+  absl::Status executeImpl() override {
+    if (completion_result_ < 0) {
+      return statusAfterFileError(-completion_result_);
+    }
+    return absl::OkStatus();
+  }
+
+private:
+  const std::string filename_;
+};
+
+} // namespace
+
+CancelFunction AsyncFileManagerIoUring::createAnonymousFile(
+    Event::Dispatcher* dispatcher, absl::string_view path,
+    absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  auto action = std::make_unique<ActionCreateAnonymousFile>(*this, path, std::move(on_complete));
+  if (!supports_o_tmpfile_) {
+    return enqueue(dispatcher, std::move(action));
+  }
+  return enqueueIoUring(dispatcher, std::move(action));
+}
+
+CancelFunction AsyncFileManagerIoUring::openExistingFile(
+    Event::Dispatcher* dispatcher, absl::string_view filename, Mode mode,
+    absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return enqueueIoUring(dispatcher, std::make_unique<ActionOpenExistingFile>(
+                                        *this, filename, mode, std::move(on_complete)));
+}
+
+CancelFunction
+AsyncFileManagerIoUring::stat(Event::Dispatcher* dispatcher, absl::string_view filename,
+                              absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete) {
+  return enqueueIoUring(dispatcher,
+                        std::make_unique<ActionStat>(filename, std::move(on_complete)));
+}
+
+CancelFunction AsyncFileManagerIoUring::unlink(Event::Dispatcher* dispatcher,
+                                               absl::string_view filename,
+                                               absl::AnyInvocable<void(absl::Status)> on_complete) {
+  return enqueueIoUring(dispatcher,
+                        std::make_unique<ActionUnlink>(filename, std::move(on_complete)));
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
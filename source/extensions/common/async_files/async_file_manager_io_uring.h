@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/common/io/io_uring.h"
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+// The part of an AsyncFileAction performed by the kernel through io_uring.
+//
+// prepare() puts the action's system call in the submission queue, and the result of the call is
+// passed to onCompletion() once it completes. The action's execute() then turns that result into
+// the result passed to its callback, rather than performing a blocking system call.
+class IoUringOperation {
+public:
+  virtual ~IoUringOperation() = default;
+
+  // Puts the system call for the operation in the submission queue of ring.
+  // Returns IoUringResult::Failed if the submission queue is full.
+  virtual Io::IoUringResult prepare(Io::IoUring& ring, Io::Request* user_data) PURE;
+
+  // Receives the result of the system call. Returns false if the operation is not finished and
+  // should be prepared again, e.g. after a short write.
+  virtual bool onCompletion(int32_t result) {
+    completion_result_ = result;
+    return true;
+  }
+
+protected:
+  // The result of the system call; a negated errno value on failure.
+  int32_t completion_result_ = 0;
+};
+
+// An AsyncFileManager which submits file operations to the kernel through io_uring, rather than
+// performing blocking system calls on a pool of threads.
+//
+// Operations can be enqueued from any thread. The manager's ring thread takes all the operations
+// enqueued since it last woke, puts them in the submission queue and submits them together with
+// one system call. As each operation completes, its callback is posted to the dispatcher that the
+// operation was enqueued with, with the same cancellation guarantees as
+// AsyncFileManagerThreadPool. No thread waits on any single operation, so the number of
+// operations in flight is bounded by the queue size rather than by a number of threads.
+//
+// io_uring has no operations for truncating or duplicating a file; those, and creating anonymous
+// files on filesystems which do not support O_TMPFILE, are performed with blocking system calls on
+// the ring thread.
+class AsyncFileManagerIoUring : public AsyncFileManager,
+                                public std::enable_shared_from_this<AsyncFileManagerIoUring>,
+                                protected Logger::Loggable<Logger::Id::main> {
+public:
+  AsyncFileManagerIoUring(
+      const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+      Api::OsSysCalls& posix);
+  ~AsyncFileManagerIoUring() ABSL_LOCKS_EXCLUDED(queue_mutex_) override;
+  CancelFunction createAnonymousFile(
+      Event::Dispatcher* dispatcher, absl::string_view path,
+      absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) override;
+  CancelFunction
+  openExistingFile(Event::Dispatcher* dispatcher, absl::string_view filename, Mode mode,
+                   absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) override;
+  CancelFunction stat(Event::Dispatcher* dispatcher, absl::string_view filename,
+                      absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete) override;
+  CancelFunction unlink(Event::Dispatcher* dispatcher, absl::string_view filename,
+                        absl::AnyInvocable<void(absl::Status)> on_complete) override;
+  std::string describe() const override;
+  void waitForIdle() ABSL_LOCKS_EXCLUDED(queue_mutex_) override;
+  Api::OsSysCalls& posix() const { return posix_; }
+
+  // Puts an action in the queue to be performed through io_uring. operation is the action's
+  // IoUringOperation; if it is null, the action is performed with blocking system calls on the
+  // ring thread instead.
+  CancelFunction enqueueIoUring(Event::Dispatcher* dispatcher,
+                                std::unique_ptr<AsyncFileAction> action,
+                                IoUringOperation* operation) ABSL_LOCKS_EXCLUDED(queue_mutex_);
+  // As above, for actions which are both an AsyncFileAction and an IoUringOperation.
+  template <class T>
+  CancelFunction enqueueIoUring(Event::Dispatcher* dispatcher, std::unique_ptr<T> action) {
+    IoUringOperation* operation = action.get();
+    return enqueueIoUring(dispatcher, std::move(action), operation);
+  }
+
+  // Whether opening anonymous files with O_TMPFILE works. Cleared the first time it fails with an
+  // error indicating that the filesystem does not support it, after which anonymous files are
+  // created with mkstemp on the ring thread.
+  std::atomic<bool> supports_o_tmpfile_{true};
+
+  // Converts the result of statx to the struct stat passed to callbacks.
+  static struct stat toStat(const struct statx& statx_result);
+
+private:
+  class RingRequest;
+  using RingRequestPtr = std::unique_ptr<RingRequest>;
+
+  // Puts an action in the queue to be performed with blocking system calls on the ring thread.
+  CancelFunction enqueue(Event::Dispatcher* dispatcher,
+                         std::unique_ptr<AsyncFileAction> action) override {
+    return enqueueIoUring(dispatcher, std::move(action), nullptr);
+  }
+  void postCancelledActionForCleanup(std::unique_ptr<AsyncFileAction> action)
+      ABSL_LOCKS_EXCLUDED(queue_mutex_) override;
+  void wake();
+  void ringThread() ABSL_LOCKS_EXCLUDED(queue_mutex_);
+  // Moves queued actions into the submission queue until it is full, and submits them.
+  void submitWaitingActions();
+  void onRingCompletion(RingRequestPtr request, int32_t result);
+  void executeBlocking(QueuedAction&& queued_action);
+  // Arranges the callback of an action which has been executed.
+  void complete(QueuedAction&& queued_action);
+
+  const uint32_t queue_size_;
+  Api::OsSysCalls& posix_;
+  Io::IoUringPtr ring_;
+  os_fd_t event_fd_;
+
+  absl::Mutex queue_mutex_;
+  std::deque<RingRequestPtr> queue_ ABSL_GUARDED_BY(queue_mutex_);
+  std::queue<std::unique_ptr<AsyncFileAction>> cleanup_queue_ ABSL_GUARDED_BY(queue_mutex_);
+  // Whether the ring thread holds any actions which are not yet complete.
+  bool ring_busy_ ABSL_GUARDED_BY(queue_mutex_) = false;
+  bool terminate_ ABSL_GUARDED_BY(queue_mutex_) = false;
+
+  // Only accessed by the ring thread.
+  std::deque<RingRequestPtr> waiting_for_ring_;
+  uint32_t in_flight_ = 0;
+  // Whether prepared operations were left in the submission queue because the kernel was busy.
+  bool submit_pending_ = false;
+
+  std::thread ring_thread_;
+};
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,104 @@
+#include "source/extensions/common/async_files/mapped_file_range.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+
+// A buffer fragment referring to a read-only memory mapping of a range of a file. Owns the mapping
+// and a file descriptor for the file, and deletes itself when the buffer is done with it.
+class MappedFileFragment : public Buffer::BufferFragment {
+public:
+  MappedFileFragment(Api::OsSysCalls& posix, int fd, void* mapping, size_t mapping_length,
+                     size_t data_offset, off_t file_offset, size_t length)
+      : posix_(posix), fd_(fd), mapping_(mapping), mapping_length_(mapping_length),
+        data_offset_(data_offset), file_offset_(file_offset), length_(length) {}
+
+  ~MappedFileFragment() override {
+    ::munmap(mapping_, mapping_length_);
+    posix_.close(fd_);
+  }
+
+  // Buffer::BufferFragment
+  const void* data() const override { return static_cast<const char*>(mapping_) + data_offset_; }
+  size_t size() const override { return length_; }
+  void done() override { delete this; }
+  absl::optional<Buffer::FileRange> fileRange() const override {
+    return Buffer::FileRange{fd_, static_cast<uint64_t>(file_offset_), length_};
+  }
+
+private:
+  Api::OsSysCalls& posix_;
+  const int fd_;
+  void* const mapping_;
+  const size_t mapping_length_;
+  const size_t data_offset_;
+  const off_t file_offset_;
+  const size_t length_;
+};
+
+} // namespace
+
+absl::StatusOr<Buffer::InstancePtr> readMappedFileRange(Api::OsSysCalls& posix, int fd,
+                                                        off_t offset, size_t length) {
+  auto result = std::make_unique<Buffer::OwnedImpl>();
+  // Mapping beyond the end of the file would fault on access, so like pread the result is
+  // shortened to the part of the range that is in the file.
+  struct stat stat_result;
+  auto stat_status = posix.fstat(fd, &stat_result);
+  if (stat_status.return_value_ != 0) {
+    return statusAfterFileError(stat_status);
+  }
+  if (offset >= stat_result.st_size) {
+    return result;
+  }
+  length = std::min<size_t>(length, stat_result.st_size - offset);
+  if (length == 0) {
+    return result;
+  }
+
+  static const off_t page_size = ::sysconf(_SC_PAGESIZE);
+  const off_t mapping_offset = offset - offset % page_size;
+  const size_t data_offset = offset - mapping_offset;
+  const size_t mapping_length = data_offset + length;
+  auto dup_fd = posix.duplicate(fd);
+  if (dup_fd.return_value_ == -1) {
+    return statusAfterFileError(dup_fd);
+  }
+  auto mapping = posix.mmap(nullptr, mapping_length, PROT_READ, MAP_SHARED, dup_fd.return_value_,
+                            mapping_offset);
+  if (mapping.return_value_ == MAP_FAILED) {
+    posix.close(dup_fd.return_value_);
+    return statusAfterFileError(mapping);
+  }
+  // Read the pages in on this thread rather than when the mapping is first accessed, which may be
+  // on an event loop.
+  ::madvise(mapping.return_value_, mapping_length, MADV_WILLNEED);
+  const volatile char* pages = static_cast<const volatile char*>(mapping.return_value_);
+  for (size_t i = 0; i < mapping_length; i += page_size) {
+    static_cast<void>(pages[i]);
+  }
+
+  auto* fragment =
+      new MappedFileFragment(posix, dup_fd.return_value_, mapping.return_value_, mapping_length,
+                             data_offset, offset, length);
+  result->addBufferFragment(*fragment);
+  return result;
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/buffer/buffer.h"
+
+#include "absl/status/statusor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+// Performs the blocking part of AsyncFileContext::readMapped: returns a buffer whose content is up
+// to length bytes of the file fd at offset, as a read-only memory mapping of the file rather than a
+// copy, recording the range of the file it maps so that a socket can send it directly from the
+// file (see Buffer::BufferFragment::fileRange()).
+//
+// The pages of the mapping are read in before returning, so that reading the buffer's content, or
+// sending it from the file, does not then block on the disk. The buffer holds a duplicate of fd, so
+// the file may be closed before the buffer is destroyed. The range of the file must not be
+// truncated while the buffer exists.
+absl::StatusOr<Buffer::InstancePtr> readMappedFileRange(Api::OsSysCalls& posix, int fd,
+                                                        off_t offset, size_t length);
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
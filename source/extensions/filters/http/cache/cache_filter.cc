@@ -5,6 +5,7 @@
 #include "source/common/common/enum_to_int.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/utility.h"
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/cache/cache_custom_headers.h"
 #include "source/extensions/filters/http/cache/cache_entry_utils.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
@@ -30,6 +31,8 @@ namespace {
 //
 // And everyone knows 64MB should be enough for anyone.
 static const size_t MAX_BYTES_TO_FETCH_FROM_CACHE_PER_REQUEST = 64 * 1024 * 1024;
+
+constexpr uint64_t DefaultCoalescingWaitTimeoutMs = 5000;
 } // namespace
 
 struct CacheResponseCodeDetailValues {
@@ -40,10 +43,17 @@ using CacheResponseCodeDetails = ConstSingleton<CacheResponseCodeDetailValues>;
 
 CacheFilterConfig::CacheFilterConfig(
     const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
-    Server::Configuration::CommonFactoryContext& context)
+    Server::Configuration::CommonFactoryContext& context, const std::string& stats_prefix,
+    Stats::Scope& scope)
     : vary_allow_list_(config.allowed_vary_headers(), context), time_source_(context.timeSource()),
       ignore_request_cache_control_header_(config.ignore_request_cache_control_header()),
-      cluster_manager_(context.clusterManager()) {}
+      cluster_manager_(context.clusterManager()),
+      stats_{ALL_CACHE_FILTER_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix + "cache."))},
+      request_coalescer_(config.has_request_coalescing() ? std::make_unique<RequestCoalescer>()
+                                                         : nullptr),
+      coalescing_wait_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(config.request_coalescing(),
+                                                          wait_timeout,
+                                                          DefaultCoalescingWaitTimeoutMs)) {}
 
 CacheFilter::CacheFilter(std::shared_ptr<const CacheFilterConfig> config,
                          std::shared_ptr<HttpCache> http_cache)
@@ -51,6 +61,7 @@ CacheFilter::CacheFilter(std::shared_ptr<const CacheFilterConfig> config,
 
 void CacheFilter::onDestroy() {
   filter_state_ = FilterState::Destroyed;
+  leaveCoalescedFill();
   if (lookup_ != nullptr) {
     lookup_->onDestroy();
   }
@@ -71,12 +82,140 @@ void CacheFilter::sendUpstreamRequest(Http::RequestHeaderMap& request_headers) {
   if (thread_local_cluster == nullptr) {
     return sendNoClusterResponse(route_entry->clusterName());
   }
+  // Let other requests for the same response wait for this one, unless another request is already
+  // fetching it.
+  CoalescedFillSharedPtr coalesced_fill;
+  if (coalescing_key_.has_value()) {
+    coalesced_fill = config_->requestCoalescer()->lead(*coalescing_key_, request_headers);
+  }
   upstream_request_ =
       UpstreamRequest::create(this, std::move(lookup_), std::move(lookup_result_), cache_,
-                              thread_local_cluster->httpAsyncClient(), config_->upstreamOptions());
+                              thread_local_cluster->httpAsyncClient(), config_->upstreamOptions(),
+                              std::move(coalesced_fill));
   upstream_request_->sendHeaders(request_headers);
 }
 
+bool CacheFilter::joinCoalescedFill(Http::RequestHeaderMap& request_headers) {
+  if (!coalescing_key_.has_value() || joined_coalesced_fill_) {
+    return false;
+  }
+  coalesced_subscription_ = config_->requestCoalescer()->join(
+      *coalescing_key_, decoder_callbacks_->dispatcher(), *this);
+  if (coalesced_subscription_ == nullptr) {
+    return false;
+  }
+  ENVOY_STREAM_LOG(debug, "CacheFilter waiting for an in-flight upstream request",
+                   *decoder_callbacks_);
+  joined_coalesced_fill_ = true;
+  coalesced_request_headers_ = &request_headers;
+  config_->stats().coalesced_requests_.inc();
+  coalescing_timer_ = decoder_callbacks_->dispatcher().createTimer([this]() {
+    ENVOY_STREAM_LOG(debug, "CacheFilter timed out waiting for an in-flight upstream request",
+                     *decoder_callbacks_);
+    config_->stats().coalescing_timeouts_.inc();
+    leaveCoalescedFill();
+    sendUpstreamRequestAfterCoalescing();
+  });
+  coalescing_timer_->enableTimer(config_->coalescingWaitTimeout());
+  return true;
+}
+
+void CacheFilter::leaveCoalescedFill() {
+  if (coalescing_timer_ != nullptr) {
+    coalescing_timer_->disableTimer();
+  }
+  if (coalesced_subscription_ != nullptr) {
+    coalesced_subscription_->cancel();
+    coalesced_subscription_ = nullptr;
+  }
+}
+
+void CacheFilter::sendUpstreamRequestAfterCoalescing() {
+  Http::RequestHeaderMap& request_headers = *coalesced_request_headers_;
+  coalesced_request_headers_ = nullptr;
+  if (cache_entry_status_ == CacheEntryStatus::RequiresValidation) {
+    handleCacheHitWithValidation(request_headers);
+  } else {
+    sendUpstreamRequest(request_headers);
+  }
+}
+
+void CacheFilter::onFillHeaders(Http::ResponseHeaderMapPtr&& headers,
+                                const absl::optional<std::string>& vary_identifier,
+                                bool end_stream) {
+  ASSERT(filter_state_ != FilterState::Destroyed);
+  if (VaryHeaderUtils::hasVary(*headers)) {
+    // The in-flight response is only the right variant for this request if the request headers it
+    // varies on match those of the request that fetched it.
+    const absl::optional<std::string> own_vary_identifier =
+        VaryHeaderUtils::createVaryIdentifier(config_->varyAllowList(),
+                                              VaryHeaderUtils::getVaryValues(*headers),
+                                              *coalesced_request_headers_);
+    if (!vary_identifier.has_value() || own_vary_identifier != vary_identifier) {
+      onFillFailed(CoalescedFillFailure::NotShareable);
+      return;
+    }
+  }
+  coalescing_timer_->disableTimer();
+  ENVOY_STREAM_LOG(debug, "CacheFilter serving the response of an in-flight upstream request",
+                   *decoder_callbacks_);
+  coalesced_request_headers_ = nullptr;
+  serving_coalesced_response_ = true;
+  filter_state_ = FilterState::NotServingFromCache;
+  insert_status_ = InsertStatus::NoInsertRequestCoalesced;
+  // The lookup is no longer needed, and with it gone encodeHeaders lets the response through.
+  lookup_->onDestroy();
+  lookup_ = nullptr;
+  if (end_stream) {
+    leaveCoalescedFill();
+  }
+  decoder_callbacks_->encodeHeaders(std::move(headers), end_stream,
+                                    StreamInfo::ResponseCodeDetails::get().ViaUpstream);
+}
+
+void CacheFilter::onFillData(Buffer::Instance& data, bool end_stream) {
+  ASSERT(serving_coalesced_response_);
+  if (end_stream) {
+    leaveCoalescedFill();
+  }
+  decoder_callbacks_->encodeData(data, end_stream);
+}
+
+void CacheFilter::onFillTrailers(Http::ResponseTrailerMapPtr&& trailers) {
+  ASSERT(serving_coalesced_response_);
+  leaveCoalescedFill();
+  decoder_callbacks_->encodeTrailers(std::move(trailers));
+}
+
+void CacheFilter::onFillFailed(CoalescedFillFailure failure) {
+  leaveCoalescedFill();
+  if (serving_coalesced_response_) {
+    // Part of the response has already been sent, so there is nothing to fall back to.
+    decoder_callbacks_->resetStream();
+    return;
+  }
+  if (failure == CoalescedFillFailure::Revalidated) {
+    // The in-flight request freshened the cached entry, so look it up again.
+    ENVOY_STREAM_LOG(debug, "CacheFilter repeating lookup after in-flight validation",
+                     *decoder_callbacks_);
+    Http::RequestHeaderMap& request_headers = *coalesced_request_headers_;
+    coalesced_request_headers_ = nullptr;
+    lookup_->onDestroy();
+    lookup_result_ = nullptr;
+    cache_entry_status_.reset();
+    lookup_ = cache_->makeLookupContext(
+        LookupRequest(request_headers, config_->timeSource().systemTime(),
+                      config_->varyAllowList(), config_->ignoreRequestCacheControlHeader()),
+        *decoder_callbacks_);
+    getHeaders(request_headers);
+    return;
+  }
+  ENVOY_STREAM_LOG(debug, "CacheFilter could not use the response of an in-flight upstream request",
+                   *decoder_callbacks_);
+  config_->stats().coalescing_fallbacks_.inc();
+  sendUpstreamRequestAfterCoalescing();
+}
+
 void CacheFilter::sendNoRouteResponse() {
   decoder_callbacks_->sendLocalReply(Http::Code::NotFound, "", nullptr, absl::nullopt,
                                      "cache_no_route");
@@ -127,6 +266,11 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
                                config_->ignoreRequestCacheControlHeader());
   request_allows_inserts_ = !lookup_request.requestCacheControl().no_store_;
   is_head_request_ = headers.getMethodValue() == Http::Headers::get().MethodValues.Head;
+  // Only requests whose response can be shared in full are coalesced.
+  if (config_->requestCoalescer() != nullptr && request_allows_inserts_ && !is_head_request_ &&
+      headers.get(Http::Headers::get().Range).empty()) {
+    coalescing_key_ = lookup_request.key();
+  }
   lookup_ = cache_->makeLookupContext(std::move(lookup_request), *decoder_callbacks_);
 
   ASSERT(lookup_);
@@ -152,6 +296,13 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     return Http::FilterHeadersStatus::Continue;
   }
 
+  if (coalesced_subscription_ != nullptr && !serving_coalesced_response_) {
+    // A local reply was sent while waiting for an in-flight upstream request.
+    leaveCoalescedFill();
+    filter_state_ = FilterState::NotServingFromCache;
+    return Http::FilterHeadersStatus::Continue;
+  }
+
   // If lookup_ is null, the request wasn't cacheable, so the response isn't either.
   if (!lookup_) {
     return Http::FilterHeadersStatus::Continue;
@@ -317,6 +468,9 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     // request and let it pass through as if no cache entry was found. If the
     // cache entry was valid, the response status should be 304 (unmodified)
     // and the cache entry will be injected in the response body.
+    if (joinCoalescedFill(request_headers)) {
+      return;
+    }
     handleCacheHitWithValidation(request_headers);
     return;
   case CacheEntryStatus::Ok:
@@ -327,6 +481,9 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     handleCacheHit(/* end_stream_after_headers = */ end_stream);
     return;
   case CacheEntryStatus::Unusable:
+    if (joinCoalescedFill(request_headers)) {
+      return;
+    }
     sendUpstreamRequest(request_headers);
     return;
   case CacheEntryStatus::LookupError:
@@ -3,13 +3,17 @@
 #include <memory>
 #include <vector>
 
+#include "envoy/event/timer.h"
 #include "envoy/extensions/filters/http/cache/v3/cache.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "source/common/common/logger.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/filters/http/cache/filter_state.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/filters/http/cache/request_coalescer.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
 
 namespace Envoy {
@@ -19,10 +23,26 @@ namespace Cache {
 
 class UpstreamRequest;
 
+/**
+ * All cache filter stats. @see stats_macros.h
+ */
+#define ALL_CACHE_FILTER_STATS(COUNTER)                                                            \
+  COUNTER(coalesced_requests)                                                                      \
+  COUNTER(coalescing_fallbacks)                                                                    \
+  COUNTER(coalescing_timeouts)
+
+/**
+ * Struct definition for all cache filter stats. @see stats_macros.h
+ */
+struct CacheFilterStats {
+  ALL_CACHE_FILTER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
 class CacheFilterConfig {
 public:
   CacheFilterConfig(const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
-                    Server::Configuration::CommonFactoryContext& context);
+                    Server::Configuration::CommonFactoryContext& context,
+                    const std::string& stats_prefix, Stats::Scope& scope);
 
   // The allow list rules that decide if a header can be varied upon.
   const VaryAllowList& varyAllowList() const { return vary_allow_list_; }
@@ -30,6 +50,10 @@ public:
   const Http::AsyncClient::StreamOptions& upstreamOptions() const { return upstream_options_; }
   Upstream::ClusterManager& clusterManager() const { return cluster_manager_; }
   bool ignoreRequestCacheControlHeader() const { return ignore_request_cache_control_header_; }
+  const CacheFilterStats& stats() const { return stats_; }
+  // The table of in-flight upstream requests, or nullptr if request coalescing is disabled.
+  RequestCoalescer* requestCoalescer() const { return request_coalescer_.get(); }
+  std::chrono::milliseconds coalescingWaitTimeout() const { return coalescing_wait_timeout_; }
 
 private:
   const VaryAllowList vary_allow_list_;
@@ -37,12 +61,16 @@ private:
   const bool ignore_request_cache_control_header_;
   Upstream::ClusterManager& cluster_manager_;
   Http::AsyncClient::StreamOptions upstream_options_;
+  const CacheFilterStats stats_;
+  const RequestCoalescerPtr request_coalescer_;
+  const std::chrono::milliseconds coalescing_wait_timeout_;
 };
 
 /**
  * A filter that caches responses and attempts to satisfy requests from cache.
  */
 class CacheFilter : public Http::PassThroughFilter,
+                    public CoalescedFillCallbacks,
                     public Logger::Loggable<Logger::Id::cache_filter>,
                     public std::enable_shared_from_this<CacheFilter> {
 public:
@@ -57,6 +85,12 @@ public:
   // Http::StreamEncoderFilter
   Http::FilterHeadersStatus encodeHeaders(Http::ResponseHeaderMap& headers,
                                           bool end_stream) override;
+  // CoalescedFillCallbacks
+  void onFillHeaders(Http::ResponseHeaderMapPtr&& headers,
+                     const absl::optional<std::string>& vary_identifier, bool end_stream) override;
+  void onFillData(Buffer::Instance& data, bool end_stream) override;
+  void onFillTrailers(Http::ResponseTrailerMapPtr&& trailers) override;
+  void onFillFailed(CoalescedFillFailure failure) override;
 
   static LookupStatus resolveLookupStatus(absl::optional<CacheEntryStatus> cache_entry_status,
                                           FilterState filter_state);
@@ -74,6 +108,18 @@ private:
   // send a 503 locally.
   void sendNoClusterResponse(absl::string_view cluster_name);
 
+  // On a cache miss, or a cached response that requires validation, waits for an in-flight upstream
+  // request for the same cache key instead of sending another one, if request coalescing is
+  // enabled. Returns false if the request should be sent upstream as usual.
+  bool joinCoalescedFill(Http::RequestHeaderMap& request_headers);
+
+  // Stops waiting for, or receiving, a coalesced response.
+  void leaveCoalescedFill();
+
+  // Called when a coalesced request can't be served the in-flight response, and has to send the
+  // upstream request it would have sent without coalescing.
+  void sendUpstreamRequestAfterCoalescing();
+
   // Called by UpstreamRequest if it is reset before CacheFilter is destroyed.
   // CacheFilter must make no more calls to upstream_request_ once this has been called.
   void onUpstreamRequestReset();
@@ -159,6 +205,19 @@ private:
   bool is_head_request_ = false;
   // This toggle is used to detect callbacks being called directly and not posted.
   bool callback_called_directly_ = false;
+
+  // The cache key, if the request may be coalesced with other requests for the same response.
+  absl::optional<Key> coalescing_key_;
+  // Set once the request has joined an in-flight upstream request. A request only joins once;
+  // if that doesn't produce a response, it sends its own upstream request.
+  bool joined_coalesced_fill_ = false;
+  // Set once a response from the in-flight upstream request has been sent downstream.
+  bool serving_coalesced_response_ = false;
+  // The request headers, kept while waiting for an in-flight upstream request so that the request
+  // can be sent upstream if the wait fails. Decoding is stopped, so they remain valid.
+  Http::RequestHeaderMap* coalesced_request_headers_ = nullptr;
+  CoalescedFill::SubscriptionSharedPtr coalesced_subscription_;
+  Event::TimerPtr coalescing_timer_;
   // The status of the insert operation or header update, or decision not to insert or update.
   // If it's too early to determine the final status, this is empty.
   absl::optional<InsertStatus> insert_status_;
@@ -83,6 +83,9 @@ enum class InsertStatus {
   // The CacheFilter couldn't determine whether the request was in cache and
   // didn't try to insert it.
   NoInsertLookupError,
+  // The response was a copy of the response to another request for the same
+  // cache key, which inserted it if it was cacheable.
+  NoInsertRequestCoalesced,
 };
 
 absl::string_view insertStatusToString(InsertStatus status);
@@ -0,0 +1,217 @@
+#include "source/extensions/filters/http/cache/request_coalescer.h"
+
+#include <algorithm>
+
+#include "source/common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+void CoalescedFill::Subscription::cancel() {
+  callbacks_ = nullptr;
+  if (CoalescedFillSharedPtr fill = fill_.lock()) {
+    fill->unsubscribe(*this);
+  }
+}
+
+CoalescedFill::CoalescedFill(RequestCoalescer& coalescer, const Key& key,
+                             const Http::RequestHeaderMap& request_headers)
+    : coalescer_(coalescer), key_(key),
+      leader_request_headers_(Http::createHeaderMap<Http::RequestHeaderMapImpl>(request_headers)) {}
+
+// Followers are released if the leader drops the fill without ending it.
+CoalescedFill::~CoalescedFill() { onFailed(CoalescedFillFailure::Reset); }
+
+CoalescedFill::SubscriptionSharedPtr CoalescedFill::subscribe(Event::Dispatcher& dispatcher,
+                                                              CoalescedFillCallbacks& callbacks) {
+  auto subscription = std::make_shared<Subscription>(dispatcher, callbacks, weak_from_this());
+  absl::MutexLock lock(&mutex_);
+  if (closed_) {
+    return nullptr;
+  }
+  if (headers_ != nullptr) {
+    postHeaders(subscription, *headers_, vary_identifier_, false);
+    if (body_.length() > 0) {
+      postData(subscription, std::make_shared<const std::string>(body_.toString()), false);
+    }
+  }
+  subscribers_.push_back(subscription);
+  return subscription;
+}
+
+void CoalescedFill::unsubscribe(const Subscription& subscription) {
+  absl::MutexLock lock(&mutex_);
+  subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+                                    [&subscription](const SubscriptionSharedPtr& subscriber) {
+                                      return subscriber.get() == &subscription;
+                                    }),
+                     subscribers_.end());
+}
+
+void CoalescedFill::closeToFollowers() {
+  coalescer_.remove(key_, *this);
+  absl::MutexLock lock(&mutex_);
+  closed_ = true;
+}
+
+void CoalescedFill::finishLocked() {
+  finished_ = true;
+  subscribers_.clear();
+  headers_ = nullptr;
+  vary_identifier_.reset();
+  body_.drain(body_.length());
+}
+
+void CoalescedFill::postHeaders(const SubscriptionSharedPtr& subscription,
+                                const Http::ResponseHeaderMap& headers,
+                                const absl::optional<std::string>& vary_identifier,
+                                bool end_stream) {
+  Http::ResponseHeaderMapPtr copy = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(headers);
+  subscription->dispatcher_.post(
+      [subscription, headers = std::move(copy), vary_identifier, end_stream]() mutable {
+        if (subscription->callbacks_ != nullptr) {
+          subscription->callbacks_->onFillHeaders(std::move(headers), vary_identifier, end_stream);
+        }
+      });
+}
+
+void CoalescedFill::postData(const SubscriptionSharedPtr& subscription,
+                             std::shared_ptr<const std::string> data, bool end_stream) {
+  // The body is flattened once by the leader, and each follower copies it on its own thread.
+  subscription->dispatcher_.post([subscription, data = std::move(data), end_stream]() {
+    if (subscription->callbacks_ != nullptr) {
+      Buffer::OwnedImpl buffer(*data);
+      subscription->callbacks_->onFillData(buffer, end_stream);
+    }
+  });
+}
+
+void CoalescedFill::onHeaders(const Http::ResponseHeaderMap& headers,
+                              const VaryAllowList& vary_allow_list, bool end_stream) {
+  absl::optional<std::string> vary_identifier;
+  if (VaryHeaderUtils::hasVary(headers)) {
+    vary_identifier = VaryHeaderUtils::createVaryIdentifier(
+        vary_allow_list, VaryHeaderUtils::getVaryValues(headers), *leader_request_headers_);
+  }
+  if (end_stream) {
+    closeToFollowers();
+  }
+  absl::MutexLock lock(&mutex_);
+  if (finished_) {
+    return;
+  }
+  ASSERT(headers_ == nullptr);
+  for (const SubscriptionSharedPtr& subscriber : subscribers_) {
+    postHeaders(subscriber, headers, vary_identifier, end_stream);
+  }
+  if (end_stream) {
+    finishLocked();
+  } else {
+    headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(headers);
+    vary_identifier_ = std::move(vary_identifier);
+  }
+}
+
+void CoalescedFill::onData(const Buffer::Instance& data, bool end_stream) {
+  body_bytes_received_ += data.length();
+  const bool replayable = !end_stream && body_bytes_received_ <= MaxReplayBytes;
+  if (!replayable) {
+    closeToFollowers();
+  }
+  absl::MutexLock lock(&mutex_);
+  if (finished_) {
+    return;
+  }
+  auto chunk = std::make_shared<const std::string>(data.toString());
+  for (const SubscriptionSharedPtr& subscriber : subscribers_) {
+    postData(subscriber, chunk, end_stream);
+  }
+  if (end_stream) {
+    finishLocked();
+  } else if (replayable) {
+    body_.add(data);
+  } else {
+    // No more followers can join, so the response no longer needs to be retained.
+    headers_ = nullptr;
+    body_.drain(body_.length());
+  }
+}
+
+void CoalescedFill::onTrailers(const Http::ResponseTrailerMap& trailers) {
+  closeToFollowers();
+  absl::MutexLock lock(&mutex_);
+  if (finished_) {
+    return;
+  }
+  for (const SubscriptionSharedPtr& subscriber : subscribers_) {
+    Http::ResponseTrailerMapPtr copy =
+        Http::createHeaderMap<Http::ResponseTrailerMapImpl>(trailers);
+    subscriber->dispatcher_.post([subscriber, trailers = std::move(copy)]() mutable {
+      if (subscriber->callbacks_ != nullptr) {
+        subscriber->callbacks_->onFillTrailers(std::move(trailers));
+      }
+    });
+  }
+  finishLocked();
+}
+
+void CoalescedFill::onFailed(CoalescedFillFailure failure) {
+  closeToFollowers();
+  absl::MutexLock lock(&mutex_);
+  if (finished_) {
+    return;
+  }
+  for (const SubscriptionSharedPtr& subscriber : subscribers_) {
+    subscriber->dispatcher_.post([subscriber, failure]() {
+      if (subscriber->callbacks_ != nullptr) {
+        subscriber->callbacks_->onFillFailed(failure);
+      }
+    });
+  }
+  finishLocked();
+}
+
+CoalescedFill::SubscriptionSharedPtr RequestCoalescer::join(const Key& key,
+                                                            Event::Dispatcher& dispatcher,
+                                                            CoalescedFillCallbacks& callbacks) {
+  CoalescedFillSharedPtr fill;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = fills_.find(key);
+    if (it == fills_.end()) {
+      return nullptr;
+    }
+    // The fill may be waiting in its destructor to remove itself from the table. The reference is
+    // released outside the lock in case it is the last one.
+    fill = it->second->weak_from_this().lock();
+  }
+  // The fill may also have been closed since, in which case subscribing fails.
+  return fill == nullptr ? nullptr : fill->subscribe(dispatcher, callbacks);
+}
+
+CoalescedFillSharedPtr RequestCoalescer::lead(const Key& key,
+                                              const Http::RequestHeaderMap& request_headers) {
+  absl::MutexLock lock(&mutex_);
+  auto [it, inserted] = fills_.try_emplace(key, nullptr);
+  if (!inserted) {
+    return nullptr;
+  }
+  auto fill = std::make_shared<CoalescedFill>(*this, key, request_headers);
+  it->second = fill.get();
+  return fill;
+}
+
+void RequestCoalescer::remove(const Key& key, const CoalescedFill& fill) {
+  absl::MutexLock lock(&mutex_);
+  auto it = fills_.find(key);
+  if (it != fills_.end() && it->second == &fill) {
+    fills_.erase(it);
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/header_map.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+#include "source/extensions/filters/http/cache/key.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+// The reason a CoalescedFill ended without delivering a complete response to its followers.
+enum class CoalescedFillFailure {
+  // The response is not cacheable, so it can't be shared with other requests.
+  NotShareable,
+  // The leading request validated the cached entry instead of fetching a new response. Followers
+  // should look the entry up again.
+  Revalidated,
+  // The upstream request was reset, or never sent.
+  Reset,
+};
+
+// Receives the response of a CoalescedFill. Callbacks are always made on the dispatcher passed to
+// RequestCoalescer::join.
+class CoalescedFillCallbacks {
+public:
+  virtual ~CoalescedFillCallbacks() = default;
+
+  // If the response varies, vary_identifier is the identifier of the leading request's variant,
+  // so that followers can check whether the response is also the right variant for them.
+  virtual void onFillHeaders(Http::ResponseHeaderMapPtr&& headers,
+                             const absl::optional<std::string>& vary_identifier,
+                             bool end_stream) PURE;
+  virtual void onFillData(Buffer::Instance& data, bool end_stream) PURE;
+  virtual void onFillTrailers(Http::ResponseTrailerMapPtr&& trailers) PURE;
+  // No more callbacks are made after this one.
+  virtual void onFillFailed(CoalescedFillFailure failure) PURE;
+};
+
+class RequestCoalescer;
+
+// An upstream fetch for a cache miss, which other requests for the same cache key can follow
+// instead of sending their own upstream requests. The upstream request of the leading request
+// publishes the response as it arrives, and every follower receives a copy posted to its own
+// dispatcher, so followers may be on any worker thread.
+//
+// The response received so far is retained so that requests which join late can catch up, up to
+// MaxReplayBytes of body. After that, or once the response is complete, the fill stops accepting
+// new followers.
+class CoalescedFill : public std::enable_shared_from_this<CoalescedFill> {
+public:
+  static constexpr uint64_t MaxReplayBytes = 1024 * 1024;
+
+  // A follower's subscription to a fill. Must only be used on the follower's dispatcher.
+  class Subscription {
+  public:
+    Subscription(Event::Dispatcher& dispatcher, CoalescedFillCallbacks& callbacks,
+                 std::weak_ptr<CoalescedFill> fill)
+        : dispatcher_(dispatcher), callbacks_(&callbacks), fill_(std::move(fill)) {}
+
+    // Stops delivery of the response. No callbacks are made once this returns.
+    void cancel();
+
+  private:
+    friend class CoalescedFill;
+
+    Event::Dispatcher& dispatcher_;
+    CoalescedFillCallbacks* callbacks_;
+    const std::weak_ptr<CoalescedFill> fill_;
+  };
+  using SubscriptionSharedPtr = std::shared_ptr<Subscription>;
+
+  CoalescedFill(RequestCoalescer& coalescer, const Key& key,
+                const Http::RequestHeaderMap& request_headers);
+  ~CoalescedFill();
+
+  // Called by the leading request as the response arrives, on the leader's dispatcher. Calls after
+  // the response has ended or failed are ignored.
+  void onHeaders(const Http::ResponseHeaderMap& headers, const VaryAllowList& vary_allow_list,
+                 bool end_stream);
+  void onData(const Buffer::Instance& data, bool end_stream);
+  void onTrailers(const Http::ResponseTrailerMap& trailers);
+  void onFailed(CoalescedFillFailure failure);
+
+private:
+  friend class RequestCoalescer;
+
+  // Adds a follower, catching it up with the response so far. Returns nullptr if the fill no longer
+  // accepts followers.
+  SubscriptionSharedPtr subscribe(Event::Dispatcher& dispatcher, CoalescedFillCallbacks& callbacks);
+  void unsubscribe(const Subscription& subscription);
+  // Stops new requests from joining the fill. Must not be called with mutex_ held.
+  void closeToFollowers();
+  void finishLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  static void postHeaders(const SubscriptionSharedPtr& subscription,
+                          const Http::ResponseHeaderMap& headers,
+                          const absl::optional<std::string>& vary_identifier, bool end_stream);
+  static void postData(const SubscriptionSharedPtr& subscription,
+                       std::shared_ptr<const std::string> data, bool end_stream);
+
+  RequestCoalescer& coalescer_;
+  const Key key_;
+  // Only accessed by the leader.
+  const Http::RequestHeaderMapPtr leader_request_headers_;
+  // Body bytes received so far. Only accessed by the leader.
+  uint64_t body_bytes_received_{0};
+
+  absl::Mutex mutex_;
+  std::vector<SubscriptionSharedPtr> subscribers_ ABSL_GUARDED_BY(mutex_);
+  // The response headers and body retained for followers which join late.
+  Http::ResponseHeaderMapPtr headers_ ABSL_GUARDED_BY(mutex_);
+  absl::optional<std::string> vary_identifier_ ABSL_GUARDED_BY(mutex_);
+  Buffer::OwnedImpl body_ ABSL_GUARDED_BY(mutex_);
+  // Set once the fill no longer accepts followers.
+  bool closed_ ABSL_GUARDED_BY(mutex_){false};
+  // Set once the response has ended or failed.
+  bool finished_ ABSL_GUARDED_BY(mutex_){false};
+};
+using CoalescedFillSharedPtr = std::shared_ptr<CoalescedFill>;
+
+// The table of in-flight fills, keyed on cache key. Shared by all workers using a filter config.
+class RequestCoalescer {
+public:
+  // If a fill is in flight for key, subscribes callbacks to it and returns the subscription.
+  // Otherwise returns nullptr.
+  CoalescedFill::SubscriptionSharedPtr join(const Key& key, Event::Dispatcher& dispatcher,
+                                            CoalescedFillCallbacks& callbacks);
+
+  // Registers a new fill for key, led by the caller. Returns nullptr if a fill is already in flight
+  // for key.
+  CoalescedFillSharedPtr lead(const Key& key, const Http::RequestHeaderMap& request_headers);
+
+private:
+  friend class CoalescedFill;
+
+  void remove(const Key& key, const CoalescedFill& fill);
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Key, CoalescedFill*, MessageUtil, MessageUtil> fills_ ABSL_GUARDED_BY(mutex_);
+};
+using RequestCoalescerPtr = std::unique_ptr<RequestCoalescer>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -71,9 +71,17 @@ void UpstreamRequest::processSuccessfulValidation(Http::ResponseHeaderMapPtr res
     // TODO(yosrym93): else the cached entry should be deleted.
     // Update metadata associated with the cached response. Right now this is only response_time;
     const ResponseMetadata metadata = {config_->timeSource().systemTime()};
+    // Requests waiting for this one look the entry up again, once it has been freshened.
     cache_->updateHeaders(*lookup_, *response_headers, metadata,
-                          [](bool updated ABSL_ATTRIBUTE_UNUSED) {});
+                          [coalesced_fill = std::move(coalesced_fill_)](bool) {
+                            if (coalesced_fill != nullptr) {
+                              coalesced_fill->onFailed(CoalescedFillFailure::Revalidated);
+                            }
+                          });
     setInsertStatus(InsertStatus::HeaderUpdate);
+  } else if (coalesced_fill_ != nullptr) {
+    coalesced_fill_->onFailed(CoalescedFillFailure::Revalidated);
+    coalesced_fill_ = nullptr;
   }
 
   // A cache entry was successfully validated, so abort the upstream request, send
@@ -116,20 +124,22 @@ UpstreamRequest* UpstreamRequest::create(CacheFilter* filter, LookupContextPtr l
                                          LookupResultPtr lookup_result,
                                          std::shared_ptr<HttpCache> cache,
                                          Http::AsyncClient& async_client,
-                                         const Http::AsyncClient::StreamOptions& options) {
+                                         const Http::AsyncClient::StreamOptions& options,
+                                         CoalescedFillSharedPtr coalesced_fill) {
   return new UpstreamRequest(filter, std::move(lookup), std::move(lookup_result), std::move(cache),
-                             async_client, options);
+                             async_client, options, std::move(coalesced_fill));
 }
 
 UpstreamRequest::UpstreamRequest(CacheFilter* filter, LookupContextPtr lookup,
                                  LookupResultPtr lookup_result, std::shared_ptr<HttpCache> cache,
                                  Http::AsyncClient& async_client,
-                                 const Http::AsyncClient::StreamOptions& options)
+                                 const Http::AsyncClient::StreamOptions& options,
+                                 CoalescedFillSharedPtr coalesced_fill)
     : filter_(filter), lookup_(std::move(lookup)), lookup_result_(std::move(lookup_result)),
       is_head_request_(filter->is_head_request_),
       request_allows_inserts_(filter->request_allows_inserts_), config_(filter->config_),
       filter_state_(filter->filter_state_), cache_(std::move(cache)),
-      stream_(async_client.start(*this, options)) {
+      stream_(async_client.start(*this, options)), coalesced_fill_(std::move(coalesced_fill)) {
   ASSERT(stream_ != nullptr);
 }
 
@@ -162,6 +172,11 @@ void UpstreamRequest::abort() {
 }
 
 UpstreamRequest::~UpstreamRequest() {
+  if (coalesced_fill_ != nullptr) {
+    // Requests waiting for this one send their own upstream requests, unless they have already
+    // received part of the response.
+    coalesced_fill_->onFailed(CoalescedFillFailure::Reset);
+  }
   if (filter_ != nullptr) {
     filter_->onUpstreamRequestReset();
   }
@@ -200,8 +215,21 @@ void UpstreamRequest::onHeaders(Http::ResponseHeaderMapPtr&& headers, bool end_s
   }
   // Either a cache miss or a cache entry that is no longer valid.
   // Check if the new response can be cached.
-  if (request_allows_inserts_ && !is_head_request_ &&
-      CacheabilityUtils::isCacheableResponse(*headers, config_->varyAllowList())) {
+  const bool cacheable =
+      request_allows_inserts_ && !is_head_request_ &&
+      CacheabilityUtils::isCacheableResponse(*headers, config_->varyAllowList());
+  if (coalesced_fill_ != nullptr) {
+    // Only a cacheable response is shared, as only it could have been served from cache.
+    if (cacheable) {
+      coalesced_fill_->onHeaders(*headers, config_->varyAllowList(), end_stream);
+    } else {
+      coalesced_fill_->onFailed(CoalescedFillFailure::NotShareable);
+    }
+    if (!cacheable || end_stream) {
+      coalesced_fill_ = nullptr;
+    }
+  }
+  if (cacheable) {
     if (filter_) {
       ENVOY_STREAM_LOG(debug, "UpstreamRequest::onHeaders inserting headers",
                        *filter_->decoder_callbacks_);
@@ -235,6 +263,12 @@ void UpstreamRequest::onHeaders(Http::ResponseHeaderMapPtr&& headers, bool end_s
 }
 
 void UpstreamRequest::onData(Buffer::Instance& body, bool end_stream) {
+  if (coalesced_fill_ != nullptr) {
+    coalesced_fill_->onData(body, end_stream);
+    if (end_stream) {
+      coalesced_fill_ = nullptr;
+    }
+  }
   if (insert_queue_ != nullptr) {
     insert_queue_->insertBody(body, end_stream);
   }
@@ -253,6 +287,10 @@ void UpstreamRequest::onData(Buffer::Instance& body, bool end_stream) {
 }
 
 void UpstreamRequest::onTrailers(Http::ResponseTrailerMapPtr&& trailers) {
+  if (coalesced_fill_ != nullptr) {
+    coalesced_fill_->onTrailers(*trailers);
+    coalesced_fill_ = nullptr;
+  }
   if (insert_queue_ != nullptr) {
     insert_queue_->insertTrailers(*trailers);
   }
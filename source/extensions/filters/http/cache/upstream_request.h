@@ -3,6 +3,7 @@
 #include "source/common/common/logger.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/filters/http/cache/cache_insert_queue.h"
+#include "source/extensions/filters/http/cache/request_coalescer.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -38,10 +39,12 @@ public:
   static UpstreamRequest* create(CacheFilter* filter, LookupContextPtr lookup,
                                  LookupResultPtr lookup_result, std::shared_ptr<HttpCache> cache,
                                  Http::AsyncClient& async_client,
-                                 const Http::AsyncClient::StreamOptions& options);
+                                 const Http::AsyncClient::StreamOptions& options,
+                                 CoalescedFillSharedPtr coalesced_fill = nullptr);
   UpstreamRequest(CacheFilter* filter, LookupContextPtr lookup, LookupResultPtr lookup_result,
                   std::shared_ptr<HttpCache> cache, Http::AsyncClient& async_client,
-                  const Http::AsyncClient::StreamOptions& options);
+                  const Http::AsyncClient::StreamOptions& options,
+                  CoalescedFillSharedPtr coalesced_fill);
   ~UpstreamRequest() override;
 
 private:
@@ -76,6 +79,9 @@ private:
   std::shared_ptr<HttpCache> cache_;
   Http::AsyncClient::Stream* stream_ = nullptr;
   std::unique_ptr<CacheInsertQueue> insert_queue_;
+  // If other requests for the same cache key are waiting for this one, the response is shared
+  // with them through coalesced_fill_. It is released once the response ends or can't be shared.
+  CoalescedFillSharedPtr coalesced_fill_;
 };
 
 } // namespace Cache
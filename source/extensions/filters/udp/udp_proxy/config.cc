@@ -150,6 +150,16 @@ UdpProxyFilterConfigImpl::UdpProxyFilterConfigImpl(
     tunneling_config_ = std::make_unique<TunnelingConfigImpl>(config.tunneling_config(), context);
   }
 
+  if (config.has_upstream_packet_writer_config()) {
+    auto& factory_factory =
+        Config::Utility::getAndCheckFactory<Network::UdpPacketWriterFactoryFactory>(
+            config.upstream_packet_writer_config());
+    upstream_packet_writer_factory_ =
+        factory_factory.createUdpPacketWriterFactory(config.upstream_packet_writer_config());
+  } else {
+    upstream_packet_writer_factory_ = std::make_unique<Network::UdpDefaultWriterFactory>();
+  }
+
   if (config.has_access_log_options()) {
     flush_access_log_on_tunnel_connected_ =
         config.access_log_options().flush_access_log_on_tunnel_connected();
@@ -338,6 +338,13 @@ UdpProxyFilter::UdpActiveSession::UdpActiveSession(
     : ActiveSession(filter, std::move(addresses), std::move(host)),
       use_original_src_ip_(filter_.config_->usingOriginalSrcIp()) {}
 
+UdpProxyFilter::UdpActiveSession::~UdpActiveSession() {
+  // Send any datagrams still batched in the writer before the socket is closed.
+  if (writer_ != nullptr && writer_->isBatchMode()) {
+    flushUpstream();
+  }
+}
+
 UdpProxyFilter::ActiveSession::~ActiveSession() {
   ENVOY_BUG(on_session_complete_called_, "onSessionComplete() not called");
 }
@@ -553,16 +560,116 @@ void UdpProxyFilter::UdpActiveSession::writeUpstream(Network::UdpRecvData& data)
             tx_buffer_length, addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host_->address()->asStringView());
 
+  // While the socket buffer is full, datagrams are dropped until the write event for the socket
+  // makes the writer writable again.
+  if (writer_->isWriteBlocked()) {
+    cluster_->cluster_stats_.sess_tx_errors_.inc();
+    return;
+  }
+
   const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
-  Api::IoCallUint64Result rc = Network::Utility::writeToSocket(
-      udp_socket_->ioHandle(), *data.buffer_, local_ip, *host_->address());
+  if (!writer_->isBatchMode()) {
+    onUpstreamWritten(writer_->writePacket(*data.buffer_, local_ip, *host_->address()),
+                      tx_buffer_length);
+    return;
+  }
+
+  // A datagram which is too large to batch is sent on its own, and one with a source address may be
+  // sent by the writer at once. Either way, the datagrams batched before it are flushed first so
+  // that the result of the write only applies to this datagram.
+  const bool too_large = tx_buffer_length > writer_->getMaxPacketSize(*host_->address());
+  if ((too_large || local_ip != nullptr) && !batched_datagram_lengths_.empty()) {
+    flushUpstream();
+    if (writer_->isWriteBlocked()) {
+      cluster_->cluster_stats_.sess_tx_errors_.inc();
+      return;
+    }
+  }
+  if (too_large) {
+    onUpstreamWritten(Network::Utility::writeToSocket(udp_socket_->ioHandle(), *data.buffer_,
+                                                      local_ip, *host_->address()),
+                      tx_buffer_length);
+    return;
+  }
 
+  const Api::IoCallUint64Result rc =
+      writer_->writePacket(*data.buffer_, local_ip, *host_->address());
   if (!rc.ok()) {
+    // The writer failed to send the datagrams it was holding to make room for this one, and dropped
+    // them along with it.
+    onUpstreamFlushed(rc);
+    onUpstreamWritten(rc, tx_buffer_length);
+    return;
+  }
+  // The datagram is counted once the batch holding it has been sent. If the writer sent a full
+  // batch on its own to make room, the datagrams in it are counted by the next flush.
+  batched_datagram_lengths_.push_back(tx_buffer_length);
+  flush_upstream_cb_->scheduleCallbackCurrentIteration();
+}
+
+void UdpProxyFilter::UdpActiveSession::onUpstreamWritten(const Api::IoCallUint64Result& rc,
+                                                         uint64_t tx_buffer_length) {
+  if (!rc.ok()) {
+    ENVOY_LOG(debug, "cannot write datagram upstream: downstream={} local={} upstream={}: {}",
+              addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
+              host_->address()->asStringView(), rc.err_->getErrorDetails());
     cluster_->cluster_stats_.sess_tx_errors_.inc();
   } else {
     cluster_->cluster_stats_.sess_tx_datagrams_.inc();
     cluster_->cluster_info_->trafficStats()->upstream_cx_tx_bytes_total_.add(tx_buffer_length);
   }
+  enableWriteEventIfBlocked();
+}
+
+void UdpProxyFilter::UdpActiveSession::flushUpstream() {
+  const Api::IoCallUint64Result rc = writer_->flush();
+  if (!rc.ok()) {
+    ENVOY_LOG(debug, "cannot flush datagrams upstream: downstream={} local={} upstream={}: {}",
+              addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
+              host_->address()->asStringView(), rc.err_->getErrorDetails());
+  }
+  onUpstreamFlushed(rc);
+  enableWriteEventIfBlocked();
+}
+
+void UdpProxyFilter::UdpActiveSession::onUpstreamFlushed(const Api::IoCallUint64Result& rc) {
+  if (cluster_ == nullptr) {
+    batched_datagram_lengths_.clear();
+    return;
+  }
+
+  // Batched datagrams are sent in order, so a failed flush sent the ones whose lengths add up to
+  // the bytes it reports and dropped the rest.
+  uint64_t bytes_left = rc.return_value_;
+  uint64_t datagrams_sent = 0;
+  uint64_t bytes_sent = 0;
+  for (const uint64_t length : batched_datagram_lengths_) {
+    if (!rc.ok()) {
+      if (length > bytes_left) {
+        break;
+      }
+      bytes_left -= length;
+    }
+    ++datagrams_sent;
+    bytes_sent += length;
+  }
+
+  cluster_->cluster_stats_.sess_tx_datagrams_.add(datagrams_sent);
+  cluster_->cluster_stats_.sess_tx_errors_.add(batched_datagram_lengths_.size() - datagrams_sent);
+  cluster_->cluster_info_->trafficStats()->upstream_cx_tx_bytes_total_.add(bytes_sent);
+  batched_datagram_lengths_.clear();
+}
+
+void UdpProxyFilter::UdpActiveSession::enableWriteEventIfBlocked() {
+  if (writer_->isWriteBlocked()) {
+    udp_socket_->ioHandle().enableFileEvents(Event::FileReadyType::Read |
+                                             Event::FileReadyType::Write);
+  }
+}
+
+void UdpProxyFilter::UdpActiveSession::onWriteReady() {
+  writer_->setWritable();
+  udp_socket_->ioHandle().enableFileEvents(Event::FileReadyType::Read);
 }
 
 bool UdpProxyFilter::ActiveSession::onContinueFilterChain(ActiveReadFilter* filter) {
@@ -631,10 +738,22 @@ void UdpProxyFilter::UdpActiveSession::createUdpSocket(const Upstream::HostConst
   // NOTE: The socket call can only fail due to memory/fd exhaustion. No local ephemeral port
   //       is bound until the first packet is sent to the upstream host.
   udp_socket_ = filter_.createUdpSocket(host);
+  writer_ = filter_.config_->upstreamPacketWriterFactory().createUdpPacketWriter(
+      udp_socket_->ioHandle(), cluster_->cluster_info_->statsScope());
+  if (writer_->isBatchMode()) {
+    flush_upstream_cb_ =
+        filter_.read_callbacks_->udpListener().dispatcher().createSchedulableCallback(
+            [this] { flushUpstream(); });
+  }
   udp_socket_->ioHandle().initializeFileEvent(
       filter_.read_callbacks_->udpListener().dispatcher(),
-      [this](uint32_t) {
-        onReadReady();
+      [this](uint32_t events) {
+        if (events & Event::FileReadyType::Write) {
+          onWriteReady();
+        }
+        if (events & Event::FileReadyType::Read) {
+          onReadReady();
+        }
         return absl::OkStatus();
       },
       Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
@@ -654,6 +773,19 @@ void UdpProxyFilter::UdpActiveSession::createUdpSocket(const Upstream::HostConst
               addresses_.peer_->asStringView());
   }
 
+  // Reads use a GRO sized buffer whenever the platform supports GRO, so ask the kernel to coalesce
+  // datagrams from the upstream host into it. Otherwise each read only returns a single datagram.
+  if (filter_.config_->upstreamSocketConfig().prefer_gro_ &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.udp_proxy_upstream_gro") &&
+      udp_socket_->ioHandle().supportsUdpGro()) {
+    if (!Network::Socket::applyOptions(Network::SocketOptionFactory::buildUdpGroOptions(),
+                                       *udp_socket_,
+                                       envoy::config::core::v3::SocketOption::STATE_BOUND)) {
+      ENVOY_LOG(debug, "cannot enable UDP_GRO on the upstream socket for address {}.",
+                host->address()->asStringView());
+    }
+  }
+
   // TODO(mattklein123): Enable dropped packets socket option. In general the Socket abstraction
   // does not work well right now for client sockets. It's too heavy weight and is aimed at listener
   // sockets. We need to figure out how to either refactor Socket into something that works better
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <queue>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/config/accesslog/v3/accesslog.pb.h"
@@ -9,6 +10,7 @@
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
 #include "envoy/http/header_evaluator.h"
 #include "envoy/network/filter.h"
+#include "envoy/network/udp_packet_writer_handler.h"
 #include "envoy/stream_info/stream_info.h"
 #include "envoy/stream_info/uint32_accessor.h"
 #include "envoy/upstream/cluster_manager.h"
@@ -24,6 +26,7 @@
 #include "source/common/http/utility.h"
 #include "source/common/network/socket_impl.h"
 #include "source/common/network/socket_interface.h"
+#include "source/common/network/udp_packet_writer_handler_impl.h"
 #include "source/common/network/utility.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/router/header_parser.h"
@@ -131,6 +134,7 @@ public:
   virtual UdpProxyDownstreamStats& stats() const PURE;
   virtual TimeSource& timeSource() const PURE;
   virtual const Network::ResolvedUdpSocketConfig& upstreamSocketConfig() const PURE;
+  virtual Network::UdpPacketWriterFactory& upstreamPacketWriterFactory() const PURE;
   virtual const AccessLog::InstanceSharedPtrVector& sessionAccessLogs() const PURE;
   virtual const AccessLog::InstanceSharedPtrVector& proxyAccessLogs() const PURE;
   virtual const UdpSessionFilterChainFactory& sessionFilterFactory() const PURE;
@@ -681,7 +685,7 @@ protected:
   public:
     UdpActiveSession(UdpProxyFilter& filter, Network::UdpRecvData::LocalPeerAddresses&& addresses,
                      const Upstream::HostConstSharedPtr& host);
-    ~UdpActiveSession() override = default;
+    ~UdpActiveSession() override;
 
     // ActiveSession
     bool shouldCreateUpstream() override;
@@ -717,12 +721,26 @@ protected:
 
   private:
     void onReadReady();
+    void onWriteReady();
     void createUdpSocket(const Upstream::HostConstSharedPtr& host);
+    void flushUpstream();
+    // Counts a datagram written upstream on its own as sent or as a send error.
+    void onUpstreamWritten(const Api::IoCallUint64Result& rc, uint64_t tx_buffer_length);
+    // Counts the datagrams batched since the last flush as sent or as send errors.
+    void onUpstreamFlushed(const Api::IoCallUint64Result& rc);
+    // Waits for the socket to become writable once the writer is blocked by a full socket buffer.
+    void enableWriteEventIfBlocked();
 
     // The socket is used for writing packets to the selected upstream host as well as receiving
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
     // write to the upstream host.
     Network::SocketPtr udp_socket_;
+    // Writes datagrams to udp_socket_. A batching writer is flushed by flush_upstream_cb_ at the
+    // end of the event loop iteration in which datagrams were written to it.
+    Network::UdpPacketWriterPtr writer_;
+    Event::SchedulableCallbackPtr flush_upstream_cb_;
+    // The lengths of the datagrams batched in writer_ since the last flush, in order.
+    std::vector<uint64_t> batched_datagram_lengths_;
     // The socket has been connected to avoid port exhaustion.
     bool connected_{};
     const bool use_original_src_ip_;
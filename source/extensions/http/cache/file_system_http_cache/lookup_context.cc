@@ -138,21 +138,26 @@ void FileLookupContext::getBody(const AdjustedByteRange& range, LookupBodyCallba
   ASSERT(cb);
   ASSERT(!cancel_action_in_flight_);
   ASSERT(file_handle_);
-  auto queued = file_handle_->read(
-      dispatcher(), header_block_.offsetToBody() + range.begin(), range.length(),
-      [this, cb = std::move(cb), range](absl::StatusOr<Buffer::InstancePtr> read_result) mutable {
-        ASSERT(dispatcher()->isThreadSafe());
-        cancel_action_in_flight_ = nullptr;
-        if (!read_result.ok() || read_result.value()->length() != range.length()) {
-          invalidateCacheEntry();
-          // Calling callback with nullptr fails the request.
-          std::move(cb)(nullptr, /* end_stream (ignored) = */ false);
-          return;
-        }
-        std::move(cb)(std::move(read_result.value()),
-                      /* end_stream = */ range.end() == header_block_.bodySize() &&
-                          header_block_.trailerSize() == 0);
-      });
+  auto on_read = [this, cb = std::move(cb),
+                  range](absl::StatusOr<Buffer::InstancePtr> read_result) mutable {
+    ASSERT(dispatcher()->isThreadSafe());
+    cancel_action_in_flight_ = nullptr;
+    if (!read_result.ok() || read_result.value()->length() != range.length()) {
+      invalidateCacheEntry();
+      // Calling callback with nullptr fails the request.
+      std::move(cb)(nullptr, /* end_stream (ignored) = */ false);
+      return;
+    }
+    std::move(cb)(std::move(read_result.value()),
+                  /* end_stream = */ range.end() == header_block_.bodySize() &&
+                      header_block_.trailerSize() == 0);
+  };
+  const off_t offset = header_block_.offsetToBody() + range.begin();
+  // A mapped body is sent to the downstream socket straight from the cache file where possible.
+  auto queued = cache_.config().send_body_from_file()
+                    ? file_handle_->readMapped(dispatcher(), offset, range.length(),
+                                               std::move(on_read))
+                    : file_handle_->read(dispatcher(), offset, range.length(), std::move(on_read));
   ASSERT(queued.ok(), queued.status().ToString());
   cancel_action_in_flight_ = std::move(queued.value());
 }
@@ -0,0 +1,84 @@
+#include "source/extensions/http/cache/memory_http_cache/frequency_sketch.h"
+
+#include <algorithm>
+
+#include "absl/numeric/bits.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+namespace {
+
+// Odd multipliers giving each row an independent-looking index for the same hash.
+constexpr uint64_t RowSeeds[] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+                                 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL};
+constexpr uint64_t OneMask = 0x1111111111111111ULL;
+constexpr uint64_t ResetMask = 0x7777777777777777ULL;
+// Keeps small shards from having so few counters that unrelated keys routinely share them.
+constexpr uint64_t MinExpectedEntries = 64;
+
+uint64_t tableSize(uint64_t expected_entries) {
+  // One word per expected entry gives each key sixteen candidate counters per row, which keeps
+  // the estimates accurate without growing the sketch past a few bytes per entry.
+  return absl::bit_ceil(
+      std::clamp<uint64_t>(expected_entries, MinExpectedEntries, uint64_t(1) << 24));
+}
+
+} // namespace
+
+FrequencySketch::FrequencySketch(uint64_t expected_entries)
+    : table_(tableSize(expected_entries)), table_mask_(table_.size() - 1),
+      sample_size_(10 * std::max(expected_entries, MinExpectedEntries)) {}
+
+uint64_t FrequencySketch::indexOf(uint64_t hash, uint32_t row) const {
+  uint64_t h = (hash + RowSeeds[row]) * RowSeeds[row];
+  h += h >> 32;
+  return h & table_mask_;
+}
+
+void FrequencySketch::increment(uint64_t hash) {
+  // Which of the four groups of four counters in a word this key uses.
+  const uint32_t start = (hash & 3) << 2;
+  bool added = false;
+  for (uint32_t row = 0; row < 4; ++row) {
+    uint64_t& word = table_[indexOf(hash, row)];
+    const uint32_t shift = (start + row) << 2;
+    const uint64_t mask = uint64_t(0xf) << shift;
+    if ((word & mask) != mask) {
+      word += uint64_t(1) << shift;
+      added = true;
+    }
+  }
+  if (added && ++additions_ >= sample_size_) {
+    reset();
+  }
+}
+
+uint32_t FrequencySketch::frequency(uint64_t hash) const {
+  const uint32_t start = (hash & 3) << 2;
+  uint32_t frequency = MaxFrequency;
+  for (uint32_t row = 0; row < 4; ++row) {
+    const uint32_t shift = (start + row) << 2;
+    frequency =
+        std::min<uint32_t>(frequency, (table_[indexOf(hash, row)] >> shift) & MaxFrequency);
+  }
+  return frequency;
+}
+
+void FrequencySketch::reset() {
+  uint64_t odd_counters = 0;
+  for (uint64_t& word : table_) {
+    odd_counters += absl::popcount(word & OneMask);
+    word = (word >> 1) & ResetMask;
+  }
+  // Halving truncates odd counters, and each increment touched four of them.
+  additions_ = (additions_ - std::min(additions_, odd_counters >> 2)) >> 1;
+}
+
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+
+/**
+ * A count-min sketch of recent access frequencies, with 4-bit counters, as used by TinyLFU to
+ * decide whether a new cache entry is worth keeping at the expense of an existing one.
+ *
+ * Each key is counted in one counter in each of four rows, and its estimated frequency is the
+ * smallest of those counters. Once the number of increments reaches ten times the expected number
+ * of entries, all counters are halved, so that the sketch reflects recent popularity rather than
+ * all-time popularity.
+ *
+ * Not thread-safe.
+ */
+class FrequencySketch {
+public:
+  // The largest frequency the sketch can count.
+  static constexpr uint32_t MaxFrequency = 15;
+
+  /**
+   * @param expected_entries the number of distinct keys the sketch should be able to tell apart,
+   *        i.e. roughly the number of entries the cache can hold.
+   */
+  explicit FrequencySketch(uint64_t expected_entries);
+
+  /**
+   * Counts an access to the key with the given hash.
+   */
+  void increment(uint64_t hash);
+
+  /**
+   * @return the estimated number of recent accesses to the key with the given hash, up to
+   *         MaxFrequency.
+   */
+  uint32_t frequency(uint64_t hash) const;
+
+private:
+  // Returns the index in table_ of the word holding the counter for hash in the given row.
+  uint64_t indexOf(uint64_t hash, uint32_t row) const;
+  // Halves every counter.
+  void reset();
+
+  // Each word holds sixteen counters.
+  std::vector<uint64_t> table_;
+  const uint64_t table_mask_;
+  const uint64_t sample_size_;
+  uint64_t additions_{0};
+};
+
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
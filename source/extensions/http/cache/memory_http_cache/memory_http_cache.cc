@@ -0,0 +1,563 @@
+#include "source/extensions/http/cache/memory_http_cache/memory_http_cache.h"
+
+#include <algorithm>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/extensions/filters/http/cache/cache_entry_utils.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+namespace {
+
+constexpr uint32_t DefaultShards = 32;
+
+// Approximate memory used by an entry beyond its key, headers, body and trailers: the index node,
+// its place in the eviction order, and the entry and header map structures.
+constexpr uint64_t EntryOverheadBytes = 256;
+
+// Used to size the frequency sketch of a shard, which needs to tell apart about as many keys as
+// the shard can hold.
+constexpr uint64_t EstimatedEntrySizeBytes = 16 * 1024;
+
+uint32_t shardCount(const ConfigProto& config) {
+  return PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, shards, DefaultShards);
+}
+
+uint64_t shardSizeBytes(const ConfigProto& config) {
+  return std::max<uint64_t>(config.max_cache_size_bytes() / shardCount(config), 1);
+}
+
+MemoryHttpCacheStats generateStats(Stats::Scope& scope, absl::string_view name) {
+  const std::string prefix =
+      absl::StrCat("cache.memory.", absl::StrReplaceAll(name, {{".", "_"}}), ".");
+  return {ALL_MEMORY_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                      POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+// Returns the key of the variant of a response with a vary header which matches the request, or
+// nullopt if the vary headers in the response are not compatible with the VaryAllowList.
+absl::optional<Key> variedRequestKey(const Key& key, const Http::RequestHeaderMap& request_headers,
+                                     const VaryAllowList& vary_allow_list,
+                                     const Http::ResponseHeaderMap& response_headers) {
+  absl::btree_set<absl::string_view> vary_header_values =
+      VaryHeaderUtils::getVaryValues(response_headers);
+  ASSERT(!vary_header_values.empty());
+  const absl::optional<std::string> vary_identifier =
+      VaryHeaderUtils::createVaryIdentifier(vary_allow_list, vary_header_values, request_headers);
+  if (!vary_identifier.has_value()) {
+    return absl::nullopt;
+  }
+  Key varied_request_key = key;
+  varied_request_key.add_custom_fields(vary_identifier.value());
+  return varied_request_key;
+}
+
+// A slice of a cached body, which keeps the body alive until the buffer holding it is drained.
+class CachedBodyFragment : public Buffer::BufferFragment {
+public:
+  CachedBodyFragment(std::shared_ptr<const std::string> body, uint64_t offset, uint64_t length)
+      : body_(std::move(body)), offset_(offset), length_(length) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return body_->data() + offset_; }
+  size_t size() const override { return length_; }
+  void done() override { delete this; }
+
+private:
+  const std::shared_ptr<const std::string> body_;
+  const uint64_t offset_;
+  const uint64_t length_;
+};
+
+class MemoryLookupContext : public LookupContext {
+public:
+  MemoryLookupContext(Event::Dispatcher& dispatcher, MemoryHttpCache& cache,
+                      LookupRequest&& request)
+      : dispatcher_(dispatcher), cache_(cache), request_(std::move(request)) {}
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    entry_ = cache_.lookup(request_);
+    LookupResult result;
+    bool end_stream = true;
+    if (entry_ != nullptr) {
+      result = request_.makeLookupResult(
+          Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry_->response_headers_),
+          ResponseMetadata(entry_->metadata_), entry_->body_->size());
+      end_stream = entry_->body_->empty() && entry_->trailers_ == nullptr;
+    }
+    dispatcher_.post([result = std::move(result), cb = std::move(cb), end_stream,
+                      cancelled = cancelled_]() mutable {
+      if (!*cancelled) {
+        std::move(cb)(std::move(result), end_stream);
+      }
+    });
+  }
+
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    ASSERT(entry_ != nullptr);
+    ASSERT(range.end() <= entry_->body_->size(), "Attempt to read past end of body.");
+    auto result = std::make_unique<Buffer::OwnedImpl>();
+    if (range.length() > 0) {
+      result->addBufferFragment(
+          *new CachedBodyFragment(entry_->body_, range.begin(), range.length()));
+    }
+    const bool end_stream = entry_->trailers_ == nullptr && range.end() == entry_->body_->size();
+    dispatcher_.post([result = std::move(result), cb = std::move(cb), end_stream,
+                      cancelled = cancelled_]() mutable {
+      if (!*cancelled) {
+        std::move(cb)(std::move(result), end_stream);
+      }
+    });
+  }
+
+  void getTrailers(LookupTrailersCallback&& cb) override {
+    ASSERT(entry_ != nullptr && entry_->trailers_ != nullptr);
+    dispatcher_.post([cb = std::move(cb),
+                      trailers = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(
+                          *entry_->trailers_),
+                      cancelled = cancelled_]() mutable {
+      if (!*cancelled) {
+        std::move(cb)(std::move(trailers));
+      }
+    });
+  }
+
+  void onDestroy() override { *cancelled_ = true; }
+
+  const LookupRequest& request() const { return request_; }
+  Event::Dispatcher& dispatcher() const { return dispatcher_; }
+
+private:
+  Event::Dispatcher& dispatcher_;
+  std::shared_ptr<bool> cancelled_ = std::make_shared<bool>(false);
+  MemoryHttpCache& cache_;
+  const LookupRequest request_;
+  CacheEntrySharedPtr entry_;
+};
+
+class MemoryInsertContext : public InsertContext {
+public:
+  MemoryInsertContext(std::unique_ptr<MemoryLookupContext> lookup_context, MemoryHttpCache& cache)
+      : lookup_context_(std::move(lookup_context)), cache_(cache) {}
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, InsertCallback insert_success,
+                     bool end_stream) override {
+    ASSERT(!committed_);
+    response_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+    metadata_ = metadata;
+    if (end_stream) {
+      post(std::move(insert_success), commit());
+    } else {
+      post(std::move(insert_success), withinSizeLimit());
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+    body_.add(chunk);
+    if (end_stream) {
+      post(std::move(ready_for_next_chunk), commit());
+    } else {
+      post(std::move(ready_for_next_chunk), withinSizeLimit());
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap& trailers,
+                      InsertCallback insert_complete) override {
+    ASSERT(!committed_);
+    trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(trailers);
+    post(std::move(insert_complete), commit());
+  }
+
+  void onDestroy() override {
+    *cancelled_ = true;
+    lookup_context_->onDestroy();
+  }
+
+private:
+  void post(InsertCallback cb, bool result) {
+    lookup_context_->dispatcher().post(
+        [cb = std::move(cb), result, cancelled = cancelled_]() mutable {
+          if (!*cancelled) {
+            std::move(cb)(result);
+          }
+        });
+  }
+
+  // Checks the response received so far against the entry size limit, so that the filter can
+  // stop buffering a response that won't be cached.
+  bool withinSizeLimit() {
+    if (response_headers_->byteSize() + body_.length() <= cache_.maxEntrySizeBytes()) {
+      return true;
+    }
+    cache_.stats().insert_rejections_.inc();
+    return false;
+  }
+
+  bool commit() {
+    committed_ = true;
+    const LookupRequest& request = lookup_context_->request();
+    return cache_.insert(request.key(), request.requestHeaders(), request.varyAllowList(),
+                         std::move(response_headers_), std::move(metadata_), body_.toString(),
+                         std::move(trailers_));
+  }
+
+  const std::unique_ptr<MemoryLookupContext> lookup_context_;
+  MemoryHttpCache& cache_;
+  std::shared_ptr<bool> cancelled_ = std::make_shared<bool>(false);
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  Buffer::OwnedImpl body_;
+  Http::ResponseTrailerMapPtr trailers_;
+  bool committed_ = false;
+};
+
+} // namespace
+
+CacheShard::CacheShard(uint64_t max_size_bytes, ConfigProto::EvictionPolicy eviction_policy,
+                       MemoryHttpCacheStats& stats)
+    : max_size_bytes_(max_size_bytes),
+      window_capacity_(eviction_policy == ConfigProto::LRU ? max_size_bytes : max_size_bytes / 100),
+      main_capacity_(max_size_bytes - window_capacity_),
+      protected_capacity_(main_capacity_ / 5 * 4), stats_(stats),
+      sketch_(eviction_policy == ConfigProto::LRU
+                  ? nullptr
+                  : std::make_unique<FrequencySketch>(max_size_bytes / EstimatedEntrySizeBytes)) {}
+
+CacheShard::NodeList& CacheShard::list(Region region) {
+  switch (region) {
+  case Region::Window:
+    return window_;
+  case Region::Probation:
+    return probation_;
+  case Region::Protected:
+    return protected_;
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+uint64_t& CacheShard::regionBytes(Region region) {
+  switch (region) {
+  case Region::Window:
+    return window_bytes_;
+  case Region::Probation:
+    return probation_bytes_;
+  case Region::Protected:
+    return protected_bytes_;
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+void CacheShard::link(Node& node, Region region) {
+  NodeList& nodes = list(region);
+  nodes.push_front(&node);
+  node.position_ = nodes.begin();
+  node.region_ = region;
+  regionBytes(region) += node.size_;
+}
+
+void CacheShard::unlink(Node& node) {
+  list(node.region_).erase(node.position_);
+  regionBytes(node.region_) -= node.size_;
+}
+
+void CacheShard::evict(Node& node) {
+  stats_.evictions_.inc();
+  stats_.size_bytes_.sub(node.size_);
+  stats_.size_count_.dec();
+  nodes_.erase(nodes_.find(*node.key_));
+}
+
+void CacheShard::onAccess(Node& node) {
+  switch (node.region_) {
+  case Region::Window:
+  case Region::Protected: {
+    NodeList& nodes = list(node.region_);
+    nodes.splice(nodes.begin(), nodes, node.position_);
+    return;
+  }
+  case Region::Probation:
+    // A second use of an entry on probation shows it is worth protecting.
+    unlink(node);
+    link(node, Region::Protected);
+    demoteFromProtected();
+    return;
+  }
+}
+
+void CacheShard::evictFromWindow() {
+  while (window_bytes_ > window_capacity_) {
+    Node& candidate = *window_.back();
+    unlink(candidate);
+    admitToMain(candidate);
+  }
+}
+
+void CacheShard::admitToMain(Node& candidate) {
+  if (candidate.size_ > main_capacity_) {
+    evict(candidate);
+    return;
+  }
+  while (probation_bytes_ + protected_bytes_ + candidate.size_ > main_capacity_) {
+    Node& victim = probation_.empty() ? *protected_.back() : *probation_.back();
+    // Ties go to the existing entry, so that a burst of one-off requests can't flush the cache.
+    if (sketch_->frequency(candidate.hash_) <= sketch_->frequency(victim.hash_)) {
+      evict(candidate);
+      return;
+    }
+    unlink(victim);
+    evict(victim);
+  }
+  link(candidate, Region::Probation);
+}
+
+void CacheShard::demoteFromProtected() {
+  while (protected_bytes_ > protected_capacity_) {
+    Node& node = *protected_.back();
+    unlink(node);
+    link(node, Region::Probation);
+  }
+}
+
+CacheEntrySharedPtr CacheShard::lookup(const Key& key, uint64_t hash) {
+  absl::MutexLock lock(&mutex_);
+  if (sketch_ != nullptr) {
+    sketch_->increment(hash);
+  }
+  auto it = nodes_.find(key);
+  if (it == nodes_.end()) {
+    return nullptr;
+  }
+  onAccess(it->second);
+  return it->second.entry_;
+}
+
+CacheEntrySharedPtr CacheShard::find(const Key& key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = nodes_.find(key);
+  return it == nodes_.end() ? nullptr : it->second.entry_;
+}
+
+void CacheShard::insert(const Key& key, uint64_t hash, CacheEntrySharedPtr entry, uint64_t size) {
+  ASSERT(size <= max_size_bytes_);
+  absl::MutexLock lock(&mutex_);
+  auto [it, inserted] = nodes_.try_emplace(key);
+  Node& node = it->second;
+  if (inserted) {
+    node.key_ = &it->first;
+    stats_.size_count_.inc();
+  } else {
+    unlink(node);
+    stats_.size_bytes_.sub(node.size_);
+  }
+  node.hash_ = hash;
+  node.entry_ = std::move(entry);
+  node.size_ = size;
+  stats_.size_bytes_.add(size);
+  link(node, Region::Window);
+  evictFromWindow();
+}
+
+bool CacheShard::replace(const Key& key, const CacheEntry& expected_entry,
+                         CacheEntrySharedPtr entry, uint64_t size) {
+  ASSERT(size <= max_size_bytes_);
+  absl::MutexLock lock(&mutex_);
+  auto it = nodes_.find(key);
+  if (it == nodes_.end() || it->second.entry_.get() != &expected_entry) {
+    return false;
+  }
+  Node& node = it->second;
+  stats_.size_bytes_.sub(node.size_);
+  stats_.size_bytes_.add(size);
+  regionBytes(node.region_) -= node.size_;
+  regionBytes(node.region_) += size;
+  node.entry_ = std::move(entry);
+  node.size_ = size;
+  // The entry may have grown, so make room for it.
+  evictFromWindow();
+  demoteFromProtected();
+  while (probation_bytes_ + protected_bytes_ > main_capacity_) {
+    Node& victim = probation_.empty() ? *protected_.back() : *probation_.back();
+    unlink(victim);
+    evict(victim);
+  }
+  return true;
+}
+
+uint64_t CacheShard::sizeBytes() const {
+  absl::MutexLock lock(&mutex_);
+  return window_bytes_ + probation_bytes_ + protected_bytes_;
+}
+
+uint64_t CacheShard::sizeCount() const {
+  absl::MutexLock lock(&mutex_);
+  return nodes_.size();
+}
+
+MemoryHttpCache::MemoryHttpCache(const ConfigProto& config, Stats::Scope& stats_scope)
+    : config_(config), stats_(generateStats(stats_scope, config.name())),
+      max_entry_size_bytes_(std::min(shardSizeBytes(config),
+                                     PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entry_size_bytes,
+                                                                     shardSizeBytes(config)))) {
+  const uint32_t shard_count = shardCount(config);
+  shards_.reserve(shard_count);
+  for (uint32_t i = 0; i < shard_count; ++i) {
+    shards_.push_back(std::make_unique<CacheShard>(shardSizeBytes(config),
+                                                   config.eviction_policy(), stats_));
+  }
+}
+
+CacheShard& MemoryHttpCache::shardFor(uint64_t hash) {
+  // The low bits of the hash pick counters in the frequency sketch, so use the high bits here.
+  return *shards_[(hash >> 32) % shards_.size()];
+}
+
+uint64_t MemoryHttpCache::entrySize(const Key& key, const CacheEntry& entry) {
+  return key.ByteSizeLong() + entry.response_headers_->byteSize() + entry.body_->size() +
+         (entry.trailers_ != nullptr ? entry.trailers_->byteSize() : 0) + EntryOverheadBytes;
+}
+
+LookupContextPtr MemoryHttpCache::makeLookupContext(LookupRequest&& request,
+                                                    Http::StreamFilterCallbacks& callbacks) {
+  return std::make_unique<MemoryLookupContext>(callbacks.dispatcher(), *this, std::move(request));
+}
+
+InsertContextPtr MemoryHttpCache::makeInsertContext(LookupContextPtr&& lookup_context,
+                                                    Http::StreamFilterCallbacks&) {
+  auto memory_lookup_context = std::unique_ptr<MemoryLookupContext>(
+      dynamic_cast<MemoryLookupContext*>(lookup_context.release()));
+  ASSERT(memory_lookup_context);
+  return std::make_unique<MemoryInsertContext>(std::move(memory_lookup_context), *this);
+}
+
+CacheEntrySharedPtr MemoryHttpCache::lookup(const LookupRequest& request) {
+  uint64_t hash = MessageUtil::hash(request.key());
+  CacheEntrySharedPtr entry = shardFor(hash).lookup(request.key(), hash);
+  if (entry != nullptr && VaryHeaderUtils::hasVary(*entry->response_headers_)) {
+    const absl::optional<Key> varied_key =
+        variedRequestKey(request.key(), request.requestHeaders(), request.varyAllowList(),
+                         *entry->response_headers_);
+    entry = nullptr;
+    if (varied_key.has_value()) {
+      hash = MessageUtil::hash(*varied_key);
+      entry = shardFor(hash).lookup(*varied_key, hash);
+    }
+  }
+  if (entry != nullptr) {
+    stats_.hits_.inc();
+  } else {
+    stats_.misses_.inc();
+  }
+  return entry;
+}
+
+bool MemoryHttpCache::insert(const Key& key, const Http::RequestHeaderMap& request_headers,
+                             const VaryAllowList& vary_allow_list,
+                             Http::ResponseHeaderMapPtr&& response_headers,
+                             ResponseMetadata&& metadata, std::string&& body,
+                             Http::ResponseTrailerMapPtr&& trailers) {
+  if (!VaryHeaderUtils::hasVary(*response_headers)) {
+    return insertEntry(key, std::make_shared<const CacheEntry>(CacheEntry{
+                                std::move(response_headers), std::move(metadata),
+                                std::make_shared<const std::string>(std::move(body)),
+                                std::move(trailers)}));
+  }
+
+  const absl::optional<Key> varied_key =
+      variedRequestKey(key, request_headers, vary_allow_list, *response_headers);
+  if (!varied_key.has_value()) {
+    // Skip the insert if we are unable to create a vary key.
+    return false;
+  }
+  Http::ResponseHeaderMapPtr vary_only_headers =
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+  vary_only_headers->setCopy(Http::CustomHeaders::get().Vary,
+                             absl::StrJoin(VaryHeaderUtils::getVaryValues(*response_headers), ","));
+  if (!insertEntry(*varied_key, std::make_shared<const CacheEntry>(CacheEntry{
+                                    std::move(response_headers), std::move(metadata),
+                                    std::make_shared<const std::string>(std::move(body)),
+                                    std::move(trailers)}))) {
+    return false;
+  }
+  // Add a special entry to flag that this request generates varied responses. It is replaced
+  // even if present, in case the response now varies on different headers.
+  return insertEntry(key, std::make_shared<const CacheEntry>(
+                              CacheEntry{std::move(vary_only_headers), {},
+                                         std::make_shared<const std::string>(), nullptr}));
+}
+
+bool MemoryHttpCache::insertEntry(const Key& key, CacheEntrySharedPtr entry) {
+  const uint64_t size = entrySize(key, *entry);
+  if (size > max_entry_size_bytes_) {
+    stats_.insert_rejections_.inc();
+    return false;
+  }
+  const uint64_t hash = MessageUtil::hash(key);
+  shardFor(hash).insert(key, hash, std::move(entry), size);
+  stats_.inserts_.inc();
+  return true;
+}
+
+CacheEntrySharedPtr MemoryHttpCache::findForUpdate(const LookupRequest& request, Key& key) {
+  key = request.key();
+  CacheEntrySharedPtr entry = shardFor(MessageUtil::hash(key)).find(key);
+  if (entry == nullptr || !VaryHeaderUtils::hasVary(*entry->response_headers_)) {
+    return entry;
+  }
+  absl::optional<Key> varied_key = variedRequestKey(
+      key, request.requestHeaders(), request.varyAllowList(), *entry->response_headers_);
+  if (!varied_key.has_value()) {
+    return nullptr;
+  }
+  key = std::move(*varied_key);
+  return shardFor(MessageUtil::hash(key)).find(key);
+}
+
+void MemoryHttpCache::updateHeaders(const LookupContext& lookup_context,
+                                    const Http::ResponseHeaderMap& response_headers,
+                                    const ResponseMetadata& metadata,
+                                    UpdateHeadersCallback on_complete) {
+  const auto& memory_lookup_context = static_cast<const MemoryLookupContext&>(lookup_context);
+  Key key;
+  CacheEntrySharedPtr entry = findForUpdate(memory_lookup_context.request(), key);
+  bool updated = false;
+  if (entry != nullptr) {
+    Http::ResponseHeaderMapPtr updated_headers =
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry->response_headers_);
+    applyHeaderUpdate(response_headers, *updated_headers);
+    // The body and trailers are shared with the entry being replaced.
+    auto updated_entry = std::make_shared<const CacheEntry>(
+        CacheEntry{std::move(updated_headers), metadata, entry->body_, entry->trailers_});
+    const uint64_t size = entrySize(key, *updated_entry);
+    updated = size <= max_entry_size_bytes_ &&
+              shardFor(MessageUtil::hash(key)).replace(key, *entry, std::move(updated_entry), size);
+  }
+  memory_lookup_context.dispatcher().post(
+      [on_complete = std::move(on_complete), updated]() mutable {
+        std::move(on_complete)(updated);
+      });
+}
+
+CacheInfo MemoryHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = name();
+  return cache_info;
+}
+
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
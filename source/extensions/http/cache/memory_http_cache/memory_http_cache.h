@@ -0,0 +1,223 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/http/cache/memory_http_cache/v3/memory_http_cache.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/memory_http_cache/frequency_sketch.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+
+using ConfigProto = envoy::extensions::http::cache::memory_http_cache::v3::MemoryHttpCacheConfig;
+
+/**
+ * All memory cache stats. @see stats_macros.h
+ *
+ * evictions counts entries removed to make room for others, including new entries which the
+ * admission policy declined to keep. insert_rejections counts responses too large to be cached.
+ */
+#define ALL_MEMORY_HTTP_CACHE_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(evictions)                                                                               \
+  COUNTER(hits)                                                                                    \
+  COUNTER(insert_rejections)                                                                       \
+  COUNTER(inserts)                                                                                 \
+  COUNTER(misses)                                                                                  \
+  GAUGE(size_bytes, NeverImport)                                                                   \
+  GAUGE(size_count, NeverImport)
+
+/**
+ * Struct definition for all memory cache stats. @see stats_macros.h
+ */
+struct MemoryHttpCacheStats {
+  ALL_MEMORY_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * A cached response. Entries are never modified once cached; updating the headers of an entry
+ * replaces it with a new entry sharing the same body and trailers. Lookups hold a reference to the
+ * entry they found, so its body can be handed to the filter without copying, even if the entry is
+ * evicted in the meantime.
+ */
+struct CacheEntry {
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  std::shared_ptr<const std::string> body_;
+  std::shared_ptr<const Http::ResponseTrailerMap> trailers_;
+};
+using CacheEntrySharedPtr = std::shared_ptr<const CacheEntry>;
+
+/**
+ * One shard of a MemoryHttpCache: an index of entries, bounded in total size, with its own lock.
+ *
+ * With the W_TINY_LFU policy, the shard is split into a window holding 1% of its capacity and a
+ * main region holding the rest. New entries enter the window, which is least-recently-used. An
+ * entry leaving the window is admitted to the main region only if the frequency sketch estimates
+ * that it has been requested more often than the entries it would displace. The main region is a
+ * segmented LRU: admitted entries start out on probation, and move to the protected segment,
+ * holding up to 80% of the main region, when they are used again.
+ *
+ * With the LRU policy, the whole shard is the window, and entries leaving it are evicted.
+ */
+class CacheShard {
+public:
+  CacheShard(uint64_t max_size_bytes, ConfigProto::EvictionPolicy eviction_policy,
+             MemoryHttpCacheStats& stats);
+
+  /**
+   * Records a request for key, and returns its entry if there is one.
+   * @param hash the hash of key, as used for choosing the shard.
+   */
+  CacheEntrySharedPtr lookup(const Key& key, uint64_t hash);
+
+  /**
+   * Returns the entry for key if there is one, without recording a request for it.
+   */
+  CacheEntrySharedPtr find(const Key& key);
+
+  /**
+   * Inserts an entry, replacing any existing entry for key, and evicts entries as needed to stay
+   * within the size limit. The new entry may itself be evicted straight away.
+   * @param size the size of the entry, which must not exceed the size limit of the shard.
+   */
+  void insert(const Key& key, uint64_t hash, CacheEntrySharedPtr entry, uint64_t size);
+
+  /**
+   * Replaces the entry for key, keeping its place in the eviction order, if it is still
+   * expected_entry.
+   * @return false if the entry for key has been evicted or replaced since it was read.
+   */
+  bool replace(const Key& key, const CacheEntry& expected_entry, CacheEntrySharedPtr entry,
+               uint64_t size);
+
+  uint64_t maxSizeBytes() const { return max_size_bytes_; }
+  uint64_t sizeBytes() const;
+  uint64_t sizeCount() const;
+
+private:
+  enum class Region { Window, Probation, Protected };
+
+  struct Node;
+  using NodeList = std::list<Node*>;
+  struct Node {
+    const Key* key_;
+    uint64_t hash_;
+    CacheEntrySharedPtr entry_;
+    uint64_t size_;
+    Region region_;
+    NodeList::iterator position_;
+  };
+
+  NodeList& list(Region region) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  uint64_t& regionBytes(Region region) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void link(Node& node, Region region) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void unlink(Node& node) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Removes an unlinked node from the index, counting it as evicted.
+  void evict(Node& node) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void onAccess(Node& node) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Moves entries out of the window until it is within its capacity.
+  void evictFromWindow() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Admits an unlinked node leaving the window to the main region, or evicts it.
+  void admitToMain(Node& candidate) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Moves entries from the protected segment to probation until it is within its capacity.
+  void demoteFromProtected() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const uint64_t max_size_bytes_;
+  const uint64_t window_capacity_;
+  const uint64_t main_capacity_;
+  const uint64_t protected_capacity_;
+  MemoryHttpCacheStats& stats_;
+
+  mutable absl::Mutex mutex_;
+  absl::node_hash_map<Key, Node, MessageUtil, MessageUtil> nodes_ ABSL_GUARDED_BY(mutex_);
+  // Most recently used first.
+  NodeList window_ ABSL_GUARDED_BY(mutex_);
+  NodeList probation_ ABSL_GUARDED_BY(mutex_);
+  NodeList protected_ ABSL_GUARDED_BY(mutex_);
+  uint64_t window_bytes_ ABSL_GUARDED_BY(mutex_){0};
+  uint64_t probation_bytes_ ABSL_GUARDED_BY(mutex_){0};
+  uint64_t protected_bytes_ ABSL_GUARDED_BY(mutex_){0};
+  // Only used by W_TINY_LFU.
+  std::unique_ptr<FrequencySketch> sketch_ ABSL_GUARDED_BY(mutex_);
+};
+
+/**
+ * An HttpCache which keeps responses in memory, up to a configured total size.
+ *
+ * Entries are spread over shards by a hash of their cache key, so that lookups and inserts on
+ * different workers rarely wait for each other. Bodies of cache hits are passed to the filter as
+ * buffer fragments referencing the cached body, rather than copies.
+ */
+class MemoryHttpCache : public HttpCache {
+public:
+  MemoryHttpCache(const ConfigProto& config, Stats::Scope& stats_scope);
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request,
+                                     Http::StreamFilterCallbacks& callbacks) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context,
+                                     Http::StreamFilterCallbacks& callbacks) override;
+  void updateHeaders(const LookupContext& lookup_context,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, UpdateHeadersCallback on_complete) override;
+  CacheInfo cacheInfo() const override;
+
+  const ConfigProto& config() const { return config_; }
+  uint64_t maxEntrySizeBytes() const { return max_entry_size_bytes_; }
+  MemoryHttpCacheStats& stats() { return stats_; }
+
+  /**
+   * @return the entry for the request, following the vary entry for its key if there is one, or
+   *         nullptr on a miss.
+   */
+  CacheEntrySharedPtr lookup(const LookupRequest& request);
+
+  /**
+   * Inserts a response for a request, if it isn't too large. If the response has a vary header, it
+   * is inserted as the variant matching request_headers.
+   * @return false if the response was not inserted.
+   */
+  bool insert(const Key& key, const Http::RequestHeaderMap& request_headers,
+              const VaryAllowList& vary_allow_list, Http::ResponseHeaderMapPtr&& response_headers,
+              ResponseMetadata&& metadata, std::string&& body,
+              Http::ResponseTrailerMapPtr&& trailers);
+
+  /**
+   * @return the size of an entry, as counted towards the size limit of the cache.
+   */
+  static uint64_t entrySize(const Key& key, const CacheEntry& entry);
+
+  static absl::string_view name() { return "envoy.extensions.http.cache.memory_http_cache"; }
+
+private:
+  CacheShard& shardFor(uint64_t hash);
+  bool insertEntry(const Key& key, CacheEntrySharedPtr entry);
+  // Returns the entry for key without recording a request for it, following the vary entry for
+  // key if there is one. Sets key to the key of the returned entry.
+  CacheEntrySharedPtr findForUpdate(const LookupRequest& request, Key& key);
+
+  const ConfigProto config_;
+  MemoryHttpCacheStats stats_;
+  std::vector<std::unique_ptr<CacheShard>> shards_;
+  const uint64_t max_entry_size_bytes_;
+};
+
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -236,14 +236,7 @@ HeaderValidator::validateGenericHeaderValue(const HeaderString& value) {
   //
   // VCHAR          =  %x21-7E
   //                   ; visible (printing) characters
-  const auto& value_string_view = value.getStringView();
-  bool is_valid = true;
-
-  for (auto iter = value_string_view.begin(); iter != value_string_view.end() && is_valid; ++iter) {
-    is_valid &= testCharInTable(kGenericHeaderValueCharTable, *iter);
-  }
-
-  if (!is_valid) {
+  if (!::Envoy::Http::kGenericHeaderValueCharSet.containsAll(value.getStringView())) {
     return {HeaderValueValidationResult::Action::Reject,
             UhvResponseCodeDetail::get().InvalidValueCharacters};
   }
@@ -422,63 +415,53 @@ HeaderValidator::validateHostHeaderRegName(absl::string_view host) {
 
 HeaderValidator::HeaderValueValidationResult
 HeaderValidator::validatePathHeaderCharacters(const HeaderString& value) {
-  return validatePathHeaderCharacterSet(value, kPathHeaderCharTable,
-                                        ::Envoy::Http::kUriQueryAndFragmentCharTable);
+  return validatePathHeaderCharacterSet(value, kPathHeaderCharSet,
+                                        ::Envoy::Http::kUriQueryAndFragmentCharSet);
 }
 
 HeaderValidator::HeaderValueValidationResult HeaderValidator::validatePathHeaderCharacterSet(
-    const HeaderString& value, const std::array<uint32_t, 8>& allowed_path_chracters,
-    const std::array<uint32_t, 8>& allowed_query_fragment_characters) {
+    const HeaderString& value, const ::Envoy::Http::CharacterSet& allowed_path_chracters,
+    const ::Envoy::Http::CharacterSet& allowed_query_fragment_characters) {
   static const HeaderValueValidationResult bad_path_result{
       HeaderValueValidationResult::Action::Reject, UhvResponseCodeDetail::get().InvalidUrl};
-  const auto& path = value.getStringView();
+  // The path character sets never contain '?' or '#', so the first character that is not in the
+  // path character set either starts the query or fragment, or is invalid.
+  ASSERT(!allowed_path_chracters.contains('?') && !allowed_path_chracters.contains('#'));
+  absl::string_view path = value.getStringView();
   if (path.empty()) {
     return bad_path_result;
   }
 
-  auto iter = path.begin();
-  auto end = path.end();
-
   // Validate the path component of the URI
-  for (; iter != end; ++iter) {
-    if (*iter == '?' || *iter == '#') {
-      // This is the start of the query or fragment portion of the path which uses a different
-      // character table.
-      break;
-    }
+  size_t pos = allowed_path_chracters.findFirstNotIn(path);
+  if (pos == absl::string_view::npos) {
+    return HeaderValueValidationResult::success();
+  }
+  if (path[pos] != '?' && path[pos] != '#') {
+    return bad_path_result;
+  }
 
-    if (!testCharInTable(allowed_path_chracters, *iter)) {
+  if (path[pos] == '?') {
+    // Validate the query component of the URI. This is the start of the query or fragment portion
+    // of the path which uses a different character table.
+    path.remove_prefix(pos + 1);
+    pos = path.find('#');
+    if (!allowed_query_fragment_characters.containsAll(path.substr(0, pos))) {
       return bad_path_result;
     }
-  }
-
-  if (iter != end && *iter == '?') {
-    // Validate the query component of the URI
-    ++iter;
-    for (; iter != end; ++iter) {
-      if (*iter == '#') {
-        break;
-      }
-
-      if (!testCharInTable(allowed_query_fragment_characters, *iter)) {
-        return bad_path_result;
-      }
+    if (pos == absl::string_view::npos) {
+      return HeaderValueValidationResult::success();
     }
   }
 
-  if (iter != end) {
-    ASSERT(*iter == '#');
-    if (!config_.strip_fragment_from_path()) {
-      return {HeaderValueValidationResult::Action::Reject,
-              UhvResponseCodeDetail::get().FragmentInUrlPath};
-    }
-    // Validate the fragment component of the URI
-    ++iter;
-    for (; iter != end; ++iter) {
-      if (!testCharInTable(allowed_query_fragment_characters, *iter)) {
-        return bad_path_result;
-      }
-    }
+  ASSERT(path[pos] == '#');
+  if (!config_.strip_fragment_from_path()) {
+    return {HeaderValueValidationResult::Action::Reject,
+            UhvResponseCodeDetail::get().FragmentInUrlPath};
+  }
+  // Validate the fragment component of the URI
+  if (!allowed_query_fragment_characters.containsAll(path.substr(pos + 1))) {
+    return bad_path_result;
   }
 
   return HeaderValueValidationResult::success();
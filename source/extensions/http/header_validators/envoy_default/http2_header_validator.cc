@@ -153,9 +153,13 @@ Http2HeaderValidator::validatePathHeaderWithAdditionalCharactersHttp2(
       0b11111111111111111111111111111111,
       0b11111111111111111111111111111111,
   };
+  static constexpr ::Envoy::Http::CharacterSet kPathHeaderCharSetWithAdditionalCharacters{
+      kPathHeaderCharTableWithAdditionalCharacters};
+  static constexpr ::Envoy::Http::CharacterSet kQueryAndFragmentCharSetWithAdditionalCharacters{
+      kQueryAndFragmentCharTableWithAdditionalCharacters};
   return HeaderValidator::validatePathHeaderCharacterSet(
-      path_header_value, kPathHeaderCharTableWithAdditionalCharacters,
-      kQueryAndFragmentCharTableWithAdditionalCharacters);
+      path_header_value, kPathHeaderCharSetWithAdditionalCharacters,
+      kQueryAndFragmentCharSetWithAdditionalCharacters);
 }
 
 HeaderValidator::HeaderValueValidationResult
@@ -201,9 +205,13 @@ Http2HeaderValidator::validatePathHeaderWithAdditionalCharactersHttp3(
       0b00000000000000000000000000000000,
       0b00000000000000000000000000000000,
   };
+  static constexpr ::Envoy::Http::CharacterSet kPathHeaderCharSetWithAdditionalCharacters{
+      kPathHeaderCharTableWithAdditionalCharacters};
+  static constexpr ::Envoy::Http::CharacterSet kQueryAndFragmentCharSetWithAdditionalCharacters{
+      kQueryAndFragmentCharTableWithAdditionalCharacters};
   return HeaderValidator::validatePathHeaderCharacterSet(
-      path_header_value, kPathHeaderCharTableWithAdditionalCharacters,
-      kQueryAndFragmentCharTableWithAdditionalCharacters);
+      path_header_value, kPathHeaderCharSetWithAdditionalCharacters,
+      kQueryAndFragmentCharSetWithAdditionalCharacters);
 }
 
 ValidationResult
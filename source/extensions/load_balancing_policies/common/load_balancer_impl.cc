@@ -936,14 +936,24 @@ void EdfLoadBalancerBase::recalculateHostsInSlowStart(const HostVector& hosts) {
 }
 
 void EdfLoadBalancerBase::refresh(uint32_t priority) {
-  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
-    // Nuke existing scheduler if it exists.
-    auto& scheduler = scheduler_[source] = Scheduler{};
+  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts,
+                                       const HostVector* previous_hosts) {
+    auto& scheduler = scheduler_[source];
     refreshHostSource(source);
     if (isSlowStartEnabled()) {
       recalculateHostsInSlowStart(hosts);
     }
 
+    // Updates usually touch only a few of the host lists of a priority, e.g. a single locality,
+    // so the schedulers of the lists which are unchanged are kept rather than rebuilt. With slow
+    // start, weights change over time and the schedulers are always rebuilt.
+    if (previous_hosts != nullptr && !isSlowStartEnabled() &&
+        schedulerUpToDate(scheduler, hosts, *previous_hosts)) {
+      return;
+    }
+    // Nuke existing scheduler if it exists.
+    scheduler = Scheduler{};
+
     // Check if the original host weights are equal and no hosts are in slow start mode, in that
     // case EDF creation is skipped. When all original weights are equal and no hosts are in slow
     // start mode we can rely on unweighted host pick to do optimal round robin and least-loaded
@@ -972,26 +982,75 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
         // at which point it is reinserted into the EdfScheduler with its new
         // weight in chooseHost().
         [this](const Host& host) { return hostWeight(host); }, seed_));
+    scheduler.weights_.reserve(hosts.size());
+    for (const auto& host : hosts) {
+      scheduler.weights_.push_back(host->weight());
+    }
   };
+  const auto previous_locality_hosts = [](const HostsPerLocalityConstSharedPtr& hosts_per_locality,
+                                          uint32_t locality_index) -> const HostVector* {
+    if (hosts_per_locality == nullptr || locality_index >= hosts_per_locality->get().size()) {
+      return nullptr;
+    }
+    return &hosts_per_locality->get()[locality_index];
+  };
+
   // Populate EdfSchedulers for each valid HostsSource value for the host set at this priority.
   const auto& host_set = priority_set_.hostSetsPerPriority()[priority];
-  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts());
+  if (refreshed_hosts_.size() <= priority) {
+    refreshed_hosts_.resize(priority + 1);
+  }
+  // The previous lists are kept alive until the schedulers are refreshed, so that they can be
+  // compared with the current ones.
+  const RefreshedHosts previous = std::move(refreshed_hosts_[priority]);
+  RefreshedHosts& current = refreshed_hosts_[priority];
+  current.hosts_ = host_set->hostsPtr();
+  current.healthy_hosts_ = host_set->healthyHostsPtr();
+  current.degraded_hosts_ = host_set->degradedHostsPtr();
+  current.healthy_hosts_per_locality_ = host_set->healthyHostsPerLocalityPtr();
+  current.degraded_hosts_per_locality_ = host_set->degradedHostsPerLocalityPtr();
+
+  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts(),
+                   previous.hosts_.get());
   add_hosts_source(HostsSource(priority, HostsSource::SourceType::HealthyHosts),
-                   host_set->healthyHosts());
+                   host_set->healthyHosts(),
+                   previous.healthy_hosts_ != nullptr ? &previous.healthy_hosts_->get() : nullptr);
   add_hosts_source(HostsSource(priority, HostsSource::SourceType::DegradedHosts),
-                   host_set->degradedHosts());
+                   host_set->degradedHosts(),
+                   previous.degraded_hosts_ != nullptr ? &previous.degraded_hosts_->get()
+                                                       : nullptr);
   for (uint32_t locality_index = 0;
        locality_index < host_set->healthyHostsPerLocality().get().size(); ++locality_index) {
     add_hosts_source(
         HostsSource(priority, HostsSource::SourceType::LocalityHealthyHosts, locality_index),
-        host_set->healthyHostsPerLocality().get()[locality_index]);
+        host_set->healthyHostsPerLocality().get()[locality_index],
+        previous_locality_hosts(previous.healthy_hosts_per_locality_, locality_index));
   }
   for (uint32_t locality_index = 0;
        locality_index < host_set->degradedHostsPerLocality().get().size(); ++locality_index) {
     add_hosts_source(
         HostsSource(priority, HostsSource::SourceType::LocalityDegradedHosts, locality_index),
-        host_set->degradedHostsPerLocality().get()[locality_index]);
+        host_set->degradedHostsPerLocality().get()[locality_index],
+        previous_locality_hosts(previous.degraded_hosts_per_locality_, locality_index));
+  }
+}
+
+bool EdfLoadBalancerBase::schedulerUpToDate(const Scheduler& scheduler, const HostVector& hosts,
+                                            const HostVector& previous_hosts) {
+  if (&hosts != &previous_hosts && hosts != previous_hosts) {
+    return false;
   }
+  if (scheduler.edf_ == nullptr) {
+    // The scheduler was skipped because the weights were equal, or there were too few hosts.
+    return hostWeightsAreEqual(hosts);
+  }
+  // The weights of hosts are updated in place, so the scheduler must be rebuilt if any changed.
+  for (size_t i = 0; i < hosts.size(); ++i) {
+    if (hosts[i]->weight() != scheduler.weights_[i]) {
+      return false;
+    }
+  }
+  return true;
 }
 
 bool EdfLoadBalancerBase::isSlowStartEnabled() const {
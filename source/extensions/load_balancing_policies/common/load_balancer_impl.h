@@ -474,6 +474,8 @@ protected:
     // host weights of 2 or more hosts differ. When not present, the
     // implementation of chooseHostOnce falls back to unweightedHostPick.
     std::unique_ptr<EdfScheduler<Host>> edf_;
+    // The weights of the hosts when edf_ was built, in the order of the hosts.
+    std::vector<uint32_t> weights_;
   };
 
   void initialize();
@@ -496,6 +498,19 @@ protected:
 
 private:
   friend class EdfLoadBalancerBasePeer;
+
+  // The host lists of a priority which its schedulers were last refreshed from.
+  struct RefreshedHosts {
+    HostVectorConstSharedPtr hosts_;
+    HealthyHostVectorConstSharedPtr healthy_hosts_;
+    DegradedHostVectorConstSharedPtr degraded_hosts_;
+    HostsPerLocalityConstSharedPtr healthy_hosts_per_locality_;
+    HostsPerLocalityConstSharedPtr degraded_hosts_per_locality_;
+  };
+
+  // Whether a scheduler built for previous_hosts can be kept for hosts.
+  static bool schedulerUpToDate(const Scheduler& scheduler, const HostVector& hosts,
+                                const HostVector& previous_hosts);
   virtual void refreshHostSource(const HostsSource& source) PURE;
   virtual double hostWeight(const Host& host) const PURE;
   virtual HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
@@ -505,6 +520,7 @@ private:
 
   // Scheduler for each valid HostsSource.
   absl::flat_hash_map<HostsSource, Scheduler, HostsSourceHash> scheduler_;
+  std::vector<RefreshedHosts> refreshed_hosts_;
   Common::CallbackHandlePtr priority_update_cb_;
   Common::CallbackHandlePtr member_update_cb_;
 
@@ -38,19 +38,20 @@ public:
   static MaglevTableSharedPtr
   createMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                     double max_normalized_weight, uint64_t table_size,
-                    bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats) {
+                    bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats,
+                    MaglevPermutationCache* permutation_cache) {
 
     MaglevTableSharedPtr maglev_table;
     if (shouldUseCompactTable(normalized_host_weights.size(), table_size)) {
-      maglev_table =
-          std::make_shared<CompactMaglevTable>(normalized_host_weights, max_normalized_weight,
-                                               table_size, use_hostname_for_hashing, stats);
+      maglev_table = std::make_shared<CompactMaglevTable>(
+          normalized_host_weights, max_normalized_weight, table_size, use_hostname_for_hashing,
+          stats, permutation_cache);
       ENVOY_LOG(debug, "creating compact maglev table given table size {} and number of hosts {}",
                 table_size, normalized_host_weights.size());
     } else {
-      maglev_table =
-          std::make_shared<OriginalMaglevTable>(normalized_host_weights, max_normalized_weight,
-                                                table_size, use_hostname_for_hashing, stats);
+      maglev_table = std::make_shared<OriginalMaglevTable>(
+          normalized_host_weights, max_normalized_weight, table_size, use_hostname_for_hashing,
+          stats, permutation_cache);
       ENVOY_LOG(debug, "creating original maglev table given table size {} and number of hosts {}",
                 table_size, normalized_host_weights.size());
     }
@@ -69,13 +70,91 @@ LegacyMaglevLbConfig::LegacyMaglevLbConfig(const ClusterProto& cluster) {
 
 TypedMaglevLbConfig::TypedMaglevLbConfig(const MaglevLbProto& lb_config) : lb_config_(lb_config) {}
 
+MaglevPermutationCache::Permutation MaglevPermutationCache::permutation(absl::string_view key,
+                                                                       uint64_t table_size) {
+  return {HashUtil::xxHash64(key) % table_size,
+          (HashUtil::xxHash64(key, 1) % (table_size - 1)) + 1};
+}
+
+bool MaglevPermutationCache::update(std::vector<HostKey>& hosts) {
+  // Find which cached keys are still present, and collect the keys that were added.
+  std::vector<HostKey> added_hosts;
+  for (uint32_t i = 0; i < hosts.size(); ++i) {
+    const auto it = positions_.find(hosts[i].key_);
+    if (it == positions_.end()) {
+      added_hosts.push_back(hosts[i]);
+    } else if (it->second->host_ == NotPresent) {
+      it->second->host_ = i;
+    } else {
+      clear();
+      return false;
+    }
+  }
+
+  std::sort(added_hosts.begin(), added_hosts.end(),
+            [](const HostKey& a, const HostKey& b) { return a.key_ < b.key_; });
+  for (uint32_t i = 1; i < added_hosts.size(); ++i) {
+    if (added_hosts[i - 1].key_ == added_hosts[i].key_) {
+      clear();
+      return false;
+    }
+  }
+
+  // Merge the remaining cached keys with the added ones, both of which are sorted.
+  std::vector<HostKey> sorted_hosts;
+  sorted_hosts.reserve(hosts.size());
+  std::vector<CachedKeyPtr> keys;
+  keys.reserve(hosts.size());
+  auto added = added_hosts.begin();
+  const auto take_added = [this, &sorted_hosts, &keys, &added]() {
+    HostKey& host = sorted_hosts.emplace_back(*added++);
+    host.permutation_ = permutation(host.key_, table_size_);
+    CachedKeyPtr& cached =
+        keys.emplace_back(std::make_unique<CachedKey>(host.key_, host.permutation_));
+    positions_.emplace(cached->key_, cached.get());
+  };
+  for (CachedKeyPtr& cached : keys_) {
+    if (cached->host_ == NotPresent) {
+      positions_.erase(cached->key_);
+      continue;
+    }
+    while (added != added_hosts.end() && added->key_ < absl::string_view(cached->key_)) {
+      take_added();
+    }
+    HostKey& host = sorted_hosts.emplace_back(hosts[cached->host_]);
+    host.permutation_ = cached->permutation_;
+    cached->host_ = NotPresent;
+    keys.push_back(std::move(cached));
+  }
+  while (added != added_hosts.end()) {
+    take_added();
+  }
+
+  hosts = std::move(sorted_hosts);
+  keys_ = std::move(keys);
+  return true;
+}
+
+void MaglevPermutationCache::clear() {
+  positions_.clear();
+  keys_.clear();
+}
+
 ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr
-MaglevLoadBalancer::createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+MaglevLoadBalancer::createLoadBalancer(uint32_t priority,
+                                       const NormalizedHostWeightVector& normalized_host_weights,
                                        double /* min_normalized_weight */,
                                        double max_normalized_weight) {
-  HashingLoadBalancerSharedPtr maglev_lb =
-      MaglevFactory::createMaglevTable(normalized_host_weights, max_normalized_weight, table_size_,
-                                       use_hostname_for_hashing_, stats_);
+  if (permutation_caches_.size() <= priority) {
+    permutation_caches_.resize(priority + 1);
+  }
+  if (permutation_caches_[priority] == nullptr) {
+    permutation_caches_[priority] = std::make_unique<MaglevPermutationCache>(table_size_);
+  }
+
+  HashingLoadBalancerSharedPtr maglev_lb = MaglevFactory::createMaglevTable(
+      normalized_host_weights, max_normalized_weight, table_size_, use_hostname_for_hashing_,
+      stats_, permutation_caches_[priority].get());
 
   if (hash_balance_factor_ == 0) {
     return maglev_lb;
@@ -85,13 +164,33 @@ MaglevLoadBalancer::createLoadBalancer(const NormalizedHostWeightVector& normali
       maglev_lb, std::move(normalized_host_weights), hash_balance_factor_);
 }
 
-void MaglevTable::constructMaglevTableInternal(
-    const NormalizedHostWeightVector& normalized_host_weights, double max_normalized_weight,
-    bool use_hostname_for_hashing) {
-  // We can't do anything sensible with no hosts.
-  if (normalized_host_weights.empty()) {
-    ENVOY_LOG(debug, "maglev: normalized hosts weights is empty, skipping building table");
-    return;
+std::vector<MaglevTable::TableBuildEntry>
+MaglevTable::tableBuildEntries(const NormalizedHostWeightVector& normalized_host_weights,
+                               bool use_hostname_for_hashing,
+                               MaglevPermutationCache* permutation_cache) const {
+  std::vector<TableBuildEntry> table_build_entries;
+  table_build_entries.reserve(normalized_host_weights.size());
+
+  if (permutation_cache != nullptr) {
+    std::vector<MaglevPermutationCache::HostKey> host_keys;
+    host_keys.reserve(normalized_host_weights.size());
+    for (uint32_t i = 0; i < normalized_host_weights.size(); ++i) {
+      const absl::string_view key_to_hash =
+          hashKey(normalized_host_weights[i].first, use_hostname_for_hashing);
+      ASSERT(!key_to_hash.empty());
+      host_keys.push_back({key_to_hash, i});
+    }
+
+    // Hosts with duplicate hash keys are ordered by pointer below, which the cache cannot
+    // reproduce, so they fall back to a full sort.
+    if (permutation_cache->update(host_keys)) {
+      for (const auto& host_key : host_keys) {
+        const auto& host_weight = normalized_host_weights[host_key.index_];
+        table_build_entries.emplace_back(host_weight.first, host_key.permutation_.offset_,
+                                         host_key.permutation_.skip_, host_weight.second);
+      }
+      return table_build_entries;
+    }
   }
 
   // Prepare stable (sorted) vector of host_weight.
@@ -109,18 +208,30 @@ void MaglevTable::constructMaglevTableInternal(
 
   std::sort(sorted_host_weights.begin(), sorted_host_weights.end());
 
-  // Implementation of pseudocode listing 1 in the paper (see header file for more info).
-  std::vector<TableBuildEntry> table_build_entries;
-  table_build_entries.reserve(normalized_host_weights.size());
   for (const auto& sorted_host_weight : sorted_host_weights) {
     const auto& key_to_hash = std::get<0>(sorted_host_weight);
     const auto& host = std::get<1>(sorted_host_weight);
     const auto& weight = std::get<2>(sorted_host_weight);
 
-    table_build_entries.emplace_back(host, HashUtil::xxHash64(key_to_hash) % table_size_,
-                                     (HashUtil::xxHash64(key_to_hash, 1) % (table_size_ - 1)) + 1,
-                                     weight);
+    const MaglevPermutationCache::Permutation permutation =
+        MaglevPermutationCache::permutation(key_to_hash, table_size_);
+    table_build_entries.emplace_back(host, permutation.offset_, permutation.skip_, weight);
   }
+  return table_build_entries;
+}
+
+void MaglevTable::constructMaglevTableInternal(
+    const NormalizedHostWeightVector& normalized_host_weights, double max_normalized_weight,
+    bool use_hostname_for_hashing, MaglevPermutationCache* permutation_cache) {
+  // We can't do anything sensible with no hosts.
+  if (normalized_host_weights.empty()) {
+    ENVOY_LOG(debug, "maglev: normalized hosts weights is empty, skipping building table");
+    return;
+  }
+
+  // Implementation of pseudocode listing 1 in the paper (see header file for more info).
+  std::vector<TableBuildEntry> table_build_entries =
+      tableBuildEntries(normalized_host_weights, use_hostname_for_hashing, permutation_cache);
 
   constructImplementationInternals(table_build_entries, max_normalized_weight);
 
@@ -144,6 +255,9 @@ void OriginalMaglevTable::constructImplementationInternals(
   // Size internal representation for maglev table correctly.
   table_.resize(table_size_);
 
+  // Track occupied slots separately rather than probing table_, which is 16 bytes per slot.
+  std::vector<uint8_t> occupied(table_size_, 0);
+
   // Iterate through the table build entries as many times as it takes to fill up the table.
   uint64_t table_index = 0;
   for (uint32_t iteration = 1; table_index < table_size_; ++iteration) {
@@ -157,14 +271,13 @@ void OriginalMaglevTable::constructImplementationInternals(
         continue;
       }
       entry.target_weight_ += max_normalized_weight;
-      uint64_t c = permutation(entry);
-      while (table_[c] != nullptr) {
-        entry.next_++;
-        c = permutation(entry);
+      while (occupied[entry.position_]) {
+        nextPosition(entry);
       }
 
-      table_[c] = entry.host_;
-      entry.next_++;
+      table_[entry.position_] = entry.host_;
+      occupied[entry.position_] = 1;
+      nextPosition(entry);
       entry.count_++;
       table_index++;
     }
@@ -173,11 +286,12 @@ void OriginalMaglevTable::constructImplementationInternals(
 CompactMaglevTable::CompactMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                                        double max_normalized_weight, uint64_t table_size,
                                        bool use_hostname_for_hashing,
-                                       MaglevLoadBalancerStats& stats)
+                                       MaglevLoadBalancerStats& stats,
+                                       MaglevPermutationCache* permutation_cache)
     : MaglevTable(table_size, stats),
       table_(absl::bit_width(normalized_host_weights.size()), table_size) {
   constructMaglevTableInternal(normalized_host_weights, max_normalized_weight,
-                               use_hostname_for_hashing);
+                               use_hostname_for_hashing, permutation_cache);
 }
 
 void CompactMaglevTable::constructImplementationInternals(
@@ -191,8 +305,9 @@ void CompactMaglevTable::constructImplementationInternals(
   host_table_.shrink_to_fit();
 
   // Vector to track whether or not a given fixed width bit is set in the
-  // BitArray used as the maglev table.
-  std::vector<bool> occupied(table_size_, false);
+  // BitArray used as the maglev table. This uses a byte per slot, as probing
+  // is measurably faster than with a packed std::vector<bool>.
+  std::vector<uint8_t> occupied(table_size_, 0);
 
   // Iterate through the table build entries as many times as it takes to fill up the table.
   uint64_t table_index = 0;
@@ -207,19 +322,17 @@ void CompactMaglevTable::constructImplementationInternals(
         continue;
       }
       entry.target_weight_ += max_normalized_weight;
-      // As we're using the compact implementation, our table size is limited to
-      // 32-bit, hence static_cast here should be safe.
-      uint32_t c = static_cast<uint32_t>(permutation(entry));
-      while (occupied[c]) {
-        entry.next_++;
-        c = static_cast<uint32_t>(permutation(entry));
+      while (occupied[entry.position_]) {
+        nextPosition(entry);
       }
 
-      // Record the index of the given host.
+      // Record the index of the given host. As we're using the compact implementation, our table
+      // size is limited to 32-bit, hence static_cast here should be safe.
+      const uint32_t c = static_cast<uint32_t>(entry.position_);
       table_.set(c, i);
-      occupied[c] = true;
+      occupied[c] = 1;
 
-      entry.next_++;
+      nextPosition(entry);
       entry.count_++;
       table_index++;
     }
@@ -282,10 +395,6 @@ HostSelectionResponse CompactMaglevTable::chooseHost(uint64_t hash, uint32_t att
   return {host_table_[index]};
 }
 
-uint64_t MaglevTable::permutation(const TableBuildEntry& entry) {
-  return (entry.offset_ + (entry.skip_ * entry.next_)) % table_size_;
-}
-
 MaglevLoadBalancer::MaglevLoadBalancer(
     const PrioritySet& priority_set, ClusterLbStats& stats, Stats::Scope& scope,
     Runtime::Loader& runtime, Random::RandomGenerator& random,
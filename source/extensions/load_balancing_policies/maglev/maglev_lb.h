@@ -1,5 +1,10 @@
 #pragma once
 
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "envoy/common/pure.h"
 #include "envoy/common/random_generator.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
@@ -12,6 +17,8 @@
 #include "source/common/common/bit_array.h"
 #include "source/extensions/load_balancing_policies/common/thread_aware_lb_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -64,6 +71,68 @@ struct MaglevLoadBalancerStats {
 class MaglevTable;
 using MaglevTableSharedPtr = std::shared_ptr<MaglevTable>;
 
+/**
+ * Retains the hash keys and permutation parameters of the hosts used to build a Maglev table, so
+ * that the next table built for the same priority only has to hash and sort the hosts that were
+ * added since. Hosts are ordered by hash key when a table is built, so the remaining hosts can be
+ * merged with the sorted added hosts in linear time, and the resulting table is identical to one
+ * built from scratch.
+ */
+class MaglevPermutationCache {
+public:
+  struct Permutation {
+    uint64_t offset_{};
+    uint64_t skip_{};
+  };
+
+  struct HostKey {
+    // Must remain valid until update() returns.
+    absl::string_view key_;
+    // Index of the host in the caller's host vector.
+    uint32_t index_{};
+    Permutation permutation_{};
+  };
+
+  explicit MaglevPermutationCache(uint64_t table_size) : table_size_(table_size) {}
+
+  /**
+   * @return the permutation parameters of a hash key, as described in section 3.4 of the paper.
+   */
+  static Permutation permutation(absl::string_view key, uint64_t table_size);
+
+  /**
+   * Sorts hosts by hash key and fills in their permutation parameters, hashing only the keys that
+   * were not present in the previous update. Afterwards the cache holds exactly the given keys.
+   * @param hosts the hosts to sort.
+   * @return false if the hash keys are not unique, in which case hosts are left unsorted and the
+   * cache is cleared.
+   */
+  bool update(std::vector<HostKey>& hosts);
+
+  size_t size() const { return keys_.size(); }
+
+private:
+  static constexpr uint32_t NotPresent = std::numeric_limits<uint32_t>::max();
+
+  struct CachedKey {
+    CachedKey(absl::string_view key, const Permutation& permutation)
+        : key_(key), permutation_(permutation) {}
+
+    const std::string key_;
+    const Permutation permutation_;
+    // Index of the host with this key during update(), or NotPresent.
+    uint32_t host_{NotPresent};
+  };
+  using CachedKeyPtr = std::unique_ptr<CachedKey>;
+
+  void clear();
+
+  const uint64_t table_size_;
+  // Sorted by key_.
+  std::vector<CachedKeyPtr> keys_;
+  absl::flat_hash_map<absl::string_view, CachedKey*> positions_;
+};
+
 /**
  * This is an implementation of Maglev consistent hashing as described in:
  * https://static.googleusercontent.com/media/research.google.com/en//pubs/archive/44824.pdf
@@ -83,29 +152,48 @@ public:
 protected:
   struct TableBuildEntry {
     TableBuildEntry(const HostConstSharedPtr& host, uint64_t offset, uint64_t skip, double weight)
-        : host_(host), offset_(offset), skip_(skip), weight_(weight) {}
+        : host_(host), skip_(skip), weight_(weight), position_(offset) {}
 
     HostConstSharedPtr host_;
-    const uint64_t offset_;
     const uint64_t skip_;
     const double weight_;
     double target_weight_{};
-    uint64_t next_{};
+    // The current slot of the entry's permutation; starts at the permutation offset.
+    uint64_t position_;
     uint64_t count_{};
   };
 
-  uint64_t permutation(const TableBuildEntry& entry);
+  /**
+   * Advances an entry to the next slot of its permutation. This steps through
+   * (offset + skip * next) % table_size_ for successive values of next without a division per
+   * step, which dominates the cost of filling large tables otherwise.
+   */
+  void nextPosition(TableBuildEntry& entry) const {
+    entry.position_ += entry.skip_;
+    if (entry.position_ >= table_size_) {
+      entry.position_ -= table_size_;
+    }
+  }
 
   /**
    * Template method for constructing the Maglev table.
    */
   void constructMaglevTableInternal(const NormalizedHostWeightVector& normalized_host_weights,
-                                    double max_normalized_weight, bool use_hostname_for_hashing);
+                                    double max_normalized_weight, bool use_hostname_for_hashing,
+                                    MaglevPermutationCache* permutation_cache);
 
   const uint64_t table_size_;
   MaglevLoadBalancerStats& stats_;
 
 private:
+  /**
+   * Builds the entries for all hosts, ordered by hash key, reusing the permutation cache if there
+   * is one.
+   */
+  std::vector<TableBuildEntry>
+  tableBuildEntries(const NormalizedHostWeightVector& normalized_host_weights,
+                    bool use_hostname_for_hashing, MaglevPermutationCache* permutation_cache) const;
+
   /**
    * Implementation specific construction of data structures to represent the
    * Maglev Table.
@@ -127,10 +215,11 @@ class OriginalMaglevTable : public MaglevTable {
 public:
   OriginalMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                       double max_normalized_weight, uint64_t table_size,
-                      bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats)
+                      bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats,
+                      MaglevPermutationCache* permutation_cache = nullptr)
       : MaglevTable(table_size, stats) {
     constructMaglevTableInternal(normalized_host_weights, max_normalized_weight,
-                                 use_hostname_for_hashing);
+                                 use_hostname_for_hashing, permutation_cache);
   }
   ~OriginalMaglevTable() override = default;
 
@@ -155,7 +244,8 @@ class CompactMaglevTable : public MaglevTable {
 public:
   CompactMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                      double max_normalized_weight, uint64_t table_size,
-                     bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats);
+                     bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats,
+                     MaglevPermutationCache* permutation_cache = nullptr);
   ~CompactMaglevTable() override = default;
 
   // ThreadAwareLoadBalancerBase::HashingLoadBalancer
@@ -194,11 +284,13 @@ public:
 private:
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
                      double /* min_normalized_weight */, double max_normalized_weight) override;
   static MaglevLoadBalancerStats generateStats(Stats::Scope& scope);
 
   Stats::ScopeSharedPtr scope_;
+  // Indexed by priority. Only used on the main thread, where tables are built.
+  std::vector<std::unique_ptr<MaglevPermutationCache>> permutation_caches_;
   MaglevLoadBalancerStats stats_;
   const uint64_t table_size_;
   const bool use_hostname_for_hashing_;
@@ -0,0 +1,174 @@
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+// An average response time below a microsecond is taken to mean that no response has been observed
+// for many decay times rather than that the host is that fast.
+constexpr double DecayedResponseTime = 1e-3;
+// The cost of a host whose average has decayed while it has active requests, far above any real
+// cost. The requests may be hanging, and a host which responds to nothing must not become the
+// cheapest host as its average decays.
+constexpr double StalledHostCost = 1e9;
+
+} // namespace
+
+PeakEwmaLbConfig::PeakEwmaLbConfig(const PeakEwmaLbProto& lb_proto)
+    : choice_count_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(lb_proto, choice_count, 2)),
+      // The decay time is validated to be positive, but may be shorter than a millisecond.
+      decay_time_(std::max<uint64_t>(PROTOBUF_GET_MS_OR_DEFAULT(lb_proto, decay_time, 10000), 1)),
+      default_response_time_(PROTOBUF_GET_MS_OR_DEFAULT(lb_proto, default_response_time, 30)),
+      locality_lb_config_(LoadBalancerConfigHelper::localityLbConfigFromProto(lb_proto)) {}
+
+void PeakEwmaHostLbPolicyData::onResponseTime(std::chrono::microseconds response_time) {
+  observe(std::chrono::duration<double, std::milli>(response_time).count(),
+          time_source_.monotonicTime());
+}
+
+void PeakEwmaHostLbPolicyData::observe(double response_time, MonotonicTime now) {
+  const int64_t now_ns = toNanos(now);
+  const int64_t last_ns = last_observation_ns_.exchange(now_ns);
+  const double decay = last_ns == NoObservation ? 0.0 : decayFactor(now_ns - last_ns);
+
+  double ewma = ewma_.load();
+  double next;
+  do {
+    // A slower response replaces the average, so that a host which slows down is avoided at once,
+    // while a faster one is only gradually trusted.
+    next = response_time > ewma ? response_time : ewma * decay + response_time * (1.0 - decay);
+  } while (!ewma_.compare_exchange_weak(ewma, next));
+}
+
+absl::optional<double> PeakEwmaHostLbPolicyData::responseTime(MonotonicTime now) const {
+  const int64_t last_ns = last_observation_ns_.load();
+  if (last_ns == NoObservation) {
+    return absl::nullopt;
+  }
+  return ewma_.load() * decayFactor(toNanos(now) - last_ns);
+}
+
+double PeakEwmaHostLbPolicyData::decayFactor(int64_t elapsed_ns) const {
+  // Another worker may have observed a response after `now` was taken.
+  if (elapsed_ns <= 0) {
+    return 1.0;
+  }
+  return std::exp(-static_cast<double>(elapsed_ns) / decay_time_ns_);
+}
+
+PeakEwmaLoadBalancer::WorkerLocalLb::WorkerLocalLb(
+    const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterLbStats& stats,
+    Runtime::Loader& runtime, Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
+    const PeakEwmaLbConfig& lb_config, TimeSource& time_source)
+    : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
+                          healthy_panic_threshold, lb_config.locality_lb_config_,
+                          /*slow_start_config=*/absl::nullopt, time_source),
+      choice_count_(lb_config.choice_count_),
+      default_response_time_(static_cast<double>(lb_config.default_response_time_.count())) {
+  initialize();
+}
+
+double PeakEwmaLoadBalancer::WorkerLocalLb::hostCost(const Host& host, MonotonicTime now) const {
+  absl::optional<double> response_time;
+  const auto lb_policy_data = host.typedLbPolicyData<PeakEwmaHostLbPolicyData>();
+  if (lb_policy_data.has_value()) {
+    response_time = lb_policy_data->responseTime(now);
+  }
+  const double active_requests = static_cast<double>(host.statsForReading().rq_active_.value());
+  if (response_time.has_value() && *response_time < DecayedResponseTime && active_requests > 0) {
+    // The number of active requests still orders stalled hosts among themselves.
+    return StalledHostCost + active_requests;
+  }
+  return response_time.value_or(default_response_time_) * (active_requests + 1);
+}
+
+double PeakEwmaLoadBalancer::WorkerLocalLb::hostWeight(const Host& host) const {
+  // `weight = load_balancing_weight / (1 + cost)`. Adding 1 avoids a division by 0 for an idle
+  // host whose average has decayed to 0, and makes costs below a millisecond count little.
+  return static_cast<double>(host.weight()) / (1 + hostCost(host, time_source_.monotonicTime()));
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::WorkerLocalLb::unweightedHostPeek(const HostVector&,
+                                                                           const HostsSource&) {
+  // As with the least request load balancer, the costs may change between preconnect and
+  // host-pick, so deterministic preconnecting is not possible.
+  return nullptr;
+}
+
+HostConstSharedPtr
+PeakEwmaLoadBalancer::WorkerLocalLb::unweightedHostPick(const HostVector& hosts_to_use,
+                                                        const HostsSource&) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  HostSharedPtr candidate_host = nullptr;
+  double candidate_cost = 0;
+
+  for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
+    const int rand_idx = random_.random() % hosts_to_use.size();
+    const HostSharedPtr& sampled_host = hosts_to_use[rand_idx];
+    const double sampled_cost = hostCost(*sampled_host, now);
+
+    if (candidate_host == nullptr || sampled_cost < candidate_cost) {
+      candidate_host = sampled_host;
+      candidate_cost = sampled_cost;
+    }
+  }
+
+  return candidate_host;
+}
+
+Upstream::LoadBalancerPtr
+PeakEwmaLoadBalancer::WorkerLocalLbFactory::create(Upstream::LoadBalancerParams params) {
+  return std::make_unique<WorkerLocalLb>(
+      params.priority_set, params.local_priority_set, cluster_info_.lbStats(), runtime_, random_,
+      PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(cluster_info_.lbConfig(),
+                                                     healthy_panic_threshold, 100, 50),
+      lb_config_, time_source_);
+}
+
+PeakEwmaLoadBalancer::PeakEwmaLoadBalancer(OptRef<const Upstream::LoadBalancerConfig> lb_config,
+                                           const Upstream::ClusterInfo& cluster_info,
+                                           const Upstream::PrioritySet& priority_set,
+                                           Runtime::Loader& runtime,
+                                           Envoy::Random::RandomGenerator& random,
+                                           TimeSource& time_source)
+    : priority_set_(priority_set), time_source_(time_source) {
+  const auto* typed_lb_config = dynamic_cast<const PeakEwmaLbConfig*>(lb_config.ptr());
+  ASSERT(typed_lb_config != nullptr);
+  decay_time_ = typed_lb_config->decay_time_;
+  factory_ = std::make_shared<WorkerLocalLbFactory>(*typed_lb_config, cluster_info, runtime, random,
+                                                    time_source);
+}
+
+absl::Status PeakEwmaLoadBalancer::initialize() {
+  // Ensure that all hosts have peak EWMA lb policy data.
+  for (const HostSetPtr& host_set : priority_set_.hostSetsPerPriority()) {
+    addLbPolicyDataToHosts(host_set->hosts());
+  }
+
+  // Setup a callback to receive priority set updates.
+  priority_update_cb_ = priority_set_.addPriorityUpdateCb(
+      [this](uint32_t, const HostVector& hosts_added, const HostVector&) -> absl::Status {
+        addLbPolicyDataToHosts(hosts_added);
+        return absl::OkStatus();
+      });
+
+  return absl::OkStatus();
+}
+
+void PeakEwmaLoadBalancer::addLbPolicyDataToHosts(const HostVector& hosts) {
+  for (const auto& host_ptr : hosts) {
+    if (!host_ptr->lbPolicyData().has_value()) {
+      host_ptr->setLbPolicyData(
+          std::make_unique<PeakEwmaHostLbPolicyData>(decay_time_, time_source_));
+    }
+  }
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/load_balancing_policies/peak_ewma/v3/peak_ewma.pb.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/extensions/load_balancing_policies/common/load_balancer_impl.h"
+
+namespace Envoy {
+namespace Upstream {
+
+using PeakEwmaLbProto = envoy::extensions::load_balancing_policies::peak_ewma::v3::PeakEwma;
+
+/**
+ * Load balancer config used to wrap the config proto.
+ */
+class PeakEwmaLbConfig : public Upstream::LoadBalancerConfig {
+public:
+  PeakEwmaLbConfig(const PeakEwmaLbProto& lb_proto);
+
+  const uint32_t choice_count_;
+  const std::chrono::milliseconds decay_time_;
+  const std::chrono::milliseconds default_response_time_;
+  const absl::optional<envoy::extensions::load_balancing_policies::common::v3::LocalityLbConfig>
+      locality_lb_config_;
+};
+
+/**
+ * The peak EWMA of the response times of a host. It follows a slower response immediately and
+ * decays exponentially towards faster responses, and towards zero while no response is observed.
+ *
+ * Responses are observed by the routers of all workers concurrently, so the average is kept in
+ * atomics and updated without locking. Two observations racing can at worst make one of them decay
+ * the average over a slightly shorter interval.
+ */
+class PeakEwmaHostLbPolicyData : public HostLbPolicyData {
+public:
+  PeakEwmaHostLbPolicyData(std::chrono::milliseconds decay_time, TimeSource& time_source)
+      : decay_time_ns_(std::chrono::duration<double, std::nano>(decay_time).count()),
+        time_source_(time_source) {}
+
+  // Upstream::HostLbPolicyData
+  void onResponseTime(std::chrono::microseconds response_time) override;
+
+  /**
+   * Records a response time.
+   * @param response_time supplies the response time in milliseconds.
+   * @param now supplies the time of the response.
+   */
+  void observe(double response_time, MonotonicTime now);
+
+  /**
+   * @return the average response time in milliseconds decayed to now, or nullopt if no response
+   * has been observed yet.
+   */
+  absl::optional<double> responseTime(MonotonicTime now) const;
+
+private:
+  static int64_t toNanos(MonotonicTime time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+  }
+
+  // The weight left to an average after elapsed_ns.
+  double decayFactor(int64_t elapsed_ns) const;
+
+  const double decay_time_ns_;
+  TimeSource& time_source_;
+  // In milliseconds, as of the last observation.
+  std::atomic<double> ewma_{0.0};
+  std::atomic<int64_t> last_observation_ns_{NoObservation};
+
+  static constexpr int64_t NoObservation = std::numeric_limits<int64_t>::min();
+};
+
+/**
+ * Peak EWMA load balancer.
+ *
+ * The cost of a host is the peak EWMA of its response times multiplied by its number of active
+ * requests plus one, so that a host is penalized both for being slow and for being busy. Requests
+ * which time out or are reset count as responses taking as long as they waited, and a host whose
+ * average has decayed to nothing while it has active requests, e.g. because they hang, is given
+ * a cost higher than that of any responsive host. With equal
+ * host weights, N healthy hosts (where N is specified in the LB configuration) are picked at random
+ * and the one with the lowest cost is chosen (P2C, as in the least request load balancer). When
+ * hosts have different weights, an RR EDF schedule is used in which the weight of a host is scaled
+ * by its cost at pick/insert time.
+ *
+ * The averages are shared by the workers through the lb policy data of the hosts, which is attached
+ * on the main thread, so each worker sees the responses observed by all of them.
+ */
+class PeakEwmaLoadBalancer : public Upstream::ThreadAwareLoadBalancer {
+public:
+  // This class is used to handle the load balancing on the worker thread.
+  class WorkerLocalLb : public EdfLoadBalancerBase {
+  public:
+    WorkerLocalLb(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
+                  ClusterLbStats& stats, Runtime::Loader& runtime, Random::RandomGenerator& random,
+                  uint32_t healthy_panic_threshold, const PeakEwmaLbConfig& lb_config,
+                  TimeSource& time_source);
+
+  private:
+    void refreshHostSource(const HostsSource&) override {}
+    double hostWeight(const Host& host) const override;
+    HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
+                                          const HostsSource& source) override;
+    HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
+                                          const HostsSource& source) override;
+
+    // The cost of a host in milliseconds: its average response time scaled by its load. A host
+    // whose average has decayed to nothing while it has active requests costs more than any other.
+    double hostCost(const Host& host, MonotonicTime now) const;
+
+    const uint32_t choice_count_;
+    const double default_response_time_;
+  };
+
+  // Factory used to create worker-local load balancer on the worker thread.
+  class WorkerLocalLbFactory : public Upstream::LoadBalancerFactory {
+  public:
+    WorkerLocalLbFactory(const PeakEwmaLbConfig& lb_config,
+                         const Upstream::ClusterInfo& cluster_info, Runtime::Loader& runtime,
+                         Envoy::Random::RandomGenerator& random, TimeSource& time_source)
+        : lb_config_(lb_config), cluster_info_(cluster_info), runtime_(runtime), random_(random),
+          time_source_(time_source) {}
+
+    Upstream::LoadBalancerPtr create(Upstream::LoadBalancerParams params) override;
+
+    bool recreateOnHostChange() const override { return false; }
+
+  private:
+    const PeakEwmaLbConfig& lb_config_;
+    const Upstream::ClusterInfo& cluster_info_;
+    Runtime::Loader& runtime_;
+    Envoy::Random::RandomGenerator& random_;
+    TimeSource& time_source_;
+  };
+
+  PeakEwmaLoadBalancer(OptRef<const Upstream::LoadBalancerConfig> lb_config,
+                       const Upstream::ClusterInfo& cluster_info,
+                       const Upstream::PrioritySet& priority_set, Runtime::Loader& runtime,
+                       Envoy::Random::RandomGenerator& random, TimeSource& time_source);
+
+  // Upstream::ThreadAwareLoadBalancer
+  Upstream::LoadBalancerFactorySharedPtr factory() override { return factory_; }
+  absl::Status initialize() override;
+
+private:
+  // Add peak EWMA host LB policy data to all `hosts`.
+  void addLbPolicyDataToHosts(const HostVector& hosts);
+
+  const Upstream::PrioritySet& priority_set_;
+  TimeSource& time_source_;
+  std::chrono::milliseconds decay_time_;
+  std::shared_ptr<WorkerLocalLbFactory> factory_;
+  // Callback for `priority_set_` updates.
+  Common::CallbackHandlePtr priority_update_cb_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,21 @@
+#include "source/extensions/udp_packet_writer/mmsg/config.h"
+
+#include "source/common/protobuf/message_validator_impl.h"
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Network {
+
+UdpPacketWriterFactoryPtr UdpMmsgBatchWriterFactoryFactory::createUdpPacketWriterFactory(
+    const envoy::config::core::v3::TypedExtensionConfig& config) {
+  const auto proto_config = MessageUtil::anyConvertAndValidate<
+      envoy::extensions::udp_packet_writer::v3::UdpMmsgBatchWriterFactory>(
+      config.typed_config(), ProtobufMessage::getStrictValidationVisitor());
+  return std::make_unique<UdpMmsgBatchWriterFactory>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      proto_config, max_batch_size, UdpMmsgBatchWriter::DefaultBatchSize));
+}
+
+REGISTER_FACTORY(UdpMmsgBatchWriterFactoryFactory, UdpPacketWriterFactoryFactory);
+
+} // namespace Network
+} // namespace Envoy
@@ -61,7 +61,10 @@ ValidationInstance::ValidationInstance(
                                    random_generator_, bootstrap_, process_context)),
       dispatcher_(api_->allocateDispatcher("main_thread")),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+                          store, options.fileFlushBufferLimitBytes(),
+                          options.fileFlushOverflowAction() == FileFlushOverflowAction::Drop
+                              ? AccessLog::FileOverflowAction::Drop
+                              : AccessLog::FileOverflowAction::Block),
       grpc_context_(stats_store_.symbolTable()), http_context_(stats_store_.symbolTable()),
       router_context_(stats_store_.symbolTable()), time_system_(time_system),
       server_contexts_(*this), quic_stat_names_(stats_store_.symbolTable()) {
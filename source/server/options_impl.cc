@@ -138,6 +138,14 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   TCLAP::ValueArg<uint32_t> file_flush_interval_msec("", "file-flush-interval-msec",
                                                      "Interval for log flushing in msec", false,
                                                      10000, "uint32_t", cmd);
+  TCLAP::ValueArg<uint64_t> file_flush_buffer_limit_bytes(
+      "", "file-flush-buffer-limit-bytes",
+      "Maximum bytes buffered for each log file before they are flushed, 0 for no limit", false, 0,
+      "uint64_t", cmd);
+  TCLAP::ValueArg<std::string> file_flush_overflow_action(
+      "", "file-flush-overflow-action",
+      "Log writes when the buffer limit is reached, one of 'block' (default) or 'drop'.", false,
+      "block", "string", cmd);
   TCLAP::ValueArg<uint32_t> drain_time_s("", "drain-time-s",
                                          "Hot restart and LDS removal drain time in seconds", false,
                                          600, "uint32_t", cmd);
@@ -290,6 +298,7 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   service_node_ = service_node.getValue();
   service_zone_ = service_zone.getValue();
   file_flush_interval_msec_ = std::chrono::milliseconds(file_flush_interval_msec.getValue());
+  file_flush_buffer_limit_bytes_ = file_flush_buffer_limit_bytes.getValue();
   drain_time_ = std::chrono::seconds(drain_time_s.getValue());
   parent_shutdown_time_ = std::chrono::seconds(parent_shutdown_time_s.getValue());
   socket_path_ = socket_path.getValue();
@@ -314,6 +323,15 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
         fmt::format("error: unknown drain-strategy '{}'", mode.getValue()));
   }
 
+  if (file_flush_overflow_action.getValue() == "block") {
+    file_flush_overflow_action_ = Server::FileFlushOverflowAction::Block;
+  } else if (file_flush_overflow_action.getValue() == "drop") {
+    file_flush_overflow_action_ = Server::FileFlushOverflowAction::Drop;
+  } else {
+    throw MalformedArgvException(fmt::format("error: unknown file-flush-overflow-action '{}'",
+                                             file_flush_overflow_action.getValue()));
+  }
+
   if (hot_restart_version_option.getValue()) {
     std::cerr << hot_restart_version_cb(!hot_restart_disabled_);
     throw NoServingException("NoServingException");
@@ -431,6 +449,11 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   }
   command_line_options->mutable_file_flush_interval()->MergeFrom(
       Protobuf::util::TimeUtil::MillisecondsToDuration(fileFlushIntervalMsec().count()));
+  command_line_options->set_file_flush_buffer_limit_bytes(fileFlushBufferLimitBytes());
+  command_line_options->set_file_flush_overflow_action(
+      fileFlushOverflowAction() == Server::FileFlushOverflowAction::Drop
+          ? envoy::admin::v3::CommandLineOptions::Drop
+          : envoy::admin::v3::CommandLineOptions::Block);
 
   command_line_options->mutable_drain_time()->MergeFrom(
       Protobuf::util::TimeUtil::SecondsToDuration(drainTime().count()));
@@ -67,6 +67,12 @@ public:
   void setFileFlushIntervalMsec(std::chrono::milliseconds file_flush_interval_msec) {
     file_flush_interval_msec_ = file_flush_interval_msec;
   }
+  void setFileFlushBufferLimitBytes(uint64_t file_flush_buffer_limit_bytes) {
+    file_flush_buffer_limit_bytes_ = file_flush_buffer_limit_bytes;
+  }
+  void setFileFlushOverflowAction(Server::FileFlushOverflowAction file_flush_overflow_action) {
+    file_flush_overflow_action_ = file_flush_overflow_action;
+  }
   void setServiceClusterName(const std::string& service_cluster) {
     service_cluster_ = service_cluster;
   }
@@ -137,6 +143,10 @@ public:
   std::chrono::milliseconds fileFlushIntervalMsec() const override {
     return file_flush_interval_msec_;
   }
+  uint64_t fileFlushBufferLimitBytes() const override { return file_flush_buffer_limit_bytes_; }
+  Server::FileFlushOverflowAction fileFlushOverflowAction() const override {
+    return file_flush_overflow_action_;
+  }
   const std::string& serviceClusterName() const override { return service_cluster_; }
   const std::string& serviceNodeName() const override { return service_node_; }
   const std::string& serviceZone() const override { return service_zone_; }
@@ -201,6 +211,9 @@ private:
   std::string service_node_;
   std::string service_zone_;
   std::chrono::milliseconds file_flush_interval_msec_{10000};
+  uint64_t file_flush_buffer_limit_bytes_{0};
+  Server::FileFlushOverflowAction file_flush_overflow_action_{
+      Server::FileFlushOverflowAction::Block};
   std::chrono::seconds drain_time_{600};
   std::chrono::seconds parent_shutdown_time_{900};
   Server::DrainStrategy drain_strategy_{Server::DrainStrategy::Gradual};
@@ -26,6 +26,7 @@
 
 #include "source/common/api/api_impl.h"
 #include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/mutex_tracer_impl.h"
 #include "source/common/common/utility.h"
@@ -96,7 +97,10 @@ InstanceBase::InstanceBase(Init::Manager& init_manager, const Options& options,
           watermark_factory)),
       dispatcher_(api_->allocateDispatcher("main_thread")),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+                          store, options.fileFlushBufferLimitBytes(),
+                          options.fileFlushOverflowAction() == FileFlushOverflowAction::Drop
+                              ? AccessLog::FileOverflowAction::Drop
+                              : AccessLog::FileOverflowAction::Block),
       handler_(getHandler(*dispatcher_)), worker_factory_(thread_local_, *api_, hooks),
       mutex_tracer_(options.mutexTracingEnabled() ? &Envoy::MutexTracerImpl::getOrCreateTracer()
                                                   : nullptr),
@@ -539,6 +543,16 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
   memory_allocator_manager_ = std::make_unique<Memory::AllocatorManager>(
       *api_, *stats_store_.rootScope(), bootstrap_.memory_allocator_manager());
 
+  // Dispatchers build their buffer slice pools from the bootstrap when they first run.
+  const auto& slice_pool_proto = bootstrap_.buffer_slice_pool();
+  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(slice_pool_proto, low_watermark,
+                                      Buffer::SlicePoolConfig::DefaultLowWatermark) >
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(slice_pool_proto, high_watermark,
+                                      Buffer::SlicePoolConfig::DefaultHighWatermark)) {
+    return absl::InvalidArgumentError(
+        "buffer slice pool low watermark is greater than its high watermark");
+  }
+
   initialization_timer_ = std::make_unique<Stats::HistogramCompletableTimespanImpl>(
       server_stats_->initialization_time_ms_, timeSource());
   server_stats_->concurrency_.set(options_.concurrency());
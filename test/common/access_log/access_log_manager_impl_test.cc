@@ -8,9 +8,12 @@
 #include "test/mocks/api/mocks.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/filesystem/mocks.h"
+#include "test/mocks/thread/mocks.h"
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -121,11 +124,15 @@ TEST_F(AccessLogManagerImplTest, FlushToLogFilePeriodically) {
 
   log_file->write("test");
 
+  // make sure timer is re-enabled on callback call
+  EXPECT_CALL(*timer, enableTimer(timeout_40ms_, _));
+  timer->invokeCallback();
+
   EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 1));
 
   EXPECT_TRUE(waitForCounterEq("filesystem.write_completed", 1));
   EXPECT_EQ(1UL, store_.counter("filesystem.write_buffered").value());
-  EXPECT_EQ(0UL, store_.counter("filesystem.flushed_by_timer").value());
+  EXPECT_EQ(1UL, store_.counter("filesystem.flushed_by_timer").value());
   EXPECT_TRUE(waitForGaugeEq("filesystem.write_total_buffered", 0));
 
   EXPECT_CALL(*file_, write_(_))
@@ -141,7 +148,6 @@ TEST_F(AccessLogManagerImplTest, FlushToLogFilePeriodically) {
   log_file->write("test2");
   EXPECT_EQ(2UL, store_.counter("filesystem.write_buffered").value());
 
-  // make sure timer is re-enabled on callback call
   EXPECT_CALL(*timer, enableTimer(timeout_40ms_, _));
   timer->invokeCallback();
 
@@ -149,7 +155,7 @@ TEST_F(AccessLogManagerImplTest, FlushToLogFilePeriodically) {
 
   EXPECT_TRUE(waitForCounterEq("filesystem.write_completed", 2));
   EXPECT_EQ(0UL, store_.counter("filesystem.write_failed").value());
-  EXPECT_EQ(1UL, store_.counter("filesystem.flushed_by_timer").value());
+  EXPECT_EQ(2UL, store_.counter("filesystem.flushed_by_timer").value());
   EXPECT_EQ(2UL, store_.counter("filesystem.write_buffered").value());
   EXPECT_TRUE(waitForGaugeEq("filesystem.write_total_buffered", 0));
 
@@ -167,17 +173,7 @@ TEST_F(AccessLogManagerImplTest, FlushToLogFileOnDemand) {
           .value();
 
   EXPECT_EQ(0UL, store_.counter("filesystem.flushed_by_timer").value());
-
-  // The first write to a given file will start the flush thread. Because AccessManagerImpl::write
-  // holds the write_lock_ when the thread is started, the thread will flush on its first loop, once
-  // it obtains the write_lock_. Perform a write to get all that out of the way.
-  EXPECT_CALL(*file_, write_(_))
-      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
-        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
-      }));
-  log_file->write("prime-it");
-  uint32_t expected_writes = 1;
-  EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, expected_writes));
+  uint32_t expected_writes = 0;
 
   EXPECT_CALL(*file_, write_(_))
       .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
@@ -196,7 +192,7 @@ TEST_F(AccessLogManagerImplTest, FlushToLogFileOnDemand) {
   expected_writes++;
   EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, expected_writes));
 
-  EXPECT_TRUE(waitForCounterEq("filesystem.write_completed", 2));
+  EXPECT_TRUE(waitForCounterEq("filesystem.write_completed", 1));
   EXPECT_EQ(0UL, store_.counter("filesystem.flushed_by_timer").value());
 
   EXPECT_CALL(*file_, write_(_))
@@ -234,6 +230,8 @@ TEST_F(AccessLogManagerImplTest, FlushCountsIOErrors) {
       }));
 
   log_file->write("test");
+  EXPECT_CALL(*timer, enableTimer(timeout_40ms_, _));
+  timer->invokeCallback();
 
   EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 1));
   EXPECT_TRUE(waitForCounterEq("filesystem.write_failed", 1));
@@ -418,29 +416,56 @@ TEST_F(AccessLogManagerImplTest, BigDataChunkShouldBeFlushedWithoutTimer) {
           .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
           .value();
 
+  // A big string should be flushed even when timer is not enabled.
   EXPECT_CALL(*file_, write_(_))
       .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
-        EXPECT_EQ(0, data.compare("a"));
+        std::string expected(1024 * 64 + 1, 'b');
+        EXPECT_EQ(0, data.compare(expected));
         return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
       }));
 
-  log_file->write("a");
+  std::string big_string(1024 * 64 + 1, 'b');
+  log_file->write(big_string);
   EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 1));
 
-  // First write happens without waiting on thread_flush_. Now make a big string and it should be
-  // flushed even when timer is not enabled
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+// A flush which ends with more than MIN_FLUSH_SIZE buffered requests another flush. If the file is
+// being destroyed, that request must not outlive it.
+TEST_F(AccessLogManagerImplTest, DestroyedWhileFlushing) {
+  // The file is only destroyed with its manager, so this test uses its own.
+  auto access_log_manager =
+      std::make_unique<AccessLogManagerImpl>(timeout_40ms_, api_, dispatcher_, lock_, store_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file =
+      access_log_manager
+          ->createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+          .value();
+
+  absl::Notification flushing;
+  absl::Notification destroying;
   EXPECT_CALL(*file_, write_(_))
-      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
-        std::string expected(1024 * 64 + 1, 'b');
-        EXPECT_EQ(0, data.compare(expected));
+      .WillOnce(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        flushing.Notify();
+        destroying.WaitForNotification();
+        // Gives the destructor time to start waiting for this flush.
+        absl::SleepFor(absl::Milliseconds(10));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }))
+      .WillRepeatedly(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
         return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
       }));
 
   std::string big_string(1024 * 64 + 1, 'b');
   log_file->write(big_string);
-  EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 2));
+  flushing.WaitForNotification();
+  log_file->write(big_string);
 
   EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  destroying.Notify();
+  log_file.reset();
+  access_log_manager.reset();
 }
 
 TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
@@ -527,6 +552,149 @@ TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
       .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+// All the files of a manager are flushed by a single thread.
+TEST_F(AccessLogManagerImplTest, FilesShareFlushThread) {
+  Thread::MockThreadFactory mock_thread_factory;
+  EXPECT_CALL(api_, threadFactory()).WillRepeatedly(ReturnRef(mock_thread_factory));
+  EXPECT_CALL(mock_thread_factory, createThread(_, _))
+      .WillOnce(Invoke([this](std::function<void()> thread_routine,
+                              Thread::OptionsOptConstRef options) -> Thread::ThreadPtr {
+        return thread_factory_.createThread(thread_routine, options);
+      }));
+
+  // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
+  NiceMock<Event::MockTimer>* timer2 = new NiceMock<Event::MockTimer>(&dispatcher_);
+  // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
+  NiceMock<Event::MockTimer>* timer1 = new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log1 =
+      access_log_manager_
+          .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+          .value();
+
+  NiceMock<Filesystem::MockFile>* file2 = new NiceMock<Filesystem::MockFile>;
+  EXPECT_CALL(*file2, path()).WillRepeatedly(Return("bar"));
+  EXPECT_CALL(file_system_,
+              createFile(testing::Matcher<const Envoy::Filesystem::FilePathAndType&>(
+                  Filesystem::FilePathAndType{Filesystem::DestinationType::File, "bar"})))
+      .WillOnce(Return(ByMove(std::unique_ptr<NiceMock<Filesystem::MockFile>>(file2))));
+  EXPECT_CALL(*file2, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log2 =
+      access_log_manager_
+          .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "bar"})
+          .value();
+
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ("first", data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  EXPECT_CALL(*file2, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ("second", data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  log1->write("first");
+  log2->write("second");
+  timer1->invokeCallback();
+  timer2->invokeCallback();
+  EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 1));
+  EXPECT_TRUE(file2->waitForEventCount(file2->num_writes_, 1));
+  EXPECT_TRUE(waitForCounterEq("filesystem.write_completed", 2));
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file2, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, DropWhenBufferLimitReached) {
+  // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  AccessLogManagerImpl access_log_manager(timeout_40ms_, api_, dispatcher_, lock_, store_, 10,
+                                          FileOverflowAction::Drop);
+
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file =
+      access_log_manager
+          .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+          .value();
+
+  Sequence sq;
+  EXPECT_CALL(*file_, write_(_))
+      .InSequence(sq)
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ("0123456789", data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  EXPECT_CALL(*file_, write_(_))
+      .InSequence(sq)
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ("after", data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  log_file->write("01234");
+  log_file->write("56789");
+  log_file->write("dropped");
+  EXPECT_EQ(2UL, store_.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_dropped").value());
+
+  timer->invokeCallback();
+  EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 1));
+  EXPECT_TRUE(waitForGaugeEq("filesystem.write_total_buffered", 0));
+
+  // There is room again once the buffer has been written.
+  log_file->write("after");
+  log_file->flush();
+  EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 2));
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_blocked").value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, BlockWhenBufferLimitReached) {
+  AccessLogManagerImpl access_log_manager(timeout_40ms_, api_, dispatcher_, lock_, store_, 10,
+                                          FileOverflowAction::Block);
+
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file =
+      access_log_manager
+          .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+          .value();
+
+  Sequence sq;
+  EXPECT_CALL(*file_, write_(_))
+      .InSequence(sq)
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ("0123456789", data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  EXPECT_CALL(*file_, write_(_))
+      .InSequence(sq)
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ("blocked", data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  log_file->write("0123456789");
+
+  // The write waits for the flush thread to write out the buffer, which it asks for.
+  Thread::ThreadPtr writer =
+      thread_factory_.createThread([&log_file]() -> void { log_file->write("blocked"); });
+  writer->join();
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_blocked").value());
+  EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 1));
+
+  log_file->flush();
+  EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 2));
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(2UL, store_.counter("filesystem.write_buffered").value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 } // namespace
 } // namespace AccessLog
 } // namespace Envoy
@@ -145,6 +145,10 @@ public:
 
   Buffer::RawSlice frontSlice() const override { return {const_cast<char*>(start()), size_}; }
 
+  absl::optional<std::pair<uint64_t, Buffer::FileRange>> findFileSlice(uint64_t) const override {
+    return absl::nullopt;
+  }
+
   uint64_t length() const override { return size_; }
 
   void* linearize(uint32_t /*size*/) override {
@@ -2,6 +2,7 @@
 #include "envoy/http/stream_reset_handler.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/buffer/watermark_buffer.h"
 #include "source/common/common/assert.h"
 
@@ -558,4 +559,56 @@ BENCHMARK(bufferAddVsAddFragments)
     ->Args({1, 1, 64, 5})
     ->Args({1, 1, 4096, 5});
 
+// Test filling a buffer with slices of a given size and draining it again, as is done when proxying
+// a body, with and without a slice pool installed on the thread.
+// Args: use_pool, slice_size.
+static void bufferSlicePoolFillDrain(benchmark::State& state) {
+  const bool use_pool = state.range(0) != 0;
+  const uint64_t slice_size = state.range(1);
+  Buffer::SlicePoolConfig config;
+  config.size_classes_ = {4096, 16384, 65536};
+  Buffer::SlicePool pool(config);
+  Buffer::SlicePool::ScopedCurrent scoped_pool(use_pool ? &pool : nullptr);
+
+  const std::string data(slice_size, 'a');
+  Buffer::OwnedImpl buffer;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (uint64_t length = 0; length < MaxBufferLength; length += slice_size) {
+      Buffer::OwnedImpl slice_buffer;
+      slice_buffer.appendSliceForTest(data);
+      buffer.move(slice_buffer);
+    }
+    buffer.drain(buffer.length());
+  }
+  benchmark::DoNotOptimize(buffer.length());
+}
+BENCHMARK(bufferSlicePoolFillDrain)
+    ->Args({0, 4096})
+    ->Args({1, 4096})
+    ->Args({0, 16384})
+    ->Args({1, 16384})
+    ->Args({0, 65536})
+    ->Args({1, 65536});
+
+// Test reserve+commit of full reads followed by a drain, with and without a slice pool installed on
+// the thread. Args: use_pool.
+static void bufferSlicePoolReserveDrain(benchmark::State& state) {
+  const bool use_pool = state.range(0) != 0;
+  Buffer::SlicePoolConfig config;
+  config.size_classes_ = {16384};
+  Buffer::SlicePool pool(config);
+  Buffer::SlicePool::ScopedCurrent scoped_pool(use_pool ? &pool : nullptr);
+
+  Buffer::OwnedImpl buffer;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Buffer::Reservation reservation = buffer.reserveForRead();
+    reservation.commit(reservation.length());
+    buffer.drain(buffer.length());
+  }
+  benchmark::DoNotOptimize(buffer.length());
+}
+BENCHMARK(bufferSlicePoolReserveDrain)->Arg(0)->Arg(1);
+
 } // namespace Envoy
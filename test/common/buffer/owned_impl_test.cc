@@ -170,6 +170,55 @@ TEST_F(OwnedImplTest, AddBufferFragmentDynamicAllocation) {
   EXPECT_TRUE(release_callback_called_);
 }
 
+// A fragment whose data is a mapping of a range of a file.
+class FileRangeFragment : public BufferFragmentImpl {
+public:
+  FileRangeFragment(const void* data, size_t size, FileRange range)
+      : BufferFragmentImpl(data, size, nullptr), range_(range) {}
+  absl::optional<FileRange> fileRange() const override { return range_; }
+
+private:
+  const FileRange range_;
+};
+
+TEST_F(OwnedImplTest, FindFileSlice) {
+  char input[] = "hello world";
+  FileRangeFragment frag(input, 11, FileRange{7, 100, 11});
+  Buffer::OwnedImpl buffer("abc");
+  EXPECT_FALSE(buffer.findFileSlice(16).has_value());
+  buffer.addBufferFragment(frag);
+  buffer.add("def");
+
+  auto file_slice = buffer.findFileSlice(16);
+  ASSERT_TRUE(file_slice.has_value());
+  EXPECT_EQ(3, file_slice->first);
+  EXPECT_EQ(7, file_slice->second.fd_);
+  EXPECT_EQ(100, file_slice->second.offset_);
+  EXPECT_EQ(11, file_slice->second.len_);
+  // Only the first slice is searched.
+  EXPECT_FALSE(buffer.findFileSlice(1).has_value());
+
+  // Draining part of the fragment moves the range along the file.
+  buffer.drain(5);
+  file_slice = buffer.findFileSlice(1);
+  ASSERT_TRUE(file_slice.has_value());
+  EXPECT_EQ(0, file_slice->first);
+  EXPECT_EQ(102, file_slice->second.offset_);
+  EXPECT_EQ(9, file_slice->second.len_);
+
+  // Moving the slice to another buffer keeps the range.
+  Buffer::OwnedImpl other("xy");
+  other.move(buffer);
+  file_slice = other.findFileSlice(16);
+  ASSERT_TRUE(file_slice.has_value());
+  EXPECT_EQ(2, file_slice->first);
+  EXPECT_EQ(102, file_slice->second.offset_);
+
+  other.drain(11);
+  EXPECT_FALSE(other.findFileSlice(16).has_value());
+  EXPECT_EQ("def", other.toString());
+}
+
 TEST_F(OwnedImplTest, AddOwnedBufferFragmentWithCleanup) {
   std::string input(2048, 'a');
   const size_t expected_length = input.size();
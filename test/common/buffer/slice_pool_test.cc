@@ -0,0 +1,146 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/slice_pool.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class SlicePoolTest : public testing::Test {
+protected:
+  SlicePoolConfig config(uint32_t high_watermark, uint32_t low_watermark) {
+    SlicePoolConfig config;
+    config.size_classes_ = {4096, 16384};
+    config.high_watermark_ = high_watermark;
+    config.low_watermark_ = low_watermark;
+    return config;
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counterFromString("pool." + name).value();
+  }
+  uint64_t cachedBytes() {
+    return store_.gaugeFromString("pool.cached_bytes", Stats::Gauge::ImportMode::NeverImport)
+        .value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+};
+
+TEST_F(SlicePoolTest, ReusesReleasedStorage) {
+  SlicePool pool(config(4, 2));
+  pool.initializeStats(*store_.rootScope(), "pool.");
+
+  SlicePool::StoragePtr storage = pool.allocate(16384);
+  uint8_t* raw = storage.get();
+  EXPECT_EQ(1, counter("miss"));
+
+  pool.release(std::move(storage), 16384);
+  EXPECT_EQ(1, pool.cachedBlocks(16384));
+  EXPECT_EQ(0, pool.cachedBlocks(4096));
+  EXPECT_EQ(16384, cachedBytes());
+
+  storage = pool.allocate(16384);
+  EXPECT_EQ(raw, storage.get());
+  EXPECT_EQ(1, counter("hit"));
+  EXPECT_EQ(0, cachedBytes());
+  pool.release(std::move(storage), 16384);
+}
+
+TEST_F(SlicePoolTest, UnpooledCapacitiesAreNotCached) {
+  SlicePool pool(config(4, 2));
+  pool.initializeStats(*store_.rootScope(), "pool.");
+
+  for (const uint64_t capacity : {8192, 4095, 1024 * 1024}) {
+    SlicePool::StoragePtr storage = pool.allocate(capacity);
+    ASSERT_NE(nullptr, storage);
+    pool.release(std::move(storage), capacity);
+    EXPECT_EQ(0, pool.cachedBlocks(capacity));
+  }
+  EXPECT_EQ(0, counter("hit"));
+  EXPECT_EQ(0, counter("miss"));
+  EXPECT_EQ(0, cachedBytes());
+}
+
+TEST_F(SlicePoolTest, TrimsToLowWatermark) {
+  SlicePool pool(config(4, 1));
+  pool.initializeStats(*store_.rootScope(), "pool.");
+
+  std::vector<SlicePool::StoragePtr> blocks;
+  for (int i = 0; i < 5; ++i) {
+    blocks.push_back(pool.allocate(4096));
+  }
+  for (int i = 0; i < 4; ++i) {
+    pool.release(std::move(blocks[i]), 4096);
+  }
+  EXPECT_EQ(4, pool.cachedBlocks(4096));
+  EXPECT_EQ(0, counter("trimmed"));
+
+  // The cache is full, so it is trimmed to the low watermark before the block is cached.
+  pool.release(std::move(blocks[4]), 4096);
+  EXPECT_EQ(2, pool.cachedBlocks(4096));
+  EXPECT_EQ(3, counter("trimmed"));
+  EXPECT_EQ(2 * 4096, cachedBytes());
+}
+
+TEST_F(SlicePoolTest, DestructionReleasesCachedBytes) {
+  {
+    SlicePool pool(config(4, 2));
+    pool.initializeStats(*store_.rootScope(), "pool.");
+    pool.release(pool.allocate(4096), 4096);
+    pool.release(pool.allocate(16384), 16384);
+    EXPECT_EQ(4096 + 16384, cachedBytes());
+  }
+  EXPECT_EQ(0, cachedBytes());
+}
+
+TEST_F(SlicePoolTest, Create) {
+  EXPECT_EQ(nullptr, SlicePool::create(SlicePoolConfig{}));
+  EXPECT_NE(nullptr, SlicePool::create(config(4, 2)));
+}
+
+// Slices created while a pool is installed on the thread allocate from and release to it.
+TEST_F(SlicePoolTest, OwnedImplUsesCurrentPool) {
+  SlicePool pool(config(4, 2));
+  EXPECT_EQ(nullptr, SlicePool::current());
+  {
+    SlicePool::ScopedCurrent scoped(&pool);
+    EXPECT_EQ(&pool, SlicePool::current());
+
+    OwnedImpl buffer;
+    buffer.appendSliceForTest(std::string(4096, 'a'));
+    buffer.appendSliceForTest(std::string(16384, 'b'));
+    const uint8_t* first = static_cast<const uint8_t*>(buffer.frontSlice().mem_);
+    buffer.drain(buffer.length());
+    EXPECT_EQ(1, pool.cachedBlocks(4096));
+    EXPECT_EQ(1, pool.cachedBlocks(16384));
+
+    buffer.appendSliceForTest(std::string(100, 'c'));
+    EXPECT_EQ(first, buffer.frontSlice().mem_);
+    EXPECT_EQ(0, pool.cachedBlocks(4096));
+
+    // Reservations for reads draw their storage from the pool as well.
+    buffer.drain(buffer.length());
+    {
+      Reservation reservation = buffer.reserveForRead();
+      reservation.commit(reservation.length());
+    }
+    buffer.drain(buffer.length());
+    EXPECT_LT(0, pool.cachedBlocks(16384));
+  }
+  EXPECT_EQ(nullptr, SlicePool::current());
+
+  // With no pool installed, storage is freed normally.
+  const uint32_t cached = pool.cachedBlocks(4096);
+  {
+    OwnedImpl buffer;
+    buffer.appendSliceForTest(std::string(4096, 'a'));
+  }
+  EXPECT_EQ(cached, pool.cachedBlocks(4096));
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
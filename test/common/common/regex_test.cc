@@ -140,6 +140,43 @@ TEST(Utility, ParseRegex) {
   }
 }
 
+TEST(CompiledGoogleReSet, Empty) {
+  auto set = CompiledGoogleReSet::create({});
+  ASSERT_TRUE(set.ok());
+  EXPECT_EQ(0, set.value()->size());
+  std::vector<int> matches{1};
+  EXPECT_TRUE(set.value()->match("anything", matches));
+  EXPECT_TRUE(matches.empty());
+}
+
+TEST(CompiledGoogleReSet, ReportsAllFullMatches) {
+  auto set = CompiledGoogleReSet::create(
+      {"/users/[0-9]+", "/users/.*", "/items/[a-z]+", "/users/42", "/users"});
+  ASSERT_TRUE(set.ok());
+  EXPECT_EQ(5, set.value()->size());
+
+  std::vector<int> matches;
+  EXPECT_TRUE(set.value()->match("/users/42", matches));
+  EXPECT_THAT(matches, testing::ElementsAre(0, 1, 3));
+
+  EXPECT_TRUE(set.value()->match("/users/abc", matches));
+  EXPECT_THAT(matches, testing::ElementsAre(1));
+
+  // Patterns are anchored at both ends, like CompiledGoogleReMatcher::match().
+  EXPECT_TRUE(set.value()->match("/users/42/extra", matches));
+  EXPECT_THAT(matches, testing::ElementsAre(1));
+  EXPECT_TRUE(set.value()->match("/prefix/items/abc", matches));
+  EXPECT_TRUE(matches.empty());
+  EXPECT_TRUE(set.value()->match("/items/abc", matches));
+  EXPECT_THAT(matches, testing::ElementsAre(2));
+}
+
+TEST(CompiledGoogleReSet, InvalidPattern) {
+  auto set = CompiledGoogleReSet::create({"/valid", "(+invalid)"});
+  EXPECT_FALSE(set.ok());
+  EXPECT_THAT(set.status().message(), ContainsRegex("unable to add regex '\\(\\+invalid\\)'"));
+}
+
 } // namespace
 } // namespace Regex
 } // namespace Envoy
@@ -1,7 +1,10 @@
 #include "source/common/common/trie_lookup_table.h"
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::ElementsAre;
+
 namespace Envoy {
 
 TEST(TrieLookupTable, AddItems) {
@@ -65,6 +68,33 @@ TEST(TrieLookupTable, LongestPrefix) {
   EXPECT_EQ(nullptr, trie.findLongestPrefix(" "));
 }
 
+TEST(TrieLookupTable, FindMatchingPrefixes) {
+  TrieLookupTable<const char*> trie;
+  const char* cstr_a = "a";
+  const char* cstr_b = "b";
+  const char* cstr_c = "c";
+  const char* cstr_d = "d";
+
+  EXPECT_TRUE(trie.findMatchingPrefixes("foo").empty());
+
+  EXPECT_TRUE(trie.add("/", cstr_a));
+  EXPECT_TRUE(trie.add("/foo", cstr_b));
+  EXPECT_TRUE(trie.add("/foo/bar", cstr_c));
+  EXPECT_TRUE(trie.add("/baz", cstr_d));
+
+  EXPECT_THAT(trie.findMatchingPrefixes("/foo/bar/zzz"), ElementsAre(cstr_a, cstr_b, cstr_c));
+  EXPECT_THAT(trie.findMatchingPrefixes("/foo/ba"), ElementsAre(cstr_a, cstr_b));
+  EXPECT_THAT(trie.findMatchingPrefixes("/fo"), ElementsAre(cstr_a));
+  EXPECT_THAT(trie.findMatchingPrefixes("/bazooka"), ElementsAre(cstr_a, cstr_d));
+  EXPECT_TRUE(trie.findMatchingPrefixes("foo").empty());
+  EXPECT_TRUE(trie.findMatchingPrefixes("").empty());
+
+  // The empty key matches everything.
+  EXPECT_TRUE(trie.add("", cstr_d));
+  EXPECT_THAT(trie.findMatchingPrefixes(""), ElementsAre(cstr_d));
+  EXPECT_THAT(trie.findMatchingPrefixes("/f"), ElementsAre(cstr_d, cstr_a));
+}
+
 TEST(TrieLookupTable, VeryDeepTrieDoesNotStackOverflowOnDestructor) {
   TrieLookupTable<const char*> trie;
   const char* cstr_a = "a";
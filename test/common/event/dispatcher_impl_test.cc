@@ -1,10 +1,12 @@
 #include <functional>
 
 #include "envoy/common/scope_tracker.h"
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
 #include "envoy/thread/thread.h"
 
 #include "source/common/api/api_impl.h"
 #include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/common/lock_guard.h"
 #include "source/common/common/scope_tracker.h"
 #include "source/common/common/utility.h"
@@ -21,6 +23,7 @@
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_time.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
@@ -323,6 +326,32 @@ TEST(DeferredDeleteTest, DeferredDeleteAndPostOrdering) {
   dispatcher->run(Dispatcher::RunType::NonBlock);
 }
 
+// The slice pool is built from the bootstrap when the dispatcher first runs, so that the main
+// thread dispatcher, which is created before the bootstrap is loaded, gets one too.
+TEST(DispatcherSlicePoolTest, PoolBuiltFromBootstrapOnFirstRun) {
+  envoy::config::bootstrap::v3::Bootstrap bootstrap;
+  Stats::IsolatedStoreImpl stats_store;
+  GlobalTimeSystem time_system;
+  NiceMock<Random::MockRandomGenerator> random;
+  Api::Impl api(Thread::threadFactoryForTest(), stats_store, time_system,
+                Filesystem::fileSystemForTest(), random, bootstrap);
+  DispatcherPtr dispatcher = api.allocateDispatcher("test_thread");
+
+  bootstrap.mutable_buffer_slice_pool()->add_size_classes(4096);
+  Buffer::SlicePool* pool = nullptr;
+  dispatcher->post([&pool]() { pool = Buffer::SlicePool::current(); });
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+  EXPECT_NE(nullptr, pool);
+  EXPECT_EQ(nullptr, Buffer::SlicePool::current());
+
+  // The configuration belongs to the API it was given to, so other dispatchers get no pool.
+  Api::ApiPtr other_api = Api::createApiForTest();
+  DispatcherPtr other_dispatcher = other_api->allocateDispatcher("test_thread");
+  other_dispatcher->post([&pool]() { pool = Buffer::SlicePool::current(); });
+  other_dispatcher->run(Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(nullptr, pool);
+}
+
 class DispatcherImplTest : public testing::Test {
 protected:
   DispatcherImplTest()
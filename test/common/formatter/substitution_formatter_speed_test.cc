@@ -4,7 +4,10 @@
 
 #include "test/common/stream_info/test_util.h"
 #include "test/mocks/http/mocks.h"
+#include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -47,6 +50,77 @@ std::unique_ptr<Envoy::Formatter::StructFormatter> makeStructFormatter(bool type
   return std::make_unique<Envoy::Formatter::StructFormatter>(StructLogFormat, typed, false);
 }
 
+// 40 commands, roughly half of them typed, as a large production access log would use.
+constexpr absl::string_view LargeLogFormatCommands[] = {
+    "%START_TIME%",
+    "%REQ(:METHOD)%",
+    "%REQ(X-ENVOY-ORIGINAL-PATH?:PATH)%",
+    "%REQ(:AUTHORITY)%",
+    "%REQ(X-FORWARDED-PROTO)%",
+    "%REQ(X-FORWARDED-FOR)%",
+    "%REQ(X-REQUEST-ID)%",
+    "%REQ(USER-AGENT)%",
+    "%REQ(REFERER)%",
+    "%REQ(CONTENT-TYPE)%",
+    "%REQ(ACCEPT)%",
+    "%REQ(ACCEPT-ENCODING)%",
+    "%RESP(CONTENT-TYPE)%",
+    "%RESP(CONTENT-ENCODING)%",
+    "%RESP(SERVER)%",
+    "%PROTOCOL%",
+    "%RESPONSE_CODE%",
+    "%RESPONSE_CODE_DETAILS%",
+    "%RESPONSE_FLAGS%",
+    "%CONNECTION_TERMINATION_DETAILS%",
+    "%BYTES_RECEIVED%",
+    "%BYTES_SENT%",
+    "%UPSTREAM_WIRE_BYTES_SENT%",
+    "%UPSTREAM_WIRE_BYTES_RECEIVED%",
+    "%DOWNSTREAM_WIRE_BYTES_SENT%",
+    "%DOWNSTREAM_WIRE_BYTES_RECEIVED%",
+    "%DURATION%",
+    "%REQUEST_DURATION%",
+    "%RESPONSE_DURATION%",
+    "%RESPONSE_TX_DURATION%",
+    "%UPSTREAM_HOST%",
+    "%UPSTREAM_CLUSTER%",
+    "%UPSTREAM_LOCAL_ADDRESS%",
+    "%UPSTREAM_TRANSPORT_FAILURE_REASON%",
+    "%DOWNSTREAM_REMOTE_ADDRESS%",
+    "%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT%",
+    "%DOWNSTREAM_LOCAL_ADDRESS%",
+    "%REQUESTED_SERVER_NAME%",
+    "%ROUTE_NAME%",
+    "%CONNECTION_ID%",
+};
+
+std::unique_ptr<Envoy::Formatter::JsonFormatterImpl> makeLargeJsonFormatter() {
+  ProtobufWkt::Struct json_log_format;
+  for (size_t i = 0; i < std::size(LargeLogFormatCommands); i++) {
+    (*json_log_format.mutable_fields())[absl::StrCat("field_", i)].set_string_value(
+        LargeLogFormatCommands[i]);
+  }
+  return std::make_unique<Envoy::Formatter::JsonFormatterImpl>(json_log_format, false);
+}
+
+std::unique_ptr<Envoy::Formatter::FormatterImpl> makeLargeFormatter() {
+  return *Envoy::Formatter::FormatterImpl::create(
+      absl::StrCat(absl::StrJoin(LargeLogFormatCommands, " "), "\n"), false);
+}
+
+Http::TestRequestHeaderMapImpl makeRequestHeaders() {
+  return {{":method", "GET"},
+          {":path", "/api/v1/resources/1234?verbose=true"},
+          {":authority", "api.example.com"},
+          {"x-forwarded-proto", "https"},
+          {"x-forwarded-for", "203.0.113.1"},
+          {"x-request-id", "6c5ef1a8-8f7b-4d1d-9e5a-0b3c2d1e4f5a"},
+          {"user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko)"},
+          {"referer", "https://www.example.com/index.html"},
+          {"accept", "application/json"},
+          {"accept-encoding", "gzip, deflate, br"}};
+}
+
 std::unique_ptr<Envoy::TestStreamInfo> makeStreamInfo(TimeSource& time_source) {
   auto stream_info = std::make_unique<Envoy::TestStreamInfo>(time_source);
   stream_info->downstream_connection_info_provider_->setRemoteAddress(
@@ -141,6 +215,71 @@ static void BM_JsonAccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_JsonAccessLogFormatter);
 
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_LargeAccessLogFormatter(benchmark::State& state) {
+  testing::NiceMock<MockTimeSystem> time_system;
+
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo(time_system);
+  Http::TestRequestHeaderMapImpl request_headers = makeRequestHeaders();
+  Http::TestResponseHeaderMapImpl response_headers{{"content-type", "application/json"},
+                                                   {"server", "envoy"}};
+  const Formatter::HttpFormatterContext context(&request_headers, &response_headers);
+  std::unique_ptr<Envoy::Formatter::FormatterImpl> formatter = makeLargeFormatter();
+
+  // The buffer is reused for all lines, as a caller batching log lines would.
+  std::string log_line;
+  size_t output_bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    log_line.clear();
+    formatter->appendWithContext(context, *stream_info, log_line);
+    output_bytes += log_line.length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_LargeAccessLogFormatter);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_LargeJsonAccessLogFormatter(benchmark::State& state) {
+  testing::NiceMock<MockTimeSystem> time_system;
+
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo(time_system);
+  Http::TestRequestHeaderMapImpl request_headers = makeRequestHeaders();
+  Http::TestResponseHeaderMapImpl response_headers{{"content-type", "application/json"},
+                                                   {"server", "envoy"}};
+  const Formatter::HttpFormatterContext context(&request_headers, &response_headers);
+  std::unique_ptr<Envoy::Formatter::JsonFormatterImpl> json_formatter = makeLargeJsonFormatter();
+
+  std::string log_line;
+  size_t output_bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    log_line.clear();
+    json_formatter->appendWithContext(context, *stream_info, log_line);
+    output_bytes += log_line.length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_LargeJsonAccessLogFormatter);
+
+// Formats lines into a new string per line, for comparison with the buffer reuse above.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_LargeJsonAccessLogFormatterNewLine(benchmark::State& state) {
+  testing::NiceMock<MockTimeSystem> time_system;
+
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo(time_system);
+  Http::TestRequestHeaderMapImpl request_headers = makeRequestHeaders();
+  Http::TestResponseHeaderMapImpl response_headers{{"content-type", "application/json"},
+                                                   {"server", "envoy"}};
+  const Formatter::HttpFormatterContext context(&request_headers, &response_headers);
+  std::unique_ptr<Envoy::Formatter::JsonFormatterImpl> json_formatter = makeLargeJsonFormatter();
+
+  size_t output_bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes += json_formatter->formatWithContext(context, *stream_info).length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_LargeJsonAccessLogFormatterNewLine);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_FormatterCommandParsing(benchmark::State& state) {
   const std::string token = "Listener:namespace:key";
@@ -4695,6 +4695,64 @@ TEST(SubstitutionFormatterTest, JsonFormatterWithOrderedPropertiesTest) {
   EXPECT_EQ(legacy_out_json, legacy_expected);
 }
 
+TEST(SubstitutionFormatterTest, JsonFormatterTypedValuesTest) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"key_1", R"(value_with_quotes_"_)"}};
+  HttpFormatterContext formatter_context(&request_header);
+
+  EXPECT_CALL(stream_info, bytesSent()).WillRepeatedly(Return(12345678901));
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(absl::nullopt));
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    string_value: '%REQ(key_1)%'
+    missing_string_value: '%REQ(missing)%'
+    truncated_string_value: '%REQ(key_1):5%'
+    stream_info_string_value: '%PROTOCOL%'
+    integer_value: '%BYTES_SENT%'
+    missing_integer_value: '%REQUEST_DURATION%'
+    plain_value: 'plain "value"'
+    combined_value: '%BYTES_SENT% %REQ(key_1)%'
+  )EOF",
+                            key_mapping);
+
+  const std::string expected = R"EOF({
+    "string_value": "value_with_quotes_\"_",
+    "missing_string_value": null,
+    "truncated_string_value": "value",
+    "stream_info_string_value": null,
+    "integer_value": 12345678901,
+    "missing_integer_value": null,
+    "plain_value": "plain \"value\"",
+    "combined_value": "12345678901 value_with_quotes_\"_"
+  })EOF";
+
+  JsonFormatterImpl formatter(key_mapping, false);
+  const std::string out_json = formatter.formatWithContext(formatter_context, stream_info);
+  EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected)) << out_json;
+
+  // Lines can be appended to a reused buffer.
+  std::string buffer = "prefix";
+  formatter.appendWithContext(formatter_context, stream_info, buffer);
+  EXPECT_EQ(absl::StrCat("prefix", out_json), buffer);
+}
+
+TEST(SubstitutionFormatterTest, FormatterAppendWithContext) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"key_1", "value_1"}};
+  HttpFormatterContext formatter_context(&request_header);
+  EXPECT_CALL(stream_info, bytesSent()).WillRepeatedly(Return(123));
+
+  FormatterPtr formatter = *FormatterImpl::create("%REQ(key_1)% %BYTES_SENT% %REQ(missing)%\n");
+  EXPECT_EQ("value_1 123 -\n", formatter->formatWithContext(formatter_context, stream_info));
+
+  std::string buffer;
+  for (int i = 0; i < 2; i++) {
+    formatter->appendWithContext(formatter_context, stream_info, buffer);
+  }
+  EXPECT_EQ("value_1 123 -\nvalue_1 123 -\n", buffer);
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
   Http::TestResponseHeaderMapImpl response_header{{"second", "PUT"}, {"test", "test"}};
@@ -0,0 +1,113 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <random>
+#include <string>
+
+#include "source/common/http/character_set_validation.h"
+#include "source/common/http/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// Realistic inputs for the validation loops: a short header value, a user agent, a large cookie
+// header and a long URL with a query string.
+enum class Corpus { ShortValue, UserAgent, Cookie, LongUrl };
+
+std::string randomToken(std::mt19937& rng, size_t length) {
+  static constexpr absl::string_view chars =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+  std::string token(length, '\0');
+  for (char& c : token) {
+    c = chars[rng() % chars.size()];
+  }
+  return token;
+}
+
+std::string makeCorpus(Corpus corpus) {
+  std::mt19937 rng(0);
+  switch (corpus) {
+  case Corpus::ShortValue:
+    return "application/json";
+  case Corpus::UserAgent:
+    return "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+           "Chrome/120.0.0.0 Safari/537.36";
+  case Corpus::Cookie: {
+    std::string cookie;
+    while (cookie.size() < 4096) {
+      absl::StrAppend(&cookie, cookie.empty() ? "" : "; ", randomToken(rng, 8), "=",
+                      randomToken(rng, 64));
+    }
+    return cookie;
+  }
+  case Corpus::LongUrl: {
+    std::string url = absl::StrCat("/", randomToken(rng, 16), "/", randomToken(rng, 24), "?");
+    while (url.size() < 2048) {
+      absl::StrAppend(&url, randomToken(rng, 8), "=", randomToken(rng, 40), "%2F",
+                      randomToken(rng, 12), "&");
+    }
+    return url;
+  }
+  }
+  return "";
+}
+
+const CharacterSet& corpusCharacterSet(Corpus corpus) {
+  return corpus == Corpus::LongUrl ? kUriQueryAndFragmentCharSet : kGenericHeaderValueCharSet;
+}
+
+} // namespace
+
+// Scans a corpus for invalid characters. Args: scan implementation, corpus.
+static void bmCharacterSetScan(benchmark::State& state) {
+  const auto impl = static_cast<CharacterSet::ScanImpl>(state.range(0));
+  const auto corpus = static_cast<Corpus>(state.range(1));
+  if (!CharacterSet::scanImplSupported(impl)) {
+    state.SkipWithError("scan implementation is not supported by this CPU");
+    return;
+  }
+  const std::string value = makeCorpus(corpus);
+  const CharacterSet& set = corpusCharacterSet(corpus);
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(set.findFirstNotIn(value, impl));
+  }
+  state.SetBytesProcessed(state.iterations() * value.size());
+}
+BENCHMARK(bmCharacterSetScan)->ArgsProduct({{0, 1, 2}, {0, 1, 2, 3}});
+
+// Validates a header value with the default implementation. Args: corpus.
+static void bmHeaderValueIsValid(benchmark::State& state) {
+  const std::string value = makeCorpus(static_cast<Corpus>(state.range(0)));
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(kGenericHeaderValueCharSet.containsAll(value));
+  }
+  state.SetBytesProcessed(state.iterations() * value.size());
+}
+BENCHMARK(bmHeaderValueIsValid)->DenseRange(0, 3);
+
+// Percent-decodes a long URL with sparse escapes.
+static void bmPercentDecode(benchmark::State& state) {
+  const std::string value = makeCorpus(Corpus::LongUrl);
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(Utility::PercentEncoding::decode(value));
+  }
+  state.SetBytesProcessed(state.iterations() * value.size());
+}
+BENCHMARK(bmPercentDecode);
+
+// Percent-decodes a long URL query parameter with sparse escapes.
+static void bmUrlDecodeQueryParameter(benchmark::State& state) {
+  const std::string value = makeCorpus(Corpus::LongUrl);
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(Utility::PercentEncoding::urlDecodeQueryParameter(value));
+  }
+  state.SetBytesProcessed(state.iterations() * value.size());
+}
+BENCHMARK(bmUrlDecodeQueryParameter);
+
+} // namespace Http
+} // namespace Envoy
@@ -1,3 +1,6 @@
+#include <random>
+#include <string>
+
 #include "source/common/http/character_set_validation.h"
 
 #include "gtest/gtest.h"
@@ -33,5 +36,70 @@ TEST(CharacterSetValidationTest, Test) {
   }
 }
 
+class CharacterSetScanTest : public testing::TestWithParam<CharacterSet::ScanImpl> {
+protected:
+  void SetUp() override {
+    if (!CharacterSet::scanImplSupported(GetParam())) {
+      GTEST_SKIP() << "scan implementation is not supported by this CPU";
+    }
+  }
+
+  static size_t expectedFirstNotIn(const CharacterSet& set, absl::string_view value) {
+    for (size_t i = 0; i < value.size(); ++i) {
+      if (!set.contains(value[i])) {
+        return i;
+      }
+    }
+    return absl::string_view::npos;
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(ScanImpls, CharacterSetScanTest,
+                         testing::Values(CharacterSet::ScanImpl::Scalar,
+                                         CharacterSet::ScanImpl::Ssse3,
+                                         CharacterSet::ScanImpl::Avx2));
+
+// Every character is classified the same way as testCharInTable(), wherever it is in the string.
+TEST_P(CharacterSetScanTest, EveryCharacterAtEveryPosition) {
+  for (const CharacterSet* set : {&kGenericHeaderNameCharSet, &kGenericHeaderValueCharSet,
+                                  &kUriQueryAndFragmentCharSet}) {
+    for (const size_t length : {1, 15, 16, 17, 31, 32, 33, 64}) {
+      std::string value(length, 'a');
+      for (size_t pos = 0; pos < length; ++pos) {
+        for (unsigned c = 0; c < 256; ++c) {
+          value[pos] = static_cast<char>(c);
+          EXPECT_EQ(set->contains(value[pos]) ? absl::string_view::npos : pos,
+                    set->findFirstNotIn(value, GetParam()))
+              << "length=" << length << " pos=" << pos << " c=" << c;
+        }
+        value[pos] = 'a';
+      }
+    }
+  }
+}
+
+TEST_P(CharacterSetScanTest, RandomStrings) {
+  std::mt19937 rng(0);
+  for (const CharacterSet* set : {&kGenericHeaderNameCharSet, &kGenericHeaderValueCharSet,
+                                  &kUriQueryAndFragmentCharSet}) {
+    for (size_t length = 0; length < 200; ++length) {
+      std::string value(length, '\0');
+      for (char& c : value) {
+        do {
+          c = static_cast<char>(rng());
+        } while (!set->contains(c));
+      }
+      EXPECT_EQ(absl::string_view::npos, set->findFirstNotIn(value, GetParam()));
+      EXPECT_TRUE(set->containsAll(value));
+      if (length > 0) {
+        value[rng() % length] = static_cast<char>(rng());
+        value[rng() % length] = static_cast<char>(rng());
+        EXPECT_EQ(expectedFirstNotIn(*set, value), set->findFirstNotIn(value, GetParam()));
+        EXPECT_EQ(expectedFirstNotIn(*set, value), set->findFirstNotIn(value));
+      }
+    }
+  }
+}
+
 } // namespace Http
 } // namespace Envoy
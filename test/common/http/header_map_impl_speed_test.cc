@@ -210,6 +210,56 @@ static void headerMapImplPopulate(benchmark::State& state) {
 }
 BENCHMARK(headerMapImplPopulate);
 
+/**
+ * Measure the speed of building and tearing down a request header map of a typical size. The
+ * numeric Arg is the number of non-inline headers added on top of the inline ones, which exercises
+ * the growth of the header entry storage.
+ */
+static void headerMapImplBuildAndDestroy(benchmark::State& state) {
+  for (auto _ : state) { // NOLINT
+    auto headers = Http::RequestHeaderMapImpl::create();
+    headers->setReferenceMethod(Http::Headers::get().MethodValues.Get);
+    headers->setReferencePath("/some/path");
+    headers->setReferenceHost("example.com");
+    headers->setReferenceScheme(Http::Headers::get().SchemeValues.Https);
+    headers->setReferenceUserAgent("benchmark");
+    addDummyHeaders(*headers, state.range(0));
+    benchmark::DoNotOptimize(headers->size());
+  }
+}
+BENCHMARK(headerMapImplBuildAndDestroy)->Arg(0)->Arg(5)->Arg(20)->Arg(50)->Arg(100);
+
+/**
+ * Measure the speed of copying a header map, which allocates a new entry for every header.
+ */
+static void headerMapImplCopy(benchmark::State& state) {
+  auto headers = Http::RequestHeaderMapImpl::create();
+  headers->setReferenceMethod(Http::Headers::get().MethodValues.Get);
+  headers->setReferencePath("/some/path");
+  headers->setReferenceHost("example.com");
+  addDummyHeaders(*headers, state.range(0));
+  for (auto _ : state) { // NOLINT
+    Http::RequestHeaderMapPtr copy = createHeaderMap<RequestHeaderMapImpl>(*headers);
+    benchmark::DoNotOptimize(copy->size());
+  }
+}
+BENCHMARK(headerMapImplCopy)->Arg(0)->Arg(5)->Arg(20)->Arg(50)->Arg(100);
+
+/**
+ * Measure the speed of repeatedly clearing and repopulating the same header map, for which the
+ * entry storage allocated by the first iteration is reused.
+ */
+static void headerMapImplClearAndRepopulate(benchmark::State& state) {
+  auto headers = Http::ResponseHeaderMapImpl::create();
+  for (auto _ : state) { // NOLINT
+    headers->clear();
+    headers->setStatus(200);
+    addDummyHeaders(*headers, state.range(0));
+  }
+  benchmark::DoNotOptimize(headers->size());
+}
+BENCHMARK(headerMapImplClearAndRepopulate)->Arg(0)->Arg(5)->Arg(20)->Arg(50);
+
 /**
  * Measure the speed of encoding headers as part of upgraded requests (HTTP/1 to HTTP/2)
  * @note The measured time for each iteration includes the time needed to add
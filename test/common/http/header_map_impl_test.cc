@@ -991,6 +991,59 @@ TEST(HeaderMapImplTest, ClearHeaderMap) {
   EXPECT_TRUE(headers.empty());
 }
 
+// Validates that header entries are allocated in chunks, that released entries are reused, and that
+// inline header pointers and insertion order survive interleaved inserts and removals.
+TEST(HeaderMapImplTest, HeaderEntryStorageReuse) {
+  auto headers = RequestHeaderMapImpl::create();
+  EXPECT_EQ(0, headers->headerStorageChunksForTest());
+
+  headers->setReferenceMethod("GET");
+  headers->setReferencePath("/");
+  for (int i = 0; i < 25; i++) {
+    headers->addCopy(LowerCaseString(absl::StrCat("key-", i)), absl::StrCat("value-", i));
+  }
+  EXPECT_EQ(27, headers->size());
+  // 27 entries fit in chunks of 4, 8 and 16 entries.
+  const uint32_t chunks = headers->headerStorageChunksForTest();
+  EXPECT_EQ(3, chunks);
+  EXPECT_EQ("GET", headers->getMethodValue());
+
+  // Removing and re-adding headers reuses the released entries.
+  for (int i = 0; i < 25; i += 2) {
+    headers->remove(LowerCaseString(absl::StrCat("key-", i)));
+  }
+  headers->removeMethod();
+  for (int i = 0; i < 25; i += 2) {
+    headers->addCopy(LowerCaseString(absl::StrCat("new-key-", i)), "new-value");
+  }
+  headers->setReferenceMethod("POST");
+  EXPECT_EQ(chunks, headers->headerStorageChunksForTest());
+  EXPECT_EQ("POST", headers->getMethodValue());
+  EXPECT_EQ("/", headers->getPathValue());
+  headers->verifyByteSizeInternalForTest();
+
+  // Pseudo headers stay in front and regular headers keep insertion order.
+  std::vector<std::string> keys;
+  headers->iterate([&keys](const HeaderEntry& header) -> HeaderMap::Iterate {
+    keys.emplace_back(header.key().getStringView());
+    return HeaderMap::Iterate::Continue;
+  });
+  ASSERT_EQ(27, keys.size());
+  EXPECT_EQ(":path", keys[0]);
+  EXPECT_EQ(":method", keys[1]);
+  EXPECT_EQ("key-1", keys[2]);
+  EXPECT_EQ("new-key-0", keys[14]);
+  EXPECT_EQ("new-key-24", keys[26]);
+
+  // Clearing keeps the storage around for reuse.
+  headers->clear();
+  for (int i = 0; i < 27; i++) {
+    headers->addCopy(LowerCaseString(absl::StrCat("key-", i)), "value");
+  }
+  EXPECT_EQ(chunks, headers->headerStorageChunksForTest());
+  headers->verifyByteSizeInternalForTest();
+}
+
 // Validates byte size is properly accounted for in different inline header setting scenarios.
 TEST(HeaderMapImplTest, InlineHeaderByteSize) {
   {
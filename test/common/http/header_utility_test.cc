@@ -1012,6 +1012,17 @@ TEST(HeaderIsValidTest, ValidHeaderValuesAreAccepted) {
   EXPECT_TRUE(HeaderUtility::headerValueIsValid("Some Other Value"));
 }
 
+// Header values may contain HTAB, SP, visible characters and obs-text, and nothing else.
+TEST(HeaderIsValidTest, HeaderValueCharacters) {
+  for (int i = 0; i < 256; i++) {
+    const bool valid = i == '\t' || (i >= ' ' && i <= '~') || i >= 0x80;
+    EXPECT_EQ(valid, HeaderUtility::headerValueIsValid(std::string(1, i))) << i;
+    EXPECT_EQ(valid, HeaderUtility::headerValueIsValid(absl::StrCat(std::string(40, 'a'),
+                                                                    std::string(1, i), "a")))
+        << i;
+  }
+}
+
 TEST(HeaderIsValidTest, AuthorityIsValid) {
   EXPECT_TRUE(HeaderUtility::authorityIsValid("strangebutlegal$-%&'"));
   EXPECT_FALSE(HeaderUtility::authorityIsValid("illegal{}"));
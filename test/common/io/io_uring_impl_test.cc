@@ -86,6 +86,18 @@ INSTANTIATE_TEST_SUITE_P(
         [](IoUring& uring, os_fd_t fd) -> IoUringResult {
           return uring.prepareWritev(fd, nullptr, 0, 0, nullptr);
         },
+        [](IoUring& uring, os_fd_t fd) -> IoUringResult {
+          return uring.prepareOpenat(fd, "file", O_RDONLY, 0, nullptr);
+        },
+        [](IoUring& uring, os_fd_t fd) -> IoUringResult {
+          return uring.prepareStatx(fd, "", AT_EMPTY_PATH, STATX_BASIC_STATS, nullptr, nullptr);
+        },
+        [](IoUring& uring, os_fd_t fd) -> IoUringResult {
+          return uring.prepareUnlinkat(fd, "file", 0, nullptr);
+        },
+        [](IoUring& uring, os_fd_t fd) -> IoUringResult {
+          return uring.prepareLinkat(fd, "file", fd, "link", 0, nullptr);
+        },
         [](IoUring& uring, os_fd_t fd) -> IoUringResult { return uring.prepareClose(fd, nullptr); },
         [](IoUring& uring, os_fd_t fd) -> IoUringResult {
           return uring.prepareShutdown(fd, 0, nullptr);
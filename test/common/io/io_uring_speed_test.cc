@@ -0,0 +1,97 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <sys/socket.h>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/io/io_uring_impl.h"
+
+#include "test/mocks/io/mocks.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Io {
+
+// Receive data written to a socket pair in chunks of the given size, either with a readv submitted
+// for every read, or with a single multishot receive reading from the provided buffer ring.
+// Args: use_buffer_ring, chunk_size.
+static void ioUringReceive(benchmark::State& state) {
+  if (!isIoUringSupported()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  const bool use_buffer_ring = state.range(0) != 0;
+  const uint32_t chunk_size = state.range(1);
+
+  IoUringImpl io_uring(256, false);
+  io_uring.registerEventfd();
+  if (use_buffer_ring && !io_uring.setupBufferRing(64, chunk_size)) {
+    state.SkipWithError("provided buffer rings are not supported");
+    return;
+  }
+
+  int fds[2];
+  RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "");
+  testing::NiceMock<MockIoUringSocket> socket;
+  Request req(Request::RequestType::Read, socket);
+  std::unique_ptr<uint8_t[]> read_buf(new uint8_t[chunk_size]);
+  struct iovec iov {
+    read_buf.get(), chunk_size
+  };
+
+  bool armed = false;
+  auto arm = [&]() {
+    if (use_buffer_ring) {
+      RELEASE_ASSERT(io_uring.prepareRecvMultishot(fds[1], &req) == IoUringResult::Ok, "");
+    } else {
+      RELEASE_ASSERT(io_uring.prepareReadv(fds[1], &iov, 1, 0, &req) == IoUringResult::Ok, "");
+    }
+    io_uring.submit();
+    armed = true;
+  };
+
+  const std::string chunk(chunk_size, 'a');
+  Buffer::OwnedImpl received;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    RELEASE_ASSERT(write(fds[0], chunk.data(), chunk.size()) == static_cast<ssize_t>(chunk_size),
+                   "");
+    if (!armed) {
+      arm();
+    }
+    while (received.length() < chunk_size) {
+      io_uring.forEveryCompletion([&](Request* completed, int32_t result, bool) {
+        if (result > 0) {
+          if (completed->completionFlags() & IORING_CQE_F_BUFFER) {
+            io_uring.consumeProvidedBuffer(completed->completionFlags() >> IORING_CQE_BUFFER_SHIFT,
+                                           result, received);
+          } else {
+            received.add(read_buf.get(), result);
+          }
+        }
+        if (!(completed->completionFlags() & IORING_CQE_F_MORE)) {
+          armed = false;
+        }
+      });
+      if (!armed && received.length() < chunk_size) {
+        arm();
+      }
+    }
+    received.drain(received.length());
+  }
+
+  close(fds[0]);
+  close(fds[1]);
+  io_uring.unregisterEventfd();
+}
+BENCHMARK(ioUringReceive)
+    ->Args({0, 512})
+    ->Args({1, 512})
+    ->Args({0, 4096})
+    ->Args({1, 4096})
+    ->Args({0, 16384})
+    ->Args({1, 16384});
+
+} // namespace Io
+} // namespace Envoy
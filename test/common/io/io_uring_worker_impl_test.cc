@@ -33,8 +33,10 @@ public:
 
 class IoUringWorkerTestImpl : public IoUringWorkerImpl {
 public:
-  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher)
-      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, dispatcher) {}
+  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher,
+                        uint32_t buffer_ring_size = 0, bool enable_linked_write_and_close = false)
+      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, dispatcher, buffer_ring_size,
+                          enable_linked_write_and_close) {}
 
   IoUringSocket& addTestSocket(os_fd_t fd) {
     return addSocket(std::make_unique<IoUringSocketTestImpl>(fd, *this));
@@ -693,6 +695,232 @@ TEST(IoUringWorkerImplTest, NoEnableReadOnConnectError) {
   delete static_cast<Request*>(connect_req);
 }
 
+// A multishot receive stays armed across completions and feeds the provided buffers into the
+// socket's read buffer.
+TEST(IoUringWorkerImplTest, MultishotReadFromBufferRing) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  Event::FileReadyCb file_event_callback;
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(
+          DoAll(SaveArg<1>(&file_event_callback), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+  // The ring size is rounded up to a power of 2.
+  EXPECT_CALL(mock_io_uring, setupBufferRing(8, 8192)).WillOnce(Return(true));
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, 5);
+  EXPECT_TRUE(worker.bufferRingEnabled());
+
+  os_fd_t fd = 11;
+  SET_SOCKET_INVALID(fd);
+
+  Request* read_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecvMultishot(fd, _))
+      .WillOnce(DoAll(SaveArg<1>(&read_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  std::string received;
+  auto& io_uring_socket =
+      worker.addServerSocket(fd, [](uint32_t) { return absl::OkStatus(); }, false);
+  io_uring_socket.setFileReadyCb([&io_uring_socket, &received](uint32_t events) {
+    if (events & Event::FileReadyType::Read) {
+      Buffer::Instance& buf = io_uring_socket.getReadParam()->buf_;
+      received.append(buf.toString());
+      buf.drain(buf.length());
+    }
+    return absl::OkStatus();
+  });
+
+  // Two completions of the same multishot receive, each with data in a provided buffer. The
+  // receive remains armed, so no new read is submitted.
+  EXPECT_CALL(mock_io_uring, consumeProvidedBuffer(3, 5, _))
+      .WillOnce(Invoke([](uint16_t, uint32_t, Buffer::Instance& output) { output.add("hello"); }));
+  EXPECT_CALL(mock_io_uring, consumeProvidedBuffer(4, 6, _))
+      .WillOnce(Invoke([](uint16_t, uint32_t, Buffer::Instance& output) { output.add(" world"); }));
+  EXPECT_CALL(mock_io_uring, prepareRecvMultishot(_, _)).Times(0);
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&read_req](const CompletionCb& cb) {
+        read_req->setCompletionFlags(IORING_CQE_F_MORE | IORING_CQE_F_BUFFER |
+                                     (3 << IORING_CQE_BUFFER_SHIFT));
+        cb(read_req, 5, false);
+        read_req->setCompletionFlags(IORING_CQE_F_MORE | IORING_CQE_F_BUFFER |
+                                     (4 << IORING_CQE_BUFFER_SHIFT));
+        cb(read_req, 6, false);
+      }));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+  EXPECT_EQ("hello world", received);
+
+  // Running out of provided buffers ends the receive without an error, and it is armed again.
+  Request* second_read_req = nullptr;
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&read_req](const CompletionCb& cb) {
+        read_req->setCompletionFlags(0);
+        cb(read_req, -ENOBUFS, false);
+      }));
+  EXPECT_CALL(mock_io_uring, prepareRecvMultishot(fd, _))
+      .WillOnce(DoAll(SaveArg<1>(&second_read_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  // Closing cancels the receive. Data arriving before the final completion is discarded but its
+  // buffer is still returned to the ring.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareCancel(second_read_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  io_uring_socket.close(false);
+
+  EXPECT_CALL(mock_io_uring, consumeProvidedBuffer(1, 3, _));
+  Request* close_req = nullptr;
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&second_read_req, &cancel_req](const CompletionCb& cb) {
+        second_read_req->setCompletionFlags(IORING_CQE_F_MORE | IORING_CQE_F_BUFFER |
+                                            (1 << IORING_CQE_BUFFER_SHIFT));
+        cb(second_read_req, 3, false);
+        second_read_req->setCompletionFlags(0);
+        cb(second_read_req, -ECANCELED, false);
+        cb(cancel_req, 0, false);
+      }));
+  EXPECT_CALL(mock_io_uring, prepareClose(fd, _))
+      .WillOnce(DoAll(SaveArg<1>(&close_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+  EXPECT_EQ("hello world", received);
+
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&close_req](const CompletionCb& cb) { cb(close_req, 0, false); }));
+  EXPECT_CALL(mock_io_uring, removeInjectedCompletion(fd));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  EXPECT_EQ(0, worker.getSockets().size());
+}
+
+TEST(IoUringWorkerImplTest, BufferRingUnsupportedFallsBackToReadv) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                           Event::FileReadyType::Read));
+  EXPECT_CALL(mock_io_uring, setupBufferRing(16, 8192)).WillOnce(Return(false));
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, 16);
+  EXPECT_FALSE(worker.bufferRingEnabled());
+
+  os_fd_t fd = 11;
+  SET_SOCKET_INVALID(fd);
+  auto& io_uring_socket = worker.addTestSocket(fd);
+
+  EXPECT_CALL(mock_io_uring, prepareRecvMultishot(_, _)).Times(0);
+  EXPECT_CALL(mock_io_uring, prepareReadv(fd, _, 1, 0, _))
+      .WillOnce(Return<IoUringResult>(IoUringResult::Ok));
+  EXPECT_CALL(mock_io_uring, submit());
+  delete worker.submitReadRequest(io_uring_socket);
+
+  EXPECT_CALL(mock_io_uring, removeInjectedCompletion(fd));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  dynamic_cast<IoUringSocketTestImpl*>(worker.getSockets().front().get())->cleanupForTest();
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+}
+
+// When closing with data left to write, the last write is linked to the close. If the linked write
+// is short, the close is canceled and retried once the remaining data is written.
+TEST(IoUringWorkerImplTest, LinkedWriteAndClose) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  Event::FileReadyCb file_event_callback;
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(
+          DoAll(SaveArg<1>(&file_event_callback), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, 0, true);
+
+  os_fd_t fd = 11;
+  SET_SOCKET_INVALID(fd);
+
+  Request* read_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadv(fd, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&read_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  auto& io_uring_socket =
+      worker.addServerSocket(fd, [](uint32_t) { return absl::OkStatus(); }, false);
+
+  // Disable the socket and finish the read request, so that there is no read in flight.
+  io_uring_socket.disableRead();
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&read_req](const CompletionCb& cb) { cb(read_req, -EAGAIN, false); }));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  Request* write_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareWritev(fd, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&write_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  Buffer::OwnedImpl write_buf;
+  write_buf.add("Hello");
+  io_uring_socket.write(write_buf);
+  write_buf.add("World");
+  io_uring_socket.write(write_buf);
+
+  EXPECT_CALL(dispatcher, createTimer_(_)).WillOnce(ReturnNew<NiceMock<Event::MockTimer>>());
+  io_uring_socket.close(false);
+
+  // The first write completes, the rest of the data is written with the close linked to it.
+  Request* linked_write_req = nullptr;
+  Request* linked_close_req = nullptr;
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&write_req](const CompletionCb& cb) { cb(write_req, 5, false); }));
+  EXPECT_CALL(mock_io_uring, prepareWritevAndClose(fd, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<3>(&linked_write_req), SaveArg<4>(&linked_close_req),
+                      Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  // The linked write is short, so the close is canceled. The rest is written on its own.
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&linked_write_req, &linked_close_req](const CompletionCb& cb) {
+        cb(linked_write_req, 2, false);
+        cb(linked_close_req, -ECANCELED, false);
+      }));
+  EXPECT_CALL(mock_io_uring, prepareWritev(fd, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&write_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  // Once all the data is written, the socket is closed.
+  Request* close_req = nullptr;
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&write_req](const CompletionCb& cb) { cb(write_req, 3, false); }));
+  EXPECT_CALL(mock_io_uring, prepareClose(fd, _))
+      .WillOnce(DoAll(SaveArg<1>(&close_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&close_req](const CompletionCb& cb) { cb(close_req, 0, false); }));
+  EXPECT_CALL(mock_io_uring, removeInjectedCompletion(fd));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  EXPECT_EQ(0, worker.getSockets().size());
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
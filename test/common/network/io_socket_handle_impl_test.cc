@@ -101,6 +101,53 @@ TEST(IoSocketHandleImpl, LastRoundTripTimeReturnsRttIfSuccessful) {
               Eq(std::chrono::duration_cast<std::chrono::milliseconds>(rtt)));
 }
 
+#if defined(__linux__)
+TEST(IoSocketHandleImpl, WriteSendsFileSlicesWithSendfile) {
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+
+  class FileFragment : public Buffer::BufferFragmentImpl {
+  public:
+    FileFragment(const char* data, size_t size)
+        : BufferFragmentImpl(data, size, nullptr), size_(size) {}
+    absl::optional<Buffer::FileRange> fileRange() const override {
+      return Buffer::FileRange{42, 1000, size_};
+    }
+
+  private:
+    const size_t size_;
+  };
+  const std::string body(100, 'b');
+  FileFragment fragment(body.data(), body.size());
+  Buffer::OwnedImpl buffer("headers");
+  buffer.addBufferFragment(fragment);
+
+  IoSocketHandleImpl io_handle(7);
+  // The data before the file slice is written up to the start of the file slice.
+  EXPECT_CALL(os_sys_calls, send(7, _, 7, 0)).WillOnce(Return(Api::SysCallSizeResult{7, 0}));
+  EXPECT_EQ(7, io_handle.write(buffer).return_value_);
+  EXPECT_EQ(100, buffer.length());
+
+  EXPECT_CALL(linux_os_sys_calls, sendfile(7, 42, _, 100))
+      .WillOnce(Invoke([](os_fd_t, os_fd_t, off_t* offset, size_t) -> Api::SysCallSizeResult {
+        EXPECT_EQ(1000, *offset);
+        return {60, 0};
+      }));
+  EXPECT_EQ(60, io_handle.write(buffer).return_value_);
+  EXPECT_EQ(40, buffer.length());
+
+  // If sendfile is not supported, the mapped data is written from memory.
+  EXPECT_CALL(linux_os_sys_calls, sendfile(7, 42, _, 40))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, EINVAL}));
+  EXPECT_CALL(os_sys_calls, send(7, Eq(body.data() + 60), 40, 0))
+      .WillOnce(Return(Api::SysCallSizeResult{40, 0}));
+  EXPECT_EQ(40, io_handle.write(buffer).return_value_);
+  EXPECT_EQ(0, buffer.length());
+}
+#endif
+
 TEST(IoSocketHandleImpl, InterfaceNameWithPipe) {
   std::string path = TestEnvironment::unixDomainSocketPath("foo.sock");
 
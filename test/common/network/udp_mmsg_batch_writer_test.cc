@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/network/udp_mmsg_batch_writer.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class UdpMmsgBatchWriterTest : public testing::Test {
+protected:
+  UdpMmsgBatchWriterTest() : io_handle_(fd_) {}
+
+  // Records the datagrams in a sendmmsg() call and reports up to max_sent of them as sent.
+  auto sendBatch(int max_sent = -1) {
+    return [this, max_sent](os_fd_t fd, struct mmsghdr* messages, unsigned int count,
+                            int) -> Api::SysCallIntResult {
+      EXPECT_EQ(fd_, fd);
+      const unsigned int num_sent = max_sent < 0 ? count : std::min<unsigned int>(count, max_sent);
+      for (unsigned int i = 0; i < num_sent; ++i) {
+        const msghdr& header = messages[i].msg_hdr;
+        EXPECT_EQ(1, header.msg_iovlen);
+        EXPECT_EQ(peer_address_.sockAddrLen(), header.msg_namelen);
+        EXPECT_EQ(0, memcmp(peer_address_.sockAddr(), header.msg_name, header.msg_namelen));
+        sent_.emplace_back(static_cast<const char*>(header.msg_iov[0].iov_base),
+                           header.msg_iov[0].iov_len);
+        messages[i].msg_len = header.msg_iov[0].iov_len;
+      }
+      return {static_cast<int>(num_sent), 0};
+    };
+  }
+
+  Api::IoCallUint64Result write(UdpMmsgBatchWriter& writer, const std::string& data) {
+    Buffer::OwnedImpl buffer(data);
+    return writer.writePacket(buffer, nullptr, peer_address_);
+  }
+
+  Api::MockOsSysCalls os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  const os_fd_t fd_{10};
+  IoSocketHandleImpl io_handle_;
+  const Address::Ipv4Instance peer_address_{"127.0.0.1", 5000};
+  std::vector<std::string> sent_;
+};
+
+TEST_F(UdpMmsgBatchWriterTest, FlushSendsBatch) {
+  UdpMmsgBatchWriter writer(io_handle_, 4);
+  EXPECT_TRUE(writer.isBatchMode());
+
+  EXPECT_EQ(5, write(writer, "hello").return_value_);
+  EXPECT_EQ(6, write(writer, "world!").return_value_);
+  EXPECT_EQ(2, writer.bufferedPackets());
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(fd_, _, 2, 0)).WillOnce(Invoke(sendBatch()));
+  Api::IoCallUint64Result result = writer.flush();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(11, result.return_value_);
+  EXPECT_EQ((std::vector<std::string>{"hello", "world!"}), sent_);
+  EXPECT_EQ(0, writer.bufferedPackets());
+
+  // Flushing an empty batch does not make a system call.
+  EXPECT_TRUE(writer.flush().ok());
+}
+
+TEST_F(UdpMmsgBatchWriterTest, FullBatchIsSent) {
+  UdpMmsgBatchWriter writer(io_handle_, 2);
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(fd_, _, 2, 0)).WillOnce(Invoke(sendBatch()));
+  EXPECT_TRUE(write(writer, "a").ok());
+  EXPECT_TRUE(write(writer, "b").ok());
+  EXPECT_TRUE(sent_.empty());
+  EXPECT_TRUE(write(writer, "c").ok());
+  EXPECT_EQ((std::vector<std::string>{"a", "b"}), sent_);
+  EXPECT_EQ(1, writer.bufferedPackets());
+}
+
+TEST_F(UdpMmsgBatchWriterTest, PartialSendIsRetried) {
+  UdpMmsgBatchWriter writer(io_handle_, 4);
+  EXPECT_TRUE(write(writer, "a").ok());
+  EXPECT_TRUE(write(writer, "bb").ok());
+  EXPECT_TRUE(write(writer, "ccc").ok());
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(fd_, _, 3, 0)).WillOnce(Invoke(sendBatch(1)));
+  EXPECT_CALL(os_sys_calls_, sendmmsg(fd_, _, 2, 0)).WillOnce(Invoke(sendBatch()));
+  Api::IoCallUint64Result result = writer.flush();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(6, result.return_value_);
+  EXPECT_EQ((std::vector<std::string>{"a", "bb", "ccc"}), sent_);
+}
+
+TEST_F(UdpMmsgBatchWriterTest, BlockedWriteDropsBatch) {
+  UdpMmsgBatchWriter writer(io_handle_, 4);
+  EXPECT_TRUE(write(writer, "a").ok());
+  EXPECT_TRUE(write(writer, "bb").ok());
+
+  EXPECT_CALL(os_sys_calls_, sendmmsg(fd_, _, 2, 0)).WillOnce(Invoke(sendBatch(1)));
+  EXPECT_CALL(os_sys_calls_, sendmmsg(fd_, _, 1, 0))
+      .WillOnce(Return(Api::SysCallIntResult{-1, SOCKET_ERROR_AGAIN}))
+      .WillOnce(Return(Api::SysCallIntResult{-1, SOCKET_ERROR_INVAL}));
+  Api::IoCallUint64Result result = writer.flush();
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_EQ(1, result.return_value_);
+  EXPECT_TRUE(writer.isWriteBlocked());
+  EXPECT_EQ(0, writer.bufferedPackets());
+
+  writer.setWritable();
+  EXPECT_TRUE(write(writer, "a").ok());
+  result = writer.flush();
+  EXPECT_EQ(Api::IoError::IoErrorCode::InvalidArgument, result.err_->getErrorCode());
+  EXPECT_EQ(0, result.return_value_);
+  EXPECT_FALSE(writer.isWriteBlocked());
+}
+
+// Datagrams with a source address are sent on their own, after the batch.
+TEST_F(UdpMmsgBatchWriterTest, SourceAddressBypassesBatch) {
+  UdpMmsgBatchWriter writer(io_handle_, 4);
+  EXPECT_TRUE(write(writer, "a").ok());
+
+  testing::InSequence s;
+  EXPECT_CALL(os_sys_calls_, sendmmsg(fd_, _, 1, 0)).WillOnce(Invoke(sendBatch()));
+  EXPECT_CALL(os_sys_calls_, sendmsg(fd_, _, 0))
+      .WillOnce(Invoke([this](os_fd_t, const msghdr* message, int) -> Api::SysCallSizeResult {
+        EXPECT_NE(nullptr, message->msg_control);
+        sent_.emplace_back(static_cast<const char*>(message->msg_iov[0].iov_base),
+                           message->msg_iov[0].iov_len);
+        return {static_cast<ssize_t>(message->msg_iov[0].iov_len), 0};
+      }));
+
+  const Address::Ipv4Instance local_address("127.0.0.2");
+  Buffer::OwnedImpl buffer("bb");
+  EXPECT_EQ(2, writer.writePacket(buffer, local_address.ip(), peer_address_).return_value_);
+  EXPECT_EQ((std::vector<std::string>{"a", "bb"}), sent_);
+}
+
+TEST(UdpMmsgBatchWriterFactoryTest, FallsBackWithoutMmsg) {
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  IoSocketHandleImpl io_handle(10);
+  Stats::IsolatedStoreImpl store;
+  UdpMmsgBatchWriterFactory factory(8);
+
+  EXPECT_CALL(os_sys_calls, supportsMmsg()).WillOnce(Return(false));
+  EXPECT_FALSE(factory.createUdpPacketWriter(io_handle, *store.rootScope())->isBatchMode());
+  EXPECT_CALL(os_sys_calls, supportsMmsg()).WillOnce(Return(true));
+  EXPECT_TRUE(factory.createUdpPacketWriter(io_handle, *store.rootScope())->isBatchMode());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
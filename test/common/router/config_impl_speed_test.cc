@@ -6,6 +6,7 @@
 
 #include "test/mocks/server/instance.h"
 #include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "benchmark/benchmark.h"
@@ -59,7 +60,7 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       break;
     }
     case RouteMatch::PathSpecifierCase::kPath: {
-      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
       break;
     }
     case RouteMatch::PathSpecifierCase::kSafeRegex: {
@@ -311,6 +312,76 @@ static void bmRouteTableSizeWithPrefixMatcherTree(benchmark::State& state) {
   }
 }
 
+/**
+ * Generates a route config with `n` routes mixing the path matcher types commonly found in large
+ * route tables:
+ * - /api/v1/resource_x (exact)
+ * - /static/dir_x/ (prefix)
+ * - ^/users/[0-9]+/item_x$ (regex)
+ * - /svc_x (path separated prefix)
+ */
+static RouteConfiguration genMixedRouteConfig(int num_routes) {
+  RouteConfiguration route_config;
+  VirtualHost* v_host = route_config.add_virtual_hosts();
+  v_host->set_name("default");
+  v_host->add_domains("*");
+
+  for (int i = 0; i < num_routes; ++i) {
+    Route* route = v_host->add_routes();
+    route->mutable_direct_response()->set_status(200);
+    RouteMatch* match = route->mutable_match();
+    switch (i % 4) {
+    case 0:
+      match->set_path(absl::StrCat("/api/v1/resource_", i));
+      break;
+    case 1:
+      match->set_prefix(absl::StrCat("/static/dir_", i, "/"));
+      break;
+    case 2: {
+      envoy::type::matcher::v3::RegexMatcher* regex = match->mutable_safe_regex();
+      regex->mutable_google_re2();
+      regex->set_regex(absl::StrCat("^/users/[0-9]+/item_", i, "$"));
+      break;
+    }
+    default:
+      match->set_path_separated_prefix(absl::StrCat("/svc_", i));
+      break;
+    }
+  }
+  return route_config;
+}
+
+/**
+ * Measure route selection against a large mixed route table, where the request matches the last
+ * exact path route. The second argument selects whether the route index is used (1) or all routes
+ * are scanned linearly (0).
+ */
+static void bmRouteTableSizeWithMixedMatch(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.router_route_index", state.range(1) ? "true" : "false"}});
+
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+
+  const int num_routes = state.range(0);
+  std::shared_ptr<ConfigImpl> config =
+      *ConfigImpl::create(genMixedRouteConfig(num_routes), factory_context,
+                          ProtobufMessage::getNullValidationVisitor(), true);
+  const int last_exact_route = (num_routes - 1) / 4 * 4;
+  Http::TestRequestHeaderMapImpl headers{
+      {":authority", "www.google.com"},
+      {":method", "GET"},
+      {":path", absl::StrCat("/api/v1/resource_", last_exact_route, "?query=1")},
+      {"x-forwarded-proto", "http"}};
+
+  for (auto _ : state) { // NOLINT
+    RELEASE_ASSERT(config->route(headers, stream_info, 0) != nullptr, "");
+  }
+}
+
 BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
@@ -318,6 +389,10 @@ BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 <<
 BENCHMARK(bmRouteTableSizeWithExactMatcherTree)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithPrefixMatcherTree)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 
+BENCHMARK(bmRouteTableSizeWithMixedMatch)
+    ->ArgsProduct({{64, 512, 4096, 16384}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
@@ -1223,6 +1223,123 @@ virtual_hosts:
             config.route(genHeaders("example.com", "/", "GET"), 0)->routeEntry()->clusterName());
 }
 
+// Validates that the route index used for large virtual hosts selects the same routes, in the
+// same first-match order, as a linear scan over the routes.
+TEST_F(RouteMatcherTest, TestRouteIndexPreservesFirstMatch) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: indexed
+  domains: ["*"]
+  routes:
+  - match: { prefix: "/api", headers: [{ name: x-canary, string_match: { exact: "1" } }] }
+    route: { cluster: canary }
+  - match: { path: "/api/v1/users" }
+    route: { cluster: users }
+  - match: { safe_regex: { regex: "^/api/v1/users/[0-9]+$" } }
+    route: { cluster: user_by_id }
+  - match: { prefix: "/api/v1/" }
+    route: { cluster: api_v1 }
+  - match: { path: "/API/V1/ITEMS", case_sensitive: false }
+    route: { cluster: items }
+  - match: { prefix: "/Static/", case_sensitive: false }
+    route: { cluster: static }
+  - match: { path_separated_prefix: "/svc" }
+    route: { cluster: svc }
+  - match: { path: "/api/v1/users" }
+    route: { cluster: unreachable }
+  - match: { prefix: "/api" }
+    route: { cluster: api }
+  - match: { prefix: "" }
+    route: { cluster: default }
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"canary", "users", "user_by_id", "api_v1", "items", "static", "svc", "unreachable", "api",
+       "default"},
+      {});
+
+  const std::vector<std::pair<std::string, std::string>> expectations = {
+      {"/api/v1/users", "users"},
+      {"/api/v1/users?limit=10", "users"},
+      {"/api/v1/users#frag", "users"},
+      {"/api/v1/users/42", "user_by_id"},
+      {"/api/v1/users/abc", "api_v1"},
+      {"/api/v1/items", "api_v1"},
+      {"/Api/V1/Items", "items"},
+      {"/api/v2/items", "api"},
+      {"/STATIC/img.png", "static"},
+      {"/static/img.png", "static"},
+      {"/svc", "svc"},
+      {"/svc/method", "svc"},
+      {"/svcfoo", "default"},
+      {"/apix", "api"},
+      {"/other", "default"},
+      {"/", "default"},
+  };
+
+  for (const bool use_index : {true, false}) {
+    mergeValues(
+        {{"envoy.reloadable_features.router_route_index", use_index ? "true" : "false"}});
+    TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true,
+                          creation_status_);
+    ASSERT_TRUE(creation_status_.ok());
+
+    for (const auto& [path, cluster] : expectations) {
+      EXPECT_EQ(cluster, config.route(genHeaders("www.lyft.com", path, "GET"), 0)
+                             ->routeEntry()
+                             ->clusterName())
+          << path << " use_index=" << use_index;
+    }
+
+    // Header matchers are still evaluated on the candidates.
+    auto headers = genHeaders("www.lyft.com", "/api/v1/users", "GET");
+    headers.addCopy("x-canary", "1");
+    EXPECT_EQ("canary", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+}
+
+TEST_F(RouteMatcherTest, TestRouteIndexIgnoresPathParameters) {
+  const std::string yaml = R"EOF(
+ignore_path_parameters_in_path_matching: true
+virtual_hosts:
+- name: indexed
+  domains: ["*"]
+  routes:
+  - match: { path: "/r0" }
+    route: { cluster: r0 }
+  - match: { path: "/r1" }
+    route: { cluster: r1 }
+  - match: { path: "/r2" }
+    route: { cluster: r2 }
+  - match: { path: "/r3" }
+    route: { cluster: r3 }
+  - match: { path: "/r4" }
+    route: { cluster: r4 }
+  - match: { path: "/r5" }
+    route: { cluster: r5 }
+  - match: { prefix: "/p/" }
+    route: { cluster: p }
+  - match: { prefix: "/" }
+    route: { cluster: default }
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"r0", "r1", "r2", "r3", "r4", "r5", "p", "default"}, {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true,
+                        creation_status_);
+
+  EXPECT_EQ("r3",
+            config.route(genHeaders("www.lyft.com", "/r3;foo=bar", "GET"), 0)
+                ->routeEntry()
+                ->clusterName());
+  EXPECT_EQ("p", config.route(genHeaders("www.lyft.com", "/p/;a?b", "GET"), 0)
+                     ->routeEntry()
+                     ->clusterName());
+  EXPECT_EQ("default", config.route(genHeaders("www.lyft.com", "/r3x;foo=bar", "GET"), 0)
+                           ->routeEntry()
+                           ->clusterName());
+}
+
 TEST_F(RouteMatcherTest, TestRoutesWithInvalidRegex) {
   std::string invalid_route = R"EOF(
 virtual_hosts:
@@ -0,0 +1,89 @@
+#include "source/common/router/route_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+RouteIndex::Candidates candidatesFor(const RouteIndex& index, absl::string_view path) {
+  RouteIndex::Candidates candidates;
+  index.candidates(path, candidates);
+  return candidates;
+}
+
+TEST(RouteIndexTest, Empty) {
+  RouteIndex index;
+  index.finalize();
+  EXPECT_EQ(0, index.size());
+  EXPECT_THAT(candidatesFor(index, "/foo"), IsEmpty());
+}
+
+TEST(RouteIndexTest, CandidatesAreInRouteOrder) {
+  RouteIndex index;
+  index.addPrefix(0, "/foo/bar", true);
+  index.addExactPath(1, "/foo/bar/baz", true);
+  index.addUnindexed(2);
+  index.addPrefix(3, "/foo", true);
+  index.addExactPath(4, "/foo/bar/baz", true);
+  index.addPrefix(5, "/", true);
+  index.addPrefix(6, "/foo", true);
+  index.finalize();
+  EXPECT_EQ(7, index.size());
+
+  EXPECT_THAT(candidatesFor(index, "/foo/bar/baz"), ElementsAre(0, 1, 2, 3, 4, 5, 6));
+  EXPECT_THAT(candidatesFor(index, "/foo/bar/bazz"), ElementsAre(0, 2, 3, 5, 6));
+  EXPECT_THAT(candidatesFor(index, "/foo"), ElementsAre(2, 3, 5, 6));
+  EXPECT_THAT(candidatesFor(index, "/other"), ElementsAre(2, 5));
+  EXPECT_THAT(candidatesFor(index, "other"), ElementsAre(2));
+}
+
+TEST(RouteIndexTest, CaseInsensitive) {
+  RouteIndex index;
+  index.addExactPath(0, "/Foo", false);
+  index.addExactPath(1, "/Foo", true);
+  index.addPrefix(2, "/BAR/", false);
+  index.addPrefix(3, "/BAR/", true);
+  index.finalize();
+
+  EXPECT_THAT(candidatesFor(index, "/Foo"), ElementsAre(0, 1));
+  EXPECT_THAT(candidatesFor(index, "/foo"), ElementsAre(0));
+  EXPECT_THAT(candidatesFor(index, "/FOO"), ElementsAre(0));
+  EXPECT_THAT(candidatesFor(index, "/bar/baz"), ElementsAre(2));
+  EXPECT_THAT(candidatesFor(index, "/BAR/baz"), ElementsAre(2, 3));
+}
+
+TEST(RouteIndexTest, EmptyPrefixMatchesEverything) {
+  RouteIndex index;
+  index.addExactPath(0, "/foo", true);
+  index.addPrefix(1, "", true);
+  index.finalize();
+
+  EXPECT_THAT(candidatesFor(index, "/foo"), ElementsAre(0, 1));
+  EXPECT_THAT(candidatesFor(index, ""), ElementsAre(1));
+  EXPECT_THAT(candidatesFor(index, "anything"), ElementsAre(1));
+}
+
+TEST(RouteIndexTest, RegexRoutes) {
+  RouteIndex index;
+  index.addRegex(0, "/users/[0-9]+");
+  index.addPrefix(1, "/users/", true);
+  index.addRegex(2, "/users/.*");
+  index.addUnindexed(3);
+  index.addRegex(4, "/items/[a-z]+");
+  index.finalize();
+  EXPECT_EQ(5, index.size());
+
+  EXPECT_THAT(candidatesFor(index, "/users/42"), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(candidatesFor(index, "/users/abc"), ElementsAre(1, 2, 3));
+  EXPECT_THAT(candidatesFor(index, "/items/abc"), ElementsAre(3, 4));
+  EXPECT_THAT(candidatesFor(index, "/items/123"), ElementsAre(3));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
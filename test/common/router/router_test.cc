@@ -6982,5 +6982,80 @@ TEST_F(RouterTest, OrcaLoadReportInvalidHeaderValue) {
   response_decoder->decodeHeaders(std::move(response_headers), true);
 }
 
+class TestResponseTimeLbData : public Upstream::HostLbPolicyData {
+public:
+  MOCK_METHOD(void, onResponseTime, (std::chrono::microseconds), (override));
+};
+
+TEST_F(RouterTest, ResponseTimeCallback) {
+  EXPECT_CALL(callbacks_.route_->route_entry_, timeout())
+      .WillOnce(Return(std::chrono::milliseconds(0)));
+  EXPECT_CALL(callbacks_.dispatcher_, createTimer_(_)).Times(0);
+
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  expectNewStreamWithImmediateEncoder(encoder, &response_decoder, Http::Protocol::Http10);
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_->decodeHeaders(headers, true);
+
+  auto host_lb_policy_data = std::make_unique<TestResponseTimeLbData>();
+  auto host_lb_policy_data_raw_ptr = host_lb_policy_data.get();
+  cm_.thread_local_cluster_.conn_pool_.host_->lb_policy_data_ = std::move(host_lb_policy_data);
+
+  // The response time is measured from the end of the request to the end of the response.
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onResponseTime(std::chrono::microseconds(80500)));
+
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), false);
+  test_time_.advanceTimeWait(std::chrono::microseconds(80500));
+  Buffer::OwnedImpl data;
+  response_decoder->decodeData(data, true);
+}
+
+// A request which times out reports how long it waited, so that a host which stops responding does
+// not look idle to latency aware LB policies.
+TEST_F(RouterTest, ResponseTimeCallbackOnTimeout) {
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  expectNewStreamWithImmediateEncoder(encoder, &response_decoder, Http::Protocol::Http10);
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_->decodeHeaders(headers, true);
+
+  auto host_lb_policy_data = std::make_unique<TestResponseTimeLbData>();
+  auto host_lb_policy_data_raw_ptr = host_lb_policy_data.get();
+  cm_.thread_local_cluster_.conn_pool_.host_->lb_policy_data_ = std::move(host_lb_policy_data);
+
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onResponseTime(std::chrono::microseconds(15000)));
+  test_time_.advanceTimeWait(std::chrono::milliseconds(15));
+  response_timeout_->invokeCallback();
+}
+
+// As does a request which is reset by the upstream host.
+TEST_F(RouterTest, ResponseTimeCallbackOnReset) {
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  expectNewStreamWithImmediateEncoder(encoder, &response_decoder, Http::Protocol::Http10);
+  expectResponseTimerCreate();
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_->decodeHeaders(headers, true);
+
+  auto host_lb_policy_data = std::make_unique<TestResponseTimeLbData>();
+  auto host_lb_policy_data_raw_ptr = host_lb_policy_data.get();
+  cm_.thread_local_cluster_.conn_pool_.host_->lb_policy_data_ = std::move(host_lb_policy_data);
+
+  EXPECT_CALL(*host_lb_policy_data_raw_ptr, onResponseTime(std::chrono::microseconds(7000)));
+  test_time_.advanceTimeWait(std::chrono::milliseconds(7));
+  encoder.stream_.resetStream(Http::StreamResetReason::RemoteReset);
+  EXPECT_TRUE(verifyHostUpstreamStats(0, 1));
+}
+
 } // namespace Router
 } // namespace Envoy
@@ -232,7 +232,6 @@ TEST_F(StatNameTest, TestSuccessfulDecode) {
 class StatNameDeathTest : public StatNameTest {
 public:
   void decodeSymbolVec(const SymbolVec& symbol_vec) {
-    Thread::LockGuard lock(table_.lock_);
     for (Symbol symbol : symbol_vec) {
       table_.fromSymbol(symbol);
     }
@@ -532,21 +531,15 @@ TEST_F(StatNameTest, RacingSymbolCreation) {
   access.setReady();
   accesses.Wait();
 
-  // In a perfect world, we could use reader-locks in the SymbolTable
-  // implementation, and there should be zero additional contentions
-  // after latching 'create_contentions' above. And we can definitely
-  // have this world, but this slows down BM_CreateRace in
-  // symbol_table_speed_test.cc, even on a 72-core machine.
+  // Encoding existing symbols only takes the table lock shared, as their
+  // reference counts are bumped atomically. Readers can still contend with a
+  // thread creating or removing a symbol, so there may be additional
+  // contentions after latching 'create_contentions' above.
   //
   // Thus it is better to avoid symbol-table contention by refactoring
   // all stat-creation code to symbolize all stat string elements at
   // construction, as composition does not require a lock.
   //
-  // See this commit
-  // https://github.com/envoyproxy/envoy/pull/5321/commits/ef712d0f5a11ff49831c1935e8a2ef8a0a935bc9
-  // for a working reader-lock implementation, which would pass this EXPECT:
-  //     EXPECT_EQ(create_contentions, mutex_tracer.numContentions());
-  //
   // Note also that we cannot guarantee there *will* be contentions
   // as a machine or OS is free to run all threads serially.
 
@@ -624,6 +617,40 @@ TEST_F(StatNameTest, MutexContentionOnExistingSymbols) {
   }
 }
 
+// Races encoding and freeing of names against decoding, so that symbols are
+// repeatedly released and reused while other threads decode them.
+TEST_F(StatNameTest, ConcurrentEncodeDecodeFree) {
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  const StatName shared = makeStat("shared.prefix.stat");
+
+  constexpr int num_threads = 8;
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(num_threads);
+  ConditionalInitializer start;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([this, i, &start, shared]() {
+      start.wait();
+      for (int count = 0; count < 1000; ++count) {
+        const std::string name =
+            absl::StrCat("shared.prefix.", count % 10, ".thread", i, ".", count % 7);
+        StatNameStorage storage(name, table_);
+        EXPECT_EQ(name, table_.toString(storage.statName()));
+        EXPECT_EQ("shared.prefix.stat", table_.toString(shared));
+        EXPECT_TRUE(table_.lessThan(shared, storage.statName()) ||
+                    table_.lessThan(storage.statName(), shared));
+        storage.free(table_);
+      }
+    }));
+  }
+  start.setReady();
+  for (auto& thread : threads) {
+    thread->join();
+  }
+
+  // Only the symbols of the shared name remain.
+  EXPECT_EQ(3, table_.numSymbols());
+}
+
 TEST_F(StatNameTest, SharedStatNameStorageSetInsertAndFind) {
   StatNameStorageSet set;
   const int iters = 10;
@@ -714,6 +741,25 @@ TEST_F(StatNameTest, RecentLookups) {
   EXPECT_EQ(0, num_calls);
 }
 
+TEST_F(StatNameTest, RecentLookupsCountedWithoutCapacity) {
+  EXPECT_EQ(0, table_.recentLookupCapacity());
+  encodeDecode("direct.stat1");
+  encodeDecode("direct.stat2");
+
+  uint32_t num_calls = 0;
+  EXPECT_EQ(2, table_.getRecentLookups([&num_calls](absl::string_view, uint64_t) { ++num_calls; }));
+  EXPECT_EQ(0, num_calls);
+
+  // Lookups counted before tracking began are retained in the total.
+  table_.setRecentLookupCapacity(10);
+  encodeDecode("direct.stat3");
+  EXPECT_EQ(3, table_.getRecentLookups([&num_calls](absl::string_view, uint64_t) { ++num_calls; }));
+  EXPECT_EQ(1, num_calls);
+
+  table_.clearRecentLookups();
+  EXPECT_EQ(0, table_.getRecentLookups([](absl::string_view, uint64_t) {}));
+}
+
 TEST_F(StatNameTest, StatNameEmptyEquivalent) {
   StatName empty1;
   StatName empty2 = makeStat("");
@@ -13,6 +13,7 @@
 #include "test/common/stats/make_elements_helper.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -213,3 +214,83 @@ static void bmSetStrings(benchmark::State& state) {
   }
 }
 BENCHMARK(bmSetStrings);
+
+// Encodes and frees existing stat names from a single thread. Arg: the number
+// of tokens in each name.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmEncodeExisting(benchmark::State& state) {
+  const int num_tokens = state.range(0);
+  constexpr int num_names = 64;
+
+  Envoy::Stats::SymbolTableImpl table;
+  Envoy::Stats::StatNamePool pool(table);
+  std::vector<std::string> names;
+  for (int i = 0; i < num_names; ++i) {
+    std::vector<std::string> tokens;
+    for (int j = 0; j < num_tokens; ++j) {
+      tokens.push_back(absl::StrCat("token_", j, "_", i % (j + 3)));
+    }
+    names.push_back(absl::StrJoin(tokens, "."));
+    // Hold a reference so the benchmark measures lookups of existing symbols.
+    pool.add(names.back());
+  }
+
+  uint32_t index = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Envoy::Stats::StatNameStorage storage(names[index++ % num_names], table);
+    benchmark::DoNotOptimize(storage.statName().data());
+    storage.free(table);
+  }
+}
+BENCHMARK(bmEncodeExisting)->Arg(1)->Arg(4)->Arg(8);
+
+// Encodes and frees existing stat names from several threads at once. Args:
+// number of threads, and whether each thread uses its own set of names (1) or
+// all threads use the same names (0).
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmEncodeContention(benchmark::State& state) {
+  const int num_threads = state.range(0);
+  const bool distinct_names = state.range(1) != 0;
+  constexpr int names_per_thread = 64;
+  constexpr int encodes_per_thread = 10 * 1000;
+
+  Envoy::Stats::SymbolTableImpl table;
+  Envoy::Stats::StatNamePool pool(table);
+  std::vector<std::vector<std::string>> names(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    for (int j = 0; j < names_per_thread; ++j) {
+      names[i].push_back(absl::StrCat("cluster.service_", distinct_names ? i : 0, ".upstream_rq_",
+                                      j, ".count"));
+      // Hold a reference so the benchmark measures lookups of existing symbols.
+      pool.add(names[i].back());
+    }
+  }
+
+  Envoy::Thread::ThreadFactory& thread_factory = Envoy::Thread::threadFactoryForTest();
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    std::vector<Envoy::Thread::ThreadPtr> threads;
+    threads.reserve(num_threads);
+    Envoy::ConditionalInitializer start;
+    for (int i = 0; i < num_threads; ++i) {
+      threads.push_back(thread_factory.createThread([&start, &table, &names, i]() {
+        start.wait();
+        for (int count = 0; count < encodes_per_thread; ++count) {
+          Envoy::Stats::StatNameStorage storage(names[i][count % names_per_thread], table);
+          benchmark::DoNotOptimize(table.toString(storage.statName()));
+          storage.free(table);
+        }
+      }));
+    }
+    start.setReady();
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads * encodes_per_thread);
+}
+BENCHMARK(bmEncodeContention)
+    ->ArgsProduct({{1, 4, 16}, {0, 1}})
+    ->Unit(::benchmark::kMillisecond)
+    ->UseRealTime();
@@ -13,12 +13,15 @@
 #include "source/common/stats/thread_local_store.h"
 #include "source/common/thread_local/thread_local_impl.h"
 
+#include "test/benchmark/main.h"
+#include "test/common/stats/real_thread_test_base.h"
 #include "test/common/stats/stat_test_utility.h"
 #include "test/mocks/server/server_factory_context.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -86,6 +89,42 @@ private:
   std::vector<std::unique_ptr<Stats::StatNameManagedStorage>> stat_names_;
 };
 
+class HistogramMergePerf : public Stats::ThreadLocalRealThreadsMixin {
+public:
+  HistogramMergePerf(uint32_t num_workers, uint32_t num_histograms)
+      : ThreadLocalRealThreadsMixin(num_workers) {
+    for (uint32_t i = 0; i < num_histograms; ++i) {
+      histogram_names_.push_back(makeStatName(absl::StrCat("histogram.", i)));
+    }
+    // Record into every histogram on every worker, so that each has a TLS histogram per worker as
+    // on a long-running server, and fold those values into the cumulative histograms.
+    recordValues(100);
+    mergeHistograms();
+  }
+
+  // Records a value on every worker into the given percentage of the histograms.
+  void recordValues(uint32_t percent) {
+    runOnAllWorkersBlocking([this, percent]() {
+      for (uint32_t i = 0; i < histogram_names_.size(); ++i) {
+        if (i % 100 < percent) {
+          scope_.histogramFromStatName(histogram_names_[i], Stats::Histogram::Unit::Unspecified)
+              .recordValue(i);
+        }
+      }
+    });
+  }
+
+  void mergeHistograms() {
+    BlockingBarrier blocking_barrier(1);
+    runOnMainBlocking([this, &blocking_barrier]() {
+      store_->mergeHistograms(blocking_barrier.decrementCountFn());
+    });
+  }
+
+private:
+  std::vector<Stats::StatName> histogram_names_;
+};
+
 } // namespace Envoy
 
 // Tests the single-threaded performance of the thread-local-store stats caches
@@ -138,5 +177,26 @@ static void BM_StatsWithTlsAndRejectionsWithoutDot(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTlsAndRejectionsWithoutDot);
 
+// Measures a histogram flush, i.e. swapping the TLS histograms on every worker and merging them
+// into the parent histograms on the main thread, with the given number of workers and the given
+// percentage of histograms recording values during the interval.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HistogramMerge(benchmark::State& state) {
+  const uint32_t num_workers = state.range(0);
+  const uint32_t active_percent = state.range(1);
+  const uint32_t num_histograms = Envoy::benchmark::skipExpensiveBenchmarks() ? 100 : 10000;
+  Envoy::HistogramMergePerf context(num_workers, num_histograms);
+
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    context.recordValues(active_percent);
+    state.ResumeTiming();
+    context.mergeHistograms();
+  }
+}
+BENCHMARK(BM_HistogramMerge)
+    ->ArgsProduct({{1, 4, 16, 48}, {0, 1, 100}})
+    ->Unit(::benchmark::kMillisecond);
+
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
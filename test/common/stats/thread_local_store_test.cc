@@ -36,6 +36,7 @@
 using testing::_;
 using testing::HasSubstr;
 using testing::InSequence;
+using testing::IsEmpty;
 using testing::NiceMock;
 using testing::Ref;
 using testing::Return;
@@ -1819,6 +1820,32 @@ TEST_F(HistogramTest, ParentHistogramBucketSummaryAndDetail) {
   EXPECT_THAT(parent_histogram->detailedIntervalBuckets(), UnorderedElementsAre(Bucket{10, 1, 1}));
 }
 
+// Merging an interval in which nothing was recorded resets the interval histogram but keeps the
+// cumulative values, and later intervals merge new values on top of them.
+TEST_F(HistogramTest, IdleIntervalMerge) {
+  Histogram& histogram = scope_.histogramFromString("histogram", Histogram::Unit::Unspecified);
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(histogram), 10));
+  histogram.recordValue(10);
+  store_->mergeHistograms([]() -> void {});
+  ASSERT_EQ(1, store_->histograms().size());
+  ParentHistogramSharedPtr parent_histogram = store_->histograms()[0];
+  EXPECT_THAT(parent_histogram->detailedIntervalBuckets(), UnorderedElementsAre(Bucket{10, 1, 1}));
+
+  for (int i = 0; i < 2; ++i) {
+    store_->mergeHistograms([]() -> void {});
+    EXPECT_TRUE(parent_histogram->used());
+    EXPECT_THAT(parent_histogram->detailedIntervalBuckets(), IsEmpty());
+    EXPECT_THAT(parent_histogram->detailedTotalBuckets(), UnorderedElementsAre(Bucket{10, 1, 1}));
+  }
+
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(histogram), 20));
+  histogram.recordValue(20);
+  store_->mergeHistograms([]() -> void {});
+  EXPECT_THAT(parent_histogram->detailedIntervalBuckets(), UnorderedElementsAre(Bucket{20, 1, 1}));
+  EXPECT_THAT(parent_histogram->detailedTotalBuckets(),
+              UnorderedElementsAre(Bucket{10, 1, 1}, Bucket{20, 1, 1}));
+}
+
 TEST_F(HistogramTest, ForEachHistogram) {
   std::vector<std::reference_wrapper<Histogram>> histograms;
 
@@ -8,6 +8,7 @@
 #include "test/common/tls/ssl_test_utility.h"
 #include "test/mocks/server/server_factory_context.h"
 #include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
@@ -674,6 +675,79 @@ TEST(DefaultCertValidatorTest, WithVerifyDepth) {
   EXPECT_EQ(X509_STORE_CTX_get_error(store_ctx.get()), X509_V_OK);
 }
 
+TEST(DefaultCertValidatorTest, VerificationCache) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  Event::SimulatedTimeSystem time_system;
+  ON_CALL(context, timeSource()).WillByDefault(testing::ReturnRef(time_system));
+  Stats::TestUtil::TestStore test_store;
+  SslStats stats = generateSslStats(*test_store.rootScope());
+  envoy::config::core::v3::TypedExtensionConfig typed_conf;
+
+  TestCertificateValidationContextConfigPtr test_config =
+      std::make_unique<TestCertificateValidationContextConfig>(
+          typed_conf, false,
+          std::vector<envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher>{},
+          TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+              "{{ test_rundir }}/test/common/tls/test_data/ca_cert.pem")));
+  test_config->setVerificationCache({16, std::chrono::minutes(1)});
+  auto default_validator =
+      std::make_unique<DefaultCertValidator>(test_config.get(), stats, context);
+  SSLContextPtr ssl_ctx = SSL_CTX_new(TLS_method());
+  std::vector<SSL_CTX*> contexts{ssl_ctx.get()};
+  ASSERT_TRUE(default_validator->initializeSslContexts(contexts, false).ok());
+
+  bssl::UniquePtr<STACK_OF(X509)> cert_chain(sk_X509_new_null());
+  ASSERT_TRUE(bssl::PushToStack(
+      cert_chain.get(), readCertFromFile(TestEnvironment::substitute(
+                            "{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem"))));
+  const auto verify = [&](bool is_server) {
+    return default_validator->doVerifyCertChain(*cert_chain, /*callback=*/nullptr,
+                                                /*transport_socket_options=*/nullptr, *ssl_ctx, {},
+                                                is_server, "");
+  };
+
+  ValidationResults results = verify(false);
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, results.status);
+  EXPECT_EQ(Ssl::ClientValidationStatus::Validated, results.detailed_status);
+  EXPECT_EQ(0, stats.verification_cache_hit_.value());
+  EXPECT_EQ(1, stats.verification_cache_miss_.value());
+
+  // The second verification of the chain is answered from the cache.
+  results = verify(false);
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, results.status);
+  EXPECT_EQ(Ssl::ClientValidationStatus::Validated, results.detailed_status);
+  EXPECT_EQ(1, stats.verification_cache_hit_.value());
+  EXPECT_EQ(1, stats.verification_cache_miss_.value());
+
+  // A result for a server chain is not used for a client chain.
+  verify(true);
+  EXPECT_EQ(1, stats.verification_cache_hit_.value());
+  EXPECT_EQ(2, stats.verification_cache_miss_.value());
+
+  // Results expire after the configured time.
+  time_system.advanceTimeWait(std::chrono::minutes(1));
+  verify(false);
+  EXPECT_EQ(1, stats.verification_cache_hit_.value());
+  EXPECT_EQ(3, stats.verification_cache_miss_.value());
+
+  // Failed verifications are not cached.
+  bssl::UniquePtr<STACK_OF(X509)> untrusted_chain(sk_X509_new_null());
+  ASSERT_TRUE(bssl::PushToStack(
+      untrusted_chain.get(),
+      readCertFromFile(TestEnvironment::substitute(
+          "{{ test_rundir }}/test/common/tls/test_data/selfsigned_cert.pem"))));
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(ValidationResults::ValidationStatus::Failed,
+              default_validator
+                  ->doVerifyCertChain(*untrusted_chain, /*callback=*/nullptr,
+                                      /*transport_socket_options=*/nullptr, *ssl_ctx, {}, false,
+                                      "")
+                  .status);
+  }
+  EXPECT_EQ(1, stats.verification_cache_hit_.value());
+  EXPECT_EQ(5, stats.verification_cache_miss_.value());
+}
+
 class MockCertificateValidationContextConfig : public Ssl::CertificateValidationContextConfig {
 public:
   MockCertificateValidationContextConfig() : MockCertificateValidationContextConfig("") {}
@@ -705,9 +779,14 @@ public:
   bool onlyVerifyLeafCertificateCrl() const override { return false; }
   absl::optional<uint32_t> maxVerifyDepth() const override { return absl::nullopt; }
   bool autoSniSanMatch() const override { return false; }
+  const absl::optional<VerificationCacheConfig>& verificationCache() const override {
+    return verification_cache_;
+  }
+  uint32_t asyncVerificationThreads() const override { return 0; }
 
 private:
   std::string s_;
+  absl::optional<VerificationCacheConfig> verification_cache_;
   std::vector<std::string> strs_;
   std::vector<envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher> matchers_;
 };
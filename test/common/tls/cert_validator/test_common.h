@@ -106,6 +106,15 @@ public:
 
   absl::optional<uint32_t> maxVerifyDepth() const override { return max_verify_depth_; }
   bool autoSniSanMatch() const override { return auto_sni_san_match_; }
+  const absl::optional<VerificationCacheConfig>& verificationCache() const override {
+    return verification_cache_;
+  }
+  uint32_t asyncVerificationThreads() const override { return async_verification_threads_; }
+
+  void setVerificationCache(const VerificationCacheConfig& config) {
+    verification_cache_ = config;
+  }
+  void setAsyncVerificationThreads(uint32_t threads) { async_verification_threads_ = threads; }
 
 private:
   bool allow_expired_certificate_{false};
@@ -117,6 +126,8 @@ private:
   const std::string ca_cert_path_{"TEST_CA_CERT_PATH"};
   const absl::optional<uint32_t> max_verify_depth_{absl::nullopt};
   const bool auto_sni_san_match_{false};
+  absl::optional<VerificationCacheConfig> verification_cache_;
+  uint32_t async_verification_threads_{0};
 };
 
 } // namespace Tls
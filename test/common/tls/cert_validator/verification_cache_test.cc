@@ -0,0 +1,91 @@
+#include "source/common/tls/cert_validator/verification_cache.h"
+
+#include "test/common/tls/ssl_test_utility.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+VerificationCache::Key keyOf(uint8_t value) {
+  VerificationCache::Key key{};
+  key[0] = value;
+  return key;
+}
+
+class VerificationCacheTest : public testing::Test {
+protected:
+  SystemTime inOneHour() { return time_system_.systemTime() + std::chrono::hours(1); }
+
+  Event::SimulatedTimeSystem time_system_;
+};
+
+TEST_F(VerificationCacheTest, Key) {
+  bssl::UniquePtr<STACK_OF(X509)> chain1(sk_X509_new_null());
+  ASSERT_TRUE(bssl::PushToStack(
+      chain1.get(), readCertFromFile(TestEnvironment::substitute(
+                        "{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem"))));
+  bssl::UniquePtr<STACK_OF(X509)> chain2(sk_X509_new_null());
+  ASSERT_TRUE(bssl::PushToStack(
+      chain2.get(), readCertFromFile(TestEnvironment::substitute(
+                        "{{ test_rundir }}/test/common/tls/test_data/san_uri_cert.pem"))));
+
+  EXPECT_EQ(VerificationCache::key(*chain1, false), VerificationCache::key(*chain1, false));
+  EXPECT_NE(VerificationCache::key(*chain1, false), VerificationCache::key(*chain1, true));
+  EXPECT_NE(VerificationCache::key(*chain1, false), VerificationCache::key(*chain2, false));
+
+  // The intermediate certificates are part of the key.
+  const VerificationCache::Key leaf_only = VerificationCache::key(*chain1, false);
+  ASSERT_TRUE(bssl::PushToStack(
+      chain1.get(), readCertFromFile(TestEnvironment::substitute(
+                        "{{ test_rundir }}/test/common/tls/test_data/ca_cert.pem"))));
+  EXPECT_NE(leaf_only, VerificationCache::key(*chain1, false));
+}
+
+TEST_F(VerificationCacheTest, Expiry) {
+  VerificationCache cache(16, std::chrono::minutes(10), time_system_);
+  EXPECT_FALSE(cache.lookup(keyOf(1)));
+
+  cache.insert(keyOf(1), inOneHour());
+  // An entry expires when a certificate of the chain does, if that is sooner than the TTL.
+  cache.insert(keyOf(2), time_system_.systemTime() + std::chrono::minutes(5));
+  EXPECT_TRUE(cache.lookup(keyOf(1)));
+  EXPECT_TRUE(cache.lookup(keyOf(2)));
+
+  time_system_.advanceTimeWait(std::chrono::minutes(5));
+  EXPECT_TRUE(cache.lookup(keyOf(1)));
+  EXPECT_FALSE(cache.lookup(keyOf(2)));
+
+  time_system_.advanceTimeWait(std::chrono::minutes(5));
+  EXPECT_FALSE(cache.lookup(keyOf(1)));
+
+  // Inserting an entry again extends it.
+  cache.insert(keyOf(1), inOneHour());
+  time_system_.advanceTimeWait(std::chrono::minutes(9));
+  cache.insert(keyOf(1), inOneHour());
+  time_system_.advanceTimeWait(std::chrono::minutes(9));
+  EXPECT_TRUE(cache.lookup(keyOf(1)));
+}
+
+TEST_F(VerificationCacheTest, LeastRecentlyUsedEviction) {
+  VerificationCache cache(2, std::chrono::minutes(10), time_system_);
+  cache.insert(keyOf(1), inOneHour());
+  cache.insert(keyOf(2), inOneHour());
+  EXPECT_TRUE(cache.lookup(keyOf(1)));
+
+  cache.insert(keyOf(3), inOneHour());
+  EXPECT_TRUE(cache.lookup(keyOf(1)));
+  EXPECT_FALSE(cache.lookup(keyOf(2)));
+  EXPECT_TRUE(cache.lookup(keyOf(3)));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
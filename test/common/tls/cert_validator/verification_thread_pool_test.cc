@@ -0,0 +1,92 @@
+#include <atomic>
+
+#include "source/common/tls/cert_validator/verification_thread_pool.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+TEST(VerificationThreadPoolTest, RunsJobs) {
+  VerificationThreadPool pool(Thread::threadFactoryForTest(), 2);
+  auto group = std::make_shared<VerificationThreadPool::JobGroup>();
+  std::atomic<int> count{0};
+  absl::Notification done;
+  for (int i = 0; i < 10; i++) {
+    pool.post(group, [&count, &done]() {
+      if (++count == 10) {
+        done.Notify();
+      }
+    });
+  }
+  done.WaitForNotification();
+  EXPECT_EQ(10, count);
+}
+
+// cancelAndWait() returns only after the group's running jobs finish.
+TEST(VerificationThreadPoolTest, CancelWaitsForRunningJobs) {
+  VerificationThreadPool pool(Thread::threadFactoryForTest(), 1);
+  auto group = std::make_shared<VerificationThreadPool::JobGroup>();
+  absl::Notification started;
+  absl::Notification release;
+  std::atomic<bool> finished{false};
+  pool.post(group, [&]() {
+    started.Notify();
+    release.WaitForNotification();
+    finished = true;
+  });
+  started.WaitForNotification();
+
+  absl::Notification cancelled;
+  auto canceller = Thread::threadFactoryForTest().createThread([&]() {
+    group->cancelAndWait();
+    EXPECT_TRUE(finished);
+    cancelled.Notify();
+  });
+  EXPECT_FALSE(cancelled.WaitForNotificationWithTimeout(absl::Milliseconds(100)));
+  release.Notify();
+  canceller->join();
+  EXPECT_TRUE(cancelled.HasBeenNotified());
+}
+
+// The jobs of a cancelled group are dropped, while those of other groups still run.
+TEST(VerificationThreadPoolTest, CancelledGroupJobsAreDropped) {
+  VerificationThreadPool pool(Thread::threadFactoryForTest(), 1);
+  auto group = std::make_shared<VerificationThreadPool::JobGroup>();
+  group->cancelAndWait();
+  std::atomic<bool> dropped_job_ran{false};
+  pool.post(group, [&dropped_job_ran]() { dropped_job_ran = true; });
+
+  auto other_group = std::make_shared<VerificationThreadPool::JobGroup>();
+  absl::Notification other_done;
+  pool.post(other_group, [&other_done]() { other_done.Notify(); });
+  // The pool has a single thread which runs jobs in order.
+  other_done.WaitForNotification();
+  EXPECT_FALSE(dropped_job_ran);
+}
+
+TEST(VerificationThreadPoolTest, RegistrySharesPools) {
+  VerificationThreadPoolRegistry registry;
+  auto pool1 = registry.getOrCreate(2, Thread::threadFactoryForTest());
+  auto pool2 = registry.getOrCreate(2, Thread::threadFactoryForTest());
+  auto pool3 = registry.getOrCreate(1, Thread::threadFactoryForTest());
+  EXPECT_EQ(pool1, pool2);
+  EXPECT_NE(pool1, pool3);
+
+  // A pool which is no longer used is replaced.
+  pool1.reset();
+  pool2.reset();
+  EXPECT_NE(nullptr, registry.getOrCreate(2, Thread::threadFactoryForTest()));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,35 @@
+#include <cstdint>
+#include <vector>
+
+#include "source/common/common/hex.h"
+#include "source/common/tls/ktls.h"
+
+#include "gtest/gtest.h"
+#include "openssl/digest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace Ktls {
+namespace {
+
+// The server handshake traffic secret and the key and IV derived from it in the simple 1-RTT
+// handshake of RFC 8448 section 3.
+TEST(KtlsTest, HkdfExpandLabel) {
+  const std::vector<uint8_t> secret =
+      Hex::decode("b67b7d690cc16c4e75e54213cb2d37b4e9c912bcded9105d42befd59d391ad38");
+  std::vector<uint8_t> key(16);
+  ASSERT_TRUE(hkdfExpandLabel(EVP_sha256(), secret, "key", key.data(), key.size()));
+  EXPECT_EQ("3fce516009c21727d0f2e4e86ee403bc", Hex::encode(key));
+  std::vector<uint8_t> iv(12);
+  ASSERT_TRUE(hkdfExpandLabel(EVP_sha256(), secret, "iv", iv.data(), iv.size()));
+  EXPECT_EQ("5d313eb2671276ee13000b30", Hex::encode(iv));
+}
+
+} // namespace
+} // namespace Ktls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
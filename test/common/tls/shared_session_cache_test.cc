@@ -0,0 +1,234 @@
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "source/common/tls/shared_session_cache.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+#if defined(__linux__)
+
+std::vector<uint8_t> bytes(absl::string_view value) { return {value.begin(), value.end()}; }
+
+using KeyName = decltype(SharedSessionCache::TicketKey::name_);
+
+class SharedSessionCacheTest : public testing::Test {
+protected:
+  SharedSessionCacheTest() { config_ = {64, 256, "", std::chrono::seconds(3600)}; }
+
+  std::shared_ptr<SharedSessionCache> create() {
+    auto cache_or_error = SharedSessionCache::create(config_, time_system_);
+    EXPECT_TRUE(cache_or_error.ok()) << cache_or_error.status();
+    return cache_or_error.ok() ? cache_or_error.value() : nullptr;
+  }
+
+  SystemTime inOneHour() { return time_system_.systemTime() + std::chrono::hours(1); }
+
+  // The names of the cache's session ticket keys, the current key first.
+  std::vector<KeyName> keyNames(SharedSessionCache& cache,
+                                SharedSessionCache::CachedTicketKeys& cached) {
+    const SharedSessionCache::TicketKeys keys = cache.ticketKeys(cached);
+    std::vector<KeyName> names;
+    for (const SharedSessionCache::TicketKey& key : keys.keys()) {
+      names.push_back(key.name_);
+    }
+    return names;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Ssl::ServerContextConfig::SharedSessionCacheConfig config_;
+};
+
+TEST_F(SharedSessionCacheTest, InsertLookupRemove) {
+  auto cache = create();
+  std::vector<uint8_t> session;
+  EXPECT_FALSE(cache->lookup(bytes("id1"), session));
+
+  EXPECT_TRUE(cache->insert(bytes("id1"), bytes("session1"), inOneHour()));
+  EXPECT_TRUE(cache->insert(bytes("id2"), bytes("session2"), inOneHour()));
+  ASSERT_TRUE(cache->lookup(bytes("id1"), session));
+  EXPECT_EQ(bytes("session1"), session);
+  ASSERT_TRUE(cache->lookup(bytes("id2"), session));
+  EXPECT_EQ(bytes("session2"), session);
+
+  // Inserting with an existing ID replaces the session.
+  EXPECT_TRUE(cache->insert(bytes("id1"), bytes("replaced"), inOneHour()));
+  ASSERT_TRUE(cache->lookup(bytes("id1"), session));
+  EXPECT_EQ(bytes("replaced"), session);
+
+  cache->remove(bytes("id1"));
+  EXPECT_FALSE(cache->lookup(bytes("id1"), session));
+  EXPECT_TRUE(cache->lookup(bytes("id2"), session));
+}
+
+TEST_F(SharedSessionCacheTest, Expiry) {
+  auto cache = create();
+  EXPECT_TRUE(cache->insert(bytes("id"), bytes("session"), inOneHour()));
+  std::vector<uint8_t> session;
+  time_system_.advanceTimeWait(std::chrono::minutes(59));
+  EXPECT_TRUE(cache->lookup(bytes("id"), session));
+  time_system_.advanceTimeWait(std::chrono::minutes(1));
+  EXPECT_FALSE(cache->lookup(bytes("id"), session));
+}
+
+TEST_F(SharedSessionCacheTest, RejectsOversizedEntries) {
+  auto cache = create();
+  EXPECT_TRUE(cache->insert(bytes("id"), std::vector<uint8_t>(256), inOneHour()));
+  EXPECT_FALSE(cache->insert(bytes("id"), std::vector<uint8_t>(257), inOneHour()));
+  EXPECT_FALSE(cache->insert(std::vector<uint8_t>(33, 'a'), bytes("session"), inOneHour()));
+  EXPECT_FALSE(cache->insert({}, bytes("session"), inOneHour()));
+}
+
+// The cache holds at most max_sessions (rounded up to fill the shards) sessions, and keeps the
+// most recently used ones.
+TEST_F(SharedSessionCacheTest, BoundedSize) {
+  auto cache = create();
+  cache->insert(bytes("recent"), bytes("session"), inOneHour());
+  std::vector<uint8_t> session;
+  for (int i = 0; i < 1000; i++) {
+    cache->insert(bytes(absl::StrCat("id", i)), bytes("session"), inOneHour());
+    ASSERT_TRUE(cache->lookup(bytes("recent"), session));
+  }
+  int found = 0;
+  for (int i = 0; i < 1000; i++) {
+    found += cache->lookup(bytes(absl::StrCat("id", i)), session);
+  }
+  EXPECT_GT(found, 0);
+  EXPECT_LE(found, 128);
+}
+
+TEST_F(SharedSessionCacheTest, TicketKeyRotation) {
+  auto cache = create();
+  SharedSessionCache::CachedTicketKeys cached;
+  const auto keys1 = keyNames(*cache, cached);
+  ASSERT_EQ(1, keys1.size());
+  EXPECT_EQ(keys1, keyNames(*cache, cached));
+
+  time_system_.advanceTimeWait(std::chrono::hours(1));
+  const auto keys2 = keyNames(*cache, cached);
+  ASSERT_EQ(2, keys2.size());
+  EXPECT_NE(keys1[0], keys2[0]);
+  EXPECT_EQ(keys1[0], keys2[1]);
+
+  time_system_.advanceTimeWait(std::chrono::hours(1));
+  const auto keys3 = keyNames(*cache, cached);
+  ASSERT_EQ(3, keys3.size());
+  EXPECT_EQ(keys2[0], keys3[1]);
+  EXPECT_EQ(keys1[0], keys3[2]);
+
+  // The first key is dropped two intervals after it was replaced.
+  time_system_.advanceTimeWait(std::chrono::hours(1));
+  const auto keys4 = keyNames(*cache, cached);
+  ASSERT_EQ(3, keys4.size());
+  EXPECT_EQ(keys2[0], keys4[2]);
+
+  // Keys which were replaced too long ago are all dropped.
+  time_system_.advanceTimeWait(std::chrono::hours(10));
+  EXPECT_EQ(1, keyNames(*cache, cached).size());
+}
+
+// A copy of the keys which has not been refreshed since the keys were rotated through another
+// copy is refreshed.
+TEST_F(SharedSessionCacheTest, CachedTicketKeysFollowRotation) {
+  auto cache = create();
+  SharedSessionCache::CachedTicketKeys cached1;
+  SharedSessionCache::CachedTicketKeys cached2;
+  const auto keys1 = keyNames(*cache, cached1);
+  EXPECT_EQ(keys1, keyNames(*cache, cached2));
+
+  time_system_.advanceTimeWait(std::chrono::hours(1));
+  const auto keys2 = keyNames(*cache, cached2);
+  ASSERT_EQ(2, keys2.size());
+  EXPECT_EQ(keys2, keyNames(*cache, cached1));
+}
+
+TEST_F(SharedSessionCacheTest, SharedThroughFile) {
+  config_.path_ = TestEnvironment::temporaryPath("shared_session_cache_test");
+  ::unlink(config_.path_.c_str());
+  auto cache1 = create();
+  auto cache2 = create();
+  EXPECT_TRUE(cache1->insert(bytes("id"), bytes("session"), inOneHour()));
+  std::vector<uint8_t> session;
+  ASSERT_TRUE(cache2->lookup(bytes("id"), session));
+  EXPECT_EQ(bytes("session"), session);
+  SharedSessionCache::CachedTicketKeys cached1;
+  SharedSessionCache::CachedTicketKeys cached2;
+  SharedSessionCache::CachedTicketKeys cached3;
+  const auto names = keyNames(*cache1, cached1);
+  EXPECT_EQ(names, keyNames(*cache2, cached2));
+
+  // The sessions and keys survive the caches being closed, e.g. for a hot restart.
+  cache1.reset();
+  cache2.reset();
+  auto cache3 = create();
+  EXPECT_TRUE(cache3->lookup(bytes("id"), session));
+  EXPECT_EQ(names, keyNames(*cache3, cached3));
+
+  // A file created with a different configuration is not used.
+  config_.max_session_size_ = 512;
+  EXPECT_FALSE(SharedSessionCache::create(config_, time_system_).ok());
+  config_.max_session_size_ = 256;
+  config_.ticket_key_rotation_interval_ = std::chrono::seconds(60);
+  EXPECT_FALSE(SharedSessionCache::create(config_, time_system_).ok());
+  ::unlink(config_.path_.c_str());
+}
+
+// The file holds key material, so one which other users could read or write is not used.
+TEST_F(SharedSessionCacheTest, RefusesFileAccessibleByOthers) {
+  config_.path_ = TestEnvironment::temporaryPath("shared_session_cache_test");
+  ::unlink(config_.path_.c_str());
+  ASSERT_NE(nullptr, create());
+
+  ASSERT_EQ(0, ::chmod(config_.path_.c_str(), 0644));
+  const auto cache_or_error = SharedSessionCache::create(config_, time_system_);
+  EXPECT_FALSE(cache_or_error.ok());
+  EXPECT_NE(std::string::npos, cache_or_error.status().message().find("mode 0600"));
+
+  ASSERT_EQ(0, ::chmod(config_.path_.c_str(), 0600));
+  EXPECT_NE(nullptr, create());
+  ::unlink(config_.path_.c_str());
+}
+
+TEST_F(SharedSessionCacheTest, RegistrySharesCaches) {
+  SharedSessionCacheRegistry registry;
+  auto cache1 = registry.getOrCreate(config_, time_system_);
+  auto cache2 = registry.getOrCreate(config_, time_system_);
+  ASSERT_TRUE(cache1.ok());
+  ASSERT_TRUE(cache2.ok());
+  EXPECT_EQ(cache1.value(), cache2.value());
+
+  config_.max_sessions_ = 128;
+  auto cache3 = registry.getOrCreate(config_, time_system_);
+  ASSERT_TRUE(cache3.ok());
+  EXPECT_NE(cache1.value(), cache3.value());
+}
+
+#else
+
+TEST(SharedSessionCacheTest, Unsupported) {
+  Event::SimulatedTimeSystem time_system;
+  const Ssl::ServerContextConfig::SharedSessionCacheConfig config{64, 256, "",
+                                                                  std::chrono::seconds(3600)};
+  EXPECT_FALSE(SharedSessionCache::create(config, time_system).ok());
+}
+
+#endif
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -1,4 +1,5 @@
 #include <cstdint>
+#include <fstream>
 #include <memory>
 #include <string>
 
@@ -1218,6 +1219,8 @@ protected:
                                    const std::string& client_ctx_yaml, bool expect_reuse,
                                    const Network::Address::IpVersion version);
 
+  void testKernelTlsHalfClose(const std::string& tls_version, bool require_kernel_tls);
+
   Network::ListenerPtr createListener(Network::SocketSharedPtr&& socket,
                                       Network::TcpListenerCallbacks& cb, Runtime::Loader& runtime,
                                       const Network::ListenerConfig& listener_config,
@@ -3741,6 +3744,152 @@ TEST_P(SslSocketTest, HalfClose) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+namespace {
+
+// Whether the kernel has the TLS upper layer protocol, without which nothing is offloaded.
+bool kernelTlsAvailable() {
+  std::ifstream available_ulps("/proc/sys/net/ipv4/tcp_available_ulp");
+  std::string ulp;
+  while (available_ulps >> ulp) {
+    if (ulp == "tls") {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+// Sends data and half-closes in both directions on a connection with kernel TLS enabled on both
+// sides, using the given TLS version. If require_kernel_tls is set, the test is skipped without
+// kernel TLS support, and otherwise the connection must be offloaded.
+void SslSocketTest::testKernelTlsHalfClose(const std::string& tls_version,
+                                           bool require_kernel_tls) {
+  if (require_kernel_tls && !kernelTlsAvailable()) {
+    GTEST_SKIP() << "kernel TLS is not available";
+  }
+  const std::string server_ctx_yaml = absl::StrReplaceAll(R"EOF(
+  common_tls_context:
+    enable_kernel_tls: true
+    tls_params:
+      tls_minimum_protocol_version: TLS_VERSION
+      tls_maximum_protocol_version: TLS_VERSION
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+)EOF",
+                                                          {{"TLS_VERSION", tls_version}});
+
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  auto server_cfg = *ServerContextConfigImpl::create(server_tls_context, factory_context_, false);
+  NiceMock<Server::Configuration::MockServerFactoryContext> server_factory_context;
+  ContextManagerImpl manager(server_factory_context);
+  Stats::TestUtil::TestStore server_stats_store;
+  auto server_ssl_socket_factory = *ServerSslSocketFactory::create(
+      std::move(server_cfg), manager, *server_stats_store.rootScope(), std::vector<std::string>{});
+
+  auto socket = std::make_shared<Network::Test::TcpListenSocketImmediateListen>(
+      Network::Test::getCanonicalLoopbackAddress(version_));
+  Network::MockTcpListenerCallbacks listener_callbacks;
+  NiceMock<Network::MockListenerConfig> listener_config;
+  Server::ThreadLocalOverloadStateOptRef overload_state;
+  Network::ListenerPtr listener = createListener(socket, listener_callbacks, runtime_,
+                                                 listener_config, overload_state, *dispatcher_);
+  std::shared_ptr<Network::MockReadFilter> server_read_filter(new Network::MockReadFilter());
+  std::shared_ptr<Network::MockReadFilter> client_read_filter(new Network::MockReadFilter());
+
+  const std::string client_ctx_yaml = absl::StrReplaceAll(R"EOF(
+    common_tls_context:
+      enable_kernel_tls: true
+      tls_params:
+        tls_minimum_protocol_version: TLS_VERSION
+        tls_maximum_protocol_version: TLS_VERSION
+  )EOF",
+                                                          {{"TLS_VERSION", tls_version}});
+
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), tls_context);
+  auto client_cfg = *ClientContextConfigImpl::create(tls_context, factory_context_);
+  Stats::TestUtil::TestStore client_stats_store;
+  auto client_ssl_socket_factory = *ClientSslSocketFactory::create(std::move(client_cfg), manager,
+                                                                   *client_stats_store.rootScope());
+  Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+      socket->connectionInfoProvider().localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory->createTransportSocket(nullptr, nullptr), nullptr, nullptr);
+  client_connection->enableHalfClose(true);
+  client_connection->addReadFilter(client_read_filter);
+  client_connection->connect();
+  Network::MockConnectionCallbacks client_connection_callbacks;
+  client_connection->addConnectionCallbacks(client_connection_callbacks);
+
+  Network::ConnectionPtr server_connection;
+  Network::MockConnectionCallbacks server_connection_callbacks;
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+        server_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory->createDownstreamTransportSocket(),
+            stream_info_);
+        server_connection->enableHalfClose(true);
+        server_connection->addReadFilter(server_read_filter);
+        server_connection->addConnectionCallbacks(server_connection_callbacks);
+        Buffer::OwnedImpl data("hello");
+        server_connection->write(data, true);
+      }));
+  EXPECT_CALL(listener_callbacks, recordConnectionsAcceptedOnSocketEvent(_));
+
+  EXPECT_CALL(*server_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(*client_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(*client_read_filter, onData(BufferStringEqual("hello"), true))
+      .WillOnce(Invoke([&](Buffer::Instance&, bool) -> Network::FilterStatus {
+        Buffer::OwnedImpl buffer("world");
+        client_connection->write(buffer, true);
+        return Network::FilterStatus::Continue;
+      }));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose));
+  EXPECT_CALL(*server_read_filter, onData(BufferStringEqual("world"), true));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // Each side hands the connection to the kernel if the kernel supports kTLS. A TLS 1.3 client
+  // never does, as it may receive session tickets after the handshake.
+  for (Stats::TestUtil::TestStore* store : {&server_stats_store, &client_stats_store}) {
+    EXPECT_EQ(1UL, store->counter("ssl.ktls_enabled").value() +
+                       store->counter("ssl.ktls_unsupported").value());
+    EXPECT_EQ(0UL, store->counter("ssl.ktls_failed").value());
+  }
+  if (tls_version == "TLSv1_3") {
+    EXPECT_EQ(0UL, client_stats_store.counter("ssl.ktls_enabled").value());
+  }
+  if (require_kernel_tls) {
+    EXPECT_EQ(1UL, server_stats_store.counter("ssl.ktls_enabled").value());
+    if (tls_version == "TLSv1_2") {
+      EXPECT_EQ(1UL, client_stats_store.counter("ssl.ktls_enabled").value());
+    }
+  }
+}
+
+// Test that data and half-close are sent and received correctly when kernel TLS is enabled, whether
+// or not the kernel supports it.
+TEST_P(SslSocketTest, KernelTlsHalfClose) { testKernelTlsHalfClose("TLSv1_2", false); }
+
+// As above with TLS 1.3, where only the server hands the connection to the kernel.
+TEST_P(SslSocketTest, KernelTlsHalfCloseTls13) { testKernelTlsHalfClose("TLSv1_3", false); }
+
+// As above, on kernels which support kTLS, where the connections must be offloaded.
+TEST_P(SslSocketTest, KernelTlsOffloaded) { testKernelTlsHalfClose("TLSv1_2", true); }
+
+// With TLS 1.3 the server's session tickets must reach the client before the kernel's records.
+TEST_P(SslSocketTest, KernelTlsOffloadedTls13) { testKernelTlsHalfClose("TLSv1_3", true); }
+
 TEST_P(SslSocketTest, ShutdownWithCloseNotify) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -4311,6 +4460,53 @@ TEST_P(SslSocketTest, TicketSessionResumption) {
                               version_);
 }
 
+#if defined(__linux__)
+// Sessions can be resumed on a different server context when both use a shared session cache, with
+// tickets encrypted with the cache's keys.
+TEST_P(SslSocketTest, TicketSessionResumptionSharedSessionCache) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+  shared_session_cache: {}
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+  )EOF";
+
+  testTicketSessionResumption(server_ctx_yaml, {}, server_ctx_yaml, {}, client_ctx_yaml, true,
+                              version_);
+}
+
+// Sessions can be resumed on a different server context by session ID when both use a shared
+// session cache.
+TEST_P(SslSocketTest, StatefulSessionResumptionSharedSessionCache) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+  disable_stateless_session_resumption: true
+  shared_session_cache: {}
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+  )EOF";
+
+  testTicketSessionResumption(server_ctx_yaml, {}, server_ctx_yaml, {}, client_ctx_yaml, true,
+                              version_);
+}
+#endif
+
 TEST_P(SslSocketTest, TicketSessionResumptionCustomTimeout) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -49,12 +49,12 @@ protected:
   }
 
   void expectAdd(const std::string& cluster_name, const std::string& version = std::string("")) {
-    EXPECT_CALL(cm_, addOrUpdateCluster(WithName(cluster_name), version, false))
+    EXPECT_CALL(cm_, addOrUpdateCluster(WithName(cluster_name), version, false, true))
         .WillOnce(Return(true));
   }
 
   void expectAddToThrow(const std::string& cluster_name, const std::string& exception_msg) {
-    EXPECT_CALL(cm_, addOrUpdateCluster(WithName(cluster_name), _, false))
+    EXPECT_CALL(cm_, addOrUpdateCluster(WithName(cluster_name), _, false, true))
         .WillOnce(Throw(EnvoyException(exception_msg)));
   }
 
@@ -128,6 +128,29 @@ resources:
   EXPECT_EQ("1", cds_->versionInfo());
 }
 
+// Clusters which the cluster manager stores for lazy creation are removed when they are no longer
+// in the update, like created clusters.
+TEST_F(CdsApiImplTest, RemoveLazyClusters) {
+  {
+    InSequence s;
+    setup();
+  }
+
+  ClusterManager::ClusterInfoMaps existing_clusters = makeClusterInfoMaps({"cluster_1"});
+  existing_clusters.lazy_clusters_ = {"cluster_2", "cluster_3"};
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(existing_clusters));
+  EXPECT_CALL(initialized_, ready());
+
+  envoy::config::cluster::v3::Cluster cluster_2;
+  cluster_2.set_name("cluster_2");
+  expectAdd("cluster_2");
+  EXPECT_CALL(cm_, removeCluster("cluster_1", false)).WillOnce(Return(true));
+  EXPECT_CALL(cm_, removeCluster("cluster_3", false)).WillOnce(Return(true));
+
+  const auto decoded_resources = TestUtility::decodeResources({cluster_2});
+  EXPECT_TRUE(cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "").ok());
+}
+
 // Validate onConfigUpdate throws EnvoyException with duplicate clusters.
 TEST_F(CdsApiImplTest, ValidateDuplicateClusters) {
   InSequence s;
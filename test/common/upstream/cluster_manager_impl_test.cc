@@ -662,6 +662,130 @@ TEST_F(ODCDTest, TestMainThreadDiscoveryInProgressDetection) {
       odcds_handle_->requestOnDemandClusterDiscovery("cluster_foo", std::move(cb2), timeout_);
 }
 
+class LazyClusterCreationTest : public ODCDTest {
+public:
+  void SetUp() override {
+    const std::string yaml = R"EOF(
+cluster_manager:
+  lazy_cluster_creation:
+    idle_timeout: 10s
+static_resources:
+  clusters: []
+  )EOF";
+    create(parseBootstrapFromV3Yaml(yaml));
+    odcds_ = MockOdCdsApi::create();
+    odcds_handle_ = cluster_manager_->createOdCdsApiHandle(odcds_);
+  }
+
+  absl::StatusOr<bool> addCdsCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                                     const std::string& version_info) {
+    return cluster_manager_->addOrUpdateCluster(cluster, version_info,
+                                                /*avoid_cds_removal=*/false, /*from_cds=*/true);
+  }
+
+  uint64_t lazyClusters() {
+    return factory_.stats_
+        .gauge("cluster_manager.lazy_clusters", Stats::Gauge::ImportMode::NeverImport)
+        .value();
+  }
+};
+
+// Clusters added via CDS are only stored until they are requested, which creates them without
+// calling into ODCDS.
+TEST_F(LazyClusterCreationTest, ClusterCreatedOnRequest) {
+  EXPECT_TRUE(*addCdsCluster(defaultStaticCluster("cluster_foo"), "v1"));
+  EXPECT_FALSE(*addCdsCluster(defaultStaticCluster("cluster_foo"), "v2"));
+  EXPECT_EQ(1, lazyClusters());
+  EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("cluster_foo"));
+  auto clusters = cluster_manager_->clusters();
+  EXPECT_TRUE(clusters.active_clusters_.empty());
+  EXPECT_TRUE(clusters.warming_clusters_.empty());
+  EXPECT_TRUE(clusters.lazy_clusters_.contains("cluster_foo"));
+  EXPECT_TRUE(clusters.hasCluster("cluster_foo"));
+
+  EXPECT_CALL(*odcds_, updateOnDemand(_)).Times(0);
+  auto handle = odcds_handle_->requestOnDemandClusterDiscovery(
+      "cluster_foo", createCallback(ClusterDiscoveryStatus::Available), timeout_);
+  EXPECT_EQ(callback_call_count_, 1);
+  EXPECT_NE(nullptr, cluster_manager_->getThreadLocalCluster("cluster_foo"));
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.lazy_cluster_created").value());
+  clusters = cluster_manager_->clusters();
+  EXPECT_EQ(1, clusters.active_clusters_.size());
+  EXPECT_TRUE(clusters.lazy_clusters_.empty());
+
+  // A created cluster is updated, and removing it removes its stored config too.
+  auto updated = defaultStaticCluster("cluster_foo");
+  updated.mutable_connect_timeout()->set_seconds(5);
+  EXPECT_TRUE(*addCdsCluster(updated, "v3"));
+  EXPECT_EQ(std::chrono::seconds(5),
+            cluster_manager_->getThreadLocalCluster("cluster_foo")->info()->connectTimeout());
+  EXPECT_TRUE(cluster_manager_->removeCluster("cluster_foo"));
+  EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("cluster_foo"));
+  EXPECT_EQ(0, lazyClusters());
+  EXPECT_FALSE(cluster_manager_->clusters().hasCluster("cluster_foo"));
+}
+
+// Unknown clusters are still discovered via ODCDS, and are created as soon as they arrive.
+TEST_F(LazyClusterCreationTest, UnknownClusterDiscovered) {
+  EXPECT_CALL(*odcds_, updateOnDemand("cluster_foo"));
+  auto handle = odcds_handle_->requestOnDemandClusterDiscovery(
+      "cluster_foo", createCallback(ClusterDiscoveryStatus::Available), timeout_);
+  EXPECT_TRUE(*addCdsCluster(defaultStaticCluster("cluster_foo"), "v1"));
+  EXPECT_EQ(callback_call_count_, 1);
+  EXPECT_EQ(0, lazyClusters());
+}
+
+// Clusters which are not from CDS, such as those added by the dynamic forward proxy, are created
+// and warmed right away.
+TEST_F(LazyClusterCreationTest, NonCdsClusterCreated) {
+  EXPECT_TRUE(*cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_foo"), "v1"));
+  EXPECT_TRUE(*cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_bar"), "v1",
+                                                    /*avoid_cds_removal=*/true));
+  EXPECT_TRUE(*cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_baz"), "v1",
+                                                    /*avoid_cds_removal=*/true,
+                                                    /*from_cds=*/true));
+  EXPECT_EQ(0, lazyClusters());
+  EXPECT_NE(nullptr, cluster_manager_->getThreadLocalCluster("cluster_foo"));
+  EXPECT_NE(nullptr, cluster_manager_->getThreadLocalCluster("cluster_bar"));
+  EXPECT_NE(nullptr, cluster_manager_->getThreadLocalCluster("cluster_baz"));
+  EXPECT_TRUE(cluster_manager_->clusters().lazy_clusters_.empty());
+  EXPECT_EQ(0, factory_.stats_.counter("cluster_manager.lazy_cluster_created").value());
+}
+
+// A created cluster is destroyed once it is idle for a whole timeout, and is created again when it
+// is next requested.
+TEST_F(LazyClusterCreationTest, IdleClusterEvicted) {
+  EXPECT_TRUE(*addCdsCluster(defaultStaticCluster("cluster_foo"), "v1"));
+
+  // Timers are matched to the mocks created last first, and the discovery timer is created first.
+  auto* idle_timer = new Event::MockTimer(&factory_.dispatcher_);
+  new NiceMock<Event::MockTimer>(&factory_.dispatcher_);
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(10000), _)).Times(2);
+  auto handle = odcds_handle_->requestOnDemandClusterDiscovery(
+      "cluster_foo", createCallback(ClusterDiscoveryStatus::Available), timeout_);
+  ThreadLocalCluster* cluster = cluster_manager_->getThreadLocalCluster("cluster_foo");
+  ASSERT_NE(nullptr, cluster);
+
+  // Requests since the timer was enabled keep the cluster.
+  cluster->info()->trafficStats()->upstream_rq_total_.inc();
+  idle_timer->invokeCallback();
+  EXPECT_NE(nullptr, cluster_manager_->getThreadLocalCluster("cluster_foo"));
+
+  idle_timer->invokeCallback();
+  EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("cluster_foo"));
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.lazy_cluster_evicted").value());
+  EXPECT_EQ(0, factory_.stats_.counter("cluster_manager.cluster_removed").value());
+  EXPECT_TRUE(cluster_manager_->clusters().lazy_clusters_.contains("cluster_foo"));
+
+  handle.reset();
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(10000), _));
+  handle = odcds_handle_->requestOnDemandClusterDiscovery(
+      "cluster_foo", createCallback(ClusterDiscoveryStatus::Available), timeout_);
+  EXPECT_EQ(callback_call_count_, 2);
+  EXPECT_NE(nullptr, cluster_manager_->getThreadLocalCluster("cluster_foo"));
+  EXPECT_EQ(2, factory_.stats_.counter("cluster_manager.lazy_cluster_created").value());
+}
+
 class AlpnSocketFactory : public Network::RawBufferSocketFactory {
 public:
   bool supportsAlpn() const override { return true; }
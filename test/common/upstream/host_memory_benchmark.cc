@@ -0,0 +1,164 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/core/v3/base.pb.h"
+
+#include "source/common/common/fmt.h"
+#include "source/common/common/random_generator.h"
+#include "source/common/memory/stats.h"
+#include "source/common/network/utility.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/upstream/upstream_impl.h"
+#include "source/extensions/load_balancing_policies/least_request/least_request_lb.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+constexpr uint32_t NumLocalities = 16;
+
+std::vector<envoy::config::core::v3::Locality> makeLocalities() {
+  std::vector<envoy::config::core::v3::Locality> localities(NumLocalities);
+  for (uint32_t i = 0; i < NumLocalities; i++) {
+    localities[i].set_region("us-east-1");
+    localities[i].set_zone(fmt::format("us-east-1{}", static_cast<char>('a' + i % 4)));
+    localities[i].set_sub_zone(fmt::format("rack-{}", i));
+  }
+  return localities;
+}
+
+// Creates hosts as EDS does, with the addresses resolved before the measurement starts, and
+// reports the bytes allocated per host. The second argument is the percentage of hosts whose stats
+// are used, as they are by load balancing or health checking.
+void benchmarkHostMemory(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t used_percent = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 10000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  Event::SimulatedTimeSystem time_system;
+  std::shared_ptr<MockClusterInfo> info{new NiceMock<MockClusterInfo>()};
+  const std::vector<envoy::config::core::v3::Locality> localities = makeLocalities();
+  std::vector<Network::Address::InstanceConstSharedPtr> addresses;
+  addresses.reserve(num_hosts);
+  for (uint64_t i = 0; i < num_hosts; i++) {
+    addresses.push_back(Network::Utility::parseInternetAddressNoThrow(
+        fmt::format("10.{}.{}.{}", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff), 8080));
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    HostVector hosts;
+    hosts.reserve(num_hosts);
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      hosts.push_back(*HostImpl::create(
+          info, "", addresses[i], nullptr, nullptr, 1, localities[i % NumLocalities],
+          envoy::config::endpoint::v3::Endpoint::HealthCheckConfig::default_instance(), 0,
+          envoy::config::core::v3::UNKNOWN, time_system));
+      if (i % 100 < used_percent) {
+        hosts.back()->stats().rq_total_.inc();
+      }
+    }
+
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory_per_host"] = static_cast<double>(end_mem - start_mem) / num_hosts;
+
+    state.PauseTiming();
+    hosts.clear();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(benchmarkHostMemory)
+    ->Args({1000, 0})
+    ->Args({1000, 100})
+    ->Args({10000, 0})
+    ->Args({10000, 10})
+    ->Args({10000, 100})
+    ->Args({200000, 10})
+    ->Unit(::benchmark::kMillisecond);
+
+// As above, for the hosts of a least request cluster which then picks hosts for a number of
+// requests, given by the second argument. The hosts have different weights, so the load balancer
+// reads the active requests of every host to schedule them, but only the stats of the picked hosts
+// are used.
+void benchmarkLeastRequestHostMemory(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t requests = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 10000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  Event::SimulatedTimeSystem time_system;
+  std::shared_ptr<MockClusterInfo> info{new NiceMock<MockClusterInfo>()};
+  const std::vector<envoy::config::core::v3::Locality> localities = makeLocalities();
+  std::vector<Network::Address::InstanceConstSharedPtr> addresses;
+  addresses.reserve(num_hosts);
+  for (uint64_t i = 0; i < num_hosts; i++) {
+    addresses.push_back(Network::Utility::parseInternetAddressNoThrow(
+        fmt::format("10.{}.{}.{}", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff), 8080));
+  }
+
+  Stats::IsolatedStoreImpl stats_store;
+  ClusterLbStatNames stat_names{stats_store.symbolTable()};
+  ClusterLbStats stats{stat_names, *stats_store.rootScope()};
+  NiceMock<Runtime::MockLoader> runtime;
+  Random::RandomGeneratorImpl random;
+  envoy::config::cluster::v3::Cluster::CommonLbConfig common_config;
+  envoy::config::cluster::v3::Cluster::LeastRequestLbConfig least_request_config;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    auto hosts = std::make_shared<HostVector>();
+    hosts->reserve(num_hosts);
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      hosts->push_back(*HostImpl::create(
+          info, "", addresses[i], nullptr, nullptr, 1 + i % 3, localities[i % NumLocalities],
+          envoy::config::endpoint::v3::Endpoint::HealthCheckConfig::default_instance(), 0,
+          envoy::config::core::v3::UNKNOWN, time_system));
+    }
+    auto priority_set = std::make_unique<PrioritySetImpl>();
+    priority_set->updateHosts(
+        0, HostSetImpl::partitionHosts(hosts, HostsPerLocalityImpl::empty()), {}, *hosts, {}, 0);
+    auto lb = std::make_unique<LeastRequestLoadBalancer>(*priority_set, nullptr, stats, runtime,
+                                                         random, common_config,
+                                                         least_request_config, time_system);
+    for (uint64_t i = 0; i < requests; i++) {
+      // As the router does for each request.
+      lb->chooseHost(nullptr).host->stats().rq_total_.inc();
+    }
+
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory_per_host"] = static_cast<double>(end_mem - start_mem) / num_hosts;
+
+    state.PauseTiming();
+    lb.reset();
+    priority_set.reset();
+    hosts.reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(benchmarkLeastRequestHostMemory)
+    ->Args({1000, 0})
+    ->Args({1000, 100})
+    ->Args({10000, 0})
+    ->Args({10000, 1000})
+    ->Args({200000, 1000})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,110 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/core/v3/base.pb.h"
+
+#include "source/common/common/fmt.h"
+#include "source/common/common/random_generator.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/upstream/upstream_impl.h"
+#include "source/extensions/load_balancing_policies/round_robin/round_robin_lb.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+constexpr uint32_t NumLocalities = 16;
+
+// Measures the cost of an update in which a single host changes health, as after a health check,
+// for a cluster of weighted hosts spread over localities. Each update is partitioned on the
+// "main thread" priority set and then applied to a "worker" priority set with a round robin load
+// balancer, as ClusterManagerImpl does. The second argument selects whether the update is
+// partitioned against the current host set, which reuses the lists the update leaves unchanged,
+// or from copies of the host lists.
+void benchmarkHostHealthUpdate(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const bool incremental = state.range(1) != 0;
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 10000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  Event::SimulatedTimeSystem time_system;
+  std::shared_ptr<MockClusterInfo> info{new NiceMock<MockClusterInfo>()};
+  HostVector hosts;
+  std::vector<HostVector> per_locality(NumLocalities);
+  for (uint64_t i = 0; i < num_hosts; i++) {
+    envoy::config::core::v3::Locality locality;
+    locality.set_zone(fmt::format("zone-{}", i % NumLocalities));
+    hosts.push_back(makeTestHost(
+        info,
+        fmt::format("tcp://10.{}.{}.{}:80", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff),
+        time_system, locality, 1 + i % 3));
+    per_locality[i % NumLocalities].push_back(hosts.back());
+  }
+  const HostVectorConstSharedPtr all_hosts = std::make_shared<const HostVector>(std::move(hosts));
+  const HostsPerLocalityConstSharedPtr hosts_per_locality =
+      std::make_shared<HostsPerLocalityImpl>(std::move(per_locality), false);
+  const LocalityWeightsConstSharedPtr locality_weights =
+      std::make_shared<const LocalityWeights>(NumLocalities, 1);
+
+  PrioritySetImpl main_priority_set;
+  PrioritySetImpl worker_priority_set;
+  main_priority_set.updateHosts(0, HostSetImpl::partitionHosts(all_hosts, hosts_per_locality),
+                                locality_weights, *all_hosts, {}, 0);
+  const HostSet& host_set = *main_priority_set.hostSetsPerPriority()[0];
+  worker_priority_set.updateHosts(0, HostSetImpl::updateHostsParams(host_set), locality_weights,
+                                  *all_hosts, {}, 0);
+
+  Stats::IsolatedStoreImpl stats_store;
+  ClusterLbStatNames stat_names{stats_store.symbolTable()};
+  ClusterLbStats stats{stat_names, *stats_store.rootScope()};
+  NiceMock<Runtime::MockLoader> runtime;
+  Random::RandomGeneratorImpl random;
+  envoy::config::cluster::v3::Cluster::CommonLbConfig common_config;
+  envoy::config::cluster::v3::Cluster::RoundRobinLbConfig round_robin_config;
+  RoundRobinLoadBalancer lb(worker_priority_set, nullptr, stats, runtime, random, common_config,
+                            round_robin_config, time_system);
+
+  uint64_t update = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const HostSharedPtr& host = (*all_hosts)[(update / 2) % num_hosts];
+    if (update++ % 2 == 0) {
+      host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+    } else {
+      host->healthFlagClear(Host::HealthFlag::FAILED_ACTIVE_HC);
+    }
+
+    PrioritySet::UpdateHostsParams params =
+        incremental
+            ? HostSetImpl::partitionHosts(host_set.hostsPtr(), host_set.hostsPerLocalityPtr(),
+                                          host_set)
+            : HostSetImpl::partitionHosts(std::make_shared<const HostVector>(host_set.hosts()),
+                                          host_set.hostsPerLocality().clone());
+    main_priority_set.updateHosts(0, std::move(params), locality_weights, {}, {}, 0);
+    worker_priority_set.updateHosts(0, HostSetImpl::updateHostsParams(host_set), locality_weights,
+                                    {}, {}, 0);
+  }
+}
+BENCHMARK(benchmarkHostHealthUpdate)
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({10000, 0})
+    ->Args({10000, 1})
+    ->Args({100000, 0})
+    ->Args({100000, 1})
+    ->Unit(::benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
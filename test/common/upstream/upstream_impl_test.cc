@@ -1883,6 +1883,60 @@ TEST_F(HostImplTest, HostnameCanaryAndLocality) {
   EXPECT_EQ(1, host->priority());
 }
 
+// Hosts in the same locality share one copy of it.
+TEST_F(HostImplTest, LocalityShared) {
+  MockClusterMockPrioritySet cluster;
+  envoy::config::core::v3::Locality locality;
+  locality.set_region("oceania");
+  locality.set_zone("hello");
+  HostSharedPtr host1 = makeTestHost(cluster.info_, "tcp://10.0.0.1:1234", simTime(), locality);
+  HostSharedPtr host2 = makeTestHost(cluster.info_, "tcp://10.0.0.2:1234", simTime(), locality);
+  locality.set_sub_zone("world");
+  HostSharedPtr host3 = makeTestHost(cluster.info_, "tcp://10.0.0.3:1234", simTime(), locality);
+
+  EXPECT_EQ(&host1->locality(), &host2->locality());
+  EXPECT_EQ(host1->localityZoneStatName().data(), host2->localityZoneStatName().data());
+  EXPECT_NE(&host1->locality(), &host3->locality());
+  EXPECT_EQ("", host1->locality().sub_zone());
+  EXPECT_EQ("world", host3->locality().sub_zone());
+  EXPECT_EQ("hello", cluster.info_->statsScope().symbolTable().toString(
+                         host3->localityZoneStatName()));
+
+  // The locality is still valid once the host it was created for is gone.
+  host1.reset();
+  EXPECT_EQ("hello", host2->locality().zone());
+}
+
+// The stats of a host are allocated when first used, and reading them does not allocate them.
+TEST_F(HostImplTest, StatsAllocatedOnFirstUse) {
+  MockClusterMockPrioritySet cluster;
+  HostSharedPtr host1 = makeTestHost(cluster.info_, "tcp://10.0.0.1:1234", simTime());
+  HostSharedPtr host2 = makeTestHost(cluster.info_, "tcp://10.0.0.2:1234", simTime());
+  for (const auto& [name, counter] : host1->counters()) {
+    EXPECT_EQ(0, counter.get().value()) << name;
+  }
+  for (const auto& [name, gauge] : host1->gauges()) {
+    EXPECT_EQ(0, gauge.get().value()) << name;
+  }
+  EXPECT_EQ(&host1->statsForReading(), &host2->statsForReading());
+
+  host1->stats().rq_total_.inc();
+  host1->stats().cx_active_.inc();
+  EXPECT_EQ(&host1->stats(), &host1->statsForReading());
+  EXPECT_EQ(1, host1->statsForReading().rq_total_.value());
+  EXPECT_EQ(0, host2->statsForReading().rq_total_.value());
+  EXPECT_EQ(1, host1->stats().rq_total_.value());
+  EXPECT_EQ(0, host2->stats().rq_total_.value());
+  EXPECT_EQ(&host1->stats(), &host1->stats());
+  EXPECT_NE(&host1->stats(), &host2->stats());
+  for (const auto& [name, counter] : host1->counters()) {
+    EXPECT_EQ(name == "rq_total" ? 1 : 0, counter.get().value()) << name;
+  }
+  for (const auto& [name, gauge] : host1->gauges()) {
+    EXPECT_EQ(name == "cx_active" ? 1 : 0, gauge.get().value()) << name;
+  }
+}
+
 TEST_F(HostImplTest, CreateConnection) {
   MockClusterMockPrioritySet cluster;
   envoy::config::core::v3::Metadata metadata;
@@ -6367,6 +6421,76 @@ TEST(HostPartitionTest, PartitionHosts) {
   EXPECT_EQ(hosts[5], update_hosts_params.excluded_hosts_per_locality->get()[1][2]);
 }
 
+// Verifies that partitioning against the host set being updated reuses the lists which are
+// unchanged, and matches a full partition for those which changed.
+TEST(HostPartitionTest, PartitionHostsReusesUnchangedLists) {
+  std::shared_ptr<MockClusterInfo> info{new NiceMock<MockClusterInfo>()};
+  auto time_source = std::make_unique<NiceMock<MockTimeSystem>>();
+  envoy::config::core::v3::Locality zone_a;
+  zone_a.set_zone("A");
+  envoy::config::core::v3::Locality zone_b;
+  zone_b.set_zone("B");
+  HostVector hosts{makeTestHost(info, "tcp://127.0.0.1:80", *time_source, zone_a),
+                   makeTestHost(info, "tcp://127.0.0.1:81", *time_source, zone_a),
+                   makeTestHost(info, "tcp://127.0.0.1:82", *time_source, zone_b),
+                   makeTestHost(info, "tcp://127.0.0.1:83", *time_source, zone_b)};
+  hosts[1]->healthFlagSet(Host::HealthFlag::DEGRADED_ACTIVE_HC);
+
+  HostSetImpl host_set(0, false, kDefaultOverProvisioningFactor);
+  host_set.updateHosts(
+      HostSetImpl::partitionHosts(
+          std::make_shared<const HostVector>(hosts),
+          makeHostsPerLocality({{hosts[0], hosts[1]}, {hosts[2], hosts[3]}})),
+      nullptr, hosts, {}, 0);
+
+  // An update with the same hosts reuses every list.
+  {
+    auto params = HostSetImpl::partitionHosts(
+        std::make_shared<const HostVector>(hosts),
+        makeHostsPerLocality({{hosts[0], hosts[1]}, {hosts[2], hosts[3]}}), host_set);
+    EXPECT_EQ(host_set.hostsPtr(), params.hosts);
+    EXPECT_EQ(host_set.hostsPerLocalityPtr(), params.hosts_per_locality);
+    EXPECT_EQ(host_set.healthyHostsPtr(), params.healthy_hosts);
+    EXPECT_EQ(host_set.degradedHostsPtr(), params.degraded_hosts);
+    EXPECT_EQ(host_set.excludedHostsPtr(), params.excluded_hosts);
+    EXPECT_EQ(host_set.healthyHostsPerLocalityPtr(), params.healthy_hosts_per_locality);
+    EXPECT_EQ(host_set.degradedHostsPerLocalityPtr(), params.degraded_hosts_per_locality);
+    EXPECT_EQ(host_set.excludedHostsPerLocalityPtr(), params.excluded_hosts_per_locality);
+  }
+
+  // When a host becomes unhealthy, only the healthy lists are rebuilt.
+  hosts[3]->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  {
+    auto params = HostSetImpl::partitionHosts(host_set.hostsPtr(), host_set.hostsPerLocalityPtr(),
+                                              host_set);
+    EXPECT_EQ(host_set.hostsPtr(), params.hosts);
+    EXPECT_NE(host_set.healthyHostsPtr(), params.healthy_hosts);
+    EXPECT_EQ(host_set.degradedHostsPtr(), params.degraded_hosts);
+    EXPECT_EQ(host_set.excludedHostsPtr(), params.excluded_hosts);
+    EXPECT_NE(host_set.healthyHostsPerLocalityPtr(), params.healthy_hosts_per_locality);
+    EXPECT_EQ(host_set.degradedHostsPerLocalityPtr(), params.degraded_hosts_per_locality);
+    EXPECT_EQ(host_set.excludedHostsPerLocalityPtr(), params.excluded_hosts_per_locality);
+
+    EXPECT_EQ((HostVector{hosts[0], hosts[2]}), params.healthy_hosts->get());
+    const std::vector<HostVector> expected_healthy = {{hosts[0]}, {hosts[2]}};
+    EXPECT_EQ(expected_healthy, params.healthy_hosts_per_locality->get());
+  }
+
+  // Removing a host rebuilds the membership lists and the partitions it was in.
+  {
+    auto params = HostSetImpl::partitionHosts(
+        std::make_shared<const HostVector>(HostVector{hosts[0], hosts[2], hosts[3]}),
+        makeHostsPerLocality({{hosts[0]}, {hosts[2], hosts[3]}}), host_set);
+    EXPECT_NE(host_set.hostsPtr(), params.hosts);
+    EXPECT_NE(host_set.hostsPerLocalityPtr(), params.hosts_per_locality);
+    EXPECT_NE(host_set.degradedHostsPtr(), params.degraded_hosts);
+    EXPECT_EQ(host_set.excludedHostsPtr(), params.excluded_hosts);
+    EXPECT_TRUE(params.degraded_hosts->get().empty());
+    const std::vector<HostVector> expected_degraded = {{}, {}};
+    EXPECT_EQ(expected_degraded, params.degraded_hosts_per_locality->get());
+  }
+}
+
 TEST_F(ClusterInfoImplTest, MaxRequestsPerConnectionValidation) {
   const std::string yaml = R"EOF(
   name: cluster1
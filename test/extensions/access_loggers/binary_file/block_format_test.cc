@@ -0,0 +1,156 @@
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/access_loggers/binary_file/block_format.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+namespace {
+
+std::vector<ColumnSchema> testSchema() {
+  return {{"path", ColumnType::String}, {"code", ColumnType::Integer}};
+}
+
+TEST(BlockFormatTest, RoundTrip) {
+  BlockEncoder encoder(testSchema());
+  encoder.setString(0, "/foo");
+  encoder.setInteger(1, 200);
+  encoder.finishEntry();
+  encoder.setString(0, "/bar");
+  encoder.setNull(1);
+  encoder.finishEntry();
+  encoder.setString(0, "/foo");
+  encoder.setInteger(1, -1);
+  encoder.finishEntry();
+  encoder.setNull(0);
+  encoder.setInteger(1, std::numeric_limits<int64_t>::min());
+  encoder.finishEntry();
+  EXPECT_EQ(4, encoder.entries());
+
+  Buffer::OwnedImpl payload;
+  encoder.finish(payload);
+  EXPECT_EQ(0, encoder.entries());
+
+  const absl::StatusOr<DecodedBlock> block = decodeBlockPayload(payload.toString());
+  ASSERT_TRUE(block.ok()) << block.status();
+  EXPECT_EQ(4, block->entries_);
+  ASSERT_EQ(2, block->columns_.size());
+  EXPECT_EQ("path", block->columns_[0].schema_.name_);
+  EXPECT_EQ(ColumnType::String, block->columns_[0].schema_.type_);
+  EXPECT_EQ((std::vector<absl::optional<std::string>>{"/foo", "/bar", "/foo", absl::nullopt}),
+            block->columns_[0].strings_);
+  EXPECT_EQ("code", block->columns_[1].schema_.name_);
+  EXPECT_EQ(ColumnType::Integer, block->columns_[1].schema_.type_);
+  EXPECT_EQ((std::vector<absl::optional<int64_t>>{200, absl::nullopt, -1,
+                                                  std::numeric_limits<int64_t>::min()}),
+            block->columns_[1].integers_);
+}
+
+// Every int64_t value is told apart from a missing one, across bitmap bytes.
+TEST(BlockFormatTest, ExtremeIntegers) {
+  constexpr int64_t min = std::numeric_limits<int64_t>::min();
+  constexpr int64_t max = std::numeric_limits<int64_t>::max();
+  const std::vector<absl::optional<int64_t>> values{
+      min, max, absl::nullopt, 0, -1, 1, absl::nullopt, min + 1, min, absl::nullopt};
+  BlockEncoder encoder({{"value", ColumnType::Integer}});
+  for (const absl::optional<int64_t>& value : values) {
+    if (value.has_value()) {
+      encoder.setInteger(0, *value);
+    } else {
+      encoder.setNull(0);
+    }
+    encoder.finishEntry();
+  }
+  Buffer::OwnedImpl payload;
+  encoder.finish(payload);
+
+  const absl::StatusOr<DecodedBlock> block = decodeBlockPayload(payload.toString());
+  ASSERT_TRUE(block.ok()) << block.status();
+  EXPECT_EQ(values, block->columns_[0].integers_);
+
+  // A block of missing values only needs their bitmap.
+  for (int i = 0; i < 100; i++) {
+    encoder.setNull(0);
+    encoder.finishEntry();
+  }
+  Buffer::OwnedImpl null_payload;
+  encoder.finish(null_payload);
+  const absl::StatusOr<DecodedBlock> null_block = decodeBlockPayload(null_payload.toString());
+  ASSERT_TRUE(null_block.ok()) << null_block.status();
+  EXPECT_EQ(std::vector<absl::optional<int64_t>>(100), null_block->columns_[0].integers_);
+}
+
+// Values repeated within a block are stored once.
+TEST(BlockFormatTest, DictionaryPerBlock) {
+  const std::string value(1000, 'a');
+  BlockEncoder encoder({{"value", ColumnType::String}});
+  for (int i = 0; i < 100; i++) {
+    encoder.setString(0, value);
+    encoder.finishEntry();
+  }
+  Buffer::OwnedImpl payload;
+  encoder.finish(payload);
+  EXPECT_LT(payload.length(), 2 * value.size());
+
+  // The dictionary starts empty for the next block.
+  encoder.setString(0, "b");
+  encoder.finishEntry();
+  Buffer::OwnedImpl next_payload;
+  encoder.finish(next_payload);
+  const absl::StatusOr<DecodedBlock> block = decodeBlockPayload(next_payload.toString());
+  ASSERT_TRUE(block.ok()) << block.status();
+  EXPECT_EQ((std::vector<absl::optional<std::string>>{"b"}), block->columns_[0].strings_);
+}
+
+TEST(BlockFormatTest, Header) {
+  Buffer::OwnedImpl header;
+  encodeBlockHeader(10, 20, header);
+  ASSERT_EQ(BlockHeaderSize, header.length());
+  const absl::StatusOr<BlockHeader> decoded = decodeBlockHeader(header.toString());
+  ASSERT_TRUE(decoded.ok()) << decoded.status();
+  EXPECT_EQ(10, decoded->compressed_size_);
+  EXPECT_EQ(20, decoded->uncompressed_size_);
+
+  std::string invalid = header.toString();
+  invalid[0] = 'X';
+  EXPECT_EQ("not a binary access log block", decodeBlockHeader(invalid).status().message());
+  invalid = header.toString();
+  invalid[4] = 2;
+  EXPECT_EQ("unsupported format version 2", decodeBlockHeader(invalid).status().message());
+}
+
+TEST(BlockFormatTest, CorruptPayload) {
+  BlockEncoder encoder(testSchema());
+  encoder.setString(0, "/foo");
+  encoder.setInteger(1, 200);
+  encoder.finishEntry();
+  Buffer::OwnedImpl output;
+  encoder.finish(output);
+  const std::string payload = output.toString();
+
+  // Every truncation of the payload is detected.
+  for (size_t length = 0; length < payload.size(); length++) {
+    EXPECT_FALSE(decodeBlockPayload(payload.substr(0, length)).ok()) << length;
+  }
+  EXPECT_EQ("unexpected data after the last column",
+            decodeBlockPayload(payload + "x").status().message());
+
+  // The payload ends with the dictionary index of the string value, then the length of the integer
+  // column data, its bitmap and the two bytes of the integer value.
+  std::string invalid_index = payload;
+  invalid_index[payload.size() - 5] = 2;
+  EXPECT_EQ("column 'path': invalid dictionary index",
+            decodeBlockPayload(invalid_index).status().message());
+}
+
+} // namespace
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
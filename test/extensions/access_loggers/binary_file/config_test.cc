@@ -0,0 +1,190 @@
+#include "envoy/config/accesslog/v3/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/binary_file/v3/binary_file.pb.h"
+
+#include "source/common/access_log/access_log_impl.h"
+#include "source/extensions/access_loggers/binary_file/config.h"
+
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
+#include "test/tools/binary_access_log_decoder/decoder.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+namespace {
+
+constexpr absl::string_view DefaultConfig = R"EOF(
+path: "/foo"
+columns:
+- name: path
+  format: "%REQ(:path)%"
+- name: code
+  format: "%RESPONSE_CODE%"
+- name: missing
+  format: "%REQ(x-missing)%"
+entries_per_block: 3
+)EOF";
+
+class BinaryFileAccessLogTest : public testing::Test {
+public:
+  BinaryFileAccessLogTest() {
+    ON_CALL(*file_, write(_)).WillByDefault(Invoke([this](absl::string_view data) {
+      contents_.append(data);
+    }));
+  }
+
+  void createLogger(absl::string_view yaml) {
+    envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog proto_config;
+    TestUtility::loadFromYaml(std::string(yaml), proto_config);
+    envoy::config::accesslog::v3::AccessLog config;
+    config.mutable_typed_config()->PackFrom(proto_config);
+
+    Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, "/foo"};
+    EXPECT_CALL(context_.server_factory_context_.access_log_manager_, createAccessLog(file_info))
+        .WillOnce(Return(file_));
+    flush_timer_ =
+        new NiceMock<Event::MockTimer>(&context_.server_factory_context_.thread_local_.dispatcher_);
+    logger_ = AccessLog::AccessLogFactory::fromProto(config, context_);
+  }
+
+  void log(absl::string_view path) {
+    request_headers_.setPath(path);
+    logger_->log({&request_headers_}, stream_info_);
+  }
+
+  std::string decode() {
+    const auto blocks = decodeFile(contents_);
+    EXPECT_TRUE(blocks.ok()) << blocks.status();
+    std::string output;
+    if (blocks.ok()) {
+      for (const DecodedBlock& block : blocks.value()) {
+        appendJsonLines(block, output);
+      }
+    }
+    return output;
+  }
+
+  NiceMock<Server::Configuration::MockFactoryContext> context_;
+  std::shared_ptr<NiceMock<AccessLog::MockAccessLogFile>> file_{
+      std::make_shared<NiceMock<AccessLog::MockAccessLogFile>>()};
+  std::string contents_;
+  Event::MockTimer* flush_timer_;
+  AccessLog::InstanceSharedPtr logger_;
+  Http::TestRequestHeaderMapImpl request_headers_{{":method", "GET"}};
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+};
+
+TEST_F(BinaryFileAccessLogTest, WritesFullBlocks) {
+  createLogger(DefaultConfig);
+  stream_info_.setResponseCode(200);
+  log("/a");
+  log("/b");
+  EXPECT_TRUE(contents_.empty());
+  EXPECT_TRUE(flush_timer_->enabled());
+
+  EXPECT_CALL(*flush_timer_, disableTimer());
+  log("/a");
+  EXPECT_EQ("{\"path\":\"/a\",\"code\":200,\"missing\":null}\n"
+            "{\"path\":\"/b\",\"code\":200,\"missing\":null}\n"
+            "{\"path\":\"/a\",\"code\":200,\"missing\":null}\n",
+            decode());
+
+  // The partial block is written when the logger is destroyed.
+  log("/c");
+  logger_.reset();
+  EXPECT_EQ("{\"path\":\"/a\",\"code\":200,\"missing\":null}\n"
+            "{\"path\":\"/b\",\"code\":200,\"missing\":null}\n"
+            "{\"path\":\"/a\",\"code\":200,\"missing\":null}\n"
+            "{\"path\":\"/c\",\"code\":200,\"missing\":null}\n",
+            decode());
+}
+
+TEST_F(BinaryFileAccessLogTest, FlushInterval) {
+  createLogger(R"EOF(
+path: "/foo"
+columns:
+- name: path
+  format: "%REQ(:path)%"
+flush_interval: 5s
+)EOF");
+  EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(5000), _));
+  log("/a");
+  log("/b");
+  EXPECT_TRUE(contents_.empty());
+
+  flush_timer_->invokeCallback();
+  EXPECT_EQ("{\"path\":\"/a\"}\n{\"path\":\"/b\"}\n", decode());
+
+  // The timer starts again with the next entry.
+  EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(5000), _));
+  log("/c");
+  flush_timer_->invokeCallback();
+  EXPECT_EQ("{\"path\":\"/a\"}\n{\"path\":\"/b\"}\n{\"path\":\"/c\"}\n", decode());
+
+  // Nothing is written for an empty block when the logger is destroyed.
+  const std::string written = contents_;
+  logger_.reset();
+  EXPECT_EQ(written, contents_);
+}
+
+TEST_F(BinaryFileAccessLogTest, DuplicateColumnName) {
+  envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog proto_config;
+  TestUtility::loadFromYaml(R"EOF(
+path: "/foo"
+columns:
+- name: path
+  format: "%REQ(:path)%"
+- name: path
+  format: "%RESPONSE_CODE%"
+)EOF",
+                            proto_config);
+  EXPECT_THROW_WITH_MESSAGE(
+      BinaryFileAccessLogFactory().createAccessLogInstance(proto_config, nullptr, context_),
+      EnvoyException, "binary file access log: duplicate column name 'path'");
+}
+
+TEST_F(BinaryFileAccessLogTest, ColumnFormatIsSingleOperator) {
+  envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog proto_config;
+  TestUtility::loadFromYaml(R"EOF(
+path: "/foo"
+columns:
+- name: path
+  format: "path=%REQ(:path)%"
+)EOF",
+                            proto_config);
+  EXPECT_THROW_WITH_MESSAGE(
+      BinaryFileAccessLogFactory().createAccessLogInstance(proto_config, nullptr, context_),
+      EnvoyException,
+      "binary file access log: the format of column 'path' must be a single command operator");
+}
+
+TEST_F(BinaryFileAccessLogTest, ValidateFail) {
+  EXPECT_THROW(BinaryFileAccessLogFactory().createAccessLogInstance(
+                   envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog(),
+                   nullptr, context_),
+               ProtoValidationException);
+}
+
+TEST(BinaryAccessLogDecoderTest, InvalidFiles) {
+  EXPECT_EQ("truncated block header at offset 0", decodeFile("EBAL").status().message());
+  EXPECT_EQ("block at offset 0: not a binary access log block",
+            decodeFile("0123456789abcdef").status().message());
+  EXPECT_EQ("truncated block at offset 0",
+            decodeFile(absl::string_view("EBAL\x01\x10\0\0\0\x10\0\0\0", 13)).status().message());
+  EXPECT_TRUE(decodeFile("").ok());
+}
+
+} // namespace
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -138,6 +138,39 @@ TEST_F(AsyncFileHandleTest, WriteReadClose) {
   close(handle);
 }
 
+TEST_F(AsyncFileHandleTest, ReadMappedRefersToFileAndOutlivesClose) {
+  auto handle = createAnonymousFile();
+  Buffer::OwnedImpl contents(std::string(10000, 'a') + "hello world");
+  ASSERT_OK(handle->write(dispatcher_.get(), contents, 0, [](absl::StatusOr<size_t>) {}));
+  resolveFileActions();
+  absl::StatusOr<Buffer::InstancePtr> read_status, past_end_status;
+  // The range is not page-aligned, and extends past the end of the file.
+  ASSERT_OK(handle->readMapped(dispatcher_.get(), 10000, 100,
+                               [&](absl::StatusOr<Buffer::InstancePtr> status) {
+                                 read_status = std::move(status);
+                               }));
+  resolveFileActions();
+  ASSERT_OK(handle->readMapped(dispatcher_.get(), 20000, 5,
+                               [&](absl::StatusOr<Buffer::InstancePtr> status) {
+                                 past_end_status = std::move(status);
+                               }));
+  resolveFileActions();
+  close(handle);
+  ASSERT_OK(past_end_status);
+  EXPECT_EQ(0, past_end_status.value()->length());
+  ASSERT_OK(read_status);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual("hello world"));
+  auto file_slice = read_status.value()->findFileSlice(1);
+  ASSERT_TRUE(file_slice.has_value());
+  EXPECT_EQ(0, file_slice->first);
+  EXPECT_EQ(10000, file_slice->second.offset_);
+  EXPECT_EQ(11, file_slice->second.len_);
+  // The buffer's file descriptor is still open after the handle was closed.
+  char c;
+  EXPECT_EQ(1, ::pread(file_slice->second.fd_, &c, 1, file_slice->second.offset_ + 6));
+  EXPECT_EQ('w', c);
+}
+
 TEST_F(AsyncFileHandleTest, LinkCreatesNamedFile) {
   auto handle = createAnonymousFile();
   absl::StatusOr<size_t> write_status;
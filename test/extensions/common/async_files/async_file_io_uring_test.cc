@@ -0,0 +1,279 @@
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+#include "source/extensions/common/async_files/async_file_manager_factory.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/status_utility.h"
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+using StatusHelpers::HasStatusCode;
+using StatusHelpers::IsOkAndHolds;
+
+class AsyncFileIoUringTest : public testing::Test {
+public:
+  void SetUp() override {
+    if (!Io::isIoUringSupported()) {
+      GTEST_SKIP() << "io_uring is not supported";
+    }
+    envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+    config.mutable_io_uring()->set_queue_size(4);
+    manager_ = factory_->getAsyncFileManager(config);
+  }
+
+  void resolveFileActions() {
+    manager_->waitForIdle();
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+  void close(AsyncFileHandle& handle) {
+    absl::Status close_result = absl::InternalError("not set");
+    EXPECT_OK(
+        handle->close(dispatcher_.get(), [&](absl::Status status) { close_result = status; }));
+    resolveFileActions();
+    EXPECT_OK(close_result);
+  }
+  AsyncFileHandle createAnonymousFile() {
+    AsyncFileHandle create_result;
+    manager_->createAnonymousFile(
+        dispatcher_.get(), tmpdir_,
+        [&](absl::StatusOr<AsyncFileHandle> result) { create_result = result.value(); });
+    resolveFileActions();
+    return create_result;
+  }
+  std::string makeTmpFile() {
+    char filename[1024];
+    snprintf(filename, sizeof(filename), "%s/async_io_uring_test.XXXXXX", tmpdir_.c_str());
+    Api::OsSysCalls& posix = Api::OsSysCallsSingleton().get();
+    int fd = posix.mkstemp(filename).return_value_;
+    EXPECT_NE(-1, fd);
+    posix.close(fd);
+    return filename;
+  }
+
+  const char* test_tmpdir = std::getenv("TEST_TMPDIR");
+  std::string tmpdir_ = test_tmpdir ? test_tmpdir : "/tmp";
+
+  std::unique_ptr<Singleton::ManagerImpl> singleton_manager_ =
+      std::make_unique<Singleton::ManagerImpl>();
+  std::shared_ptr<AsyncFileManagerFactory> factory_ =
+      AsyncFileManagerFactory::singleton(singleton_manager_.get());
+  std::shared_ptr<AsyncFileManager> manager_;
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+};
+
+TEST_F(AsyncFileIoUringTest, DescribesQueueSize) {
+  EXPECT_EQ("io_uring_queue_size = 4", manager_->describe());
+}
+
+TEST_F(AsyncFileIoUringTest, WriteReadClose) {
+  auto handle = createAnonymousFile();
+  ASSERT_THAT(handle, testing::NotNull());
+  absl::StatusOr<size_t> write_status;
+  Buffer::OwnedImpl hello("hello");
+  ASSERT_OK(handle->write(dispatcher_.get(), hello, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, IsOkAndHolds(5U));
+  absl::StatusOr<Buffer::InstancePtr> read_status;
+  // A read past the end of the file returns what there is.
+  ASSERT_OK(handle->read(dispatcher_.get(), 1, 10, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    read_status = std::move(status);
+  }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual("ello"));
+  close(handle);
+}
+
+TEST_F(AsyncFileIoUringTest, WritesBufferWithManySlices) {
+  auto handle = createAnonymousFile();
+  Buffer::OwnedImpl data;
+  std::string expected;
+  // More slices than fit in a single writev.
+  for (int i = 0; i < 2000; i++) {
+    std::string chunk = absl::StrCat(i, ",");
+    data.appendSliceForTest(chunk);
+    expected += chunk;
+  }
+  absl::StatusOr<size_t> write_status;
+  ASSERT_OK(handle->write(dispatcher_.get(), data, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, IsOkAndHolds(expected.size()));
+  absl::StatusOr<Buffer::InstancePtr> read_status;
+  ASSERT_OK(handle->read(dispatcher_.get(), 0, expected.size(),
+                         [&](absl::StatusOr<Buffer::InstancePtr> status) {
+                           read_status = std::move(status);
+                         }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual(expected));
+  close(handle);
+}
+
+TEST_F(AsyncFileIoUringTest, ManyConcurrentOperationsExceedingQueueSize) {
+  std::vector<AsyncFileHandle> handles(10);
+  for (auto& handle : handles) {
+    manager_->createAnonymousFile(
+        dispatcher_.get(), tmpdir_,
+        [&handle](absl::StatusOr<AsyncFileHandle> result) { handle = result.value(); });
+  }
+  resolveFileActions();
+  int writes_completed = 0;
+  for (auto& handle : handles) {
+    ASSERT_THAT(handle, testing::NotNull());
+    Buffer::OwnedImpl data("hello");
+    ASSERT_OK(handle->write(dispatcher_.get(), data, 0, [&](absl::StatusOr<size_t> status) {
+      EXPECT_THAT(status, IsOkAndHolds(5U));
+      writes_completed++;
+    }));
+  }
+  resolveFileActions();
+  EXPECT_EQ(10, writes_completed);
+  for (auto& handle : handles) {
+    close(handle);
+  }
+}
+
+TEST_F(AsyncFileIoUringTest, LinkCreatesNamedFileAndStatUnlinkWork) {
+  auto handle = createAnonymousFile();
+  Buffer::OwnedImpl data("hello");
+  EXPECT_OK(handle->write(dispatcher_.get(), data, 0, [](absl::StatusOr<size_t>) {}));
+  resolveFileActions();
+  std::string filename = makeTmpFile();
+  Api::OsSysCallsSingleton().get().unlink(filename.c_str());
+  absl::Status link_status = absl::InternalError("not set");
+  EXPECT_OK(handle->createHardLink(dispatcher_.get(), filename,
+                                   [&](absl::Status status) { link_status = status; }));
+  resolveFileActions();
+  ASSERT_OK(link_status);
+  absl::StatusOr<struct stat> handle_stat;
+  EXPECT_OK(handle->stat(dispatcher_.get(), [&](absl::StatusOr<struct stat> result) {
+    handle_stat = std::move(result);
+  }));
+  resolveFileActions();
+  ASSERT_OK(handle_stat);
+  EXPECT_EQ(5, handle_stat.value().st_size);
+  close(handle);
+
+  absl::StatusOr<struct stat> stat_result;
+  manager_->stat(dispatcher_.get(), filename,
+                 [&](absl::StatusOr<struct stat> result) { stat_result = std::move(result); });
+  resolveFileActions();
+  ASSERT_OK(stat_result);
+  EXPECT_EQ(5, stat_result.value().st_size);
+  EXPECT_EQ(handle_stat.value().st_ino, stat_result.value().st_ino);
+  absl::Status unlink_result = absl::InternalError("not set");
+  manager_->unlink(dispatcher_.get(), filename,
+                   [&](absl::Status s) { unlink_result = std::move(s); });
+  resolveFileActions();
+  EXPECT_OK(unlink_result);
+  struct stat s;
+  EXPECT_EQ(-1, ::stat(filename.c_str(), &s));
+}
+
+TEST_F(AsyncFileIoUringTest, OpenExistingReadOnlyFailsOnWrite) {
+  std::string filename = makeTmpFile();
+  absl::StatusOr<AsyncFileHandle> open_result;
+  manager_->openExistingFile(dispatcher_.get(), filename, AsyncFileManager::Mode::ReadOnly,
+                             [&](absl::StatusOr<AsyncFileHandle> r) { open_result = r; });
+  resolveFileActions();
+  ASSERT_OK(open_result);
+  AsyncFileHandle handle = open_result.value();
+  absl::StatusOr<size_t> write_status;
+  Buffer::OwnedImpl buf("hello");
+  EXPECT_OK(handle->write(dispatcher_.get(), buf, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, HasStatusCode(absl::StatusCode::kFailedPrecondition));
+  close(handle);
+  Api::OsSysCallsSingleton().get().unlink(filename.c_str());
+}
+
+TEST_F(AsyncFileIoUringTest, OpenStatAndUnlinkFailForNonexistent) {
+  const std::string filename = absl::StrCat(tmpdir_, "/nonexistent_file");
+  absl::StatusOr<AsyncFileHandle> open_result;
+  manager_->openExistingFile(dispatcher_.get(), filename, AsyncFileManager::Mode::ReadWrite,
+                             [&](absl::StatusOr<AsyncFileHandle> r) { open_result = r; });
+  absl::StatusOr<struct stat> stat_result;
+  manager_->stat(dispatcher_.get(), filename,
+                 [&](absl::StatusOr<struct stat> r) { stat_result = std::move(r); });
+  absl::Status unlink_result;
+  manager_->unlink(dispatcher_.get(), filename,
+                   [&](absl::Status s) { unlink_result = std::move(s); });
+  resolveFileActions();
+  EXPECT_THAT(open_result, HasStatusCode(absl::StatusCode::kNotFound));
+  EXPECT_THAT(stat_result, HasStatusCode(absl::StatusCode::kNotFound));
+  EXPECT_THAT(unlink_result, HasStatusCode(absl::StatusCode::kNotFound));
+}
+
+TEST_F(AsyncFileIoUringTest, TruncateAndDuplicateWork) {
+  auto handle = createAnonymousFile();
+  Buffer::OwnedImpl buf("hello world");
+  EXPECT_OK(handle->write(dispatcher_.get(), buf, 0, [](absl::StatusOr<size_t>) {}));
+  resolveFileActions();
+  absl::Status truncate_status = absl::UnknownError("");
+  EXPECT_OK(handle->truncate(dispatcher_.get(), 5,
+                             [&](absl::Status result) { truncate_status = std::move(result); }));
+  resolveFileActions();
+  EXPECT_OK(truncate_status);
+  absl::StatusOr<AsyncFileHandle> duplicate_status;
+  EXPECT_OK(handle->duplicate(dispatcher_.get(), [&](absl::StatusOr<AsyncFileHandle> status) {
+    duplicate_status = std::move(status);
+  }));
+  resolveFileActions();
+  ASSERT_OK(duplicate_status);
+  AsyncFileHandle dup_file = std::move(duplicate_status.value());
+  close(handle);
+  absl::StatusOr<Buffer::InstancePtr> read_result;
+  EXPECT_OK(dup_file->read(dispatcher_.get(), 0, 11, [&](absl::StatusOr<Buffer::InstancePtr> r) {
+    read_result = std::move(r);
+  }));
+  resolveFileActions();
+  ASSERT_OK(read_result);
+  EXPECT_THAT(*read_result.value(), BufferStringEqual("hello"));
+  close(dup_file);
+}
+
+TEST_F(AsyncFileIoUringTest, CancellingBeforeCompletionPreventsTheCallback) {
+  bool called = false;
+  CancelFunction cancel = manager_->createAnonymousFile(
+      dispatcher_.get(), tmpdir_, [&](absl::StatusOr<AsyncFileHandle>) { called = true; });
+  cancel();
+  // The file, if it was opened before the cancel, is closed by the manager.
+  resolveFileActions();
+  EXPECT_FALSE(called);
+}
+
+TEST_F(AsyncFileIoUringTest, EnqueuingActionAfterCloseReturnsError) {
+  auto handle = createAnonymousFile();
+  close(handle);
+  auto failed_status = handle->close(dispatcher_.get(), [](absl::Status) {});
+  EXPECT_THAT(failed_status, HasStatusCode(absl::StatusCode::kFailedPrecondition));
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -47,6 +47,8 @@ TEST(Coverage, InsertStatusToString) {
   EXPECT_EQ(insertStatusToString(InsertStatus::NoInsertResponseVaryDisallowed),
             "NoInsertResponseVaryDisallowed");
   EXPECT_EQ(insertStatusToString(InsertStatus::NoInsertLookupError), "NoInsertLookupError");
+  EXPECT_EQ(insertStatusToString(InsertStatus::NoInsertRequestCoalesced),
+            "NoInsertRequestCoalesced");
   EXPECT_ENVOY_BUG(insertStatusToString(static_cast<InsertStatus>(99)), "Unexpected InsertStatus");
 }
 
@@ -34,7 +34,12 @@ protected:
   // The filter has to be created as a shared_ptr to enable shared_from_this() which is used in the
   // cache callbacks.
   CacheFilterSharedPtr makeFilter(std::shared_ptr<HttpCache> cache, bool auto_destroy = true) {
-    auto config = std::make_shared<CacheFilterConfig>(config_, context_.server_factory_context_);
+    return makeFilter(makeConfig(), std::move(cache), auto_destroy);
+  }
+
+  // Filters sharing a config share its table of in-flight upstream requests.
+  CacheFilterSharedPtr makeFilter(std::shared_ptr<const CacheFilterConfig> config,
+                                  std::shared_ptr<HttpCache> cache, bool auto_destroy = true) {
     std::shared_ptr<CacheFilter> filter(new CacheFilter(config, cache),
                                         [auto_destroy](CacheFilter* f) {
                                           if (auto_destroy) {
@@ -49,6 +54,23 @@ protected:
     return filter;
   }
 
+  std::shared_ptr<const CacheFilterConfig> makeConfig() {
+    return std::make_shared<CacheFilterConfig>(config_, context_.server_factory_context_, "",
+                                               context_.scope());
+  }
+
+  // Makes a filter for a second request on the same config, with its own decoder callbacks.
+  CacheFilterSharedPtr
+  makeCoalescedFilter(std::shared_ptr<const CacheFilterConfig> config,
+                      NiceMock<Http::MockStreamDecoderFilterCallbacks>& decoder_callbacks) {
+    ON_CALL(decoder_callbacks, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+    CacheFilterSharedPtr filter = makeFilter(std::move(config), simple_cache_);
+    filter->setDecoderFilterCallbacks(decoder_callbacks);
+    EXPECT_EQ(filter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    return filter;
+  }
+
   void SetUp() override {
     context_.server_factory_context_.cluster_manager_.initializeThreadLocalClusters(
         {"fake_cluster"});
@@ -381,6 +403,86 @@ TEST_F(CacheFilterTest, CacheMiss) {
   }
 }
 
+TEST_F(CacheFilterTest, CoalescedRequestReceivesInFlightResponse) {
+  request_headers_.setHost("CoalescedRequestReceivesInFlightResponse");
+  config_.mutable_request_coalescing();
+  std::shared_ptr<const CacheFilterConfig> config = makeConfig();
+  const std::string body = "abc";
+
+  CacheFilterSharedPtr leader = makeFilter(config, simple_cache_);
+  testDecodeRequestMiss(0, leader);
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> follower_callbacks;
+  CacheFilterSharedPtr follower = makeCoalescedFilter(config, follower_callbacks);
+  pumpDispatcher();
+  // The second request waits for the first one's upstream request instead of sending its own.
+  EXPECT_EQ(mock_upstreams_.size(), 1);
+  EXPECT_EQ(config->stats().coalesced_requests_.value(), 1);
+
+  receiveUpstreamHeaders(0, response_headers_, false);
+  receiveUpstreamBody(0, body, true);
+  EXPECT_CALL(follower_callbacks, encodeHeaders_(IsSupersetOfHeaders(response_headers_), false));
+  EXPECT_CALL(follower_callbacks,
+              encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq(body)), true));
+  pumpDispatcher();
+
+  follower->onStreamComplete();
+  EXPECT_EQ(follower_callbacks.stream_info_.filterState()
+                ->getDataReadOnly<CacheFilterLoggingInfo>(CacheFilterLoggingInfo::FilterStateKey)
+                ->insertStatus(),
+            InsertStatus::NoInsertRequestCoalesced);
+  EXPECT_EQ(config->stats().coalescing_fallbacks_.value(), 0);
+  EXPECT_EQ(config->stats().coalescing_timeouts_.value(), 0);
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestFallsBackOnUncacheableResponse) {
+  request_headers_.setHost("CoalescedRequestFallsBackOnUncacheableResponse");
+  response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl, "no-store");
+  config_.mutable_request_coalescing();
+  std::shared_ptr<const CacheFilterConfig> config = makeConfig();
+
+  CacheFilterSharedPtr leader = makeFilter(config, simple_cache_);
+  testDecodeRequestMiss(0, leader);
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> follower_callbacks;
+  CacheFilterSharedPtr follower = makeCoalescedFilter(config, follower_callbacks);
+  pumpDispatcher();
+  EXPECT_EQ(mock_upstreams_.size(), 1);
+
+  // The response can't be shared, so the second request is sent upstream after all.
+  EXPECT_CALL(follower_callbacks, encodeHeaders_).Times(0);
+  receiveUpstreamHeaders(0, response_headers_, true);
+  pumpDispatcher();
+  ASSERT_EQ(mock_upstreams_.size(), 2);
+  EXPECT_THAT(mock_upstreams_headers_sent_[1], testing::Optional(request_headers_));
+  EXPECT_EQ(config->stats().coalesced_requests_.value(), 1);
+  EXPECT_EQ(config->stats().coalescing_fallbacks_.value(), 1);
+}
+
+TEST_F(CacheFilterTest, CoalescedRequestTimesOut) {
+  request_headers_.setHost("CoalescedRequestTimesOut");
+  config_.mutable_request_coalescing()->mutable_wait_timeout()->set_seconds(1);
+  std::shared_ptr<const CacheFilterConfig> config = makeConfig();
+
+  CacheFilterSharedPtr leader = makeFilter(config, simple_cache_);
+  testDecodeRequestMiss(0, leader);
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> follower_callbacks;
+  CacheFilterSharedPtr follower = makeCoalescedFilter(config, follower_callbacks);
+  pumpDispatcher();
+  EXPECT_EQ(mock_upstreams_.size(), 1);
+
+  time_source_.advanceTimeAsync(Seconds(2));
+  pumpDispatcher();
+  ASSERT_EQ(mock_upstreams_.size(), 2);
+  EXPECT_EQ(config->stats().coalescing_timeouts_.value(), 1);
+
+  // The second request no longer receives the first one's response.
+  EXPECT_CALL(follower_callbacks, encodeHeaders_).Times(0);
+  receiveUpstreamHeaders(0, response_headers_, true);
+  pumpDispatcher();
+}
+
 TEST_F(CacheFilterTest, Disabled) {
   request_headers_.setHost("CacheDisabled");
   CacheFilterSharedPtr filter = makeFilter(std::shared_ptr<HttpCache>{});
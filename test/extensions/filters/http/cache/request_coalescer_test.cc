@@ -0,0 +1,173 @@
+#include <string>
+
+#include "source/extensions/filters/http/cache/request_coalescer.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/server/server_factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+using ::testing::_;
+using ::testing::Eq;
+using ::testing::InSequence;
+using ::testing::Optional;
+using ::testing::Pointee;
+
+class MockCoalescedFillCallbacks : public CoalescedFillCallbacks {
+public:
+  MOCK_METHOD(void, onFillHeaders,
+              (Http::ResponseHeaderMapPtr && headers,
+               const absl::optional<std::string>& vary_identifier, bool end_stream));
+  MOCK_METHOD(void, onFillData, (Buffer::Instance & data, bool end_stream));
+  MOCK_METHOD(void, onFillTrailers, (Http::ResponseTrailerMapPtr && trailers));
+  MOCK_METHOD(void, onFillFailed, (CoalescedFillFailure failure));
+};
+
+MATCHER_P(BufferStringEqual, expected, "") { return arg.toString() == expected; }
+
+class RequestCoalescerTest : public ::testing::Test {
+protected:
+  RequestCoalescerTest() {
+    key_.set_host("example.com");
+    key_.set_path("/");
+  }
+
+  void pumpDispatcher() { dispatcher_->run(Event::Dispatcher::RunType::NonBlock); }
+
+  VaryAllowList makeVaryAllowList(absl::string_view header) {
+    envoy::type::matcher::v3::StringMatcher matcher;
+    matcher.set_exact(std::string(header));
+    Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher> matchers;
+    *matchers.Add() = matcher;
+    return {matchers, factory_context_};
+  }
+
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context_;
+  RequestCoalescer coalescer_;
+  Key key_;
+  Http::TestRequestHeaderMapImpl request_headers_{
+      {":path", "/"}, {":method", "GET"}, {":scheme", "https"}, {"accept", "text/html"}};
+  Http::TestResponseHeaderMapImpl response_headers_{{":status", "200"},
+                                                    {"cache-control", "public,max-age=3600"}};
+  VaryAllowList vary_allow_list_ = makeVaryAllowList("accept");
+  MockCoalescedFillCallbacks callbacks_;
+};
+
+TEST_F(RequestCoalescerTest, FollowerReceivesResponse) {
+  EXPECT_EQ(coalescer_.join(key_, *dispatcher_, callbacks_), nullptr);
+  CoalescedFillSharedPtr fill = coalescer_.lead(key_, request_headers_);
+  ASSERT_NE(fill, nullptr);
+  EXPECT_EQ(coalescer_.lead(key_, request_headers_), nullptr);
+  auto subscription = coalescer_.join(key_, *dispatcher_, callbacks_);
+  ASSERT_NE(subscription, nullptr);
+
+  InSequence s;
+  EXPECT_CALL(callbacks_,
+              onFillHeaders(Pointee(IsSupersetOfHeaders(response_headers_)), Eq(absl::nullopt),
+                            false));
+  EXPECT_CALL(callbacks_, onFillData(BufferStringEqual("abc"), false));
+  EXPECT_CALL(callbacks_, onFillData(BufferStringEqual("def"), false));
+  const Http::TestResponseTrailerMapImpl trailers{{"grpc-status", "0"}};
+  EXPECT_CALL(callbacks_, onFillTrailers(Pointee(IsSupersetOfHeaders(trailers))));
+  fill->onHeaders(response_headers_, vary_allow_list_, false);
+  fill->onData(Buffer::OwnedImpl("abc"), false);
+  fill->onData(Buffer::OwnedImpl("def"), false);
+  fill->onTrailers(trailers);
+  // The response has ended, so no more followers can join, and the next miss leads a new fill.
+  EXPECT_EQ(coalescer_.join(key_, *dispatcher_, callbacks_), nullptr);
+  EXPECT_NE(coalescer_.lead(key_, request_headers_), nullptr);
+  pumpDispatcher();
+}
+
+TEST_F(RequestCoalescerTest, LateFollowerCatchesUp) {
+  CoalescedFillSharedPtr fill = coalescer_.lead(key_, request_headers_);
+  fill->onHeaders(response_headers_, vary_allow_list_, false);
+  fill->onData(Buffer::OwnedImpl("abc"), false);
+  fill->onData(Buffer::OwnedImpl("def"), false);
+  auto subscription = coalescer_.join(key_, *dispatcher_, callbacks_);
+  ASSERT_NE(subscription, nullptr);
+
+  InSequence s;
+  EXPECT_CALL(callbacks_, onFillHeaders(_, _, false));
+  EXPECT_CALL(callbacks_, onFillData(BufferStringEqual("abcdef"), false));
+  EXPECT_CALL(callbacks_, onFillData(BufferStringEqual("ghi"), true));
+  fill->onData(Buffer::OwnedImpl("ghi"), true);
+  pumpDispatcher();
+}
+
+TEST_F(RequestCoalescerTest, LargeResponseStopsAcceptingFollowers) {
+  CoalescedFillSharedPtr fill = coalescer_.lead(key_, request_headers_);
+  auto subscription = coalescer_.join(key_, *dispatcher_, callbacks_);
+  fill->onHeaders(response_headers_, vary_allow_list_, false);
+  fill->onData(Buffer::OwnedImpl(std::string(CoalescedFill::MaxReplayBytes, 'a')), false);
+  EXPECT_NE(coalescer_.join(key_, *dispatcher_, callbacks_), nullptr);
+  fill->onData(Buffer::OwnedImpl("b"), false);
+  EXPECT_EQ(coalescer_.join(key_, *dispatcher_, callbacks_), nullptr);
+
+  // Followers that already joined still receive the rest of the response.
+  EXPECT_CALL(callbacks_, onFillHeaders(_, _, false)).Times(2);
+  EXPECT_CALL(callbacks_, onFillData(_, false)).Times(4);
+  EXPECT_CALL(callbacks_, onFillData(BufferStringEqual("c"), true)).Times(2);
+  fill->onData(Buffer::OwnedImpl("c"), true);
+  pumpDispatcher();
+}
+
+TEST_F(RequestCoalescerTest, CancelledFollowerReceivesNothing) {
+  CoalescedFillSharedPtr fill = coalescer_.lead(key_, request_headers_);
+  auto subscription = coalescer_.join(key_, *dispatcher_, callbacks_);
+  fill->onHeaders(response_headers_, vary_allow_list_, false);
+  subscription->cancel();
+  fill->onData(Buffer::OwnedImpl("abc"), true);
+  EXPECT_CALL(callbacks_, onFillHeaders).Times(0);
+  EXPECT_CALL(callbacks_, onFillData).Times(0);
+  pumpDispatcher();
+}
+
+TEST_F(RequestCoalescerTest, FailureReleasesFollowers) {
+  CoalescedFillSharedPtr fill = coalescer_.lead(key_, request_headers_);
+  auto subscription = coalescer_.join(key_, *dispatcher_, callbacks_);
+  fill->onFailed(CoalescedFillFailure::NotShareable);
+  EXPECT_EQ(coalescer_.join(key_, *dispatcher_, callbacks_), nullptr);
+  // Anything after the failure is ignored.
+  fill->onHeaders(response_headers_, vary_allow_list_, true);
+  EXPECT_CALL(callbacks_, onFillFailed(CoalescedFillFailure::NotShareable));
+  EXPECT_CALL(callbacks_, onFillHeaders).Times(0);
+  pumpDispatcher();
+}
+
+TEST_F(RequestCoalescerTest, DroppedFillReleasesFollowers) {
+  CoalescedFillSharedPtr fill = coalescer_.lead(key_, request_headers_);
+  auto subscription = coalescer_.join(key_, *dispatcher_, callbacks_);
+  fill = nullptr;
+  EXPECT_CALL(callbacks_, onFillFailed(CoalescedFillFailure::Reset));
+  pumpDispatcher();
+  EXPECT_NE(coalescer_.lead(key_, request_headers_), nullptr);
+}
+
+TEST_F(RequestCoalescerTest, VaryIdentifierOfLeader) {
+  CoalescedFillSharedPtr fill = coalescer_.lead(key_, request_headers_);
+  auto subscription = coalescer_.join(key_, *dispatcher_, callbacks_);
+  response_headers_.addCopy("vary", "accept");
+  const absl::optional<std::string> expected = VaryHeaderUtils::createVaryIdentifier(
+      vary_allow_list_, VaryHeaderUtils::getVaryValues(response_headers_), request_headers_);
+  ASSERT_TRUE(expected.has_value());
+  EXPECT_CALL(callbacks_, onFillHeaders(_, Optional(*expected), true));
+  fill->onHeaders(response_headers_, vary_allow_list_, true);
+  pumpDispatcher();
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -28,6 +28,7 @@
 #include "test/mocks/upstream/host.h"
 #include "test/mocks/upstream/load_balancer_context.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 
 #include "gmock/gmock.h"
@@ -742,6 +743,237 @@ matcher:
   EXPECT_EQ(output_.front(), "fake_cluster 0 10 1 0 2");
 }
 
+// Datagrams written upstream by a session are batched into sendmmsg() calls, which are made when
+// the batch is full and at the end of the event loop iteration.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamWrites) {
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_packet_writer_config:
+  name: envoy.udp_packet_writer.mmsg
+  typed_config:
+    '@type': type.googleapis.com/envoy.extensions.udp_packet_writer.v3.UdpMmsgBatchWriterFactory
+    max_batch_size: 2
+  )EOF"));
+
+  EXPECT_CALL(os_sys_calls_, supportsMmsg()).WillRepeatedly(Return(true));
+  expectSessionCreate(upstream_address_);
+  auto* flush_cb =
+      new NiceMock<Event::MockSchedulableCallback>(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, _)).Times(3);
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, connect(_))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+
+  std::vector<std::string> sent;
+  auto send_batch = [&sent](os_fd_t, struct mmsghdr* messages, unsigned int count,
+                            int) -> Api::SysCallIntResult {
+    for (unsigned int i = 0; i < count; ++i) {
+      const iovec& iov = messages[i].msg_hdr.msg_iov[0];
+      sent.emplace_back(static_cast<const char*>(iov.iov_base), iov.iov_len);
+      messages[i].msg_len = iov.iov_len;
+    }
+    return {static_cast<int>(count), 0};
+  };
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 2, 0)).WillOnce(Invoke(send_batch));
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 1, 0)).WillOnce(Invoke(send_batch));
+
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_TRUE(flush_cb->enabled_);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "world");
+  EXPECT_TRUE(sent.empty());
+
+  // The batch is full, so it is sent before the third datagram is added.
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "!");
+  EXPECT_EQ((std::vector<std::string>{"hello", "world"}), sent);
+
+  flush_cb->invokeCallback();
+  EXPECT_EQ((std::vector<std::string>{"hello", "world", "!"}), sent);
+  EXPECT_EQ(3, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_datagrams")
+                   ->value());
+  EXPECT_EQ(11, factory_context_.server_factory_context_.cluster_manager_.thread_local_cluster_
+                    .cluster_.info_->traffic_stats_->upstream_cx_tx_bytes_total_.value());
+}
+
+// The datagrams in a failed batch are dropped and counted as send errors.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamWriteError) {
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_packet_writer_config:
+  name: envoy.udp_packet_writer.mmsg
+  typed_config:
+    '@type': type.googleapis.com/envoy.extensions.udp_packet_writer.v3.UdpMmsgBatchWriterFactory
+  )EOF"));
+
+  EXPECT_CALL(os_sys_calls_, supportsMmsg()).WillRepeatedly(Return(true));
+  expectSessionCreate(upstream_address_);
+  auto* flush_cb =
+      new NiceMock<Event::MockSchedulableCallback>(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, _)).Times(2);
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, connect(_))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 2, 0))
+      .WillOnce(Return(Api::SysCallIntResult{-1, SOCKET_ERROR_MSG_SIZE}));
+
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "world");
+  flush_cb->invokeCallback();
+  EXPECT_EQ(2, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_errors")
+                   ->value());
+  EXPECT_EQ(0, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_datagrams")
+                   ->value());
+
+  // Nothing is left to send when the session is destroyed.
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, _, _)).Times(0);
+  filter_.reset();
+}
+
+// When a batch is only partly sent because the socket buffer is full, the datagrams which were sent
+// are counted as sent and the rest as send errors. Datagrams are then dropped until the socket is
+// writable again.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamWriteBlocked) {
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_packet_writer_config:
+  name: envoy.udp_packet_writer.mmsg
+  typed_config:
+    '@type': type.googleapis.com/envoy.extensions.udp_packet_writer.v3.UdpMmsgBatchWriterFactory
+  )EOF"));
+
+  EXPECT_CALL(os_sys_calls_, supportsMmsg()).WillRepeatedly(Return(true));
+  expectSessionCreate(upstream_address_);
+  auto* flush_cb =
+      new NiceMock<Event::MockSchedulableCallback>(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, _)).Times(4);
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, connect(_))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+
+  std::vector<std::string> sent;
+  auto send_one = [&sent](os_fd_t, struct mmsghdr* messages, unsigned int,
+                          int) -> Api::SysCallIntResult {
+    const iovec& iov = messages[0].msg_hdr.msg_iov[0];
+    sent.emplace_back(static_cast<const char*>(iov.iov_base), iov.iov_len);
+    messages[0].msg_len = iov.iov_len;
+    return {1, 0};
+  };
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 2, 0)).WillOnce(Invoke(send_one));
+  EXPECT_CALL(os_sys_calls_, sendmmsg(_, _, 1, 0))
+      .WillOnce(Return(Api::SysCallIntResult{-1, SOCKET_ERROR_AGAIN}))
+      .WillOnce(Invoke(send_one));
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_,
+              enableFileEvents(Event::FileReadyType::Read | Event::FileReadyType::Write));
+
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "world");
+  flush_cb->invokeCallback();
+  EXPECT_EQ((std::vector<std::string>{"hello"}), sent);
+  EXPECT_EQ(1, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_datagrams")
+                   ->value());
+  EXPECT_EQ(1, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_errors")
+                   ->value());
+
+  // The writer stays blocked until the socket is writable.
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "dropped");
+  EXPECT_EQ(2, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_errors")
+                   ->value());
+
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, enableFileEvents(Event::FileReadyType::Read));
+  EXPECT_TRUE(test_sessions_[0].file_event_cb_(Event::FileReadyType::Write).ok());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "again");
+  flush_cb->invokeCallback();
+  EXPECT_EQ((std::vector<std::string>{"hello", "again"}), sent);
+  EXPECT_EQ(2, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_datagrams")
+                   ->value());
+  EXPECT_EQ(10, factory_context_.server_factory_context_.cluster_manager_.thread_local_cluster_
+                    .cluster_.info_->traffic_stats_->upstream_cx_tx_bytes_total_.value());
+}
+
+// GRO is enabled on upstream sockets when it is preferred and supported.
+TEST_F(UdpProxyFilterTest, UpstreamSocketGroOption) {
+  if (!ENVOY_SOCKET_UDP_GRO.hasValue()) {
+    GTEST_SKIP() << "UDP_GRO is not supported on this platform";
+  }
+
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+  )EOF"));
+
+  expectSessionCreate(upstream_address_);
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, supportsUdpGro()).WillOnce(Return(true));
+  test_sessions_[0].expectSetIpTransparentSocketOption();
+  test_sessions_[0].expectWriteToUpstream("hello", 0, nullptr, true);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_EQ(1, test_sessions_[0].sock_opts_[ENVOY_SOCKET_UDP_GRO.level()]
+                                            [ENVOY_SOCKET_UDP_GRO.option()]);
+}
+
+// GRO is not enabled on upstream sockets when the runtime guard is disabled.
+TEST_F(UdpProxyFilterTest, UpstreamSocketGroOptionRuntimeDisabled) {
+  if (!ENVOY_SOCKET_UDP_GRO.hasValue()) {
+    GTEST_SKIP() << "UDP_GRO is not supported on this platform";
+  }
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.udp_proxy_upstream_gro", "false"}});
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+  )EOF"));
+
+  expectSessionCreate(upstream_address_);
+  test_sessions_[0].expectSetIpTransparentSocketOption();
+  test_sessions_[0].expectWriteToUpstream("hello", 0, nullptr, true);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_EQ(0, test_sessions_[0].sock_opts_[ENVOY_SOCKET_UDP_GRO.level()]
+                                            [ENVOY_SOCKET_UDP_GRO.option()]);
+}
+
 // Verify upstream connect error handling.
 TEST_F(UdpProxyFilterTest, ConnectErrorHandling) {
   InSequence s;
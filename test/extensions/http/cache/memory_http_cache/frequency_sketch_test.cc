@@ -0,0 +1,53 @@
+#include "source/common/common/hash.h"
+#include "source/extensions/http/cache/memory_http_cache/frequency_sketch.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+namespace {
+
+uint64_t hashOf(absl::string_view key) { return HashUtil::xxHash64(key); }
+
+TEST(FrequencySketchTest, CountsIncrements) {
+  FrequencySketch sketch(1024);
+  EXPECT_EQ(sketch.frequency(hashOf("a")), 0);
+  for (uint32_t i = 1; i <= 5; ++i) {
+    sketch.increment(hashOf("a"));
+    EXPECT_EQ(sketch.frequency(hashOf("a")), i);
+  }
+  EXPECT_EQ(sketch.frequency(hashOf("b")), 0);
+}
+
+TEST(FrequencySketchTest, SaturatesAtMaxFrequency) {
+  FrequencySketch sketch(1024);
+  for (uint32_t i = 0; i < 2 * FrequencySketch::MaxFrequency; ++i) {
+    sketch.increment(hashOf("a"));
+  }
+  EXPECT_EQ(sketch.frequency(hashOf("a")), FrequencySketch::MaxFrequency);
+}
+
+TEST(FrequencySketchTest, AgesCountsAfterSampleSize) {
+  FrequencySketch sketch(64);
+  for (uint32_t i = 0; i < FrequencySketch::MaxFrequency; ++i) {
+    sketch.increment(hashOf("a"));
+  }
+  // Counting other keys eventually halves every counter, after ten increments per expected entry.
+  int increments = 0;
+  while (sketch.frequency(hashOf("a")) == FrequencySketch::MaxFrequency) {
+    ASSERT_LT(increments, 640);
+    sketch.increment(hashOf(absl::StrCat("other", increments++)));
+  }
+  EXPECT_EQ(sketch.frequency(hashOf("a")), FrequencySketch::MaxFrequency / 2);
+}
+
+} // namespace
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,277 @@
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/http/cache/memory_http_cache/v3/memory_http_cache.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/http/cache/memory_http_cache/memory_http_cache.h"
+
+#include "test/extensions/filters/http/cache/http_cache_implementation_test_common.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+namespace {
+
+ConfigProto makeConfig(ConfigProto::EvictionPolicy eviction_policy) {
+  ConfigProto config;
+  config.set_name("test");
+  config.set_max_cache_size_bytes(64 * 1024 * 1024);
+  config.mutable_shards()->set_value(4);
+  config.set_eviction_policy(eviction_policy);
+  return config;
+}
+
+class MemoryHttpCacheTestDelegate : public HttpCacheTestDelegate {
+public:
+  explicit MemoryHttpCacheTestDelegate(ConfigProto::EvictionPolicy eviction_policy)
+      : cache_(
+            std::make_shared<MemoryHttpCache>(makeConfig(eviction_policy), *store_.rootScope())) {}
+  std::shared_ptr<HttpCache> cache() override { return cache_; }
+  bool validationEnabled() const override { return true; }
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  std::shared_ptr<MemoryHttpCache> cache_;
+};
+
+// For the standard cache tests from http_cache_implementation_test_common.cc
+INSTANTIATE_TEST_SUITE_P(
+    MemoryHttpCacheTest, HttpCacheImplementationTest,
+    testing::Values(
+        []() -> std::unique_ptr<HttpCacheTestDelegate> {
+          return std::make_unique<MemoryHttpCacheTestDelegate>(ConfigProto::W_TINY_LFU);
+        },
+        []() -> std::unique_ptr<HttpCacheTestDelegate> {
+          return std::make_unique<MemoryHttpCacheTestDelegate>(ConfigProto::LRU);
+        }),
+    [](const testing::TestParamInfo<HttpCacheImplementationTest::ParamType>& info) {
+      return info.index == 0 ? "WTinyLfu" : "Lru";
+    });
+
+Key makeKey(absl::string_view path) {
+  Key key;
+  key.set_host("example.com");
+  key.set_path(std::string(path));
+  return key;
+}
+
+CacheEntrySharedPtr makeEntry() {
+  return std::make_shared<const CacheEntry>(
+      CacheEntry{Http::createHeaderMap<Http::ResponseHeaderMapImpl>({}),
+                 {},
+                 std::make_shared<const std::string>(),
+                 nullptr});
+}
+
+class CacheShardTest : public testing::Test {
+protected:
+  void insert(CacheShard& shard, absl::string_view path, uint64_t size) {
+    const Key key = makeKey(path);
+    shard.insert(key, MessageUtil::hash(key), makeEntry(), size);
+  }
+
+  void lookup(CacheShard& shard, absl::string_view path, int times = 1) {
+    const Key key = makeKey(path);
+    for (int i = 0; i < times; ++i) {
+      shard.lookup(key, MessageUtil::hash(key));
+    }
+  }
+
+  bool contains(CacheShard& shard, absl::string_view path) {
+    return shard.find(makeKey(path)) != nullptr;
+  }
+
+  // Fills the main region of a W_TINY_LFU shard of 10000 bytes with entries which have each been
+  // requested twice.
+  void fillWithPopularEntries(CacheShard& shard) {
+    for (int i = 0; i < 9; ++i) {
+      insert(shard, absl::StrCat("/popular", i), 1000);
+      lookup(shard, absl::StrCat("/popular", i), 2);
+    }
+    EXPECT_EQ(shard.sizeBytes(), 9000);
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  MemoryHttpCacheStats stats_{ALL_MEMORY_HTTP_CACHE_STATS(POOL_COUNTER(*store_.rootScope()),
+                                                          POOL_GAUGE(*store_.rootScope()))};
+};
+
+TEST_F(CacheShardTest, LruEvictsLeastRecentlyUsed) {
+  CacheShard shard(1000, ConfigProto::LRU, stats_);
+  insert(shard, "/a", 300);
+  insert(shard, "/b", 300);
+  insert(shard, "/c", 300);
+  lookup(shard, "/a");
+  insert(shard, "/d", 300);
+  EXPECT_TRUE(contains(shard, "/a"));
+  EXPECT_FALSE(contains(shard, "/b"));
+  EXPECT_TRUE(contains(shard, "/c"));
+  EXPECT_TRUE(contains(shard, "/d"));
+  EXPECT_EQ(stats_.evictions_.value(), 1);
+  EXPECT_EQ(stats_.size_bytes_.value(), 900);
+  EXPECT_EQ(stats_.size_count_.value(), 3);
+}
+
+TEST_F(CacheShardTest, ReinsertReplacesEntry) {
+  CacheShard shard(1000, ConfigProto::LRU, stats_);
+  insert(shard, "/a", 300);
+  insert(shard, "/a", 500);
+  EXPECT_EQ(shard.sizeBytes(), 500);
+  EXPECT_EQ(shard.sizeCount(), 1);
+  EXPECT_EQ(stats_.size_bytes_.value(), 500);
+  EXPECT_EQ(stats_.evictions_.value(), 0);
+}
+
+TEST_F(CacheShardTest, TinyLfuRejectsLessFrequentlyRequestedEntry) {
+  CacheShard shard(10000, ConfigProto::W_TINY_LFU, stats_);
+  fillWithPopularEntries(shard);
+  lookup(shard, "/new");
+  insert(shard, "/new", 1000);
+  EXPECT_FALSE(contains(shard, "/new"));
+  for (int i = 0; i < 9; ++i) {
+    EXPECT_TRUE(contains(shard, absl::StrCat("/popular", i)));
+  }
+  EXPECT_EQ(stats_.evictions_.value(), 1);
+  EXPECT_EQ(shard.sizeBytes(), 9000);
+}
+
+TEST_F(CacheShardTest, TinyLfuAdmitsMoreFrequentlyRequestedEntry) {
+  CacheShard shard(10000, ConfigProto::W_TINY_LFU, stats_);
+  fillWithPopularEntries(shard);
+  lookup(shard, "/new", 3);
+  insert(shard, "/new", 1000);
+  EXPECT_TRUE(contains(shard, "/new"));
+  EXPECT_EQ(stats_.evictions_.value(), 1);
+  EXPECT_EQ(shard.sizeBytes(), 9000);
+  EXPECT_EQ(shard.sizeCount(), 9);
+}
+
+TEST_F(CacheShardTest, ReplaceOnlyReplacesExpectedEntry) {
+  CacheShard shard(1000, ConfigProto::W_TINY_LFU, stats_);
+  const Key key = makeKey("/a");
+  insert(shard, "/a", 300);
+  CacheEntrySharedPtr original = shard.find(key);
+  ASSERT_NE(original, nullptr);
+  EXPECT_TRUE(shard.replace(key, *original, makeEntry(), 400));
+  EXPECT_NE(shard.find(key), original);
+  EXPECT_EQ(shard.sizeBytes(), 400);
+  // The entry read first is no longer the current one.
+  EXPECT_FALSE(shard.replace(key, *original, makeEntry(), 400));
+  EXPECT_FALSE(shard.replace(makeKey("/b"), *original, makeEntry(), 400));
+}
+
+class MemoryHttpCacheTest : public testing::Test {
+protected:
+  MemoryHttpCacheTest() {
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setScheme("https");
+    request_headers_.setPath("/");
+    ON_CALL(decoder_callbacks_, dispatcher()).WillByDefault(testing::ReturnRef(*dispatcher_));
+  }
+
+  LookupRequest makeLookupRequest() {
+    return {request_headers_, time_system_.systemTime(), vary_allow_list_};
+  }
+
+  bool insert(absl::string_view body) {
+    return cache_->insert(makeLookupRequest().key(), request_headers_, vary_allow_list_,
+                          Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers_),
+                          {}, std::string(body), nullptr);
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  Stats::IsolatedStoreImpl store_;
+  ConfigProto config_ = makeConfig(ConfigProto::W_TINY_LFU);
+  std::shared_ptr<MemoryHttpCache> cache_;
+  VaryAllowList vary_allow_list_{{}, factory_context_};
+  Http::TestRequestHeaderMapImpl request_headers_;
+  Http::TestResponseHeaderMapImpl response_headers_{{":status", "200"},
+                                                    {"cache-control", "public,max-age=3600"}};
+};
+
+TEST_F(MemoryHttpCacheTest, CountsHitsAndMisses) {
+  cache_ = std::make_shared<MemoryHttpCache>(config_, *store_.rootScope());
+  EXPECT_EQ(cache_->lookup(makeLookupRequest()), nullptr);
+  ASSERT_TRUE(insert("body"));
+  EXPECT_NE(cache_->lookup(makeLookupRequest()), nullptr);
+  EXPECT_EQ(TestUtility::findCounter(store_, "cache.memory.test.misses")->value(), 1);
+  EXPECT_EQ(TestUtility::findCounter(store_, "cache.memory.test.hits")->value(), 1);
+  EXPECT_EQ(TestUtility::findCounter(store_, "cache.memory.test.inserts")->value(), 1);
+  EXPECT_EQ(TestUtility::findGauge(store_, "cache.memory.test.size_count")->value(), 1);
+}
+
+TEST_F(MemoryHttpCacheTest, RejectsEntriesLargerThanLimit) {
+  config_.mutable_max_entry_size_bytes()->set_value(1024);
+  cache_ = std::make_shared<MemoryHttpCache>(config_, *store_.rootScope());
+  EXPECT_FALSE(insert(std::string(1024, 'a')));
+  EXPECT_EQ(cache_->lookup(makeLookupRequest()), nullptr);
+  EXPECT_EQ(TestUtility::findCounter(store_, "cache.memory.test.insert_rejections")->value(), 1);
+  EXPECT_TRUE(insert("small"));
+}
+
+TEST_F(MemoryHttpCacheTest, BodyIsSharedWithCachedEntry) {
+  cache_ = std::make_shared<MemoryHttpCache>(config_, *store_.rootScope());
+  ASSERT_TRUE(insert("0123456789"));
+  CacheEntrySharedPtr entry = cache_->lookup(makeLookupRequest());
+  ASSERT_NE(entry, nullptr);
+
+  LookupContextPtr lookup = cache_->makeLookupContext(makeLookupRequest(), decoder_callbacks_);
+  lookup->getHeaders([](LookupResult&& result, bool end_stream) {
+    EXPECT_EQ(result.cache_entry_status_, CacheEntryStatus::Ok);
+    EXPECT_FALSE(end_stream);
+  });
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  Buffer::InstancePtr body;
+  lookup->getBody(AdjustedByteRange(2, 6), [&body](Buffer::InstancePtr&& data, bool end_stream) {
+    body = std::move(data);
+    EXPECT_FALSE(end_stream);
+  });
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  lookup->onDestroy();
+  lookup.reset();
+
+  ASSERT_NE(body, nullptr);
+  EXPECT_EQ(body->toString(), "2345");
+  EXPECT_EQ(body->frontSlice().mem_, entry->body_->data() + 2);
+}
+
+TEST(Registration, GetCacheFromFactory) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.http.cache.memory_http_cache.v3.MemoryHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  envoy::extensions::filters::http::cache::v3::CacheConfig cache_config;
+  ConfigProto config = makeConfig(ConfigProto::W_TINY_LFU);
+  cache_config.mutable_typed_config()->PackFrom(config);
+  std::shared_ptr<HttpCache> cache = factory->getCache(cache_config, factory_context);
+  EXPECT_EQ(cache->cacheInfo().name_, "envoy.extensions.http.cache.memory_http_cache");
+  // The same name refers to the same cache.
+  EXPECT_EQ(factory->getCache(cache_config, factory_context), cache);
+  // But only if the rest of the config matches.
+  config.set_max_cache_size_bytes(1024);
+  cache_config.mutable_typed_config()->PackFrom(config);
+  EXPECT_THROW_WITH_REGEX(factory->getCache(cache_config, factory_context), EnvoyException,
+                          "mismatched MemoryHttpCacheConfig with same name");
+}
+
+} // namespace
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -47,6 +47,14 @@ public:
   static double slowStartMinWeightPercent(const EdfLoadBalancerBase& edf_lb) {
     return edf_lb.slow_start_min_weight_percent_;
   }
+  static const EdfScheduler<Host>* edfScheduler(EdfLoadBalancerBase& edf_lb,
+                                                const HostsSource& source) {
+    return edf_lb.scheduler_[source].edf_.get();
+  }
+  static const std::vector<uint32_t>& edfSchedulerWeights(EdfLoadBalancerBase& edf_lb,
+                                                          const HostsSource& source) {
+    return edf_lb.scheduler_[source].weights_;
+  }
 };
 
 class TestZoneAwareLoadBalancer : public ZoneAwareLoadBalancerBase {
@@ -78,6 +78,48 @@ BENCHMARK(benchmarkMaglevLoadBalancerBuildTable)
     ->Arg(100)
     ->Arg(200)
     ->Arg(500)
+    ->Arg(5000)
+    ->Unit(::benchmark::kMillisecond);
+
+// Times the table rebuild after replacing churn_percent of the hosts. Alternate iterations swap the
+// same hosts out and back in, so every rebuild sees the same amount of churn.
+void benchmarkMaglevLoadBalancerRebuildOnChurn(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t churn_percent = state.range(1);
+  MaglevTester tester(num_hosts);
+  ASSERT_TRUE(tester.maglev_lb_->initialize().ok());
+
+  const uint64_t num_churned = std::max<uint64_t>(1, num_hosts * churn_percent / 100);
+  HostVector replacements;
+  for (uint64_t i = 0; i < num_churned; i++) {
+    replacements.push_back(makeTestHost(
+        tester.info_, fmt::format("tcp://10.1.{}.{}:6379", i / 256, i % 256), tester.simTime()));
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    HostVector hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+    HostVector removed(hosts.begin(), hosts.begin() + num_churned);
+    hosts.erase(hosts.begin(), hosts.begin() + num_churned);
+    hosts.insert(hosts.end(), replacements.begin(), replacements.end());
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts);
+    HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({hosts});
+    state.ResumeTiming();
+
+    // The load balancer rebuilds its table from the priority update callback.
+    tester.priority_set_.updateHosts(
+        0, HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality), {}, replacements,
+        removed, tester.random_.random(), absl::nullopt);
+
+    state.PauseTiming();
+    replacements = std::move(removed);
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(benchmarkMaglevLoadBalancerRebuildOnChurn)
+    ->Args({500, 1})
+    ->Args({5000, 1})
+    ->Args({5000, 10})
     ->Unit(::benchmark::kMillisecond);
 
 void benchmarkMaglevLoadBalancerHostLoss(::benchmark::State& state) {
@@ -566,6 +566,102 @@ TEST_F(MaglevLoadBalancerTest, LocalityWeightedLopsided) {
   EXPECT_EQ(MaglevTable::DefaultTableSize - 1023, counts[0]);
 }
 
+// A table rebuilt from cached permutations after hosts are added and removed matches a table built
+// from scratch for the same hosts.
+TEST_F(MaglevLoadBalancerTest, RebuildAfterChurnMatchesFreshBuild) {
+  for (uint32_t i = 0; i < 100; ++i) {
+    host_set_.hosts_.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", i)));
+  }
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  init(1009);
+
+  HostVector removed(host_set_.hosts_.begin() + 10, host_set_.hosts_.begin() + 15);
+  host_set_.hosts_.erase(host_set_.hosts_.begin() + 10, host_set_.hosts_.begin() + 15);
+  HostVector added;
+  for (uint32_t i = 200; i < 205; ++i) {
+    added.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", i)));
+  }
+  host_set_.hosts_.insert(host_set_.hosts_.begin(), added.begin(), added.end());
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks(added, removed);
+
+  std::vector<HostConstSharedPtr> rebuilt;
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+  for (uint32_t i = 0; i < 1009; ++i) {
+    TestLoadBalancerContext context(i);
+    rebuilt.push_back(lb->chooseHost(&context).host);
+  }
+
+  createLb();
+  EXPECT_TRUE(lb_->initialize().ok());
+  lb = lb_->factory()->create(lb_params_);
+  for (uint32_t i = 0; i < 1009; ++i) {
+    TestLoadBalancerContext context(i);
+    EXPECT_EQ(rebuilt[i], lb->chooseHost(&context).host);
+  }
+}
+
+TEST(MaglevPermutationCacheTest, OrdersHostsByKey) {
+  MaglevPermutationCache cache(17);
+  const std::vector<std::string> keys = {"c", "a", "b"};
+  std::vector<MaglevPermutationCache::HostKey> hosts;
+  for (uint32_t i = 0; i < keys.size(); ++i) {
+    hosts.push_back({keys[i], i, {}});
+  }
+  ASSERT_TRUE(cache.update(hosts));
+  EXPECT_EQ(3, cache.size());
+  ASSERT_EQ(3, hosts.size());
+  EXPECT_EQ("a", hosts[0].key_);
+  EXPECT_EQ(1, hosts[0].index_);
+  EXPECT_EQ("b", hosts[1].key_);
+  EXPECT_EQ("c", hosts[2].key_);
+  for (const auto& host : hosts) {
+    const auto expected = MaglevPermutationCache::permutation(host.key_, 17);
+    EXPECT_EQ(expected.offset_, host.permutation_.offset_);
+    EXPECT_EQ(expected.skip_, host.permutation_.skip_);
+    EXPECT_LT(host.permutation_.offset_, 17);
+    EXPECT_GE(host.permutation_.skip_, 1);
+    EXPECT_LT(host.permutation_.skip_, 17);
+  }
+
+  // Removed keys are dropped and added keys are merged in order.
+  const std::vector<std::string> next_keys = {"d", "b", "aa"};
+  hosts.clear();
+  for (uint32_t i = 0; i < next_keys.size(); ++i) {
+    hosts.push_back({next_keys[i], i, {}});
+  }
+  ASSERT_TRUE(cache.update(hosts));
+  EXPECT_EQ(3, cache.size());
+  EXPECT_EQ("aa", hosts[0].key_);
+  EXPECT_EQ(2, hosts[0].index_);
+  EXPECT_EQ("b", hosts[1].key_);
+  EXPECT_EQ(1, hosts[1].index_);
+  EXPECT_EQ("d", hosts[2].key_);
+  EXPECT_EQ(0, hosts[2].index_);
+}
+
+// Duplicate hash keys cannot be ordered by key alone, so the cache gives up and is cleared.
+TEST(MaglevPermutationCacheTest, DuplicateKeys) {
+  MaglevPermutationCache cache(17);
+  std::vector<MaglevPermutationCache::HostKey> hosts = {{"a", 0, {}}, {"b", 1, {}}};
+  ASSERT_TRUE(cache.update(hosts));
+
+  // Duplicate of a cached key.
+  hosts = {{"a", 0, {}}, {"a", 1, {}}};
+  EXPECT_FALSE(cache.update(hosts));
+  EXPECT_EQ(0, cache.size());
+
+  // Duplicate of an added key.
+  hosts = {{"c", 0, {}}, {"c", 1, {}}};
+  EXPECT_FALSE(cache.update(hosts));
+  EXPECT_EQ(0, cache.size());
+
+  hosts = {{"b", 0, {}}, {"a", 1, {}}};
+  EXPECT_TRUE(cache.update(hosts));
+  EXPECT_EQ(2, cache.size());
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -0,0 +1,88 @@
+#include "envoy/config/core/v3/extension.pb.h"
+
+#include "source/extensions/load_balancing_policies/peak_ewma/config.h"
+
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/mocks/upstream/priority_set.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolices {
+namespace PeakEwma {
+namespace {
+
+TEST(PeakEwmaConfigTest, Validate) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  NiceMock<Upstream::MockClusterInfo> cluster_info;
+  NiceMock<Upstream::MockPrioritySet> main_thread_priority_set;
+  NiceMock<Upstream::MockPrioritySet> thread_local_priority_set;
+
+  envoy::config::core::v3::TypedExtensionConfig config;
+  config.set_name("envoy.load_balancing_policies.peak_ewma");
+  envoy::extensions::load_balancing_policies::peak_ewma::v3::PeakEwma config_msg;
+  config.mutable_typed_config()->PackFrom(config_msg);
+
+  auto& factory = Config::Utility::getAndCheckFactory<Upstream::TypedLoadBalancerFactory>(config);
+  EXPECT_EQ("envoy.load_balancing_policies.peak_ewma", factory.name());
+
+  auto lb_config = factory.loadConfig(context, *factory.createEmptyConfigProto()).value();
+
+  auto thread_aware_lb =
+      factory.create(*lb_config, cluster_info, main_thread_priority_set, context.runtime_loader_,
+                     context.api_.random_, context.time_system_);
+  EXPECT_NE(nullptr, thread_aware_lb);
+
+  ASSERT_TRUE(thread_aware_lb->initialize().ok());
+
+  auto thread_local_lb_factory = thread_aware_lb->factory();
+  EXPECT_NE(nullptr, thread_local_lb_factory);
+
+  auto thread_local_lb = thread_local_lb_factory->create({thread_local_priority_set, nullptr});
+  EXPECT_NE(nullptr, thread_local_lb);
+}
+
+TEST(PeakEwmaConfigTest, Defaults) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  auto& factory = Config::Utility::getAndCheckFactoryByName<Upstream::TypedLoadBalancerFactory>(
+      "envoy.load_balancing_policies.peak_ewma");
+
+  auto lb_config = factory.loadConfig(context, *factory.createEmptyConfigProto()).value();
+  const auto& typed_lb_config = dynamic_cast<const Upstream::PeakEwmaLbConfig&>(*lb_config);
+  EXPECT_EQ(2U, typed_lb_config.choice_count_);
+  EXPECT_EQ(std::chrono::milliseconds(10000), typed_lb_config.decay_time_);
+  EXPECT_EQ(std::chrono::milliseconds(30), typed_lb_config.default_response_time_);
+  EXPECT_FALSE(typed_lb_config.locality_lb_config_.has_value());
+}
+
+TEST(PeakEwmaConfigTest, Configured) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  auto& factory = Config::Utility::getAndCheckFactoryByName<Upstream::TypedLoadBalancerFactory>(
+      "envoy.load_balancing_policies.peak_ewma");
+
+  envoy::extensions::load_balancing_policies::peak_ewma::v3::PeakEwma config_msg;
+  config_msg.mutable_choice_count()->set_value(3);
+  config_msg.mutable_decay_time()->set_seconds(5);
+  config_msg.mutable_default_response_time()->set_nanos(100000000);
+  config_msg.mutable_locality_lb_config()->mutable_zone_aware_lb_config();
+
+  auto lb_config = factory.loadConfig(context, config_msg).value();
+  const auto& typed_lb_config = dynamic_cast<const Upstream::PeakEwmaLbConfig&>(*lb_config);
+  EXPECT_EQ(3U, typed_lb_config.choice_count_);
+  EXPECT_EQ(std::chrono::milliseconds(5000), typed_lb_config.decay_time_);
+  EXPECT_EQ(std::chrono::milliseconds(100), typed_lb_config.default_response_time_);
+  EXPECT_TRUE(typed_lb_config.locality_lb_config_.has_value());
+
+  // A decay time shorter than a millisecond is rounded up to one.
+  config_msg.mutable_decay_time()->set_seconds(0);
+  config_msg.mutable_decay_time()->set_nanos(1000);
+  lb_config = factory.loadConfig(context, config_msg).value();
+  EXPECT_EQ(std::chrono::milliseconds(1),
+            dynamic_cast<const Upstream::PeakEwmaLbConfig&>(*lb_config).decay_time_);
+}
+
+} // namespace
+} // namespace PeakEwma
+} // namespace LoadBalancingPolices
+} // namespace Extensions
+} // namespace Envoy
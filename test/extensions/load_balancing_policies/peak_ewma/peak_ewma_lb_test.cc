@@ -0,0 +1,201 @@
+#include <cmath>
+
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+#include "test/extensions/load_balancing_policies/common/load_balancer_impl_base_test.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+using testing::Return;
+
+TEST(PeakEwmaHostLbPolicyDataTest, NoObservation) {
+  Event::SimulatedTimeSystem time_system;
+  PeakEwmaHostLbPolicyData data(std::chrono::seconds(10), time_system);
+  EXPECT_FALSE(data.responseTime(time_system.monotonicTime()).has_value());
+}
+
+TEST(PeakEwmaHostLbPolicyDataTest, FollowsPeakAndDecays) {
+  Event::SimulatedTimeSystem time_system;
+  PeakEwmaHostLbPolicyData data(std::chrono::seconds(10), time_system);
+  const MonotonicTime start = time_system.monotonicTime();
+  const double decay = std::exp(-1.0);
+
+  // The first observation is the average.
+  data.observe(40, start);
+  EXPECT_DOUBLE_EQ(40, data.responseTime(start).value());
+
+  // A slower response replaces the average.
+  data.observe(100, start);
+  EXPECT_DOUBLE_EQ(100, data.responseTime(start).value());
+
+  // The average decays towards zero without observations.
+  EXPECT_DOUBLE_EQ(100 * decay, data.responseTime(start + std::chrono::seconds(10)).value());
+
+  // And towards a faster response.
+  data.observe(10, start + std::chrono::seconds(10));
+  EXPECT_DOUBLE_EQ(100 * decay + 10 * (1 - decay),
+                   data.responseTime(start + std::chrono::seconds(10)).value());
+
+  // A time before the last observation, as seen by a concurrent reader, does not decay.
+  EXPECT_DOUBLE_EQ(100 * decay + 10 * (1 - decay), data.responseTime(start).value());
+}
+
+TEST(PeakEwmaHostLbPolicyDataTest, OnResponseTime) {
+  Event::SimulatedTimeSystem time_system;
+  PeakEwmaHostLbPolicyData data(std::chrono::seconds(10), time_system);
+  data.onResponseTime(std::chrono::microseconds(2500));
+  EXPECT_DOUBLE_EQ(2.5, data.responseTime(time_system.monotonicTime()).value());
+}
+
+class PeakEwmaLoadBalancerTest : public LoadBalancerTestBase {
+public:
+  void init() {
+    lb_config_ = std::make_unique<PeakEwmaLbConfig>(peak_ewma_lb_config_);
+    thread_aware_lb_ = std::make_unique<PeakEwmaLoadBalancer>(*lb_config_, *info_, priority_set_,
+                                                              runtime_, random_, simTime());
+    ASSERT_TRUE(thread_aware_lb_->initialize().ok());
+    lb_ = thread_aware_lb_->factory()->create({priority_set_, nullptr});
+  }
+
+  void setHosts(HostVector hosts) {
+    hostSet().healthy_hosts_ = hosts;
+    hostSet().hosts_ = hosts;
+    hostSet().runCallbacks(hosts, {});
+  }
+
+  void observe(const HostSharedPtr& host, double response_time) {
+    host->typedLbPolicyData<PeakEwmaHostLbPolicyData>()->observe(response_time,
+                                                                 simTime().monotonicTime());
+  }
+
+  PeakEwmaLbProto peak_ewma_lb_config_;
+  std::unique_ptr<PeakEwmaLbConfig> lb_config_;
+  ThreadAwareLoadBalancerPtr thread_aware_lb_;
+  LoadBalancerPtr lb_;
+};
+
+TEST_P(PeakEwmaLoadBalancerTest, NoHosts) {
+  init();
+  EXPECT_EQ(nullptr, lb_->chooseHost(nullptr).host);
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, AddsLbPolicyDataToHosts) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  init();
+  EXPECT_TRUE(hostSet().hosts_[0]->typedLbPolicyData<PeakEwmaHostLbPolicyData>().has_value());
+
+  const HostSharedPtr added = makeTestHost(info_, "tcp://127.0.0.1:81", simTime());
+  setHosts({hostSet().hosts_[0], added});
+  EXPECT_TRUE(added->typedLbPolicyData<PeakEwmaHostLbPolicyData>().has_value());
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, NoPeek) {
+  init();
+  setHosts({makeTestHost(info_, "tcp://127.0.0.1:80", simTime())});
+  EXPECT_EQ(nullptr, lb_->peekAnotherHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, PicksLowerResponseTime) {
+  init();
+  setHosts({makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+            makeTestHost(info_, "tcp://127.0.0.1:81", simTime())});
+  observe(hostSet().healthy_hosts_[0], 100);
+  observe(hostSet().healthy_hosts_[1], 10);
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, ScalesResponseTimeByActiveRequests) {
+  init();
+  setHosts({makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+            makeTestHost(info_, "tcp://127.0.0.1:81", simTime())});
+  observe(hostSet().healthy_hosts_[0], 10);
+  observe(hostSet().healthy_hosts_[1], 20);
+
+  // Costs of 10 * 6 and 20 * 1.
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(5);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+
+  // Costs of 10 * 6 and 20 * 4.
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(3);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, DefaultResponseTime) {
+  peak_ewma_lb_config_.mutable_default_response_time()->set_nanos(5000000);
+  init();
+  setHosts({makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+            makeTestHost(info_, "tcp://127.0.0.1:81", simTime())});
+  observe(hostSet().healthy_hosts_[0], 10);
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+
+  // The average of the first host decays below the default response time.
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+}
+
+// A host whose requests hang sees no responses, so its average decays towards zero while its
+// requests are active. It must not become the cheapest host.
+TEST_P(PeakEwmaLoadBalancerTest, PenalizesHostWithDecayedAverageAndActiveRequests) {
+  init();
+  setHosts({makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+            makeTestHost(info_, "tcp://127.0.0.1:81", simTime())});
+  observe(hostSet().healthy_hosts_[0], 100);
+  simTime().advanceTimeWait(std::chrono::seconds(950));
+  observe(hostSet().healthy_hosts_[1], 10);
+  simTime().advanceTimeWait(std::chrono::seconds(50));
+
+  // The first host's average has decayed to nothing, and the second's to about 0.07ms, which
+  // without requests in flight still makes the first host the cheaper one.
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(3);
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(20);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
+
+  // Among stalled hosts, the one with fewer active requests is cheaper.
+  simTime().advanceTimeWait(std::chrono::seconds(1000));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr).host);
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, WeightedHosts) {
+  init();
+  setHosts({makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+            makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 3)});
+  // Weights of 1 / (1 + 30) and 3 / (1 + 92).
+  observe(hostSet().healthy_hosts_[1], 92);
+
+  uint32_t first_host_picks = 0;
+  for (uint32_t i = 0; i < 400; ++i) {
+    if (lb_->chooseHost(nullptr).host == hostSet().healthy_hosts_[0]) {
+      ++first_host_picks;
+    }
+  }
+  EXPECT_NEAR(200, first_host_picks, 2);
+}
+
+INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, PeakEwmaLoadBalancerTest,
+                         ::testing::Values(LoadBalancerTestParam{true},
+                                           LoadBalancerTestParam{false}));
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
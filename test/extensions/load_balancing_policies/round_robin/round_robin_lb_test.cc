@@ -454,6 +454,45 @@ TEST_P(RoundRobinLoadBalancerTest, Weighted) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr).host);
 }
 
+// Validate that the EDF scheduler of a host list is only rebuilt when its hosts or their weights
+// change.
+TEST_P(RoundRobinLoadBalancerTest, WeightedSchedulerKeptWhenUnchanged) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  init(false);
+  auto& edf_lb = static_cast<EdfLoadBalancerBase&>(*lb_);
+  const HostsSource source(0, HostsSource::SourceType::HealthyHosts);
+  const EdfScheduler<Host>* scheduler = EdfLoadBalancerBasePeer::edfScheduler(edf_lb, source);
+  ASSERT_NE(nullptr, scheduler);
+  EXPECT_EQ((std::vector<uint32_t>{1, 2}),
+            EdfLoadBalancerBasePeer::edfSchedulerWeights(edf_lb, source));
+
+  // An update leaving the hosts unchanged keeps the scheduler.
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(scheduler, EdfLoadBalancerBasePeer::edfScheduler(edf_lb, source));
+
+  // A weight change rebuilds it.
+  hostSet().healthy_hosts_[0]->weight(3);
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ((std::vector<uint32_t>{3, 2}),
+            EdfLoadBalancerBasePeer::edfSchedulerWeights(edf_lb, source));
+
+  // As does a membership change.
+  hostSet().healthy_hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), 1));
+  hostSet().hosts_.push_back(hostSet().healthy_hosts_.back());
+  hostSet().runCallbacks({hostSet().healthy_hosts_.back()}, {});
+  EXPECT_EQ((std::vector<uint32_t>{3, 2, 1}),
+            EdfLoadBalancerBasePeer::edfSchedulerWeights(edf_lb, source));
+
+  // Weights becoming equal drop the scheduler.
+  for (auto& host : hostSet().healthy_hosts_) {
+    host->weight(1);
+  }
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(nullptr, EdfLoadBalancerBasePeer::edfScheduler(edf_lb, source));
+}
+
 // Validate that the RNG seed influences pick order when weighted RR.
 TEST_P(RoundRobinLoadBalancerTest, WeightedSeed) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
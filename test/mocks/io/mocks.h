@@ -25,9 +25,26 @@ public:
   MOCK_METHOD(IoUringResult, prepareWritev,
               (os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareRecvMultishot, (os_fd_t fd, Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareWritevAndClose,
+              (os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, Request* write_user_data,
+               Request* close_user_data));
+  MOCK_METHOD(IoUringResult, prepareOpenat,
+              (os_fd_t dfd, const char* path, int flags, mode_t mode, Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareStatx,
+              (os_fd_t dfd, const char* path, int flags, unsigned mask, struct statx* statxbuf,
+               Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareUnlinkat,
+              (os_fd_t dfd, const char* path, int flags, Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareLinkat,
+              (os_fd_t old_dfd, const char* old_path, os_fd_t new_dfd, const char* new_path,
+               int flags, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareClose, (os_fd_t fd, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareCancel, (Request * cancelling_user_data, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareShutdown, (os_fd_t fd, int how, Request* user_data));
+  MOCK_METHOD(bool, setupBufferRing, (uint32_t entries, uint32_t buffer_size));
+  MOCK_METHOD(void, consumeProvidedBuffer,
+              (uint16_t buffer_id, uint32_t length, Buffer::Instance& output));
   MOCK_METHOD(IoUringResult, submit, ());
   MOCK_METHOD(void, injectCompletion, (os_fd_t fd, Request* user_data, int32_t result));
   MOCK_METHOD(void, removeInjectedCompletion, (os_fd_t fd));
@@ -31,7 +31,7 @@ MockClusterManager::MockClusterManager()
           Invoke([](OdCdsCreationFunction, const envoy::config::core::v3::ConfigSource&,
                     OptRef<xds::core::v3::ResourceLocator>,
                     ProtobufMessage::ValidationVisitor&) { return MockOdCdsApiHandle::create(); }));
-  ON_CALL(*this, addOrUpdateCluster(_, _, _)).WillByDefault(Return(false));
+  ON_CALL(*this, addOrUpdateCluster(_, _, _, _)).WillByDefault(Return(false));
 }
 
 MockClusterManager::~MockClusterManager() = default;
@@ -103,6 +103,7 @@ TEST_F(OptionsImplTest, All) {
       "--local-address-ip-version v6 -l info --component-log-level upstream:debug,connection:trace "
       "--service-cluster cluster --service-node node --service-zone zone "
       "--file-flush-interval-msec 9000 "
+      "--file-flush-buffer-limit-bytes 1048576 --file-flush-overflow-action drop "
       "--skip-hot-restart-on-no-parent "
       "--skip-hot-restart-parent-stats "
       "--drain-time-s 60 --log-format [%v] --parent-shutdown-time-s 90 "
@@ -131,6 +132,8 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ("node", options->serviceNodeName());
   EXPECT_EQ("zone", options->serviceZone());
   EXPECT_EQ(std::chrono::milliseconds(9000), options->fileFlushIntervalMsec());
+  EXPECT_EQ(1048576, options->fileFlushBufferLimitBytes());
+  EXPECT_EQ(Server::FileFlushOverflowAction::Drop, options->fileFlushOverflowAction());
   EXPECT_EQ(std::chrono::seconds(60), options->drainTime());
   EXPECT_EQ(std::chrono::seconds(90), options->parentShutdownTime());
   EXPECT_TRUE(options->hotRestartDisabled());
@@ -197,6 +200,8 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setLogPath("/foo/bar");
   options->setRestartEpoch(44);
   options->setFileFlushIntervalMsec(std::chrono::milliseconds(45));
+  options->setFileFlushBufferLimitBytes(46);
+  options->setFileFlushOverflowAction(Server::FileFlushOverflowAction::Drop);
   options->setMode(Server::Mode::Validate);
   options->setServiceClusterName("cluster_foo");
   options->setServiceNodeName("node_foo");
@@ -230,6 +235,8 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(std::chrono::seconds(43), options->parentShutdownTime());
   EXPECT_EQ(44, options->restartEpoch());
   EXPECT_EQ(std::chrono::milliseconds(45), options->fileFlushIntervalMsec());
+  EXPECT_EQ(46, options->fileFlushBufferLimitBytes());
+  EXPECT_EQ(Server::FileFlushOverflowAction::Drop, options->fileFlushOverflowAction());
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ("cluster_foo", options->serviceClusterName());
   EXPECT_EQ("node_foo", options->serviceNodeName());
@@ -263,6 +270,10 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(options->restartEpoch(), command_line_options->restart_epoch());
   EXPECT_EQ(options->fileFlushIntervalMsec().count() / 1000,
             command_line_options->file_flush_interval().seconds());
+  EXPECT_EQ(options->fileFlushBufferLimitBytes(),
+            command_line_options->file_flush_buffer_limit_bytes());
+  EXPECT_EQ(envoy::admin::v3::CommandLineOptions::Drop,
+            command_line_options->file_flush_overflow_action());
   EXPECT_EQ(envoy::admin::v3::CommandLineOptions::Validate, command_line_options->mode());
   EXPECT_EQ(options->serviceClusterName(), command_line_options->service_cluster());
   EXPECT_EQ(options->serviceNodeName(), command_line_options->service_node());
@@ -376,6 +387,9 @@ TEST_F(OptionsImplTest, OptionsFromArgvPrefix) {
 TEST_F(OptionsImplTest, BadCliOption) {
   EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy -c hello --local-address-ip-version foo"),
                           MalformedArgvException, "error: unknown IP address version 'foo'");
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy -c hello --file-flush-overflow-action foo"),
+                          MalformedArgvException,
+                          "error: unknown file-flush-overflow-action 'foo'");
 }
 
 TEST_F(OptionsImplTest, ParseComponentLogLevels) {
@@ -511,6 +525,10 @@ TEST_F(OptionsImplTest, SaneTestConstructor) {
   EXPECT_EQ(regular_options_impl->mode(), test_options_impl.mode());
   EXPECT_EQ(regular_options_impl->fileFlushIntervalMsec(),
             test_options_impl.fileFlushIntervalMsec());
+  EXPECT_EQ(regular_options_impl->fileFlushBufferLimitBytes(),
+            test_options_impl.fileFlushBufferLimitBytes());
+  EXPECT_EQ(regular_options_impl->fileFlushOverflowAction(),
+            test_options_impl.fileFlushOverflowAction());
   EXPECT_EQ(regular_options_impl->hotRestartDisabled(), test_options_impl.hotRestartDisabled());
   EXPECT_EQ(regular_options_impl->cpusetThreadsEnabled(), test_options_impl.cpusetThreadsEnabled());
 }
@@ -0,0 +1,38 @@
+// NOLINT(namespace-envoy)
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "test/tools/binary_access_log_decoder/decoder.h"
+
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: binary_access_log_decoder PATH\n"
+                 "\nPrint the entries of a binary access log file as JSON, one object per line.\n"
+                 "\n\tPATH - the path of the file written by the envoy.access_loggers.binary_file"
+                 " access logger."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::ifstream file(argv[1], std::ios::binary);
+  if (!file) {
+    std::cerr << "Unable to open " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+
+  const auto blocks = Envoy::Extensions::AccessLoggers::BinaryFile::decodeFile(contents.str());
+  if (!blocks.ok()) {
+    std::cerr << blocks.status().message() << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string output;
+  for (const auto& block : blocks.value()) {
+    output.clear();
+    Envoy::Extensions::AccessLoggers::BinaryFile::appendJsonLines(block, output);
+    std::cout << output;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,86 @@
+#include "test/tools/binary_access_log_decoder/decoder.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/fmt.h"
+#include "source/common/json/json_streamer.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/compression/zstd/decompressor/zstd_decompressor_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+namespace {
+
+constexpr uint32_t DecompressorChunkSize = 4096;
+
+} // namespace
+
+absl::StatusOr<std::vector<DecodedBlock>> decodeFile(absl::string_view contents) {
+  Stats::IsolatedStoreImpl stats_store;
+  const Compression::Zstd::Decompressor::ZstdDDictManagerPtr ddict_manager;
+  std::vector<DecodedBlock> blocks;
+  uint64_t offset = 0;
+  while (offset < contents.size()) {
+    const absl::string_view remaining = contents.substr(offset);
+    if (remaining.size() < BlockHeaderSize) {
+      return absl::InvalidArgumentError(fmt::format("truncated block header at offset {}", offset));
+    }
+    const absl::StatusOr<BlockHeader> header = decodeBlockHeader(remaining);
+    if (!header.ok()) {
+      return absl::InvalidArgumentError(
+          fmt::format("block at offset {}: {}", offset, header.status().message()));
+    }
+    if (remaining.size() - BlockHeaderSize < header->compressed_size_) {
+      return absl::InvalidArgumentError(fmt::format("truncated block at offset {}", offset));
+    }
+
+    Buffer::OwnedImpl compressed(remaining.substr(BlockHeaderSize, header->compressed_size_));
+    Buffer::OwnedImpl payload;
+    Compression::Zstd::Decompressor::ZstdDecompressorImpl decompressor(
+        *stats_store.rootScope(), "binary_access_log.", ddict_manager, DecompressorChunkSize);
+    decompressor.decompress(compressed, payload);
+    if (payload.length() != header->uncompressed_size_) {
+      return absl::InvalidArgumentError(
+          fmt::format("block at offset {} does not decompress to its size", offset));
+    }
+
+    absl::StatusOr<DecodedBlock> block = decodeBlockPayload(payload.toString());
+    if (!block.ok()) {
+      return absl::InvalidArgumentError(
+          fmt::format("block at offset {}: {}", offset, block.status().message()));
+    }
+    blocks.push_back(std::move(block.value()));
+    offset += BlockHeaderSize + header->compressed_size_;
+  }
+  return blocks;
+}
+
+void appendJsonLines(const DecodedBlock& block, std::string& output) {
+  for (uint32_t i = 0; i < block.entries_; i++) {
+    {
+      Json::StringStreamer streamer(output);
+      Json::StringStreamer::MapPtr map = streamer.makeRootMap();
+      for (const DecodedColumn& column : block.columns_) {
+        map->addKey(column.schema_.name_);
+        if (column.schema_.type_ == ColumnType::String) {
+          if (column.strings_[i].has_value()) {
+            map->addString(column.strings_[i].value());
+          } else {
+            map->addNull();
+          }
+        } else if (column.integers_[i].has_value()) {
+          map->addNumber(column.integers_[i].value());
+        } else {
+          map->addNull();
+        }
+      }
+    }
+    output.push_back('\n');
+  }
+}
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "source/extensions/access_loggers/binary_file/block_format.h"
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+/**
+ * Decodes the blocks of a binary access log file.
+ * @param contents the contents of the file.
+ * @return the blocks of the file, in order, or an error if the file is not a valid binary access
+ *         log. A block which is only partly written, as the last block of a file being written can
+ *         be, is an error.
+ */
+absl::StatusOr<std::vector<DecodedBlock>> decodeFile(absl::string_view contents);
+
+/**
+ * Appends the entries of a block to a string as JSON objects, one per line, mapping the name of
+ * each column to its value. Missing values are null.
+ */
+void appendJsonLines(const DecodedBlock& block, std::string& output);
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy